@@ -287,7 +287,11 @@ aom_codec_err_t aom_codec_register_put_frame_cb(aom_codec_ctx_t *ctx,
 /*!\brief put slice callback prototype
  *
  * This callback is invoked by the decoder to notify the application of
- * the availability of partially decoded image data. The
+ * the availability of partially decoded image data. The valid rectangle
+ * covers all the image data available so far and the update rectangle the
+ * data that became available since the previous call for this image. The
+ * callback is invoked during aom_codec_decode(), possibly from one of the
+ * decoder's threads, but never concurrently.
  */
 typedef void (*aom_codec_put_slice_cb_fn_t)(void *user_priv,
                                             const aom_image_t *img,
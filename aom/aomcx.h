@@ -506,6 +506,39 @@ enum aome_enc_control_id {
    * Experiment: ANS
    */
   AV1E_SET_ANS_WINDOW_SIZE_LOG2,
+
+  /*!\brief Codec control function to enable row based multi-threading.
+   *
+   * When enabled, the superblock rows of each tile are encoded in parallel
+   * with a wavefront dependency on the row above, so that the number of
+   * threads used is no longer limited by the number of tile columns. The
+   * output is identical for any number of threads.
+   *            0 = off (default)
+   *            1 = on
+   *
+   * Supported in codecs: AV1
+   */
+  AV1E_SET_ROW_MT,
+
+  /*!\brief Codec control function to encode key frame chunks in parallel.
+   *
+   * When enabled in the last pass of a two pass encode, the input is cut at
+   * forced key frames (a fixed key frame interval or AOM_EFLAG_FORCE_KF) and
+   * after every kf_max_dist frames, and each chunk is encoded by a compressor
+   * of its own on up to g_threads threads. A copy of every source of a chunk
+   * is held until the chunk is encoded, so up to (g_threads + 1) * kf_max_dist
+   * source frames are held at once, on top of the frame buffers of g_threads
+   * compressors: kf_max_dist should be kept small. Requires kf_mode
+   * AOM_KF_AUTO and a non-zero kf_max_dist. The bits of the sequence are
+   * shared among the chunks using the first pass stats. Output is delayed by
+   * up to g_threads chunks and is not identical to an encode with the control
+   * off.
+   *            0 = off (default)
+   *            1 = on
+   *
+   * Supported in codecs: AV1
+   */
+  AV1E_SET_KF_CHUNK_PARALLEL,
 };
 
 /*!\brief aom 1-D scaling mode
@@ -713,6 +746,12 @@ AOM_CTRL_USE_TYPE(AV1E_GET_LEVEL, int *)
 
 AOM_CTRL_USE_TYPE(AV1E_SET_ANS_WINDOW_SIZE_LOG2, unsigned int)
 #define AOM_CTRL_AV1E_SET_ANS_WINDOW_SIZE_LOG2
+
+AOM_CTRL_USE_TYPE(AV1E_SET_ROW_MT, unsigned int)
+#define AOM_CTRL_AV1E_SET_ROW_MT
+
+AOM_CTRL_USE_TYPE(AV1E_SET_KF_CHUNK_PARALLEL, unsigned int)
+#define AOM_CTRL_AV1E_SET_KF_CHUNK_PARALLEL
 /*!\endcond */
 /*! @} - end defgroup aom_encoder */
 #ifdef __cplusplus
@@ -141,7 +141,10 @@ enum aom_dec_control_id {
    * greater and equal to zero indicates only the specific row/column is
    * decoded. A value that is -1 indicates the whole row/column is decoded.
    * A special case is both values are -1 that means the whole frame is
-   * decoded.
+   * decoded. Only whole frames are posted to a put_slice callback; while a
+   * single tile row or column is decoded, which is the default with
+   * --enable-ext-tile, the callback is not invoked and frames are only output
+   * by aom_codec_get_frame().
    */
   AV1_SET_DECODE_TILE_ROW,
   AV1_SET_DECODE_TILE_COL,
@@ -152,6 +155,58 @@ enum aom_dec_control_id {
    */
   AV1_SET_INSPECTION_CALLBACK,
 
+  /** control function to pipeline the decoding of single tile columns. The
+   * superblock rows of a tile are entropy decoded in order on one thread and
+   * predicted and reconstructed on the other threads as soon as they are
+   * parsed, in wavefront order. The deblocking of the frame also joins the
+   * superblock row pipeline of the other post filters. Valid values are 0
+   * (off, default) and 1. It has no effect with frame parallel decoding or a
+   * single thread.
+   */
+  AV1D_SET_ROW_MT,
+
+  /** control function to allocate the decoded frames with a minimal border.
+   * The borders of the reference frames are then not extended after each
+   * frame, and the inter predictors replicate the frame edges only for the
+   * blocks whose motion vectors reach outside the reference frame. This saves
+   * memory and a pass over the frame borders per frame. Valid values are 0
+   * (off, default) and 1. It must be set before the first frame is decoded.
+   */
+  AV1D_SET_MIN_BORDER,
+
+  /** control function to keep the memory of a decoder instance to what the
+   * current frame needs. The tile worker scratch buffers are released after
+   * each frame, and the internal frame buffers and motion vector buffers are
+   * freed as soon as no reference points to them. This trades some
+   * allocations per frame for a smaller footprint when many streams are
+   * decoded at once. Valid values are 0 (off, default) and 1. It must be set
+   * before the first frame is decoded.
+   */
+  AV1D_SET_LOW_MEMORY,
+
+  /** control function to get the memory used by the decoder instance, as an
+   * aom_dec_mem_usage_t. The frame buffers supplied by the application are
+   * not counted.
+   */
+  AV1D_GET_MEMORY_USAGE,
+
+  /** control function to decode a rectangle of tiles, given as an
+   * aom_image_rect_t in units of tiles: x and y are the first tile column and
+   * row, w and h the numbers of tile columns and rows. Only the tiles of the
+   * rectangle are decoded and output, and the frame buffers only hold the
+   * rectangle, so that the memory and time scale with its size. A NULL
+   * rectangle, or one of zero size, decodes the whole frames. A rectangle
+   * replaces the tile set with AV1_SET_DECODE_TILE_ROW and
+   * AV1_SET_DECODE_TILE_COL, and, like them, disables the put_slice
+   * callback. It takes effect at the next key frame, and the frame size must
+   * not change until the following one. Blocks predicted from outside the
+   * rectangle see its edges replicated, and the loop filters do not cross its
+   * edges. Loop restoration is not supported. When compiled
+   * without --enable-ext-tile, or with global or warped motion, this returns
+   * AOM_CODEC_INCAPABLE.
+   */
+  AV1_SET_DECODE_TILE_RECT,
+
   AOM_DECODER_CTRL_ID_MAX,
 };
 
@@ -173,6 +228,18 @@ typedef struct aom_decrypt_init {
   void *decrypt_state;
 } aom_decrypt_init;
 
+/*!\brief Structure to hold the memory usage of a decoder instance
+ *
+ * Defines a structure to report the heap memory allocated by the decoder.
+ */
+typedef struct aom_dec_mem_usage {
+  /*! Bytes allocated after the last decoded frame. */
+  size_t current_bytes;
+
+  /*! Highest number of bytes allocated at the end of a frame. */
+  size_t peak_bytes;
+} aom_dec_mem_usage_t;
+
 /*!\cond */
 /*!\brief AOM decoder control function parameter type
  *
@@ -209,6 +276,16 @@ AOM_CTRL_USE_TYPE(AV1_SET_DECODE_TILE_COL, int)
 #define AOM_CTRL_AV1_SET_DECODE_TILE_COL
 AOM_CTRL_USE_TYPE(AV1_SET_INSPECTION_CALLBACK, aom_inspect_init *)
 #define AOM_CTRL_AV1_SET_INSPECTION_CALLBACK
+AOM_CTRL_USE_TYPE(AV1D_SET_ROW_MT, int)
+#define AOM_CTRL_AV1D_SET_ROW_MT
+AOM_CTRL_USE_TYPE(AV1D_SET_MIN_BORDER, int)
+#define AOM_CTRL_AV1D_SET_MIN_BORDER
+AOM_CTRL_USE_TYPE(AV1D_SET_LOW_MEMORY, int)
+#define AOM_CTRL_AV1D_SET_LOW_MEMORY
+AOM_CTRL_USE_TYPE(AV1D_GET_MEMORY_USAGE, aom_dec_mem_usage_t *)
+#define AOM_CTRL_AV1D_GET_MEMORY_USAGE
+AOM_CTRL_USE_TYPE(AV1_SET_DECODE_TILE_RECT, aom_image_rect_t *)
+#define AOM_CTRL_AV1_SET_DECODE_TILE_RECT
 /*!\endcond */
 /*! @} - end defgroup aom_decoder */
 
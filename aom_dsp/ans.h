@@ -27,6 +27,17 @@ extern "C" {
 #define ANS_MAX_SYMBOLS 1
 #define ANS_REVERSE 1
 
+// Number of interleaved ANS states. The symbols of a window are coded with
+// each state in turn, so that the decoder can start on a symbol before the
+// state update of the previous one has completed. 1 gives the single state
+// bitstream. Set with --ans-num-states, or ANS_NUM_STATES in cmake.
+#ifndef ANS_NUM_STATES
+#define ANS_NUM_STATES 1
+#endif
+#if ANS_NUM_STATES > 1 && !(ANS_REVERSE && ANS_MAX_SYMBOLS)
+#error "Interleaved ANS states require ANS_REVERSE and ANS_MAX_SYMBOLS"
+#endif
+
 typedef uint8_t AnsP8;
 #define ANS_P8_PRECISION 256u
 #define ANS_P8_SHIFT 8
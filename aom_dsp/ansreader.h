@@ -34,7 +34,12 @@ extern "C" {
 struct AnsDecoder {
   const uint8_t *buf;
   int buf_offset;
+  // The state that codes the next symbol.
   uint32_t state;
+#if ANS_NUM_STATES > 1
+  // The other interleaved states, in the order they will be used.
+  uint32_t next_states[ANS_NUM_STATES - 1];
+#endif
 #if ANS_MAX_SYMBOLS
   int symbols_left;
   int window_size;
@@ -60,6 +65,21 @@ static INLINE unsigned refill_state(struct AnsDecoder *const ans,
   return state;
 }
 
+// Moves on to the state that codes the next symbol.
+static INLINE void ans_next_state(struct AnsDecoder *const ans) {
+#if ANS_NUM_STATES > 1
+  const uint32_t state = ans->state;
+  int i;
+  ans->state = ans->next_states[0];
+  for (i = 0; i < ANS_NUM_STATES - 2; ++i) {
+    ans->next_states[i] = ans->next_states[i + 1];
+  }
+  ans->next_states[ANS_NUM_STATES - 2] = state;
+#else
+  (void)ans;
+#endif
+}
+
 // Decode one rABS encoded boolean where the probability of the value being zero
 // is p0.
 static INLINE int rabs_read(struct AnsDecoder *ans, AnsP8 p0) {
@@ -79,6 +99,7 @@ static INLINE int rabs_read(struct AnsDecoder *ans, AnsP8 p0) {
   else
     state = qp0 + remainder;
   ans->state = state;
+  ans_next_state(ans);
   return value;
 }
 
@@ -94,6 +115,7 @@ static INLINE int rabs_read_bit(struct AnsDecoder *ans) {
   unsigned state = refill_state(ans, ans->state);
   const int value = !!(state & 0x80);
   ans->state = ((state >> 1) & ~0x7F) | (state & 0x7F);
+  ans_next_state(ans);
   return value;
 }
 
@@ -132,38 +154,65 @@ static INLINE int rans_read(struct AnsDecoder *ans, const aom_cdf_prob *tab) {
   rem = ans->state % RANS_PRECISION;
   fetch_sym(&sym, tab, rem);
   ans->state = quo * sym.prob + rem - sym.cum_prob;
+  ans_next_state(ans);
   return sym.val;
 }
 
-static INLINE int ans_read_init(struct AnsDecoder *const ans,
-                                const uint8_t *const buf, int offset) {
-  unsigned x;
-  if (offset < 1) return 1;
 #if ANS_REVERSE
-  ans->buf = buf + offset;
-  ans->buf_offset = -offset;
-  x = buf[0];
+// Reads a state written by ans_write_state() from the size bytes at buf.
+// Returns the number of bytes read, or 0 on error.
+static INLINE int ans_read_state(const uint8_t *const buf, int size,
+                                 uint32_t *const state) {
+  const unsigned x = buf[0];
+  int state_size;
   if ((x & 0x80) == 0) {  // Marker is 0xxx xxxx
-    if (offset < 2) return 1;
-    ans->buf_offset += 2;
-    ans->state = mem_get_be16(buf) & 0x7FFF;
+    state_size = 2;
+    if (size >= 2) *state = mem_get_be16(buf) & 0x7FFF;
 #if L_BASE * IO_BASE > (1 << 23)
   } else if ((x & 0xC0) == 0x80) {  // Marker is 10xx xxxx
-    if (offset < 3) return 1;
-    ans->buf_offset += 3;
-    ans->state = mem_get_be24(buf) & 0x3FFFFF;
+    state_size = 3;
+    if (size >= 3) *state = mem_get_be24(buf) & 0x3FFFFF;
   } else {  // Marker is 11xx xxxx
-    if (offset < 4) return 1;
-    ans->buf_offset += 4;
-    ans->state = mem_get_be32(buf) & 0x3FFFFFFF;
+    state_size = 4;
+    if (size >= 4) *state = mem_get_be32(buf) & 0x3FFFFFFF;
 #else
   } else {  // Marker is 1xxx xxxx
-    if (offset < 3) return 1;
-    ans->buf_offset += 3;
-    ans->state = mem_get_be24(buf) & 0x7FFFFF;
+    state_size = 3;
+    if (size >= 3) *state = mem_get_be24(buf) & 0x7FFFFF;
 #endif
   }
+  if (size < state_size) return 0;
+  *state += L_BASE;
+  if (*state >= L_BASE * IO_BASE) return 0;
+  return state_size;
+}
+#endif  // ANS_REVERSE
+
+static INLINE int ans_read_init(struct AnsDecoder *const ans,
+                                const uint8_t *const buf, int offset) {
+#if ANS_REVERSE
+  int state_size;
+  if (offset < 1) return 1;
+  ans->buf = buf + offset;
+  ans->buf_offset = -offset;
+  state_size = ans_read_state(buf, offset, &ans->state);
+  if (state_size == 0) return 1;
+  ans->buf_offset += state_size;
+#if ANS_NUM_STATES > 1
+  {
+    int i;
+    for (i = 0; i < ANS_NUM_STATES - 1; ++i) {
+      if (ans->buf_offset >= 0) return 1;
+      state_size = ans_read_state(ans->buf + ans->buf_offset, -ans->buf_offset,
+                                  &ans->next_states[i]);
+      if (state_size == 0) return 1;
+      ans->buf_offset += state_size;
+    }
+  }
+#endif
 #else
+  unsigned x;
+  if (offset < 1) return 1;
   ans->buf = buf;
   x = buf[offset - 1];
   if ((x & 0x80) == 0) {  // Marker is 0xxx xxxx
@@ -182,12 +231,12 @@ static INLINE int ans_read_init(struct AnsDecoder *const ans,
     // Marker 110x xxxx implies this byte is a superframe marker
     return 1;
   }
+  ans->state += L_BASE;
+  if (ans->state >= L_BASE * IO_BASE) return 1;
 #endif  // ANS_REVERSE
 #if CONFIG_ACCOUNTING
   ans->accounting = NULL;
 #endif
-  ans->state += L_BASE;
-  if (ans->state >= L_BASE * IO_BASE) return 1;
 #if ANS_MAX_SYMBOLS
   assert(ans->window_size > 1);
   ans->symbols_left = ans->window_size;
@@ -202,7 +251,23 @@ static INLINE int ans_read_reinit(struct AnsDecoder *const ans) {
 #endif
 
 static INLINE int ans_read_end(const struct AnsDecoder *const ans) {
+#if ANS_NUM_STATES > 1
+  // After n symbols of the last window, the states are in the order
+  // n % ANS_NUM_STATES, ..., as numbered by the encoder. The states numbered
+  // n and up coded no symbol, were written as L_BASE and must still be
+  // L_BASE; the others must be back below L_BASE.
+  const int num_read = ans->window_size - ans->symbols_left;
+  int i;
+  if (ans->buf_offset != 0) return 0;
+  for (i = 0; i < ANS_NUM_STATES; ++i) {
+    const uint32_t state = i == 0 ? ans->state : ans->next_states[i - 1];
+    if (num_read + i < ANS_NUM_STATES ? state != L_BASE : state >= L_BASE)
+      return 0;
+  }
+  return 1;
+#else
   return ans->buf_offset == 0 && ans->state < L_BASE;
+#endif
 }
 
 static INLINE int ans_reader_has_error(const struct AnsDecoder *const ans) {
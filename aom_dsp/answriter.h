@@ -58,40 +58,47 @@ static INLINE void ans_write_init(struct AnsCoder *const ans,
   ans->state = L_BASE;
 }
 
-static INLINE int ans_write_end(struct AnsCoder *const ans) {
-  uint32_t state;
-  int ans_size;
-  assert(ans->state >= L_BASE);
-  assert(ans->state < L_BASE * IO_BASE);
-  state = ans->state - L_BASE;
+// Writes state, less L_BASE, to buf with a prefix marker giving its size.
+// Returns the number of bytes written, or 0 if the state cannot be serialized.
+static INLINE int ans_write_state(uint8_t *const buf, uint32_t state) {
+  assert(state >= L_BASE);
+  assert(state < L_BASE * IO_BASE);
+  state -= L_BASE;
   if (state < (1u << 15)) {
-    mem_put_le16(ans->buf + ans->buf_offset, (0x00u << 15) + state);
-    ans_size = ans->buf_offset + 2;
+    mem_put_le16(buf, (0x00u << 15) + state);
+    return 2;
 #if ANS_REVERSE
 #if L_BASE * IO_BASE > (1 << 23)
   } else if (state < (1u << 22)) {
-    mem_put_le24(ans->buf + ans->buf_offset, (0x02u << 22) + state);
-    ans_size = ans->buf_offset + 3;
+    mem_put_le24(buf, (0x02u << 22) + state);
+    return 3;
   } else if (state < (1u << 30)) {
-    mem_put_le32(ans->buf + ans->buf_offset, (0x03u << 30) + state);
-    ans_size = ans->buf_offset + 4;
+    mem_put_le32(buf, (0x03u << 30) + state);
+    return 4;
 #else
   } else if (state < (1u << 23)) {
-    mem_put_le24(ans->buf + ans->buf_offset, (0x01u << 23) + state);
-    ans_size = ans->buf_offset + 3;
+    mem_put_le24(buf, (0x01u << 23) + state);
+    return 3;
 #endif
 #else
   } else if (state < (1u << 22)) {
-    mem_put_le24(ans->buf + ans->buf_offset, (0x02u << 22) + state);
-    ans_size = ans->buf_offset + 3;
+    mem_put_le24(buf, (0x02u << 22) + state);
+    return 3;
   } else if (state < (1u << 29)) {
-    mem_put_le32(ans->buf + ans->buf_offset, (0x07u << 29) + state);
-    ans_size = ans->buf_offset + 4;
+    mem_put_le32(buf, (0x07u << 29) + state);
+    return 4;
 #endif
-  } else {
-    assert(0 && "State is too large to be serialized");
-    return ans->buf_offset;
   }
+  assert(0 && "State is too large to be serialized");
+  return 0;
+}
+
+static INLINE int ans_write_end(struct AnsCoder *const ans) {
+  const int state_size =
+      ans_write_state(ans->buf + ans->buf_offset, ans->state);
+  int ans_size;
+  if (state_size == 0) return ans->buf_offset;
+  ans_size = ans->buf_offset + state_size;
 #if ANS_REVERSE
   {
     int i;
@@ -44,6 +44,15 @@ typedef struct daala_writer aom_writer;
 typedef struct aom_dk_writer aom_writer;
 #endif
 
+// Writer state that the encoder keeps across frames, one entry per writer
+// that may be live at the same time. Only the daala writer owns buffers; the
+// other writers code straight into the output and need no state here.
+#if CONFIG_DAALA_EC && !CONFIG_ANS
+typedef struct daala_writer_pool aom_writer_pool;
+#else
+typedef struct aom_writer_pool { int size; } aom_writer_pool;
+#endif
+
 typedef struct TOKEN_STATS {
   int cost;
 #if CONFIG_VAR_TX
@@ -79,6 +88,60 @@ static INLINE void aom_start_encode(aom_writer *bc, uint8_t *buffer) {
 #endif
 }
 
+// Makes room for size writers with buf_size bytes of initial buffer each.
+// Returns 0 on success, or -1 on an allocation failure.
+static INLINE int aom_writer_pool_alloc(aom_writer_pool *pool, int size,
+                                        uint32_t buf_size) {
+#if CONFIG_DAALA_EC && !CONFIG_ANS
+  return aom_daala_writer_pool_alloc(pool, size, buf_size);
+#else
+  (void)buf_size;
+  pool->size = size;
+  return 0;
+#endif
+}
+
+static INLINE void aom_writer_pool_free(aom_writer_pool *pool) {
+#if CONFIG_DAALA_EC && !CONFIG_ANS
+  aom_daala_writer_pool_free(pool);
+#else
+  pool->size = 0;
+#endif
+}
+
+// Like aom_start_encode(), but reuses the buffers of entry idx of the pool
+// instead of allocating new ones.
+static INLINE void aom_start_encode_pooled(aom_writer *bc, uint8_t *buffer,
+                                           aom_writer_pool *pool, int idx) {
+#if CONFIG_ANS
+  (void)bc;
+  (void)buffer;
+  (void)pool;
+  (void)idx;
+  assert(0 && "buf_ans requires a more complicated startup procedure");
+#elif CONFIG_DAALA_EC
+  aom_daala_start_encode_pooled(bc, buffer, pool, idx);
+#else
+  (void)pool;
+  (void)idx;
+  aom_dk_start_encode(bc, buffer);
+#endif
+}
+
+// Limits the output of bc to the first size bytes of its buffer, which are
+// otherwise assumed to be enough. If the output does not fit, the bytes that
+// do not are dropped, and bc->pos exceeds size once encoding stops.
+static INLINE void aom_writer_set_buffer_size(aom_writer *bc,
+                                              unsigned int size) {
+#if CONFIG_ANS
+  (void)bc;
+  (void)size;
+  assert(0 && "buf_ans does not write to a fixed buffer");
+#else
+  bc->size = size;
+#endif
+}
+
 static INLINE void aom_stop_encode(aom_writer *bc) {
 #if CONFIG_ANS
   (void)bc;
@@ -45,27 +45,43 @@ void aom_buf_ans_grow(struct BufAnsCoder *c) {
 #endif
 
 void aom_buf_ans_flush(struct BufAnsCoder *const c) {
+  uint32_t state[ANS_NUM_STATES];
   int offset;
+  int i;
 #if ANS_MAX_SYMBOLS
   if (c->offset == 0) return;
 #endif
   assert(c->offset > 0);
-  offset = c->offset - 1;
-  // Code the first symbol such that it brings the state to the smallest normal
-  // state from an initial state that would have been a subnormal/refill state.
-  if (c->buf[offset].method == ANS_METHOD_RANS) {
-    c->ans.state += c->buf[offset].val_start;
-  } else {
-    c->ans.state += c->buf[offset].val_start ? c->buf[offset].prob : 0;
-  }
-  for (offset = offset - 1; offset >= 0; --offset) {
-    if (c->buf[offset].method == ANS_METHOD_RANS) {
-      rans_write(&c->ans, c->buf[offset].val_start, c->buf[offset].prob);
+  for (i = 0; i < ANS_NUM_STATES; ++i) state[i] = c->ans.state;
+  // Symbol k of the window is coded with state k % ANS_NUM_STATES.
+  for (offset = c->offset - 1; offset >= 0; --offset) {
+    const struct buffered_ans_symbol *const sym = &c->buf[offset];
+    const int s = offset % ANS_NUM_STATES;
+    if (offset >= c->offset - ANS_NUM_STATES) {
+      // Code the first symbol of each state such that it brings the state to
+      // the smallest normal state from an initial state that would have been a
+      // subnormal/refill state.
+      if (sym->method == ANS_METHOD_RANS) {
+        state[s] += sym->val_start;
+      } else {
+        state[s] += sym->val_start ? sym->prob : 0;
+      }
+      continue;
+    }
+    c->ans.state = state[s];
+    if (sym->method == ANS_METHOD_RANS) {
+      rans_write(&c->ans, sym->val_start, sym->prob);
     } else {
-      rabs_write(&c->ans, (uint8_t)c->buf[offset].val_start,
-                 (AnsP8)c->buf[offset].prob);
+      rabs_write(&c->ans, (uint8_t)sym->val_start, (AnsP8)sym->prob);
     }
+    state[s] = c->ans.state;
+  }
+  // The states are read back in order, so the first one is written last.
+  for (i = ANS_NUM_STATES - 1; i > 0; --i) {
+    c->ans.buf_offset +=
+        ans_write_state(c->ans.buf + c->ans.buf_offset, state[i]);
   }
+  c->ans.state = state[0];
   c->offset = 0;
   c->output_bytes += ans_write_end(&c->ans);
 }
@@ -9,24 +9,72 @@
  * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
  */
 
+#include <assert.h>
+#include <limits.h>
 #include <string.h>
 #include "aom_dsp/daalaboolwriter.h"
+#include "aom_mem/aom_mem.h"
 
 void aom_daala_start_encode(daala_writer *br, uint8_t *source) {
   br->buffer = source;
   br->pos = 0;
+  br->size = UINT_MAX;
+  br->pool_ec = NULL;
   od_ec_enc_init(&br->ec, 62025);
 }
 
+void aom_daala_start_encode_pooled(daala_writer *br, uint8_t *source,
+                                   daala_writer_pool *pool, int idx) {
+  assert(idx >= 0 && idx < pool->size);
+  br->buffer = source;
+  br->pos = 0;
+  br->size = UINT_MAX;
+  br->pool_ec = &pool->ec[idx];
+  br->ec = *br->pool_ec;
+  od_ec_enc_reset(&br->ec);
+}
+
 void aom_daala_stop_encode(daala_writer *br) {
   uint32_t daala_bytes;
   unsigned char *daala_data;
   daala_data = od_ec_enc_done(&br->ec, &daala_bytes);
-  memcpy(br->buffer, daala_data, daala_bytes);
-  br->pos = daala_bytes;
   /* Prevent ec bitstream from being detected as a superframe marker.
      Must always be added, so that rawbits knows the exact length of the
       bitstream. */
-  br->buffer[br->pos++] = 0;
-  od_ec_enc_clear(&br->ec);
+  if (daala_bytes < br->size) {
+    memcpy(br->buffer, daala_data, daala_bytes);
+    br->buffer[daala_bytes] = 0;
+  }
+  br->pos = daala_bytes + 1;
+  if (br->pool_ec) {
+    /* Keep the buffers, which may have grown, for the next user. */
+    *br->pool_ec = br->ec;
+  } else {
+    od_ec_enc_clear(&br->ec);
+  }
+}
+
+int aom_daala_writer_pool_alloc(daala_writer_pool *pool, int size,
+                                uint32_t buf_size) {
+  int i;
+  aom_daala_writer_pool_free(pool);
+  pool->ec = (od_ec_enc *)aom_calloc(size, sizeof(*pool->ec));
+  if (pool->ec == NULL) return -1;
+  pool->size = size;
+  for (i = 0; i < size; ++i) {
+    od_ec_enc_init(&pool->ec[i], buf_size);
+    if (pool->ec[i].error) {
+      aom_daala_writer_pool_free(pool);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+void aom_daala_writer_pool_free(daala_writer_pool *pool) {
+  int i;
+  for (i = 0; i < pool->size; ++i) od_ec_enc_clear(&pool->ec[i]);
+  aom_free(pool->ec);
+  pool->ec = NULL;
+  pool->size = 0;
 }
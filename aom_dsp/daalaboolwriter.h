@@ -27,14 +27,40 @@ extern "C" {
 struct daala_writer {
   unsigned int pos;
   uint8_t *buffer;
+  /* Bytes available in buffer. If the output does not fit, it is dropped,
+      but pos is still set to its size. */
+  unsigned int size;
   od_ec_enc ec;
+  /* The pool entry that owns the buffers of ec, or NULL if they were allocated
+      by aom_daala_start_encode() and are freed when encoding stops. */
+  od_ec_enc *pool_ec;
 };
 
 typedef struct daala_writer daala_writer;
 
+/* A set of entropy encoders whose buffers outlive a single writer.
+   A writer started from the pool resets its entry in place and hands any
+    buffer growth back to it when encoding stops, so that the buffers are
+    allocated once instead of for every tile of every frame. */
+typedef struct daala_writer_pool {
+  od_ec_enc *ec;
+  int size;
+} daala_writer_pool;
+
 void aom_daala_start_encode(daala_writer *w, uint8_t *buffer);
 void aom_daala_stop_encode(daala_writer *w);
 
+/* Allocates size entries with buf_size bytes of initial storage each, after
+    freeing any previous allocation.
+   Returns 0 on success, or -1 on an allocation failure. */
+int aom_daala_writer_pool_alloc(daala_writer_pool *pool, int size,
+                                uint32_t buf_size);
+void aom_daala_writer_pool_free(daala_writer_pool *pool);
+/* Starts w using the buffers of entry idx of the pool.
+   At most one writer may use an entry at a time. */
+void aom_daala_start_encode_pooled(daala_writer *w, uint8_t *buffer,
+                                   daala_writer_pool *pool, int idx);
+
 static INLINE void aom_daala_write(daala_writer *w, int bit, int prob) {
   int p = ((prob << 15) + (256 - prob)) >> 8;
 #if CONFIG_BITSTREAM_DEBUG
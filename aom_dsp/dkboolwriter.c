@@ -10,6 +10,7 @@
  */
 
 #include <assert.h>
+#include <limits.h>
 
 #include "./dkboolwriter.h"
 
@@ -23,6 +24,7 @@ void aom_dk_start_encode(aom_dk_writer *br, uint8_t *source) {
   br->count = -24;
   br->buffer = source;
   br->pos = 0;
+  br->size = UINT_MAX;
   aom_dk_write_bit(br, 0);
 }
 
@@ -40,5 +42,8 @@ void aom_dk_stop_encode(aom_dk_writer *br) {
 #endif  // CONFIG_BITSTREAM_DEBUG
 
   // Ensure there's no ambigous collision with any index marker bytes
-  if ((br->buffer[br->pos - 1] & 0xe0) == 0xc0) br->buffer[br->pos++] = 0;
+  if (br->pos <= br->size && (br->buffer[br->pos - 1] & 0xe0) == 0xc0) {
+    if (br->pos < br->size) br->buffer[br->pos] = 0;
+    br->pos++;
+  }
 }
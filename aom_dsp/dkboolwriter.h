@@ -32,6 +32,9 @@ typedef struct aom_dk_writer {
   int count;
   unsigned int pos;
   uint8_t *buffer;
+  // Bytes available in buffer. The bytes past them are dropped, but still
+  // counted in pos.
+  unsigned int size;
 } aom_dk_writer;
 
 void aom_dk_start_encode(aom_dk_writer *bc, uint8_t *buffer);
@@ -74,7 +77,7 @@ static INLINE void aom_dk_write(aom_dk_writer *br, int bit, int probability) {
     int offset = shift - count;
 
     if ((lowvalue << (offset - 1)) & 0x80000000) {
-      int x = br->pos - 1;
+      int x = (br->pos < br->size ? br->pos : br->size) - 1;
 
       while (x >= 0 && br->buffer[x] == 0xff) {
         br->buffer[x] = 0;
@@ -84,7 +87,8 @@ static INLINE void aom_dk_write(aom_dk_writer *br, int bit, int probability) {
       br->buffer[x] += 1;
     }
 
-    br->buffer[br->pos++] = (lowvalue >> (24 - offset));
+    if (br->pos < br->size) br->buffer[br->pos] = (lowvalue >> (24 - offset));
+    br->pos++;
     lowvalue <<= offset;
     shift = count;
     lowvalue &= 0xffffff;
@@ -107,9 +107,10 @@ static void od_ec_dec_refill(od_ec_dec *dec) {
   rng: The new value of the range.
   ret: The value to return.
   Return: ret.
-          This allows the compiler to jump to this function via a tail-call.*/
-static int od_ec_dec_normalize(od_ec_dec *dec, od_ec_window dif, unsigned rng,
-                               int ret) {
+          This is inlined into every decode function, so that the only branch
+           left on the common path is the rarely taken refill.*/
+static INLINE int od_ec_dec_normalize(od_ec_dec *dec, od_ec_window dif,
+                                      unsigned rng, int ret) {
   int d;
   OD_ASSERT(rng <= 65535U);
   d = 16 - OD_ILOG_NZ(rng);
@@ -37,6 +37,9 @@ int aom_free_frame_buffer(YV12_BUFFER_CONFIG *ybf) {
 #if CONFIG_AOM_HIGHBITDEPTH && CONFIG_GLOBAL_MOTION
     if (ybf->y_buffer_8bit) free(ybf->y_buffer_8bit);
 #endif
+#if CONFIG_GLOBAL_MOTION
+    if (ybf->corners) free(ybf->corners);
+#endif
 
     /* buffer_alloc isn't accessed by most functions.  Rather y_buffer,
       u_buffer and v_buffer point to buffer_alloc and are used.  Clear out
@@ -145,6 +148,8 @@ int aom_realloc_frame_buffer(YV12_BUFFER_CONFIG *ybf, int width, int height,
     ybf->frame_size = (size_t)frame_size;
     ybf->subsampling_x = ss_x;
     ybf->subsampling_y = ss_y;
+    ybf->x_origin = 0;
+    ybf->y_origin = 0;
 
     buf = ybf->buffer_alloc;
 #if CONFIG_AOM_HIGHBITDEPTH
@@ -173,6 +178,13 @@ int aom_realloc_frame_buffer(YV12_BUFFER_CONFIG *ybf, int width, int height,
       ybf->y_buffer_8bit = NULL;
     }
 #endif
+#if CONFIG_GLOBAL_MOTION
+    if (ybf->corners) {
+      free(ybf->corners);
+      ybf->corners = NULL;
+      ybf->num_corners = 0;
+    }
+#endif
 
     ybf->corrupted = 0; /* assume not corrupted by errors */
     return 0;
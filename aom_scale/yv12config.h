@@ -33,6 +33,15 @@ extern "C" {
 // to improve the decoder performance.
 #define AOM_BORDER_IN_PIXELS 160
 
+// Border of the frames decoded without extending their borders. It only has to
+// hold the parts of the blocks on the bottom and right edges which lie outside
+// the frame, and must be a multiple of 32.
+#if CONFIG_EXT_PARTITION
+#define AOM_DEC_BORDER_IN_PIXELS 64
+#else
+#define AOM_DEC_BORDER_IN_PIXELS 32
+#endif  // CONFIG_EXT_PARTITION
+
 typedef struct yv12_buffer_config {
   int y_width;
   int y_height;
@@ -55,11 +64,23 @@ typedef struct yv12_buffer_config {
   uint8_t *v_buffer;
   uint8_t *alpha_buffer;
 
+  // Position in the frame of the first luma sample of the planes, when the
+  // buffer only holds a window of the frame. The crop sizes are still those
+  // of the frame.
+  int x_origin;
+  int y_origin;
+
 #if CONFIG_AOM_HIGHBITDEPTH && CONFIG_GLOBAL_MOTION
   // If the frame is stored in a 16-bit buffer, this stores an 8-bit version
   // for use in global motion detection. It is allocated on-demand.
   uint8_t *y_buffer_8bit;
 #endif
+#if CONFIG_GLOBAL_MOTION
+  // FAST corners of the luma plane, stored as (x, y) pairs, for use in global
+  // motion detection. They are computed on-demand.
+  int *corners;
+  int num_corners;
+#endif
 
   uint8_t *buffer_alloc;
   size_t buffer_alloc_sz;
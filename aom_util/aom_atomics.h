@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2017, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#ifndef AOM_UTIL_AOM_ATOMICS_H_
+#define AOM_UTIL_AOM_ATOMICS_H_
+
+#include "./aom_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Sequentially consistent atomic operations on an int shared between
+// threads. Without multi-threading they are plain memory accesses.
+
+#if CONFIG_MULTITHREAD && defined(_MSC_VER)
+#include <intrin.h>  // NOLINT
+#pragma intrinsic(_InterlockedCompareExchange, _InterlockedExchange, \
+                  _InterlockedExchangeAdd)
+#define AOM_ATOMICS_MSVC
+#elif CONFIG_MULTITHREAD && defined(__ATOMIC_SEQ_CST)
+#define AOM_ATOMICS_BUILTIN
+#elif CONFIG_MULTITHREAD && defined(__GNUC__)
+#define AOM_ATOMICS_SYNC
+#elif CONFIG_MULTITHREAD
+#error "Atomic operations are not supported by this compiler."
+#endif
+
+static INLINE int aom_atomic_load(const int *ptr) {
+#if defined(AOM_ATOMICS_MSVC)
+  return _InterlockedCompareExchange((volatile long *)ptr, 0, 0);
+#elif defined(AOM_ATOMICS_BUILTIN)
+  return __atomic_load_n(ptr, __ATOMIC_SEQ_CST);
+#elif defined(AOM_ATOMICS_SYNC)
+  return __sync_fetch_and_add((int *)ptr, 0);
+#else
+  return *ptr;
+#endif
+}
+
+static INLINE void aom_atomic_store(int *ptr, int value) {
+#if defined(AOM_ATOMICS_MSVC)
+  _InterlockedExchange((volatile long *)ptr, value);
+#elif defined(AOM_ATOMICS_BUILTIN)
+  __atomic_store_n(ptr, value, __ATOMIC_SEQ_CST);
+#elif defined(AOM_ATOMICS_SYNC)
+  __sync_synchronize();
+  *(volatile int *)ptr = value;
+  __sync_synchronize();
+#else
+  *ptr = value;
+#endif
+}
+
+// Adds value to *ptr and returns the result.
+static INLINE int aom_atomic_add(int *ptr, int value) {
+#if defined(AOM_ATOMICS_MSVC)
+  return _InterlockedExchangeAdd((volatile long *)ptr, value) + value;
+#elif defined(AOM_ATOMICS_BUILTIN)
+  return __atomic_add_fetch(ptr, value, __ATOMIC_SEQ_CST);
+#elif defined(AOM_ATOMICS_SYNC)
+  return __sync_add_and_fetch(ptr, value);
+#else
+  return *ptr += value;
+#endif
+}
+
+// Sets *ptr to desired if it equals expected. Returns 1 if it did.
+static INLINE int aom_atomic_compare_exchange(int *ptr, int expected,
+                                              int desired) {
+#if defined(AOM_ATOMICS_MSVC)
+  return _InterlockedCompareExchange((volatile long *)ptr, desired,
+                                     expected) == expected;
+#elif defined(AOM_ATOMICS_BUILTIN)
+  return __atomic_compare_exchange_n(ptr, &expected, desired, 0,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#elif defined(AOM_ATOMICS_SYNC)
+  return __sync_bool_compare_and_swap(ptr, expected, desired);
+#else
+  if (*ptr != expected) return 0;
+  *ptr = desired;
+  return 1;
+#endif
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AOM_UTIL_AOM_ATOMICS_H_
@@ -27,10 +27,75 @@ struct AVxWorkerImpl {
   pthread_t thread_;
 };
 
+struct AVxThreadPool {
+  pthread_mutex_t mutex_;
+  pthread_cond_t work_cond_;  // a job was queued or the pool is shutting down
+  pthread_cond_t done_cond_;  // a job is done
+  pthread_t *threads_;
+  int num_threads_;
+  int ref_count_;
+  int shutdown_;
+  // Queue of the launched workers, linked through AVxWorker::next_.
+  AVxWorker *head_;
+  AVxWorker *tail_;
+};
+
 //------------------------------------------------------------------------------
 
 static void execute(AVxWorker *const worker);  // Forward declaration.
 
+// Runs the first queued job, if any. Must be called with the pool mutex held.
+static int run_pool_job(AVxThreadPool *const pool) {
+  AVxWorker *const worker = pool->head_;
+  if (worker == NULL) return 0;
+  pool->head_ = worker->next_;
+  if (pool->head_ == NULL) pool->tail_ = NULL;
+  pthread_mutex_unlock(&pool->mutex_);
+  execute(worker);
+  pthread_mutex_lock(&pool->mutex_);
+  worker->status_ = OK;
+  pthread_cond_broadcast(&pool->done_cond_);
+  return 1;
+}
+
+static THREADFN pool_thread_loop(void *ptr) {
+  AVxThreadPool *const pool = (AVxThreadPool *)ptr;
+  pthread_mutex_lock(&pool->mutex_);
+  while (run_pool_job(pool) || !pool->shutdown_) {
+    if (pool->head_ == NULL && !pool->shutdown_)
+      pthread_cond_wait(&pool->work_cond_, &pool->mutex_);
+  }
+  pthread_mutex_unlock(&pool->mutex_);
+  return THREAD_RETURN(NULL);
+}
+
+static void pool_launch(AVxWorker *const worker) {
+  AVxThreadPool *const pool = worker->pool;
+  pthread_mutex_lock(&pool->mutex_);
+  worker->status_ = WORK;
+  worker->next_ = NULL;
+  if (pool->tail_ != NULL)
+    pool->tail_->next_ = worker;
+  else
+    pool->head_ = worker;
+  pool->tail_ = worker;
+  pthread_cond_signal(&pool->work_cond_);
+  pthread_mutex_unlock(&pool->mutex_);
+}
+
+static void pool_sync(AVxWorker *const worker) {
+  AVxThreadPool *const pool = worker->pool;
+  pthread_mutex_lock(&pool->mutex_);
+  // Help with the queued jobs rather than wait idle. Jobs are started in
+  // launch() order, so a job only waiting on earlier launched jobs can always
+  // make progress.
+  while (worker->status_ == WORK) {
+    if (!run_pool_job(pool))
+      pthread_cond_wait(&pool->done_cond_, &pool->mutex_);
+  }
+  pthread_mutex_unlock(&pool->mutex_);
+}
+
 static THREADFN thread_loop(void *ptr) {
   AVxWorker *const worker = (AVxWorker *)ptr;
   int done = 0;
@@ -85,7 +150,10 @@ static void init(AVxWorker *const worker) {
 
 static int sync(AVxWorker *const worker) {
 #if CONFIG_MULTITHREAD
-  change_state(worker, OK);
+  if (worker->pool != NULL)
+    pool_sync(worker);
+  else
+    change_state(worker, OK);
 #endif
   assert(worker->status_ <= OK);
   return !worker->had_error;
@@ -96,6 +164,10 @@ static int reset(AVxWorker *const worker) {
   worker->had_error = 0;
   if (worker->status_ < OK) {
 #if CONFIG_MULTITHREAD
+    if (worker->pool != NULL) {
+      worker->status_ = OK;
+      return ok;
+    }
     worker->impl_ = (AVxWorkerImpl *)aom_calloc(1, sizeof(*worker->impl_));
     if (worker->impl_ == NULL) {
       return 0;
@@ -137,7 +209,10 @@ static void execute(AVxWorker *const worker) {
 
 static void launch(AVxWorker *const worker) {
 #if CONFIG_MULTITHREAD
-  change_state(worker, WORK);
+  if (worker->pool != NULL)
+    pool_launch(worker);
+  else
+    change_state(worker, WORK);
 #else
   execute(worker);
 #endif
@@ -145,7 +220,10 @@ static void launch(AVxWorker *const worker) {
 
 static void end(AVxWorker *const worker) {
 #if CONFIG_MULTITHREAD
-  if (worker->impl_ != NULL) {
+  if (worker->pool != NULL) {
+    pool_sync(worker);
+    worker->status_ = NOT_OK;
+  } else if (worker->impl_ != NULL) {
     change_state(worker, NOT_OK);
     pthread_join(worker->impl_->thread_, NULL);
     pthread_mutex_destroy(&worker->impl_->mutex_);
@@ -181,3 +259,98 @@ const AVxWorkerInterface *aom_get_worker_interface(void) {
 }
 
 //------------------------------------------------------------------------------
+
+AVxThreadPool *aom_thread_pool_create(int num_threads) {
+#if CONFIG_MULTITHREAD
+  AVxThreadPool *pool;
+  int i;
+
+  if (num_threads <= 0) return NULL;
+  pool = (AVxThreadPool *)aom_calloc(1, sizeof(*pool));
+  if (pool == NULL) return NULL;
+  pool->threads_ =
+      (pthread_t *)aom_calloc(num_threads, sizeof(*pool->threads_));
+  if (pool->threads_ == NULL) goto Error;
+  if (pthread_mutex_init(&pool->mutex_, NULL)) goto Error;
+  if (pthread_cond_init(&pool->work_cond_, NULL)) {
+    pthread_mutex_destroy(&pool->mutex_);
+    goto Error;
+  }
+  if (pthread_cond_init(&pool->done_cond_, NULL)) {
+    pthread_cond_destroy(&pool->work_cond_);
+    pthread_mutex_destroy(&pool->mutex_);
+    goto Error;
+  }
+  pool->ref_count_ = 1;
+
+  // The callers size their work split on num_threads, so a pool short of
+  // threads is not returned. Releasing it joins the threads already started.
+  for (i = 0; i < num_threads; ++i) {
+    if (pthread_create(&pool->threads_[i], NULL, pool_thread_loop, pool))
+      break;
+    ++pool->num_threads_;
+  }
+  if (pool->num_threads_ != num_threads) {
+    aom_thread_pool_release(pool);
+    return NULL;
+  }
+  return pool;
+
+Error:
+  aom_free(pool->threads_);
+  aom_free(pool);
+  return NULL;
+#else
+  (void)num_threads;
+  return NULL;
+#endif  // CONFIG_MULTITHREAD
+}
+
+int aom_thread_pool_num_threads(const AVxThreadPool *pool) {
+#if CONFIG_MULTITHREAD
+  return pool != NULL ? pool->num_threads_ : 0;
+#else
+  (void)pool;
+  return 0;
+#endif  // CONFIG_MULTITHREAD
+}
+
+void aom_thread_pool_retain(AVxThreadPool *pool) {
+#if CONFIG_MULTITHREAD
+  if (pool == NULL) return;
+  pthread_mutex_lock(&pool->mutex_);
+  ++pool->ref_count_;
+  pthread_mutex_unlock(&pool->mutex_);
+#else
+  (void)pool;
+#endif  // CONFIG_MULTITHREAD
+}
+
+void aom_thread_pool_release(AVxThreadPool *pool) {
+#if CONFIG_MULTITHREAD
+  int i;
+
+  if (pool == NULL) return;
+  pthread_mutex_lock(&pool->mutex_);
+  if (--pool->ref_count_ > 0) {
+    pthread_mutex_unlock(&pool->mutex_);
+    return;
+  }
+  assert(pool->head_ == NULL);
+  pool->shutdown_ = 1;
+  pthread_cond_broadcast(&pool->work_cond_);
+  pthread_mutex_unlock(&pool->mutex_);
+
+  for (i = 0; i < pool->num_threads_; ++i)
+    pthread_join(pool->threads_[i], NULL);
+  pthread_cond_destroy(&pool->done_cond_);
+  pthread_cond_destroy(&pool->work_cond_);
+  pthread_mutex_destroy(&pool->mutex_);
+  aom_free(pool->threads_);
+  aom_free(pool);
+#else
+  (void)pool;
+#endif  // CONFIG_MULTITHREAD
+}
+
+//------------------------------------------------------------------------------
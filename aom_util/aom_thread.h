@@ -23,9 +23,10 @@
 extern "C" {
 #endif
 
-// Set maximum decode threads to be 8 due to the limit of frame buffers
-// and not enough semaphores in the emulation layer on windows.
-#define MAX_DECODE_THREADS 8
+// Maximum number of frame parallel decode threads. Each of them holds a frame
+// buffer besides the reference frames, see FRAME_BUFFERS. The condition
+// variable emulation on windows also creates its semaphores with this count.
+#define MAX_DECODE_THREADS 32
 
 #if CONFIG_MULTITHREAD
 
@@ -173,6 +174,21 @@ static INLINE int pthread_cond_signal(pthread_cond_t *const condition) {
   return !ok;
 }
 
+static INLINE int pthread_cond_broadcast(pthread_cond_t *const condition) {
+  int ok = 1;
+#ifdef USE_WINDOWS_CONDITION_VARIABLE
+  WakeAllConditionVariable(condition);
+#else
+  while (ok && WaitForSingleObject(condition->waiting_sem_, 0) ==
+                   WAIT_OBJECT_0) {
+    ok = SetEvent(condition->signal_event_);
+    ok &= (WaitForSingleObject(condition->received_sem_, INFINITE) ==
+           WAIT_OBJECT_0);
+  }
+#endif
+  return !ok;
+}
+
 static INLINE int pthread_cond_wait(pthread_cond_t *const condition,
                                     pthread_mutex_t *const mutex) {
   int ok;
@@ -358,14 +374,21 @@ typedef int (*AVxWorkerHook)(void *, void *);
 // Platform-dependent implementation details for the worker.
 typedef struct AVxWorkerImpl AVxWorkerImpl;
 
+// Threads shared by all the workers of a codec instance.
+typedef struct AVxThreadPool AVxThreadPool;
+
 // Synchronization object used to launch job in the worker thread
-typedef struct {
+typedef struct AVxWorker {
   AVxWorkerImpl *impl_;
   AVxWorkerStatus status_;
   AVxWorkerHook hook;  // hook to call
   void *data1;         // first argument passed to 'hook'
   void *data2;         // second argument passed to 'hook'
   int had_error;       // return value of the last call to 'hook'
+  // When set before reset(), the worker does not own a thread. launch()
+  // queues the hook on this pool instead.
+  AVxThreadPool *pool;
+  struct AVxWorker *next_;  // next worker in the job queue of 'pool'
 } AVxWorker;
 
 // The interface for all thread-worker related functions. All these functions
@@ -403,6 +426,23 @@ int aom_set_worker_interface(const AVxWorkerInterface *const winterface);
 // Retrieve the currently set thread worker interface.
 const AVxWorkerInterface *aom_get_worker_interface(void);
 
+// Creates a pool of 'num_threads' threads. The jobs of the workers attached
+// to the pool run in launch() order. A thread waiting in sync() runs queued
+// jobs until its own worker is done, so the launching thread is not idle.
+// Returns NULL in case of error, including when not all of the threads could
+// be started, or when built without CONFIG_MULTITHREAD.
+AVxThreadPool *aom_thread_pool_create(int num_threads);
+
+// Number of threads owned by the pool.
+int aom_thread_pool_num_threads(const AVxThreadPool *pool);
+
+// Takes a reference to the pool.
+void aom_thread_pool_retain(AVxThreadPool *pool);
+
+// Drops a reference to the pool. The last reference stops the threads and
+// frees the pool; the workers attached to it must have been ended first.
+void aom_thread_pool_release(AVxThreadPool *pool);
+
 //------------------------------------------------------------------------------
 
 #ifdef __cplusplus
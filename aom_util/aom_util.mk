@@ -11,6 +11,7 @@
 
 
 UTIL_SRCS-yes += aom_util.mk
+UTIL_SRCS-yes += aom_atomics.h
 UTIL_SRCS-yes += aom_thread.c
 UTIL_SRCS-yes += aom_thread.h
 UTIL_SRCS-$(CONFIG_BITSTREAM_DEBUG) += debug_util.c
@@ -85,6 +85,15 @@ static const arg_def_t threadsarg =
     ARG_DEF("t", "threads", 1, "Max threads to use");
 static const arg_def_t frameparallelarg =
     ARG_DEF(NULL, "frame-parallel", 0, "Frame parallel decode");
+static const arg_def_t rowmtarg =
+    ARG_DEF(NULL, "row-mt", 0,
+            "Pipeline the superblock rows of a tile and the deblocking");
+static const arg_def_t minborderarg =
+    ARG_DEF(NULL, "min-border", 0,
+            "Emulate the edges of reference frames allocated without border");
+static const arg_def_t lowmemarg =
+    ARG_DEF(NULL, "low-memory", 0,
+            "Free the buffers not needed by the next frame after each frame");
 static const arg_def_t verbosearg =
     ARG_DEF("v", "verbose", 0, "Show version string");
 static const arg_def_t error_concealment =
@@ -110,6 +119,10 @@ static const arg_def_t tiler = ARG_DEF(NULL, "tile-row", 1,
 static const arg_def_t tilec = ARG_DEF(NULL, "tile-column", 1,
                                        "Column index of tile to decode "
                                        "(-1 for all columns)");
+static const arg_def_t tilerect =
+    ARG_DEF(NULL, "tile-rect", 1,
+            "Rectangle of tiles to decode from the next key frame, as "
+            "<col>,<row>,<cols>,<rows>");
 #endif  // CONFIG_EXT_TILE
 
 static const arg_def_t *all_args[] = { &codecarg,
@@ -126,6 +139,9 @@ static const arg_def_t *all_args[] = { &codecarg,
                                        &outputfile,
                                        &threadsarg,
                                        &frameparallelarg,
+                                       &rowmtarg,
+                                       &minborderarg,
+                                       &lowmemarg,
                                        &verbosearg,
                                        &scalearg,
                                        &fb_arg,
@@ -139,6 +155,7 @@ static const arg_def_t *all_args[] = { &codecarg,
 #if CONFIG_EXT_TILE
                                        &tiler,
                                        &tilec,
+                                       &tilerect,
 #endif  // CONFIG_EXT_TILE
                                        NULL };
 
@@ -506,7 +523,8 @@ static int main_loop(int argc, const char **argv_) {
   size_t bytes_in_buffer = 0, buffer_size = 0;
   FILE *infile;
   int frame_in = 0, frame_out = 0, flipuv = 0, noblit = 0;
-  int do_md5 = 0, progress = 0, frame_parallel = 0;
+  int do_md5 = 0, progress = 0, frame_parallel = 0, row_mt = 0;
+  int min_border = 0, low_memory = 0;
   int stop_after = 0, postproc = 0, summary = 0, quiet = 1;
   int arg_skip = 0;
   int ec_enabled = 0;
@@ -528,6 +546,7 @@ static int main_loop(int argc, const char **argv_) {
 #if CONFIG_EXT_TILE
   int tile_row = -1;
   int tile_col = -1;
+  aom_image_rect_t tile_rect = { 0, 0, 0, 0 };
 #endif  // CONFIG_EXT_TILE
   int frames_corrupted = 0;
   int dec_flags = 0;
@@ -612,6 +631,12 @@ static int main_loop(int argc, const char **argv_) {
 #if CONFIG_AV1_DECODER
     else if (arg_match(&arg, &frameparallelarg, argi))
       frame_parallel = 1;
+    else if (arg_match(&arg, &rowmtarg, argi))
+      row_mt = 1;
+    else if (arg_match(&arg, &minborderarg, argi))
+      min_border = 1;
+    else if (arg_match(&arg, &lowmemarg, argi))
+      low_memory = 1;
 #endif
     else if (arg_match(&arg, &verbosearg, argi))
       quiet = 0;
@@ -631,6 +656,11 @@ static int main_loop(int argc, const char **argv_) {
       tile_row = arg_parse_int(&arg);
     else if (arg_match(&arg, &tilec, argi))
       tile_col = arg_parse_int(&arg);
+    else if (arg_match(&arg, &tilerect, argi)) {
+      if (sscanf(arg.val, "%u,%u,%u,%u", &tile_rect.x, &tile_rect.y,
+                 &tile_rect.w, &tile_rect.h) != 4)
+        die("Error: Unrecognized argument (%s) to --tile-rect\n", arg.val);
+    }
 #endif  // CONFIG_EXT_TILE
     else
       argj++;
@@ -732,6 +762,23 @@ static int main_loop(int argc, const char **argv_) {
 
   if (!quiet) fprintf(stderr, "%s\n", decoder.name);
 
+#if CONFIG_AV1_DECODER
+  if (aom_codec_control(&decoder, AV1D_SET_ROW_MT, row_mt)) {
+    fprintf(stderr, "Failed to set row_mt: %s\n", aom_codec_error(&decoder));
+    goto fail;
+  }
+  if (aom_codec_control(&decoder, AV1D_SET_MIN_BORDER, min_border)) {
+    fprintf(stderr, "Failed to set min_border: %s\n",
+            aom_codec_error(&decoder));
+    goto fail;
+  }
+  if (aom_codec_control(&decoder, AV1D_SET_LOW_MEMORY, low_memory)) {
+    fprintf(stderr, "Failed to set low_memory: %s\n",
+            aom_codec_error(&decoder));
+    goto fail;
+  }
+#endif
+
 #if CONFIG_AV1_DECODER && CONFIG_EXT_TILE
   if (aom_codec_control(&decoder, AV1_SET_DECODE_TILE_ROW, tile_row)) {
     fprintf(stderr, "Failed to set decode_tile_row: %s\n",
@@ -744,6 +791,13 @@ static int main_loop(int argc, const char **argv_) {
             aom_codec_error(&decoder));
     goto fail;
   }
+
+  if (tile_rect.w > 0 && tile_rect.h > 0 &&
+      aom_codec_control(&decoder, AV1_SET_DECODE_TILE_RECT, &tile_rect)) {
+    fprintf(stderr, "Failed to set decode_tile_rect: %s\n",
+            aom_codec_error(&decoder));
+    goto fail;
+  }
 #endif
 
   if (arg_skip) fprintf(stderr, "Skipping first %d frames.\n", arg_skip);
@@ -998,6 +1052,15 @@ static int main_loop(int argc, const char **argv_) {
     show_progress(frame_in, frame_out, dx_time);
     fprintf(stderr, "\n");
   }
+#if CONFIG_AV1_DECODER
+  if (summary) {
+    aom_dec_mem_usage_t mem_usage;
+    if (!aom_codec_control(&decoder, AV1D_GET_MEMORY_USAGE, &mem_usage))
+      fprintf(stderr, "Memory: %" PRIu64 " bytes, peak %" PRIu64 " bytes\n",
+              (uint64_t)mem_usage.current_bytes,
+              (uint64_t)mem_usage.peak_bytes);
+  }
+#endif
 
   if (frames_corrupted) {
     fprintf(stderr, "WARNING: %d frames corrupted.\n", frames_corrupted);
@@ -384,6 +384,13 @@ static const arg_def_t tile_dependent_rows =
 static const arg_def_t tile_loopfilter = ARG_DEF(
     NULL, "tile-loopfilter", 1, "Enable loop filter across tile boundary");
 #endif  // CONFIG_LOOPFILTERING_ACROSS_TILES
+static const arg_def_t row_mt =
+    ARG_DEF(NULL, "row-mt", 1,
+            "Enable row based multi-threading (0: off (default), 1: on)");
+static const arg_def_t kf_chunk_parallel =
+    ARG_DEF(NULL, "kf-chunk-parallel", 1,
+            "Encode key frame chunks of the last pass in parallel "
+            "(0: off (default), 1: on)");
 static const arg_def_t lossless =
     ARG_DEF(NULL, "lossless", 1, "Lossless mode (0: false (default), 1: true)");
 #if CONFIG_AOM_QM
@@ -517,6 +524,8 @@ static const arg_def_t *av1_args[] = { &cpu_used_av1,
 #if CONFIG_TEMPMV_SIGNALING
                                        &disable_tempmv,
 #endif
+                                       &row_mt,
+                                       &kf_chunk_parallel,
 #if CONFIG_AOM_HIGHBITDEPTH
                                        &bitdeptharg,
                                        &inbitdeptharg,
@@ -565,6 +574,8 @@ static const int av1_arg_ctrl_map[] = { AOME_SET_CPUUSED,
 #if CONFIG_TEMPMV_SIGNALING
                                         AV1E_SET_DISABLE_TEMPMV,
 #endif
+                                        AV1E_SET_ROW_MT,
+                                        AV1E_SET_KF_CHUNK_PARALLEL,
                                         0 };
 #endif
 
@@ -205,7 +205,8 @@ if (CONFIG_AOM_HIGHBITDEPTH)
   set(AOM_AV1_ENCODER_SSE4_1_INTRIN
       ${AOM_AV1_ENCODER_SSE4_1_INTRIN}
       "${AOM_ROOT}/av1/encoder/x86/av1_highbd_quantize_sse4.c"
-      "${AOM_ROOT}/av1/encoder/x86/highbd_fwd_txfm_sse4.c")
+      "${AOM_ROOT}/av1/encoder/x86/highbd_fwd_txfm_sse4.c"
+      "${AOM_ROOT}/av1/encoder/x86/highbd_temporal_filter_sse4.c")
 endif ()
 
 if (CONFIG_CDEF)
@@ -224,7 +225,8 @@ if (CONFIG_CDEF)
       ${AOM_AV1_ENCODER_SOURCES}
       "${AOM_ROOT}/av1/encoder/clpf_rdo.c"
       "${AOM_ROOT}/av1/encoder/clpf_rdo.h"
-      "${AOM_ROOT}/av1/encoder/pickdering.c")
+      "${AOM_ROOT}/av1/encoder/pickdering.c"
+      "${AOM_ROOT}/av1/encoder/pickdering.h")
 
   set(AOM_AV1_COMMON_SSE2_INTRIN
       ${AOM_AV1_COMMON_SSE2_INTRIN}
@@ -75,6 +75,8 @@ struct av1_extracfg {
 #if CONFIG_ANS && ANS_MAX_SYMBOLS
   int ans_window_size_log2;
 #endif
+  unsigned int row_mt;
+  unsigned int kf_chunk_parallel;
 };
 
 static struct av1_extracfg default_extra_cfg = {
@@ -134,8 +136,59 @@ static struct av1_extracfg default_extra_cfg = {
 #if CONFIG_ANS && ANS_MAX_SYMBOLS
   23,  // ans_window_size_log2
 #endif
+  0,  // row_mt
+  0,  // kf_chunk_parallel
 };
 
+// A source frame of a key frame chunk.
+typedef struct {
+  aom_image_t *img;
+  aom_enc_frame_flags_t flags;
+  int64_t time_stamp;
+  int64_t end_time_stamp;
+} ChunkSource;
+
+// A compressed frame of a key frame chunk, stored at 'offset' in its data.
+typedef struct {
+  size_t offset;
+  size_t size;
+  int64_t time_stamp;
+  int64_t end_time_stamp;
+  aom_codec_frame_flags_t flags;
+  int show_frame;
+  // PSNR packet of the frame, returned before the frame when has_psnr is set.
+  int has_psnr;
+  aom_codec_cx_pkt_t psnr_pkt;
+} ChunkFrame;
+
+// The source frames from one forced key frame up to the next, encoded by a
+// compressor of their own when kf_chunk_parallel is enabled.
+typedef struct EncodeChunk {
+  AV1EncoderConfig oxcf;
+  int calculate_psnr;
+  // Index of the first frame of the chunk in the first pass stats.
+  int first_frame;
+  ChunkSource *sources;
+  int num_sources;
+  int sources_alloc;
+  // Space left free in 'data' before each call to av1_get_compressed_data().
+  size_t max_frame_sz;
+  unsigned char *data;
+  size_t data_sz;
+  size_t data_alloc;
+  ChunkFrame *frames;
+  int num_frames;
+  int frames_alloc;
+  // First frame not yet returned to the application.
+  int next_frame;
+  int launched;
+  int done;
+  aom_codec_err_t err;
+  const char *err_detail;
+  AVxWorker worker;
+  struct EncodeChunk *next;
+} EncodeChunk;
+
 struct aom_codec_alg_priv {
   aom_codec_priv_t base;
   aom_codec_enc_cfg_t cfg;
@@ -155,6 +208,13 @@ struct aom_codec_alg_priv {
   unsigned int fixed_kf_cntr;
   // BufferPool that holds all reference frames.
   BufferPool *buffer_pool;
+  // Key frame chunks in output order. The last one collects source frames
+  // until the next forced key frame, the others are encoding or waiting to
+  // return their frames.
+  EncodeChunk *chunk_head;
+  EncodeChunk *chunk_tail;
+  int chunk_frame_count;
+  AVxThreadPool *chunk_pool;
 };
 
 static aom_codec_err_t update_error_state(
@@ -334,6 +394,12 @@ static aom_codec_err_t validate_config(aom_codec_alg_priv_t *ctx,
 #if CONFIG_ANS && ANS_MAX_SYMBOLS
   RANGE_CHECK(extra_cfg, ans_window_size_log2, 8, 23);
 #endif
+  RANGE_CHECK_HI(extra_cfg, row_mt, 1);
+  RANGE_CHECK_HI(extra_cfg, kf_chunk_parallel, 1);
+  if (extra_cfg->kf_chunk_parallel &&
+      (cfg->kf_mode != AOM_KF_AUTO || cfg->kf_max_dist == 0)) {
+    ERROR("kf_chunk_parallel requires automatic key frames with kf_max_dist");
+  }
   return AOM_CODEC_OK;
 }
 
@@ -530,6 +596,7 @@ static aom_codec_err_t set_encoder_config(
 #endif  // CONFIG_LOOPFILTERING_ACROSS_TILES
   oxcf->error_resilient_mode = cfg->g_error_resilient;
   oxcf->frame_parallel_decoding_mode = extra_cfg->frame_parallel_decoding_mode;
+  oxcf->row_mt = extra_cfg->row_mt;
 
   oxcf->aq_mode = extra_cfg->aq_mode;
 
@@ -846,6 +913,34 @@ static aom_codec_err_t ctrl_set_frame_periodic_boost(aom_codec_alg_priv_t *ctx,
   return update_extra_cfg(ctx, &extra_cfg);
 }
 
+static void free_chunk_sources(EncodeChunk *chunk) {
+  int i;
+  for (i = 0; i < chunk->num_sources; ++i) aom_img_free(chunk->sources[i].img);
+  free(chunk->sources);
+  chunk->sources = NULL;
+  chunk->num_sources = 0;
+  chunk->sources_alloc = 0;
+}
+
+// Waits for a launched chunk to finish encoding.
+static void sync_kf_chunk(EncodeChunk *chunk) {
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  assert(chunk->launched);
+  if (!chunk->done) {
+    winterface->sync(&chunk->worker);
+    winterface->end(&chunk->worker);
+    chunk->done = 1;
+  }
+}
+
+static void free_kf_chunk(EncodeChunk *chunk) {
+  if (chunk->launched) sync_kf_chunk(chunk);
+  free_chunk_sources(chunk);
+  free(chunk->data);
+  free(chunk->frames);
+  aom_free(chunk);
+}
+
 static aom_codec_err_t encoder_init(aom_codec_ctx_t *ctx,
                                     aom_codec_priv_enc_mr_cfg_t *data) {
   aom_codec_err_t res = AOM_CODEC_OK;
@@ -896,6 +991,12 @@ static aom_codec_err_t encoder_init(aom_codec_ctx_t *ctx,
 }
 
 static aom_codec_err_t encoder_destroy(aom_codec_alg_priv_t *ctx) {
+  while (ctx->chunk_head != NULL) {
+    EncodeChunk *const chunk = ctx->chunk_head;
+    ctx->chunk_head = chunk->next;
+    free_kf_chunk(chunk);
+  }
+  aom_thread_pool_release(ctx->chunk_pool);
   free(ctx->cx_data);
   av1_remove_compressor(ctx->cpi);
 #if CONFIG_MULTITHREAD
@@ -1020,6 +1121,351 @@ static aom_codec_frame_flags_t get_frame_pkt_flags(const AV1_COMP *cpi,
   return flags;
 }
 
+// Adds a compressed frame at cx_data to the list of returned packets. Invisible
+// frames are held back and packed with the next visible frame. Returns the
+// number of bytes of cx_data used.
+static size_t add_frame_packet(aom_codec_alg_priv_t *ctx,
+                               unsigned char *cx_data, size_t size,
+                               int show_frame, aom_codec_frame_flags_t flags,
+                               int64_t dst_time_stamp,
+                               int64_t dst_end_time_stamp) {
+  const aom_rational_t *const timebase = &ctx->cfg.g_timebase;
+  aom_codec_cx_pkt_t pkt;
+
+  // Pack invisible frames with the next visible frame
+  if (!show_frame) {
+    if (ctx->pending_cx_data == 0) ctx->pending_cx_data = cx_data;
+    ctx->pending_cx_data_sz += size;
+    ctx->pending_frame_sizes[ctx->pending_frame_count++] = size;
+    return size;
+  }
+
+  // Add the frame packet to the list of returned packets.
+  pkt.kind = AOM_CODEC_CX_FRAME_PKT;
+  pkt.data.frame.pts = ticks_to_timebase_units(timebase, dst_time_stamp);
+  pkt.data.frame.duration = (unsigned long)ticks_to_timebase_units(
+      timebase, dst_end_time_stamp - dst_time_stamp);
+  pkt.data.frame.flags = flags;
+
+  if (ctx->pending_cx_data) {
+    ctx->pending_frame_sizes[ctx->pending_frame_count++] = size;
+    ctx->pending_cx_data_sz += size;
+    size += write_superframe_index(ctx);
+    pkt.data.frame.buf = ctx->pending_cx_data;
+    pkt.data.frame.sz = ctx->pending_cx_data_sz;
+    ctx->pending_cx_data = NULL;
+    ctx->pending_cx_data_sz = 0;
+    ctx->pending_frame_count = 0;
+  } else {
+    pkt.data.frame.buf = cx_data;
+    pkt.data.frame.sz = size;
+  }
+  pkt.data.frame.partition_id = -1;
+
+  aom_codec_pkt_list_add(&ctx->pkt_list.head, &pkt);
+  return size;
+}
+
+static aom_image_t *copy_image(const aom_image_t *img) {
+  aom_image_t *const copy =
+      aom_img_alloc(NULL, img->fmt, img->d_w, img->d_h, 32);
+  const int bytes = (img->fmt & AOM_IMG_FMT_HIGHBITDEPTH) ? 2 : 1;
+  int plane, r;
+
+  if (copy == NULL) return NULL;
+  copy->bit_depth = img->bit_depth;
+  copy->cs = img->cs;
+  copy->range = img->range;
+  copy->r_w = img->r_w;
+  copy->r_h = img->r_h;
+  for (plane = 0; plane < 3; ++plane) {
+    const int ss_x = plane ? img->x_chroma_shift : 0;
+    const int ss_y = plane ? img->y_chroma_shift : 0;
+    const int w = ((img->d_w + ss_x) >> ss_x) * bytes;
+    const int h = (img->d_h + ss_y) >> ss_y;
+    for (r = 0; r < h; ++r) {
+      memcpy(copy->planes[plane] + r * copy->stride[plane],
+             img->planes[plane] + r * img->stride[plane], w);
+    }
+  }
+  return copy;
+}
+
+static aom_codec_err_t add_chunk_frame(
+    EncodeChunk *chunk, AV1_COMP *cpi, unsigned int lib_flags, size_t size,
+    int64_t time_stamp, int64_t end_time_stamp,
+    const struct aom_codec_pkt_list *pkt_list) {
+  const aom_codec_cx_pkt_t *pkt;
+  aom_codec_iter_t iter = NULL;
+  ChunkFrame *frame;
+
+  if (chunk->num_frames == chunk->frames_alloc) {
+    const int frames_alloc = AOMMAX(2 * chunk->frames_alloc, 16);
+    ChunkFrame *const frames = (ChunkFrame *)realloc(
+        chunk->frames, frames_alloc * sizeof(*frames));
+    if (frames == NULL) return AOM_CODEC_MEM_ERROR;
+    chunk->frames = frames;
+    chunk->frames_alloc = frames_alloc;
+  }
+  frame = &chunk->frames[chunk->num_frames++];
+  frame->offset = chunk->data_sz;
+  frame->size = size;
+  frame->time_stamp = time_stamp;
+  frame->end_time_stamp = end_time_stamp;
+  frame->flags = get_frame_pkt_flags(cpi, lib_flags);
+  frame->show_frame = cpi->common.show_frame;
+  frame->has_psnr = 0;
+  while ((pkt = aom_codec_pkt_list_get(pkt_list, &iter)) != NULL) {
+    if (pkt->kind == AOM_CODEC_PSNR_PKT) {
+      frame->psnr_pkt = *pkt;
+      frame->has_psnr = 1;
+    }
+  }
+  chunk->data_sz += size;
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t encode_kf_chunk(EncodeChunk *chunk, AV1_COMP *cpi) {
+  // Collects the PSNR packets of each call to av1_get_compressed_data().
+  aom_codec_pkt_list_decl(4) pkt_list;
+  int i;
+
+  if (setjmp(cpi->common.error.jmp)) {
+    cpi->common.error.setjmp = 0;
+    aom_clear_system_state();
+    return cpi->common.error.error_code;
+  }
+  cpi->common.error.setjmp = 1;
+
+  cpi->output_pkt_list = &pkt_list.head;
+  if (chunk->calculate_psnr) cpi->b_calculate_psnr = 1;
+  av1_twopass_restrict_to_chunk(cpi, chunk->first_frame,
+                                chunk->first_frame + chunk->num_sources);
+
+  for (i = 0; i <= chunk->num_sources; ++i) {
+    const int flush = i == chunk->num_sources;
+    unsigned int lib_flags = 0;
+    int64_t time_stamp, end_time_stamp;
+    size_t size;
+
+    if (!flush) {
+      const ChunkSource *const src = &chunk->sources[i];
+      YV12_BUFFER_CONFIG sd;
+      av1_apply_encoding_flags(cpi, src->flags);
+      image2yuvconfig(src->img, &sd);
+      if (av1_receive_raw_frame(cpi, src->flags, &sd, src->time_stamp,
+                                src->end_time_stamp)) {
+        cpi->common.error.setjmp = 0;
+        return AOM_CODEC_ERROR;
+      }
+    }
+
+    for (;;) {
+      aom_codec_err_t res;
+      if (chunk->data_alloc - chunk->data_sz < chunk->max_frame_sz) {
+        const size_t data_alloc = 2 * chunk->data_alloc + chunk->max_frame_sz;
+        unsigned char *const data =
+            (unsigned char *)realloc(chunk->data, data_alloc);
+        if (data == NULL) {
+          cpi->common.error.setjmp = 0;
+          return AOM_CODEC_MEM_ERROR;
+        }
+        chunk->data = data;
+        chunk->data_alloc = data_alloc;
+      }
+      aom_codec_pkt_list_init(&pkt_list);
+      if (av1_get_compressed_data(cpi, &lib_flags, &size,
+                                  chunk->data + chunk->data_sz, &time_stamp,
+                                  &end_time_stamp, flush) == -1)
+        break;
+#if CONFIG_REFERENCE_BUFFER
+      if (cpi->common.invalid_delta_frame_id_minus1) {
+        chunk->err_detail = "Invalid delta_frame_id_minus1";
+        cpi->common.error.setjmp = 0;
+        return AOM_CODEC_ERROR;
+      }
+#endif  // CONFIG_REFERENCE_BUFFER
+      if (size == 0) continue;
+      res = add_chunk_frame(chunk, cpi, lib_flags, size, time_stamp,
+                            end_time_stamp, &pkt_list.head);
+      if (res != AOM_CODEC_OK) {
+        cpi->common.error.setjmp = 0;
+        return res;
+      }
+    }
+  }
+
+  cpi->common.error.setjmp = 0;
+  return AOM_CODEC_OK;
+}
+
+static int encode_kf_chunk_worker_hook(EncodeChunk *const chunk,
+                                       void *unused) {
+  BufferPool *const pool = (BufferPool *)aom_calloc(1, sizeof(*pool));
+  AV1_COMP *cpi;
+  (void)unused;
+
+  chunk->err = AOM_CODEC_MEM_ERROR;
+  if (pool != NULL) {
+#if CONFIG_MULTITHREAD
+    if (pthread_mutex_init(&pool->pool_mutex, NULL)) {
+      aom_free(pool);
+      free_chunk_sources(chunk);
+      return 0;
+    }
+#endif
+    cpi = av1_create_compressor(&chunk->oxcf, pool);
+    if (cpi != NULL) {
+      chunk->err = encode_kf_chunk(chunk, cpi);
+      av1_remove_compressor(cpi);
+    }
+#if CONFIG_MULTITHREAD
+    pthread_mutex_destroy(&pool->pool_mutex);
+#endif
+    aom_free(pool);
+  }
+  free_chunk_sources(chunk);
+  return chunk->err == AOM_CODEC_OK;
+}
+
+// Hands a chunk that got all its source frames to the thread pool. Its frames
+// are returned by output_kf_chunks() once it has been synced.
+static void launch_kf_chunk(aom_codec_alg_priv_t *ctx, EncodeChunk *chunk) {
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  AVxWorker *const worker = &chunk->worker;
+
+  chunk->oxcf = ctx->oxcf;
+  chunk->oxcf.max_threads = 1;
+  chunk->calculate_psnr = !!(ctx->base.init_flags & AOM_CODEC_USE_PSNR);
+  chunk->max_frame_sz = ctx->cx_data_sz / 2;
+  chunk->launched = 1;
+  if (ctx->chunk_pool == NULL && ctx->cfg.g_threads > 1)
+    ctx->chunk_pool = aom_thread_pool_create(ctx->cfg.g_threads);
+
+  winterface->init(worker);
+  worker->pool = ctx->chunk_pool;
+  worker->hook = (AVxWorkerHook)encode_kf_chunk_worker_hook;
+  worker->data1 = chunk;
+  worker->data2 = NULL;
+  if (worker->pool != NULL && winterface->reset(worker)) {
+    winterface->launch(worker);
+  } else {
+    winterface->execute(worker);
+    chunk->done = 1;
+  }
+}
+
+static aom_codec_err_t add_chunk_source(aom_codec_alg_priv_t *ctx,
+                                        const aom_image_t *img,
+                                        aom_enc_frame_flags_t flags,
+                                        int64_t time_stamp,
+                                        int64_t end_time_stamp) {
+  const int num_stats =
+      (int)(ctx->cfg.rc_twopass_stats_in.sz / sizeof(FIRSTPASS_STATS)) - 1;
+  EncodeChunk *chunk = ctx->chunk_tail;
+  ChunkSource *src;
+
+  if (ctx->chunk_frame_count >= num_stats) {
+    ctx->base.err_detail = "More frames than in the first pass stats";
+    return AOM_CODEC_INVALID_PARAM;
+  }
+
+  // Cut at forced key frames and after at most kf_max_dist frames, so that
+  // no more than that many source copies are held per chunk.
+  if (chunk != NULL && !chunk->launched &&
+      ((flags & AOM_EFLAG_FORCE_KF) ||
+       chunk->num_sources >= (int)ctx->cfg.kf_max_dist)) {
+    launch_kf_chunk(ctx, chunk);
+  }
+  if (chunk == NULL || chunk->launched) {
+    chunk = (EncodeChunk *)aom_calloc(1, sizeof(*chunk));
+    if (chunk == NULL) return AOM_CODEC_MEM_ERROR;
+    chunk->first_frame = ctx->chunk_frame_count;
+    if (ctx->chunk_tail != NULL)
+      ctx->chunk_tail->next = chunk;
+    else
+      ctx->chunk_head = chunk;
+    ctx->chunk_tail = chunk;
+  }
+
+  if (chunk->num_sources == chunk->sources_alloc) {
+    const int sources_alloc = AOMMAX(2 * chunk->sources_alloc, 16);
+    ChunkSource *const sources = (ChunkSource *)realloc(
+        chunk->sources, sources_alloc * sizeof(*sources));
+    if (sources == NULL) return AOM_CODEC_MEM_ERROR;
+    chunk->sources = sources;
+    chunk->sources_alloc = sources_alloc;
+  }
+  src = &chunk->sources[chunk->num_sources];
+  src->img = copy_image(img);
+  if (src->img == NULL) return AOM_CODEC_MEM_ERROR;
+  src->flags = flags;
+  src->time_stamp = time_stamp;
+  src->end_time_stamp = end_time_stamp;
+  ++chunk->num_sources;
+  ++ctx->chunk_frame_count;
+  return AOM_CODEC_OK;
+}
+
+// Returns the frames of the encoded chunks in order, as far as the packet list
+// and cx_data have room for them. At most g_threads chunks are left encoding
+// in the background, none when flushing.
+static aom_codec_err_t output_kf_chunks(aom_codec_alg_priv_t *ctx,
+                                        unsigned char *cx_data,
+                                        size_t cx_data_sz, int flush) {
+  const int max_in_flight = AOMMAX((int)ctx->cfg.g_threads, 1);
+  EncodeChunk *chunk;
+  int in_flight = 0;
+
+  if (flush && ctx->chunk_tail != NULL && !ctx->chunk_tail->launched)
+    launch_kf_chunk(ctx, ctx->chunk_tail);
+
+  for (chunk = ctx->chunk_head; chunk != NULL; chunk = chunk->next)
+    in_flight += chunk->launched && !chunk->done;
+  for (chunk = ctx->chunk_head; chunk != NULL && chunk->launched;
+       chunk = chunk->next) {
+    if (chunk->done) continue;
+    if (!flush && in_flight <= max_in_flight) break;
+    sync_kf_chunk(chunk);
+    --in_flight;
+  }
+
+  while ((chunk = ctx->chunk_head) != NULL && chunk->done) {
+    if (chunk->err != AOM_CODEC_OK) {
+      ctx->base.err_detail = chunk->err_detail != NULL
+                                 ? chunk->err_detail
+                                 : "Failed to encode a key frame chunk";
+      return chunk->err;
+    }
+    for (; chunk->next_frame < chunk->num_frames; ++chunk->next_frame) {
+      const ChunkFrame *const frame = &chunk->frames[chunk->next_frame];
+      size_t size;
+      // Leave room for the superframe index.
+      if (frame->size + 2 + 4 * 8 > cx_data_sz) {
+        if (ctx->pkt_list.head.cnt > 0) return AOM_CODEC_OK;
+        ctx->base.err_detail = "Compressed data buffer too small";
+        return AOM_CODEC_ERROR;
+      }
+      if (frame->show_frame &&
+          ctx->pkt_list.head.cnt + 1 + frame->has_psnr >
+              ctx->pkt_list.head.max)
+        return AOM_CODEC_OK;
+      if (frame->has_psnr)
+        aom_codec_pkt_list_add(&ctx->pkt_list.head, &frame->psnr_pkt);
+      memcpy(cx_data, chunk->data + frame->offset, frame->size);
+      size = add_frame_packet(ctx, cx_data, frame->size, frame->show_frame,
+                              frame->flags, frame->time_stamp,
+                              frame->end_time_stamp);
+      cx_data += size;
+      cx_data_sz -= size;
+    }
+    ctx->chunk_head = chunk->next;
+    if (ctx->chunk_head == NULL) ctx->chunk_tail = NULL;
+    free_kf_chunk(chunk);
+  }
+  return AOM_CODEC_OK;
+}
+
 const size_t kMinCompressedSize = 8192;
 static aom_codec_err_t encoder_encode(aom_codec_alg_priv_t *ctx,
                                       const aom_image_t *img,
@@ -1031,6 +1477,10 @@ static aom_codec_err_t encoder_encode(aom_codec_alg_priv_t *ctx,
   volatile aom_enc_frame_flags_t flags = enc_flags;
   AV1_COMP *const cpi = ctx->cpi;
   const aom_rational_t *const timebase = &ctx->cfg.g_timebase;
+  const int use_kf_chunks =
+      (ctx->extra_cfg.kf_chunk_parallel &&
+       ctx->cfg.g_pass == AOM_RC_LAST_PASS) ||
+      ctx->chunk_head != NULL;
   size_t data_sz;
 
   if (cpi == NULL) return AOM_CODEC_INVALID_PARAM;
@@ -1103,7 +1553,11 @@ static aom_codec_err_t encoder_encode(aom_codec_alg_priv_t *ctx,
     // Set up internal flags
     if (ctx->base.init_flags & AOM_CODEC_USE_PSNR) cpi->b_calculate_psnr = 1;
 
-    if (img != NULL) {
+    if (img != NULL && use_kf_chunks) {
+      res = add_chunk_source(ctx, img, flags | ctx->next_frame_flags,
+                             dst_time_stamp, dst_end_time_stamp);
+      ctx->next_frame_flags = 0;
+    } else if (img != NULL) {
       res = image2yuvconfig(img, &sd);
 
       // Store the original flags in to the frame buffer. Will extract the
@@ -1135,56 +1589,27 @@ static aom_codec_err_t encoder_encode(aom_codec_alg_priv_t *ctx,
       }
     }
 
-    while (cx_data_sz >= ctx->cx_data_sz / 2 &&
-           -1 != av1_get_compressed_data(cpi, &lib_flags, &size, cx_data,
-                                         &dst_time_stamp, &dst_end_time_stamp,
-                                         !img)) {
+    if (use_kf_chunks) {
+      if (res == AOM_CODEC_OK)
+        res = output_kf_chunks(ctx, cx_data, cx_data_sz, !img);
+    } else {
+      while (cx_data_sz >= ctx->cx_data_sz / 2 &&
+             -1 != av1_get_compressed_data(cpi, &lib_flags, &size, cx_data,
+                                           &dst_time_stamp,
+                                           &dst_end_time_stamp, !img)) {
 #if CONFIG_REFERENCE_BUFFER
-      if (cpi->common.invalid_delta_frame_id_minus1) {
-        ctx->base.err_detail = "Invalid delta_frame_id_minus1";
-        return AOM_CODEC_ERROR;
-      }
+        if (cpi->common.invalid_delta_frame_id_minus1) {
+          ctx->base.err_detail = "Invalid delta_frame_id_minus1";
+          return AOM_CODEC_ERROR;
+        }
 #endif
-      if (size) {
-        aom_codec_cx_pkt_t pkt;
-
-        // Pack invisible frames with the next visible frame
-        if (!cpi->common.show_frame) {
-          if (ctx->pending_cx_data == 0) ctx->pending_cx_data = cx_data;
-          ctx->pending_cx_data_sz += size;
-          ctx->pending_frame_sizes[ctx->pending_frame_count++] = size;
+        if (size) {
+          size = add_frame_packet(ctx, cx_data, size, cpi->common.show_frame,
+                                  get_frame_pkt_flags(cpi, lib_flags),
+                                  dst_time_stamp, dst_end_time_stamp);
           cx_data += size;
           cx_data_sz -= size;
-
-          continue;
         }
-
-        // Add the frame packet to the list of returned packets.
-        pkt.kind = AOM_CODEC_CX_FRAME_PKT;
-        pkt.data.frame.pts = ticks_to_timebase_units(timebase, dst_time_stamp);
-        pkt.data.frame.duration = (unsigned long)ticks_to_timebase_units(
-            timebase, dst_end_time_stamp - dst_time_stamp);
-        pkt.data.frame.flags = get_frame_pkt_flags(cpi, lib_flags);
-
-        if (ctx->pending_cx_data) {
-          ctx->pending_frame_sizes[ctx->pending_frame_count++] = size;
-          ctx->pending_cx_data_sz += size;
-          size += write_superframe_index(ctx);
-          pkt.data.frame.buf = ctx->pending_cx_data;
-          pkt.data.frame.sz = ctx->pending_cx_data_sz;
-          ctx->pending_cx_data = NULL;
-          ctx->pending_cx_data_sz = 0;
-          ctx->pending_frame_count = 0;
-        } else {
-          pkt.data.frame.buf = cx_data;
-          pkt.data.frame.sz = size;
-        }
-        pkt.data.frame.partition_id = -1;
-
-        aom_codec_pkt_list_add(&ctx->pkt_list.head, &pkt);
-
-        cx_data += size;
-        cx_data_sz -= size;
       }
     }
   }
@@ -1388,6 +1813,20 @@ static aom_codec_err_t ctrl_set_ans_window_size_log2(aom_codec_alg_priv_t *ctx,
 }
 #endif
 
+static aom_codec_err_t ctrl_set_row_mt(aom_codec_alg_priv_t *ctx,
+                                       va_list args) {
+  struct av1_extracfg extra_cfg = ctx->extra_cfg;
+  extra_cfg.row_mt = CAST(AV1E_SET_ROW_MT, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
+
+static aom_codec_err_t ctrl_set_kf_chunk_parallel(aom_codec_alg_priv_t *ctx,
+                                                  va_list args) {
+  struct av1_extracfg extra_cfg = ctx->extra_cfg;
+  extra_cfg.kf_chunk_parallel = CAST(AV1E_SET_KF_CHUNK_PARALLEL, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
+
 static aom_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   { AOM_COPY_REFERENCE, ctrl_copy_reference },
   { AOME_USE_REFERENCE, ctrl_use_reference },
@@ -1447,6 +1886,8 @@ static aom_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
 #if CONFIG_ANS && ANS_MAX_SYMBOLS
   { AV1E_SET_ANS_WINDOW_SIZE_LOG2, ctrl_set_ans_window_size_log2 },
 #endif
+  { AV1E_SET_ROW_MT, ctrl_set_row_mt },
+  { AV1E_SET_KF_CHUNK_PARALLEL, ctrl_set_kf_chunk_parallel },
 
   // Getters
   { AOME_GET_LAST_QUANTIZER, ctrl_get_quantizer },
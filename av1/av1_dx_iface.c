@@ -59,11 +59,17 @@ struct aom_codec_alg_priv {
   int skip_loop_filter;
   int decode_tile_row;
   int decode_tile_col;
+  aom_image_rect_t decode_tile_rect;
+  int row_mt;
+  int min_border;
+  int low_memory;
 
   // Frame parallel related.
   int frame_parallel_decode;  // frame-based threading.
   AVxWorker *frame_workers;
   int num_frame_workers;
+  // Threads shared by the tile and loop filter workers in serial mode.
+  AVxThreadPool *thread_pool;
   int next_submit_worker_id;
   int last_submit_worker_id;
   int next_output_worker_id;
@@ -142,6 +148,7 @@ static aom_codec_err_t decoder_destroy(aom_codec_alg_priv_t *ctx) {
     pthread_mutex_destroy(&ctx->buffer_pool->pool_mutex);
 #endif
   }
+  aom_thread_pool_release(ctx->thread_pool);
 
   if (ctx->buffer_pool) {
     av1_free_ref_frame_buffers(ctx->buffer_pool);
@@ -297,6 +304,7 @@ static void init_buffer_callbacks(aom_codec_alg_priv_t *ctx) {
     cm->new_fb_idx = INVALID_IDX;
     cm->byte_alignment = ctx->byte_alignment;
     cm->skip_loop_filter = ctx->skip_loop_filter;
+    cm->min_border = ctx->min_border;
 
     if (ctx->get_ext_fb_cb != NULL && ctx->release_ext_fb_cb != NULL) {
       pool->get_fb_cb = ctx->get_ext_fb_cb;
@@ -304,7 +312,8 @@ static void init_buffer_callbacks(aom_codec_alg_priv_t *ctx) {
       pool->cb_priv = ctx->ext_priv;
     } else {
       pool->get_fb_cb = av1_get_frame_buffer;
-      pool->release_fb_cb = av1_release_frame_buffer;
+      pool->release_fb_cb = ctx->low_memory ? av1_release_and_free_frame_buffer
+                                            : av1_release_frame_buffer;
 
       if (av1_alloc_internal_frame_buffers(&pool->int_frame_buffers))
         aom_internal_error(&cm->error, AOM_CODEC_MEM_ERROR,
@@ -385,6 +394,11 @@ static aom_codec_err_t init_decoder(aom_codec_alg_priv_t *ctx) {
   }
 #endif
 
+  // In serial mode the caller decodes and the other threads are pooled. A
+  // NULL pool makes every worker create a thread of its own.
+  if (!ctx->frame_parallel_decode && ctx->cfg.threads > 1)
+    ctx->thread_pool = aom_thread_pool_create(ctx->cfg.threads - 1);
+
   ctx->frame_workers = (AVxWorker *)aom_malloc(ctx->num_frame_workers *
                                                sizeof(*ctx->frame_workers));
   if (ctx->frame_workers == NULL) {
@@ -408,6 +422,7 @@ static aom_codec_err_t init_decoder(aom_codec_alg_priv_t *ctx) {
       return AOM_CODEC_MEM_ERROR;
     }
     frame_worker_data->pbi->frame_worker_owner = worker;
+    frame_worker_data->pbi->thread_pool = ctx->thread_pool;
     frame_worker_data->worker_id = i;
     frame_worker_data->scratch_buffer = NULL;
     frame_worker_data->scratch_buffer_size = 0;
@@ -430,6 +445,7 @@ static aom_codec_err_t init_decoder(aom_codec_alg_priv_t *ctx) {
         (ctx->frame_parallel_decode == 0) ? ctx->cfg.threads : 0;
 
     frame_worker_data->pbi->inv_tile_order = ctx->invert_tile_order;
+    frame_worker_data->pbi->low_memory = ctx->low_memory;
     frame_worker_data->pbi->common.frame_parallel_decode =
         ctx->frame_parallel_decode;
     worker->hook = (AVxWorkerHook)frame_worker_hook;
@@ -457,6 +473,70 @@ static INLINE void check_resync(aom_codec_alg_priv_t *const ctx,
     ctx->need_resync = 0;
 }
 
+// Posts the rows of the frame being decoded that are final to the put_slice
+// callback. The valid rectangle covers all the rows posted so far.
+static void put_slice_rows(void *priv, int row_start, int row_end) {
+  aom_codec_alg_priv_t *const ctx = (aom_codec_alg_priv_t *)priv;
+  FrameWorkerData *const frame_worker_data =
+      (FrameWorkerData *)ctx->frame_workers->data1;
+  const AV1_COMMON *const cm = &frame_worker_data->pbi->common;
+  RefCntBuffer *const frame_bufs = cm->buffer_pool->frame_bufs;
+  aom_image_t img;
+  aom_image_rect_t valid, update;
+
+  // Frames are not output before a key frame or an intra-only frame.
+  if (ctx->need_resync && !frame_is_intra_only(cm)) return;
+
+  yuvconfig2image(&img, &frame_bufs[cm->new_fb_idx].buf,
+                  frame_worker_data->user_priv);
+  img.fb_priv = frame_bufs[cm->new_fb_idx].raw_frame_buffer.priv;
+  valid.x = update.x = 0;
+  valid.w = update.w = img.d_w;
+  valid.y = 0;
+  valid.h = row_end;
+  update.y = row_start;
+  update.h = row_end - row_start;
+  ctx->base.dec.put_slice_cb.u.put_slice(ctx->base.dec.put_slice_cb.user_priv,
+                                         &img, &valid, &update);
+}
+
+// Passes the settings of the decoder, which the caller may change between
+// frames, to the decoder of the frame worker about to decode a frame.
+static void set_decoder_params(aom_codec_alg_priv_t *ctx, AV1Decoder *pbi) {
+  pbi->decrypt_cb = ctx->decrypt_cb;
+  pbi->decrypt_state = ctx->decrypt_state;
+  pbi->row_mt = ctx->row_mt;
+  // The frame workers of frame parallel decode do not post rows, as they
+  // finish the frames out of output order.
+  pbi->rows_done_cb =
+      ctx->base.dec.put_slice_cb.u.put_slice && !ctx->frame_parallel_decode
+          ? put_slice_rows
+          : NULL;
+  pbi->rows_done_priv = ctx;
+#if CONFIG_INSPECTION
+  pbi->inspect_cb = ctx->inspect_cb;
+  pbi->inspect_ctx = ctx->inspect_ctx;
+#endif
+
+#if CONFIG_EXT_TILE
+  // A rectangle of tiles replaces the single tile row and column.
+  if (ctx->decode_tile_rect.w > 0 && ctx->decode_tile_rect.h > 0) {
+    pbi->dec_tile_row = -1;
+    pbi->dec_tile_col = -1;
+  } else {
+    pbi->dec_tile_row = ctx->decode_tile_row;
+    pbi->dec_tile_col = ctx->decode_tile_col;
+  }
+  pbi->dec_tile_rect = ctx->decode_tile_rect;
+  // The output of a single tile or of a tile window is not posted by rows,
+  // even with a put_slice callback registered; see AV1_SET_DECODE_TILE_ROW.
+  if (ctx->decode_tile_row >= 0 || ctx->decode_tile_col >= 0 ||
+      dec_has_frame_window(pbi) ||
+      (ctx->decode_tile_rect.w > 0 && ctx->decode_tile_rect.h > 0))
+    pbi->rows_done_cb = NULL;
+#endif  // CONFIG_EXT_TILE
+}
+
 static aom_codec_err_t decode_one(aom_codec_alg_priv_t *ctx,
                                   const uint8_t **data, unsigned int data_sz,
                                   void *user_priv, int64_t deadline) {
@@ -484,19 +564,7 @@ static aom_codec_err_t decode_one(aom_codec_alg_priv_t *ctx,
     frame_worker_data->user_priv = user_priv;
     frame_worker_data->received_frame = 1;
 
-    // Set these even if already initialized.  The caller may have changed the
-    // decrypt config between frames.
-    frame_worker_data->pbi->decrypt_cb = ctx->decrypt_cb;
-    frame_worker_data->pbi->decrypt_state = ctx->decrypt_state;
-#if CONFIG_INSPECTION
-    frame_worker_data->pbi->inspect_cb = ctx->inspect_cb;
-    frame_worker_data->pbi->inspect_ctx = ctx->inspect_ctx;
-#endif
-
-#if CONFIG_EXT_TILE
-    frame_worker_data->pbi->dec_tile_row = ctx->decode_tile_row;
-    frame_worker_data->pbi->dec_tile_col = ctx->decode_tile_col;
-#endif  // CONFIG_EXT_TILE
+    set_decoder_params(ctx, frame_worker_data->pbi);
 
     worker->had_error = 0;
     winterface->execute(worker);
@@ -539,6 +607,7 @@ static aom_codec_err_t decode_one(aom_codec_alg_priv_t *ctx,
     frame_worker_data->received_frame = 1;
     frame_worker_data->data = frame_worker_data->scratch_buffer;
     frame_worker_data->user_priv = user_priv;
+    set_decoder_params(ctx, frame_worker_data->pbi);
 
     if (ctx->next_submit_worker_id != ctx->last_submit_worker_id)
       ctx->last_submit_worker_id =
@@ -702,13 +771,22 @@ static void release_last_output_frame(aom_codec_alg_priv_t *ctx) {
   RefCntBuffer *const frame_bufs = ctx->buffer_pool->frame_bufs;
   // Decrease reference count of last output frame in frame parallel mode.
   if (ctx->frame_parallel_decode && ctx->last_show_frame >= 0) {
-    BufferPool *const pool = ctx->buffer_pool;
-    lock_buffer_pool(pool);
-    decrease_ref_count(ctx->last_show_frame, frame_bufs, pool);
-    unlock_buffer_pool(pool);
+    decrease_ref_count(ctx->last_show_frame, frame_bufs, ctx->buffer_pool);
   }
 }
 
+#if CONFIG_EXT_TILE
+// Crops img, an image of a frame decoded by pbi, to the tile window, which is
+// all the frame buffers hold.
+static void crop_to_frame_window(aom_image_t *img, const AV1Decoder *pbi) {
+  const TileInfo *const win = &pbi->frame_window;
+  const int x = win->mi_col_start * MI_SIZE;
+  const int y = win->mi_row_start * MI_SIZE;
+  img->d_w = AOMMIN((int)img->d_w, win->mi_col_end * MI_SIZE) - x;
+  img->d_h = AOMMIN((int)img->d_h, win->mi_row_end * MI_SIZE) - y;
+}
+#endif  // CONFIG_EXT_TILE
+
 static aom_image_t *decoder_get_frame(aom_codec_alg_priv_t *ctx,
                                       aom_codec_iter_t *iter) {
   aom_image_t *img = NULL;
@@ -759,6 +837,9 @@ static aom_image_t *decoder_get_frame(aom_codec_alg_priv_t *ctx,
           yuvconfig2image(&ctx->img, &sd, frame_worker_data->user_priv);
 
 #if CONFIG_EXT_TILE
+          if (dec_has_frame_window(frame_worker_data->pbi))
+            crop_to_frame_window(&ctx->img, frame_worker_data->pbi);
+
           if (frame_worker_data->pbi->dec_tile_row >= 0) {
             const int tile_row =
                 AOMMIN(frame_worker_data->pbi->dec_tile_row, cm->tile_rows - 1);
@@ -837,6 +918,10 @@ static aom_codec_err_t ctrl_set_reference(aom_codec_alg_priv_t *ctx,
     YV12_BUFFER_CONFIG sd;
     AVxWorker *const worker = ctx->frame_workers;
     FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+    if (dec_has_frame_window(frame_worker_data->pbi)) {
+      set_error_detail(ctx, "Not supported when decoding a tile rectangle");
+      return AOM_CODEC_INCAPABLE;
+    }
     image2yuvconfig(&frame->img, &sd);
     return av1_set_reference_dec(&frame_worker_data->pbi->common,
                                  ref_frame_to_av1_reframe(frame->frame_type),
@@ -860,6 +945,10 @@ static aom_codec_err_t ctrl_copy_reference(aom_codec_alg_priv_t *ctx,
     YV12_BUFFER_CONFIG sd;
     AVxWorker *const worker = ctx->frame_workers;
     FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+    if (dec_has_frame_window(frame_worker_data->pbi)) {
+      set_error_detail(ctx, "Not supported when decoding a tile rectangle");
+      return AOM_CODEC_INCAPABLE;
+    }
     image2yuvconfig(&frame->img, &sd);
     return av1_copy_reference_dec(frame_worker_data->pbi,
                                   (AOM_REFFRAME)frame->frame_type, &sd);
@@ -885,6 +974,10 @@ static aom_codec_err_t ctrl_get_reference(aom_codec_alg_priv_t *ctx,
     fb = get_ref_frame(&frame_worker_data->pbi->common, data->idx);
     if (fb == NULL) return AOM_CODEC_ERROR;
     yuvconfig2image(&data->img, fb, NULL);
+#if CONFIG_EXT_TILE
+    if (dec_has_frame_window(frame_worker_data->pbi))
+      crop_to_frame_window(&data->img, frame_worker_data->pbi);
+#endif  // CONFIG_EXT_TILE
     return AOM_CODEC_OK;
   } else {
     return AOM_CODEC_INVALID_PARAM;
@@ -908,6 +1001,10 @@ static aom_codec_err_t ctrl_get_new_frame_image(aom_codec_alg_priv_t *ctx,
 
     if (av1_get_frame_to_show(frame_worker_data->pbi, &new_frame) == 0) {
       yuvconfig2image(new_img, &new_frame, NULL);
+#if CONFIG_EXT_TILE
+      if (dec_has_frame_window(frame_worker_data->pbi))
+        crop_to_frame_window(new_img, frame_worker_data->pbi);
+#endif  // CONFIG_EXT_TILE
       return AOM_CODEC_OK;
     } else {
       return AOM_CODEC_ERROR;
@@ -1142,6 +1239,75 @@ static aom_codec_err_t ctrl_set_decode_tile_col(aom_codec_alg_priv_t *ctx,
   return AOM_CODEC_OK;
 }
 
+static aom_codec_err_t ctrl_set_decode_tile_rect(aom_codec_alg_priv_t *ctx,
+                                                 va_list args) {
+#if CONFIG_EXT_TILE && !CONFIG_GLOBAL_MOTION && !CONFIG_WARPED_MOTION
+  const aom_image_rect_t *const rect = va_arg(args, aom_image_rect_t *);
+  if (rect != NULL) {
+    ctx->decode_tile_rect = *rect;
+  } else {
+    memset(&ctx->decode_tile_rect, 0, sizeof(ctx->decode_tile_rect));
+  }
+  return AOM_CODEC_OK;
+#else
+  // The warped predictors read the reference frames outside of the window.
+  (void)ctx;
+  (void)args;
+  return AOM_CODEC_INCAPABLE;
+#endif  // CONFIG_EXT_TILE && !CONFIG_GLOBAL_MOTION && !CONFIG_WARPED_MOTION
+}
+
+static aom_codec_err_t ctrl_set_row_mt(aom_codec_alg_priv_t *ctx,
+                                       va_list args) {
+  ctx->row_mt = va_arg(args, int);
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_set_min_border(aom_codec_alg_priv_t *ctx,
+                                           va_list args) {
+  // The reference frames already decoded keep the border they have.
+  if (ctx->frame_workers) return AOM_CODEC_ERROR;
+  ctx->min_border = va_arg(args, int);
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_set_low_memory(aom_codec_alg_priv_t *ctx,
+                                           va_list args) {
+  // The frame buffers are already allocated by the internal callbacks.
+  if (ctx->frame_workers) return AOM_CODEC_ERROR;
+  ctx->low_memory = va_arg(args, int);
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_get_memory_usage(aom_codec_alg_priv_t *ctx,
+                                             va_list args) {
+  aom_dec_mem_usage_t *const usage = va_arg(args, aom_dec_mem_usage_t *);
+  // The structures allocated once per decoder instance.
+  size_t fixed = sizeof(*ctx);
+  size_t peak = 0;
+  int i;
+
+  if (usage == NULL) return AOM_CODEC_INVALID_PARAM;
+
+  usage->current_bytes = 0;
+  if (ctx->frame_workers) {
+    fixed += sizeof(*ctx->buffer_pool);
+    usage->current_bytes += av1_buffer_pool_mem_usage(ctx->buffer_pool);
+    for (i = 0; i < ctx->num_frame_workers; ++i) {
+      const FrameWorkerData *const frame_worker_data =
+          (FrameWorkerData *)ctx->frame_workers[i].data1;
+      const AV1Decoder *const pbi = frame_worker_data->pbi;
+      fixed += sizeof(ctx->frame_workers[i]) + sizeof(*frame_worker_data) +
+               frame_worker_data->scratch_buffer_size;
+      usage->current_bytes += av1_decoder_mem_usage(pbi);
+      peak = AOMMAX(peak, pbi->peak_mem_usage);
+    }
+  }
+  usage->current_bytes += fixed;
+  usage->peak_bytes = AOMMAX(peak + fixed, usage->current_bytes);
+  return AOM_CODEC_OK;
+}
+
 static aom_codec_err_t ctrl_set_inspection_callback(aom_codec_alg_priv_t *ctx,
                                                     va_list args) {
 #if !CONFIG_INSPECTION
@@ -1173,6 +1339,10 @@ static aom_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { AV1_SET_DECODE_TILE_ROW, ctrl_set_decode_tile_row },
   { AV1_SET_DECODE_TILE_COL, ctrl_set_decode_tile_col },
   { AV1_SET_INSPECTION_CALLBACK, ctrl_set_inspection_callback },
+  { AV1D_SET_ROW_MT, ctrl_set_row_mt },
+  { AV1D_SET_MIN_BORDER, ctrl_set_min_border },
+  { AV1D_SET_LOW_MEMORY, ctrl_set_low_memory },
+  { AV1_SET_DECODE_TILE_RECT, ctrl_set_decode_tile_rect },
 
   // Getters
   { AOMD_GET_FRAME_CORRUPTED, ctrl_get_frame_corrupted },
@@ -1184,6 +1354,7 @@ static aom_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { AV1_GET_ACCOUNTING, ctrl_get_accounting },
   { AV1_GET_NEW_FRAME_IMAGE, ctrl_get_new_frame_image },
   { AV1_GET_REFERENCE, ctrl_get_reference },
+  { AV1D_GET_MEMORY_USAGE, ctrl_get_memory_usage },
 
   { -1, NULL },
 };
@@ -1194,7 +1365,7 @@ static aom_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
 CODEC_INTERFACE(aom_codec_av1_dx) = {
   "AOMedia Project AV1 Decoder" VERSION_STRING,
   AOM_CODEC_INTERNAL_ABI_VERSION,
-  AOM_CODEC_CAP_DECODER |
+  AOM_CODEC_CAP_DECODER | AOM_CODEC_CAP_PUT_SLICE |
       AOM_CODEC_CAP_EXTERNAL_FRAME_BUFFER,  // aom_codec_caps_t
   decoder_init,                             // aom_codec_init_fn_t
   decoder_destroy,                          // aom_codec_destroy_fn_t
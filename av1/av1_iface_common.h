@@ -131,6 +131,8 @@ static aom_codec_err_t image2yuvconfig(const aom_image_t *img,
 #endif  // CONFIG_AOM_HIGHBITDEPTH
   yv12->subsampling_x = img->x_chroma_shift;
   yv12->subsampling_y = img->y_chroma_shift;
+  yv12->x_origin = 0;
+  yv12->y_origin = 0;
   return AOM_CODEC_OK;
 }
 
@@ -1707,9 +1707,9 @@ void av1_filter_block_plane_non420_hor(AV1_COMMON *cm,
   dst->buf = dst0;
 }
 
-void av1_filter_block_plane_ss00_ver(AV1_COMMON *const cm,
-                                     struct macroblockd_plane *const plane,
-                                     int mi_row, LOOP_FILTER_MASK *lfm) {
+static INLINE void filter_block_plane_ss00_ver(
+    AV1_COMMON *const cm, struct macroblockd_plane *const plane, int mi_row,
+    LOOP_FILTER_MASK *lfm, int use_highbitdepth) {
   struct buf_2d *const dst = &plane->dst;
   uint8_t *const dst0 = dst->buf;
   int r;
@@ -1718,6 +1718,7 @@ void av1_filter_block_plane_ss00_ver(AV1_COMMON *const cm,
   uint64_t mask_4x4 = lfm->left_y[TX_4X4];
   uint64_t mask_4x4_int = lfm->int_4x4_y;
 
+  (void)use_highbitdepth;
   assert(plane->subsampling_x == 0 && plane->subsampling_y == 0);
 
   // Vertical pass: do 2 rows at one time
@@ -1729,7 +1730,7 @@ void av1_filter_block_plane_ss00_ver(AV1_COMMON *const cm,
 
 // Disable filtering on the leftmost column.
 #if CONFIG_AOM_HIGHBITDEPTH
-    if (cm->use_highbitdepth) {
+    if (use_highbitdepth) {
       highbd_filter_selectively_vert_row2(
           plane->subsampling_x, CONVERT_TO_SHORTPTR(dst->buf), dst->stride,
           mask_16x16_l, mask_8x8_l, mask_4x4_l, mask_4x4_int_l, &cm->lf_info,
@@ -1755,9 +1756,9 @@ void av1_filter_block_plane_ss00_ver(AV1_COMMON *const cm,
   dst->buf = dst0;
 }
 
-void av1_filter_block_plane_ss00_hor(AV1_COMMON *const cm,
-                                     struct macroblockd_plane *const plane,
-                                     int mi_row, LOOP_FILTER_MASK *lfm) {
+static INLINE void filter_block_plane_ss00_hor(
+    AV1_COMMON *const cm, struct macroblockd_plane *const plane, int mi_row,
+    LOOP_FILTER_MASK *lfm, int use_highbitdepth) {
   struct buf_2d *const dst = &plane->dst;
   uint8_t *const dst0 = dst->buf;
   int r;
@@ -1766,6 +1767,7 @@ void av1_filter_block_plane_ss00_hor(AV1_COMMON *const cm,
   uint64_t mask_4x4 = lfm->above_y[TX_4X4];
   uint64_t mask_4x4_int = lfm->int_4x4_y;
 
+  (void)use_highbitdepth;
   assert(plane->subsampling_x == 0 && plane->subsampling_y == 0);
 
   for (r = 0; r < cm->mib_size && mi_row + r < cm->mi_rows; r++) {
@@ -1784,7 +1786,7 @@ void av1_filter_block_plane_ss00_hor(AV1_COMMON *const cm,
     }
 
 #if CONFIG_AOM_HIGHBITDEPTH
-    if (cm->use_highbitdepth) {
+    if (use_highbitdepth) {
       highbd_filter_selectively_horiz(
           CONVERT_TO_SHORTPTR(dst->buf), dst->stride, mask_16x16_r, mask_8x8_r,
           mask_4x4_r, mask_4x4_int & 0xff, &cm->lf_info, &lfm->lfl_y[r][0],
@@ -1810,9 +1812,9 @@ void av1_filter_block_plane_ss00_hor(AV1_COMMON *const cm,
   dst->buf = dst0;
 }
 
-void av1_filter_block_plane_ss11_ver(AV1_COMMON *const cm,
-                                     struct macroblockd_plane *const plane,
-                                     int mi_row, LOOP_FILTER_MASK *lfm) {
+static INLINE void filter_block_plane_ss11_ver(
+    AV1_COMMON *const cm, struct macroblockd_plane *const plane, int mi_row,
+    LOOP_FILTER_MASK *lfm, int use_highbitdepth) {
   struct buf_2d *const dst = &plane->dst;
   uint8_t *const dst0 = dst->buf;
   int r, c;
@@ -1822,6 +1824,7 @@ void av1_filter_block_plane_ss11_ver(AV1_COMMON *const cm,
   uint16_t mask_4x4 = lfm->left_uv[TX_4X4];
   uint16_t mask_4x4_int = lfm->left_int_4x4_uv;
 
+  (void)use_highbitdepth;
   assert(plane->subsampling_x == 1 && plane->subsampling_y == 1);
   assert(plane->plane_type == PLANE_TYPE_UV);
   memset(lfm->lfl_uv, 0, sizeof(lfm->lfl_uv));
@@ -1841,7 +1844,7 @@ void av1_filter_block_plane_ss11_ver(AV1_COMMON *const cm,
 
 // Disable filtering on the leftmost column.
 #if CONFIG_AOM_HIGHBITDEPTH
-      if (cm->use_highbitdepth) {
+      if (use_highbitdepth) {
         highbd_filter_selectively_vert_row2(
             plane->subsampling_x, CONVERT_TO_SHORTPTR(dst->buf), dst->stride,
             mask_16x16_l, mask_8x8_l, mask_4x4_l, mask_4x4_int_l, &cm->lf_info,
@@ -1870,9 +1873,9 @@ void av1_filter_block_plane_ss11_ver(AV1_COMMON *const cm,
   dst->buf = dst0;
 }
 
-void av1_filter_block_plane_ss11_hor(AV1_COMMON *const cm,
-                                     struct macroblockd_plane *const plane,
-                                     int mi_row, LOOP_FILTER_MASK *lfm) {
+static INLINE void filter_block_plane_ss11_hor(
+    AV1_COMMON *const cm, struct macroblockd_plane *const plane, int mi_row,
+    LOOP_FILTER_MASK *lfm, int use_highbitdepth) {
   struct buf_2d *const dst = &plane->dst;
   uint8_t *const dst0 = dst->buf;
   int r, c;
@@ -1881,16 +1884,16 @@ void av1_filter_block_plane_ss11_hor(AV1_COMMON *const cm,
   uint64_t mask_4x4 = lfm->above_uv[TX_4X4];
   uint64_t mask_4x4_int = lfm->above_int_4x4_uv;
 
+  (void)use_highbitdepth;
   assert(plane->subsampling_x == 1 && plane->subsampling_y == 1);
   memset(lfm->lfl_uv, 0, sizeof(lfm->lfl_uv));
 
-  // re-porpulate the filter level for uv, same as the code for vertical
-  // filter in av1_filter_block_plane_ss11_ver
-  for (r = 0; r < cm->mib_size && mi_row + r < cm->mi_rows; r += 4) {
-    for (c = 0; c < (cm->mib_size >> 1); c++) {
-      lfm->lfl_uv[r >> 1][c] = lfm->lfl_y[r][c << 1];
-      lfm->lfl_uv[(r + 2) >> 1][c] = lfm->lfl_y[r + 2][c << 1];
-    }
+  // re-porpulate the filter level for uv, as the vertical filter in
+  // av1_filter_block_plane_ss11_ver does, for the uv rows filtered below.
+  for (r = 0; r < (cm->mib_size >> 1) && mi_row + (r << 1) < cm->mi_rows;
+       r++) {
+    for (c = 0; c < (cm->mib_size >> 1); c++)
+      lfm->lfl_uv[r][c] = lfm->lfl_y[r << 1][c << 1];
   }
 
   for (r = 0; r < cm->mib_size && mi_row + r < cm->mi_rows; r += 2) {
@@ -1912,7 +1915,7 @@ void av1_filter_block_plane_ss11_hor(AV1_COMMON *const cm,
     }
 
 #if CONFIG_AOM_HIGHBITDEPTH
-    if (cm->use_highbitdepth) {
+    if (use_highbitdepth) {
       highbd_filter_selectively_horiz(
           CONVERT_TO_SHORTPTR(dst->buf), dst->stride, mask_16x16_r, mask_8x8_r,
           mask_4x4_r, mask_4x4_int_r, &cm->lf_info, &lfm->lfl_uv[r >> 1][0],
@@ -1938,6 +1941,56 @@ void av1_filter_block_plane_ss11_hor(AV1_COMMON *const cm,
   dst->buf = dst0;
 }
 
+#if CONFIG_AOM_HIGHBITDEPTH
+#define USE_HIGHBITDEPTH(cm) ((cm)->use_highbitdepth)
+#else
+#define USE_HIGHBITDEPTH(cm) 0
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+
+void av1_filter_block_plane_ss00_ver(AV1_COMMON *const cm,
+                                     struct macroblockd_plane *const plane,
+                                     int mi_row, LOOP_FILTER_MASK *lfm) {
+  filter_block_plane_ss00_ver(cm, plane, mi_row, lfm, USE_HIGHBITDEPTH(cm));
+}
+
+void av1_filter_block_plane_ss00_hor(AV1_COMMON *const cm,
+                                     struct macroblockd_plane *const plane,
+                                     int mi_row, LOOP_FILTER_MASK *lfm) {
+  filter_block_plane_ss00_hor(cm, plane, mi_row, lfm, USE_HIGHBITDEPTH(cm));
+}
+
+void av1_filter_block_plane_ss11_ver(AV1_COMMON *const cm,
+                                     struct macroblockd_plane *const plane,
+                                     int mi_row, LOOP_FILTER_MASK *lfm) {
+  filter_block_plane_ss11_ver(cm, plane, mi_row, lfm, USE_HIGHBITDEPTH(cm));
+}
+
+void av1_filter_block_plane_ss11_hor(AV1_COMMON *const cm,
+                                     struct macroblockd_plane *const plane,
+                                     int mi_row, LOOP_FILTER_MASK *lfm) {
+  filter_block_plane_ss11_hor(cm, plane, mi_row, lfm, USE_HIGHBITDEPTH(cm));
+}
+
+// The 8-bit 4:2:0 specializations, where the compiler drops the high bitdepth
+// filters and the plane type picks the subsampled variant.
+void av1_filter_block_plane_lowbd_420_ver(AV1_COMMON *const cm,
+                                          struct macroblockd_plane *const plane,
+                                          int mi_row, LOOP_FILTER_MASK *lfm) {
+  if (plane->plane_type == PLANE_TYPE_Y)
+    filter_block_plane_ss00_ver(cm, plane, mi_row, lfm, 0);
+  else
+    filter_block_plane_ss11_ver(cm, plane, mi_row, lfm, 0);
+}
+
+void av1_filter_block_plane_lowbd_420_hor(AV1_COMMON *const cm,
+                                          struct macroblockd_plane *const plane,
+                                          int mi_row, LOOP_FILTER_MASK *lfm) {
+  if (plane->plane_type == PLANE_TYPE_Y)
+    filter_block_plane_ss00_hor(cm, plane, mi_row, lfm, 0);
+  else
+    filter_block_plane_ss11_hor(cm, plane, mi_row, lfm, 0);
+}
+
 #if CONFIG_PARALLEL_DEBLOCKING
 typedef enum EDGE_DIR { VERT_EDGE = 0, HORZ_EDGE = 1, NUM_EDGE_DIRS } EDGE_DIR;
 static const uint32_t av1_prediction_masks[NUM_EDGE_DIRS][BLOCK_SIZES] = {
@@ -2301,6 +2354,8 @@ void av1_loop_filter_rows(YV12_BUFFER_CONFIG *frame_buffer, AV1_COMMON *cm,
 
   if (y_only)
     path = LF_PATH_444;
+  else if (cm->lowbd_420)
+    path = LF_PATH_LOWBD_420;
   else if (planes[1].subsampling_y == 1 && planes[1].subsampling_x == 1)
     path = LF_PATH_420;
   else if (planes[1].subsampling_y == 0 && planes[1].subsampling_x == 0)
@@ -2348,6 +2403,16 @@ void av1_loop_filter_rows(YV12_BUFFER_CONFIG *frame_buffer, AV1_COMMON *cm,
       // TODO(JBB): Make setup_mask work for non 420.
       av1_setup_mask(cm, mi_row, mi_col, mi + mi_col, cm->mi_stride, &lfm);
 
+      if (path == LF_PATH_LOWBD_420) {
+        for (plane = 0; plane < num_planes; ++plane) {
+          av1_filter_block_plane_lowbd_420_ver(cm, &planes[plane], mi_row,
+                                               &lfm);
+          av1_filter_block_plane_lowbd_420_hor(cm, &planes[plane], mi_row,
+                                               &lfm);
+        }
+        continue;
+      }
+
       av1_filter_block_plane_ss00_ver(cm, &planes[0], mi_row, &lfm);
       av1_filter_block_plane_ss00_hor(cm, &planes[0], mi_row, &lfm);
       for (plane = 1; plane < num_planes; ++plane) {
@@ -2367,6 +2432,7 @@ void av1_loop_filter_rows(YV12_BUFFER_CONFIG *frame_buffer, AV1_COMMON *cm,
                                               mi_row, mi_col);
 
             break;
+          default: assert(0); break;
         }
       }
     }
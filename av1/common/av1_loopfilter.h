@@ -30,6 +30,7 @@ extern "C" {
 #define MAX_MODE_LF_DELTAS 2
 
 enum lf_path {
+  LF_PATH_LOWBD_420,
   LF_PATH_420,
   LF_PATH_444,
   LF_PATH_SLOW,
@@ -111,6 +112,13 @@ void av1_filter_block_plane_ss11_ver(struct AV1Common *const cm,
 void av1_filter_block_plane_ss11_hor(struct AV1Common *const cm,
                                      struct macroblockd_plane *const plane,
                                      int mi_row, LOOP_FILTER_MASK *lfm);
+// Filters either plane of 8-bit 4:2:0 frames, for cm->lowbd_420.
+void av1_filter_block_plane_lowbd_420_ver(struct AV1Common *const cm,
+                                          struct macroblockd_plane *const plane,
+                                          int mi_row, LOOP_FILTER_MASK *lfm);
+void av1_filter_block_plane_lowbd_420_hor(struct AV1Common *const cm,
+                                          struct macroblockd_plane *const plane,
+                                          int mi_row, LOOP_FILTER_MASK *lfm);
 
 void av1_filter_block_plane_non420_ver(struct AV1Common *cm,
                                        struct macroblockd_plane *plane,
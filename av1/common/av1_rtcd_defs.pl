@@ -700,7 +700,7 @@ if (aom_config("CONFIG_AOM_HIGHBITDEPTH") eq "yes") {
   specialize qw/av1_highbd_fwht4x4/;
 
   add_proto qw/void av1_highbd_temporal_filter_apply/, "uint8_t *frame1, unsigned int stride, uint8_t *frame2, unsigned int block_width, unsigned int block_height, int strength, int filter_weight, unsigned int *accumulator, uint16_t *count";
-  specialize qw/av1_highbd_temporal_filter_apply/;
+  specialize qw/av1_highbd_temporal_filter_apply sse4_1/;
 
 }
 # End av1_high encoder functions
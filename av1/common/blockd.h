@@ -514,6 +514,17 @@ typedef struct macroblockd {
   /* pointer to current frame */
   const YV12_BUFFER_CONFIG *cur_buf;
 
+  /* Scratch buffer for the inter predictors to replicate the edges of
+   * reference frames allocated without a border (see AV1_COMMON::min_border).
+   * NULL when the reference frames have extended borders. */
+  uint8_t *mc_buf;
+#if CONFIG_EXT_TILE
+  /* Part of the frame held by the reference frames, in mi units, when the
+   * decoder only decodes a window of tiles. Empty (mi_row_end == 0) when they
+   * hold the whole frame. */
+  TileInfo mc_window;
+#endif  // CONFIG_EXT_TILE
+
   ENTROPY_CONTEXT *above_context[MAX_MB_PLANE];
   ENTROPY_CONTEXT left_context[MAX_MB_PLANE][2 * MAX_MIB_SIZE];
 
@@ -523,6 +534,7 @@ typedef struct macroblockd {
 #if CONFIG_VAR_TX
   TXFM_CONTEXT *above_txfm_context;
   TXFM_CONTEXT *left_txfm_context;
+  TXFM_CONTEXT *above_txfm_context_buffer;
   TXFM_CONTEXT left_txfm_context_buffer[MAX_MIB_SIZE];
 
   TX_SIZE max_tx_size;
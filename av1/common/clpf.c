@@ -320,3 +320,180 @@ void av1_clpf_frame(
   aom_free(cache_ptr);
   aom_free(cache_dst);
 }
+
+// Returns the plane buffer as raw bytes with its stride and size in pixels.
+static uint8_t *clpf_plane(const YV12_BUFFER_CONFIG *frame, int plane,
+                           int *stride, int *line_width) {
+  uint8_t *const buf =
+      plane != AOM_PLANE_Y
+          ? (plane == AOM_PLANE_U ? frame->u_buffer : frame->v_buffer)
+          : frame->y_buffer;
+  *stride = plane != AOM_PLANE_Y ? frame->uv_stride : frame->y_stride;
+  // Blocks next to the right edge of the visible area may read up to two
+  // pixels past it.
+  *line_width = (plane != AOM_PLANE_Y ? frame->uv_width : frame->y_width) + 2;
+#if CONFIG_AOM_HIGHBITDEPTH
+  if (frame->flags & YV12_FLAG_HIGHBITDEPTH)
+    return (uint8_t *)CONVERT_TO_SHORTPTR(buf);
+#endif
+  return buf;
+}
+
+size_t av1_clpf_lines_size(const YV12_BUFFER_CONFIG *frame, int plane) {
+  int stride, line_width;
+  const int hbd = !!(frame->flags & YV12_FLAG_HIGHBITDEPTH);
+  clpf_plane(frame, plane, &stride, &line_width);
+  return (size_t)(4 * line_width) << hbd;
+}
+
+void av1_clpf_save_lines(const YV12_BUFFER_CONFIG *frame, int plane, int y,
+                         uint8_t *lines) {
+  int stride, line_width, r;
+  const int hbd = !!(frame->flags & YV12_FLAG_HIGHBITDEPTH);
+  const uint8_t *const buf = clpf_plane(frame, plane, &stride, &line_width);
+  for (r = 0; r < 4; r++)
+    memcpy(lines + ((r * line_width) << hbd),
+           buf + (((y - 2 + r) * stride) << hbd), line_width << hbd);
+}
+
+size_t av1_clpf_rows_buf_size(const YV12_BUFFER_CONFIG *frame) {
+  const int hbd = !!(frame->flags & YV12_FLAG_HIGHBITDEPTH);
+  // Two block rows of output and a block row with two lines of context on
+  // either side, at the luma block size, followed by two rows of block flags
+  // and the flags of the filter blocks.
+  return ((size_t)((2 * 8 + 8 + 4) * frame->y_stride) << hbd) +
+         3 * frame->y_stride;
+}
+
+// Copies the filtered blocks of a block row from the output buffer back into
+// the frame.
+static void clpf_write_row(uint8_t *dst, const uint8_t *out, int stride,
+                           const uint8_t *filtered, int bs, int width,
+                           int sizey, int hbd) {
+  int n, c;
+  for (n = 0; n * bs < width; n++) {
+    const int xpos = n * bs;
+    const int sizex = AOMMIN(width - xpos, bs);
+    if (!filtered[n]) continue;
+    for (c = 0; c < sizey; c++)
+      memcpy(dst + ((c * stride + xpos) << hbd),
+             out + ((c * stride + xpos) << hbd), sizex << hbd);
+  }
+}
+
+void av1_clpf_rows(const YV12_BUFFER_CONFIG *frame, const AV1_COMMON *cm,
+                   int enable_fb_flag, unsigned int strength,
+                   unsigned int fb_size_log2, int plane, int y_start, int y_end,
+                   const uint8_t *above, const uint8_t *below, uint8_t *buf) {
+  int k, l, m, n, r;
+  const int subx = plane != AOM_PLANE_Y && frame->subsampling_x;
+  const int suby = plane != AOM_PLANE_Y && frame->subsampling_y;
+  const int bs = (subx || suby) ? 4 : 8;
+  const int width =
+      plane != AOM_PLANE_Y ? frame->uv_crop_width : frame->y_crop_width;
+  const int height =
+      plane != AOM_PLANE_Y ? frame->uv_crop_height : frame->y_crop_height;
+  const int num_fb_hor = (width + (1 << fb_size_log2) - 1) >> fb_size_log2;
+  const int hbd = !!(frame->flags & YV12_FLAG_HIGHBITDEPTH);
+  int sstride, line_width;
+  uint8_t *const src_buffer = clpf_plane(frame, plane, &sstride, &line_width);
+  uint8_t *out[2];
+  uint8_t *const stage = buf + ((2 * 8 * frame->y_stride) << hbd);
+  uint8_t *filtered[2];
+  uint8_t *const fb_filter = buf + ((28 * frame->y_stride) << hbd) +
+                             2 * frame->y_stride;
+  int fb_row = -1;
+  int ypos, xpos;
+  int damping =
+      cm->bit_depth - 5 - (plane != AOM_PLANE_Y) + (cm->base_qindex >> 6);
+#if CONFIG_AOM_HIGHBITDEPTH
+  strength <<= (cm->bit_depth - 8);
+#endif
+  out[0] = buf;
+  out[1] = buf + ((8 * frame->y_stride) << hbd);
+  filtered[0] = buf + ((28 * frame->y_stride) << hbd);
+  filtered[1] = filtered[0] + frame->y_stride;
+
+  for (ypos = y_start, r = 0; ypos < y_end; ypos += bs, r ^= 1) {
+    const int sizey = AOMMIN(height - ypos, bs);
+    const int use_above = above && ypos == y_start;
+    const int use_below = below && ypos + bs >= y_end;
+    const uint8_t *src = src_buffer;
+    uint8_t *const dst = out[r] - ((ypos * sstride) << hbd);
+
+    // Decide which filter blocks of this filter block row to filter.
+    k = ypos >> fb_size_log2;
+    if (k != fb_row) {
+      const int yoff = k << fb_size_log2;
+      fb_row = k;
+      for (l = 0; l < num_fb_hor; l++) {
+        int allskip = !(enable_fb_flag && fb_size_log2 == MAX_FB_SIZE_LOG2);
+        const int xoff = l << fb_size_log2;
+        for (m = 0; allskip && m < (1 << fb_size_log2) / bs; m++) {
+          for (n = 0; allskip && n < (1 << fb_size_log2) / bs; n++) {
+            xpos = xoff + n * bs;
+            if (xpos < width && yoff + m * bs < height) {
+              allskip &= cm->mi_grid_visible[((yoff + m * bs) << suby) /
+                                                 MI_SIZE * cm->mi_stride +
+                                             (xpos << subx) / MI_SIZE]
+                             ->mbmi.skip;
+            }
+          }
+        }
+        fb_filter[l] =
+            !allskip &&
+            (!enable_fb_flag ||
+             cm->clpf_blocks[yoff / MIN_FB_SIZE * cm->clpf_stride +
+                             xoff / MIN_FB_SIZE]);
+      }
+    }
+
+    // The block rows next to the saved lines are filtered from a copy of the
+    // frame with those lines patched in.
+    if (use_above || use_below) {
+      for (m = -2; m < bs + 2; m++) {
+        const int y = ypos + m;
+        const uint8_t *line;
+        if (y < 0) continue;
+        if (use_above && y < y_start)
+          line = above + (((y - y_start + 2) * line_width) << hbd);
+        else if (use_below && y >= y_end)
+          line = below + (((y - y_end + 2) * line_width) << hbd);
+        else
+          line = src_buffer + ((y * sstride) << hbd);
+        memcpy(stage + (((m + 2) * sstride) << hbd), line, line_width << hbd);
+      }
+      src = stage - (((ypos - 2) * sstride) << hbd);
+    }
+
+    for (n = 0; n * bs < width; n++) {
+      const int sizex = AOMMIN(width - n * bs, bs);
+      const int mi_idx =
+          (ypos << suby) / MI_SIZE * cm->mi_stride + (n * bs << subx) / MI_SIZE;
+      xpos = n * bs;
+      filtered[r][n] =
+          fb_filter[xpos >> fb_size_log2] &&
+          (!cm->mi_grid_visible[mi_idx]->mbmi.skip ||
+           (enable_fb_flag && fb_size_log2 == MAX_FB_SIZE_LOG2));
+      if (!filtered[r][n]) continue;
+#if CONFIG_AOM_HIGHBITDEPTH
+      if (hbd) {
+        aom_clpf_block_hbd((const uint16_t *)src, (uint16_t *)dst, sstride,
+                           sstride, xpos, ypos, sizex, sizey, strength,
+                           cm->mi[mi_idx].mbmi.boundary_info, damping);
+        continue;
+      }
+#endif
+      aom_clpf_block(src, dst, sstride, sstride, xpos, ypos, sizex, sizey,
+                     strength, cm->mi[mi_idx].mbmi.boundary_info, damping);
+    }
+
+    // The previous block row is no longer read, so write it back.
+    if (ypos > y_start)
+      clpf_write_row(src_buffer + (((ypos - bs) * sstride) << hbd), out[!r],
+                     sstride, filtered[!r], bs, width, bs, hbd);
+    if (ypos + bs >= y_end)
+      clpf_write_row(src_buffer + ((ypos * sstride) << hbd), out[r], sstride,
+                     filtered[r], bs, width, sizey, hbd);
+  }
+}
@@ -29,4 +29,20 @@ void av1_clpf_frame(const YV12_BUFFER_CONFIG *frame,
                                     const AV1_COMMON *cm, int, int, int,
                                     unsigned int, unsigned int, int8_t *, int));
 
+// Size in bytes of the lines av1_clpf_save_lines() saves for a plane.
+size_t av1_clpf_lines_size(const YV12_BUFFER_CONFIG *frame, int plane);
+// Saves the two lines above and the two lines from row y of a plane.
+void av1_clpf_save_lines(const YV12_BUFFER_CONFIG *frame, int plane, int y,
+                         uint8_t *lines);
+// Size in bytes of the scratch buffer av1_clpf_rows() needs.
+size_t av1_clpf_rows_buf_size(const YV12_BUFFER_CONFIG *frame);
+// Filters the rows [y_start, y_end) of a plane in place, using the filter
+// block flags signalled in cm->clpf_blocks. above and below are the lines
+// saved at y_start and y_end before any of them were filtered, or NULL to
+// read the lines from the frame.
+void av1_clpf_rows(const YV12_BUFFER_CONFIG *frame, const AV1_COMMON *cm,
+                   int enable_fb_flag, unsigned int strength,
+                   unsigned int fb_size_log2, int plane, int y_start, int y_end,
+                   const uint8_t *above, const uint8_t *below, uint8_t *buf);
+
 #endif
@@ -35,8 +35,21 @@ int sb_compute_dering_list(const AV1_COMMON *const cm, int mi_row, int mi_col,
 void av1_dering_frame(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
                       MACROBLOCKD *xd, int global_level);
 
-int av1_dering_search(YV12_BUFFER_CONFIG *frame, const YV12_BUFFER_CONFIG *ref,
-                      AV1_COMMON *cm, MACROBLOCKD *xd);
+// Stride of the line buffers that hold OD_FILT_VBORDER unfiltered lines of a
+// plane on one side of a superblock row boundary.
+int av1_dering_line_stride(const AV1_COMMON *cm);
+// Copies the unfiltered lines on one side of the boundary above superblock row
+// sbr into lines: the first lines of row sbr when below is set, else the last
+// lines of row sbr - 1. planes must point at the top left of the frame.
+void av1_dering_save_lines(AV1_COMMON *cm,
+                           const struct macroblockd_plane *planes, int sbr,
+                           int below, int16_t *const lines[3]);
+// Derings superblock row sbr in place. above holds the unfiltered lines above
+// the row (unused for the first row). below holds the unfiltered lines below
+// it, or is NULL when they are still unfiltered in the frame.
+void av1_dering_sb_row(AV1_COMMON *cm, struct macroblockd_plane *planes,
+                       int global_level, int sbr, int16_t *const above[3],
+                       int16_t *const below[3]);
 
 #ifdef __cplusplus
 }  // extern "C"
@@ -5543,13 +5543,19 @@ static void adapt_coef_probs(AV1_COMMON *cm, TX_SIZE tx_size,
   const av1_blockz_count_model *const blockz_counts =
       (const av1_blockz_count_model *)&cm->counts.blockz_count[tx_size][0];
 #endif
+  const unsigned int(*coef_blocks)[REF_TYPES] = cm->counts.coef_blocks[tx_size];
   int i, j, k, l, m;
 #if CONFIG_RECT_TX
   assert(!is_rect_tx(tx_size));
 #endif  // CONFIG_RECT_TX
 
   for (i = 0; i < PLANE_TYPES; ++i)
-    for (j = 0; j < REF_TYPES; ++j)
+    for (j = 0; j < REF_TYPES; ++j) {
+      // Without counts every merge returns the previous probability.
+      if (coef_blocks[i][j] == 0) {
+        memcpy(probs[i][j], pre_probs[i][j], sizeof(probs[i][j]));
+        continue;
+      }
       for (k = 0; k < COEF_BANDS; ++k)
         for (l = 0; l < BAND_COEFF_CONTEXTS(k); ++l) {
           const int n0 = counts[i][j][k][l][ZERO_TOKEN];
@@ -5564,10 +5570,16 @@ static void adapt_coef_probs(AV1_COMMON *cm, TX_SIZE tx_size,
                 av1_merge_probs(pre_probs[i][j][k][l][m], branch_ct[m],
                                 count_sat, update_factor);
         }
+    }
 
 #if CONFIG_NEW_TOKENSET
   for (i = 0; i < PLANE_TYPES; ++i) {
     for (j = 0; j < REF_TYPES; ++j) {
+      if (coef_blocks[i][j] == 0) {
+        memcpy(blockz_probs[i][j], pre_blockz_probs[i][j],
+               sizeof(blockz_probs[i][j]));
+        continue;
+      }
       for (k = 0; k < BLOCKZ_CONTEXTS; ++k) {
         const int n0 = blockz_counts[i][j][k][0];
         const int n1 = blockz_counts[i][j][k][1];
@@ -278,6 +278,10 @@ typedef struct FRAME_COUNTS {
 #else
   unsigned int partition[PARTITION_CONTEXTS][PARTITION_TYPES];
 #endif
+  // Number of transform blocks counted in each coef, eob_branch and
+  // blockz_count group. Groups that were never coded are skipped when the
+  // counts are merged and adapted.
+  unsigned int coef_blocks[TX_SIZES][PLANE_TYPES][REF_TYPES];
   av1_coeff_count_model coef[TX_SIZES][PLANE_TYPES];
   unsigned int eob_branch[TX_SIZES][PLANE_TYPES][REF_TYPES][COEF_BANDS]
                          [COEFF_CONTEXTS];
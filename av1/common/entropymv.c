@@ -221,8 +221,56 @@ void av1_inc_mv(const MV *mv, nmv_context_counts *counts, const int usehp) {
   }
 }
 
+static void adapt_mv_component(nmv_component *comp,
+                               const nmv_component *pre_comp,
+                               const nmv_context_counts *counts, int i,
+                               int allow_hp) {
+  const nmv_component_counts *c = &counts->comps[i];
+  // Component 0 is the row, counted only for vectors with a nonzero row.
+  const MV_JOINT_TYPE single = i == 0 ? MV_JOINT_HZVNZ : MV_JOINT_HNZVZ;
+  const unsigned int coded =
+      counts->joints[single] + counts->joints[MV_JOINT_HNZVNZ];
+  int j;
+
+  if (coded == 0) {
+    // With no counts every merge below returns the previous probability.
+    comp->sign = pre_comp->sign;
+    av1_copy(comp->classes, pre_comp->classes);
+    av1_copy(comp->class0, pre_comp->class0);
+    av1_copy(comp->bits, pre_comp->bits);
+    av1_copy(comp->class0_fp, pre_comp->class0_fp);
+    av1_copy(comp->fp, pre_comp->fp);
+    if (allow_hp) {
+      comp->class0_hp = pre_comp->class0_hp;
+      comp->hp = pre_comp->hp;
+    }
+    return;
+  }
+
+  comp->sign = av1_mode_mv_merge_probs(pre_comp->sign, c->sign);
+  aom_tree_merge_probs(av1_mv_class_tree, pre_comp->classes, c->classes,
+                       comp->classes);
+  aom_tree_merge_probs(av1_mv_class0_tree, pre_comp->class0, c->class0,
+                       comp->class0);
+
+  for (j = 0; j < MV_OFFSET_BITS; ++j)
+    comp->bits[j] = av1_mode_mv_merge_probs(pre_comp->bits[j], c->bits[j]);
+
+  for (j = 0; j < CLASS0_SIZE; ++j)
+    aom_tree_merge_probs(av1_mv_fp_tree, pre_comp->class0_fp[j],
+                         c->class0_fp[j], comp->class0_fp[j]);
+
+  aom_tree_merge_probs(av1_mv_fp_tree, pre_comp->fp, c->fp, comp->fp);
+
+  if (allow_hp) {
+    comp->class0_hp =
+        av1_mode_mv_merge_probs(pre_comp->class0_hp, c->class0_hp);
+    comp->hp = av1_mode_mv_merge_probs(pre_comp->hp, c->hp);
+  }
+}
+
 void av1_adapt_mv_probs(AV1_COMMON *cm, int allow_hp) {
-  int i, j;
+  int i;
 #if CONFIG_REF_MV
   int idx;
   for (idx = 0; idx < NMV_CONTEXTS; ++idx) {
@@ -233,32 +281,9 @@ void av1_adapt_mv_probs(AV1_COMMON *cm, int allow_hp) {
 
     aom_tree_merge_probs(av1_mv_joint_tree, pre_fc->joints, counts->joints,
                          fc->joints);
-    for (i = 0; i < 2; ++i) {
-      nmv_component *comp = &fc->comps[i];
-      const nmv_component *pre_comp = &pre_fc->comps[i];
-      const nmv_component_counts *c = &counts->comps[i];
-
-      comp->sign = av1_mode_mv_merge_probs(pre_comp->sign, c->sign);
-      aom_tree_merge_probs(av1_mv_class_tree, pre_comp->classes, c->classes,
-                           comp->classes);
-      aom_tree_merge_probs(av1_mv_class0_tree, pre_comp->class0, c->class0,
-                           comp->class0);
-
-      for (j = 0; j < MV_OFFSET_BITS; ++j)
-        comp->bits[j] = av1_mode_mv_merge_probs(pre_comp->bits[j], c->bits[j]);
-
-      for (j = 0; j < CLASS0_SIZE; ++j)
-        aom_tree_merge_probs(av1_mv_fp_tree, pre_comp->class0_fp[j],
-                             c->class0_fp[j], comp->class0_fp[j]);
-
-      aom_tree_merge_probs(av1_mv_fp_tree, pre_comp->fp, c->fp, comp->fp);
-
-      if (allow_hp) {
-        comp->class0_hp =
-            av1_mode_mv_merge_probs(pre_comp->class0_hp, c->class0_hp);
-        comp->hp = av1_mode_mv_merge_probs(pre_comp->hp, c->hp);
-      }
-    }
+    for (i = 0; i < 2; ++i)
+      adapt_mv_component(&fc->comps[i], &pre_fc->comps[i], counts, i,
+                         allow_hp);
   }
 #else
   nmv_context *fc = &cm->fc->nmvc;
@@ -268,32 +293,8 @@ void av1_adapt_mv_probs(AV1_COMMON *cm, int allow_hp) {
   aom_tree_merge_probs(av1_mv_joint_tree, pre_fc->joints, counts->joints,
                        fc->joints);
 
-  for (i = 0; i < 2; ++i) {
-    nmv_component *comp = &fc->comps[i];
-    const nmv_component *pre_comp = &pre_fc->comps[i];
-    const nmv_component_counts *c = &counts->comps[i];
-
-    comp->sign = av1_mode_mv_merge_probs(pre_comp->sign, c->sign);
-    aom_tree_merge_probs(av1_mv_class_tree, pre_comp->classes, c->classes,
-                         comp->classes);
-    aom_tree_merge_probs(av1_mv_class0_tree, pre_comp->class0, c->class0,
-                         comp->class0);
-
-    for (j = 0; j < MV_OFFSET_BITS; ++j)
-      comp->bits[j] = av1_mode_mv_merge_probs(pre_comp->bits[j], c->bits[j]);
-
-    for (j = 0; j < CLASS0_SIZE; ++j)
-      aom_tree_merge_probs(av1_mv_fp_tree, pre_comp->class0_fp[j],
-                           c->class0_fp[j], comp->class0_fp[j]);
-
-    aom_tree_merge_probs(av1_mv_fp_tree, pre_comp->fp, c->fp, comp->fp);
-
-    if (allow_hp) {
-      comp->class0_hp =
-          av1_mode_mv_merge_probs(pre_comp->class0_hp, c->class0_hp);
-      comp->hp = av1_mode_mv_merge_probs(pre_comp->hp, c->hp);
-    }
-  }
+  for (i = 0; i < 2; ++i)
+    adapt_mv_component(&fc->comps[i], &pre_fc->comps[i], counts, i, allow_hp);
 #endif
 }
 
@@ -77,3 +77,16 @@ int av1_release_frame_buffer(void *cb_priv, aom_codec_frame_buffer_t *fb) {
   if (int_fb) int_fb->in_use = 0;
   return 0;
 }
+
+int av1_release_and_free_frame_buffer(void *cb_priv,
+                                      aom_codec_frame_buffer_t *fb) {
+  InternalFrameBuffer *const int_fb = (InternalFrameBuffer *)fb->priv;
+  (void)cb_priv;
+  if (int_fb) {
+    int_fb->in_use = 0;
+    aom_free(int_fb->data);
+    int_fb->data = NULL;
+    int_fb->size = 0;
+  }
+  return 0;
+}
@@ -47,6 +47,11 @@ int av1_get_frame_buffer(void *cb_priv, size_t min_size,
 // |cb_priv| is not used. |fb| pointer to the frame buffer.
 int av1_release_frame_buffer(void *cb_priv, aom_codec_frame_buffer_t *fb);
 
+// Same as av1_release_frame_buffer(), but also frees the memory of the frame
+// buffer, which av1_get_frame_buffer() allocates again when it is reused.
+int av1_release_and_free_frame_buffer(void *cb_priv,
+                                      aom_codec_frame_buffer_t *fb);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
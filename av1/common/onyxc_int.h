@@ -15,6 +15,7 @@
 #include "./aom_config.h"
 #include "./av1_rtcd.h"
 #include "aom/internal/aom_codec_internal.h"
+#include "aom_util/aom_atomics.h"
 #include "aom_util/aom_thread.h"
 #if CONFIG_ANS
 #include "aom_dsp/ans.h"
@@ -49,7 +50,7 @@ extern "C" {
 // of framebuffers.
 // TODO(jkoleszar): These 3 extra references could probably come from the
 // normal reference pool.
-#define FRAME_BUFFERS (REF_FRAMES + 7)
+#define FRAME_BUFFERS (REF_FRAMES + MAX_DECODE_THREADS - 1)
 
 #if CONFIG_REFERENCE_BUFFER
 /* Constant values while waiting for the sequence header */
@@ -120,15 +121,16 @@ typedef struct {
 
   // row and col indicate which position frame has been decoded to in real
   // pixel unit. They are reset to -1 when decoding begins and set to INT_MAX
-  // when the frame is fully decoded.
+  // when the frame is fully decoded. row is accessed atomically.
   int row;
   int col;
+  // Number of FrameWorkers waiting for row to advance.
+  int row_waiters;
 } RefCntBuffer;
 
 typedef struct BufferPool {
-// Protect BufferPool from being accessed by several FrameWorkers at
-// the same time during frame parallel decode.
-// TODO(hkuang): Try to use atomic variable instead of locking the whole pool.
+// Serialize the frame buffer callbacks of the FrameWorkers during frame
+// parallel decode. The reference counts are updated atomically instead.
 #if CONFIG_MULTITHREAD
   pthread_mutex_t pool_mutex;
 #endif
@@ -166,6 +168,9 @@ typedef struct AV1Common {
   // Marks if we need to use 16bit frame buffers (1: yes, 0: no).
   int use_highbitdepth;
 #endif
+  // Marks 8-bit 4:2:0 sequences, for which the loop filter takes the paths
+  // specialized to that format. Set by av1_set_lowbd_420().
+  int lowbd_420;
 #if CONFIG_CDEF
   // Two bits are used to signal the strength for all blocks and the
   // valid values are:
@@ -385,6 +390,10 @@ typedef struct AV1Common {
 
   int byte_alignment;
   int skip_loop_filter;
+  // Allocate the new frames with AOM_DEC_BORDER_IN_PIXELS instead of
+  // AOM_BORDER_IN_PIXELS and leave their borders unextended. The inter
+  // predictors then replicate the reference frame edges in MACROBLOCKD::mc_buf.
+  int min_border;
 
   // Private data associated with the frame buffer callbacks.
   void *cb_priv;
@@ -449,9 +458,7 @@ typedef struct SequenceHeader {
 } SequenceHeader;
 #endif
 
-// TODO(hkuang): Don't need to lock the whole pool after implementing atomic
-// frame reference count.
-static void lock_buffer_pool(BufferPool *const pool) {
+static INLINE void lock_buffer_pool(BufferPool *const pool) {
 #if CONFIG_MULTITHREAD
   pthread_mutex_lock(&pool->pool_mutex);
 #else
@@ -459,7 +466,7 @@ static void lock_buffer_pool(BufferPool *const pool) {
 #endif
 }
 
-static void unlock_buffer_pool(BufferPool *const pool) {
+static INLINE void unlock_buffer_pool(BufferPool *const pool) {
 #if CONFIG_MULTITHREAD
   pthread_mutex_unlock(&pool->pool_mutex);
 #else
@@ -483,30 +490,32 @@ static INLINE int get_free_fb(AV1_COMMON *cm) {
   RefCntBuffer *const frame_bufs = cm->buffer_pool->frame_bufs;
   int i;
 
-  lock_buffer_pool(cm->buffer_pool);
+  // Claim the first buffer nobody else holds.
   for (i = 0; i < FRAME_BUFFERS; ++i)
-    if (frame_bufs[i].ref_count == 0) break;
+    if (aom_atomic_compare_exchange(&frame_bufs[i].ref_count, 0, 1)) break;
 
-  if (i != FRAME_BUFFERS) {
-    frame_bufs[i].ref_count = 1;
-  } else {
-    // Reset i to be INVALID_IDX to indicate no free buffer found.
-    i = INVALID_IDX;
-  }
+  // Reset i to be INVALID_IDX to indicate no free buffer found.
+  if (i == FRAME_BUFFERS) i = INVALID_IDX;
 
-  unlock_buffer_pool(cm->buffer_pool);
   return i;
 }
 
 static INLINE void ref_cnt_fb(RefCntBuffer *bufs, int *idx, int new_idx) {
   const int ref_index = *idx;
 
-  if (ref_index >= 0 && bufs[ref_index].ref_count > 0)
-    bufs[ref_index].ref_count--;
+  if (ref_index >= 0) {
+    // Drop the old reference, unless the count is already 0, in one step.
+    int ref_count;
+    do {
+      ref_count = aom_atomic_load(&bufs[ref_index].ref_count);
+    } while (ref_count > 0 &&
+             !aom_atomic_compare_exchange(&bufs[ref_index].ref_count,
+                                          ref_count, ref_count - 1));
+  }
 
   *idx = new_idx;
 
-  bufs[new_idx].ref_count++;
+  aom_atomic_add(&bufs[new_idx].ref_count, 1);
 }
 
 static INLINE int mi_cols_aligned_to_sb(const AV1_COMMON *cm) {
@@ -517,6 +526,15 @@ static INLINE int mi_rows_aligned_to_sb(const AV1_COMMON *cm) {
   return ALIGN_POWER_OF_TWO(cm->mi_rows, cm->mib_size_log2);
 }
 
+// Selects the 8-bit 4:2:0 paths once per sequence, after the bit depth and
+// the subsampling are known.
+static INLINE void av1_set_lowbd_420(AV1_COMMON *cm) {
+  cm->lowbd_420 = cm->subsampling_x == 1 && cm->subsampling_y == 1;
+#if CONFIG_AOM_HIGHBITDEPTH
+  if (cm->use_highbitdepth) cm->lowbd_420 = 0;
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+}
+
 static INLINE int frame_is_intra_only(const AV1_COMMON *const cm) {
   return cm->frame_type == KEY_FRAME || cm->intra_only;
 }
@@ -559,6 +577,7 @@ static INLINE void av1_init_macroblockd(AV1_COMMON *cm, MACROBLOCKD *xd,
   xd->above_seg_context = cm->above_seg_context;
 #if CONFIG_VAR_TX
   xd->above_txfm_context = cm->above_txfm_context;
+  xd->above_txfm_context_buffer = cm->above_txfm_context;
 #endif
   xd->mi_stride = cm->mi_stride;
   xd->error_info = &cm->error;
@@ -10,6 +10,7 @@
  */
 
 #include <assert.h>
+#include <string.h>
 
 #include "./aom_scale_rtcd.h"
 #include "./aom_dsp_rtcd.h"
@@ -17,6 +18,7 @@
 
 #include "aom/aom_integer.h"
 #include "aom_dsp/blend.h"
+#include "aom_mem/aom_mem.h"
 
 #include "av1/common/blockd.h"
 #include "av1/common/reconinter.h"
@@ -819,6 +821,113 @@ typedef struct SubpelParams {
   int subpel_y;
 } SubpelParams;
 
+// Copies the b_w x b_h samples at (x, y) of a w x h plane to dst, replicating
+// the edge samples of the plane where the block lies outside of it.
+static void build_mc_border(const uint8_t *src, int src_stride, uint8_t *dst,
+                            int dst_stride, int x, int y, int b_w, int b_h,
+                            int w, int h) {
+  const int left = AOMMIN(AOMMAX(-x, 0), b_w);
+  const int right = AOMMIN(AOMMAX(x + b_w - w, 0), b_w - left);
+  const int copy = b_w - left - right;
+  int i;
+
+  for (i = 0; i < b_h; ++i) {
+    const uint8_t *const ref_row = src + clamp(y + i, 0, h - 1) * src_stride;
+    if (left) memset(dst, ref_row[0], left);
+    if (copy) memcpy(dst + left, ref_row + x + left, copy);
+    if (right) memset(dst + left + copy, ref_row[w - 1], right);
+    dst += dst_stride;
+  }
+}
+
+#if CONFIG_AOM_HIGHBITDEPTH
+static void highbd_build_mc_border(const uint16_t *src, int src_stride,
+                                   uint16_t *dst, int dst_stride, int x, int y,
+                                   int b_w, int b_h, int w, int h) {
+  const int left = AOMMIN(AOMMAX(-x, 0), b_w);
+  const int right = AOMMIN(AOMMAX(x + b_w - w, 0), b_w - left);
+  const int copy = b_w - left - right;
+  int i;
+
+  for (i = 0; i < b_h; ++i) {
+    const uint16_t *const ref_row = src + clamp(y + i, 0, h - 1) * src_stride;
+    if (left) aom_memset16(dst, ref_row[0], left);
+    if (copy) memcpy(dst + left, ref_row + x + left, copy * sizeof(*dst));
+    if (right) aom_memset16(dst + left + copy, ref_row[w - 1], right);
+    dst += dst_stride;
+  }
+}
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+
+// Returns the samples to predict a w x h block from, given pre, its pointer in
+// the reference plane, which is (x, y) + mv away from pre_buf->buf. When the
+// reference frame has no border and the filter taps reach outside of the
+// plane, the samples are copied to xd->mc_buf with the plane edges replicated,
+// and *pre_stride is set to the stride of the copy. When the reference frame
+// only holds a window of the frame, the edges of the window are replicated
+// instead, and the positions are relative to the window.
+static uint8_t *extend_mc_border(const MACROBLOCKD *xd,
+                                 const struct macroblockd_plane *pd,
+                                 const struct buf_2d *pre_buf, uint8_t *pre,
+                                 int x, int y, const MV32 *mv, int w, int h,
+                                 int xs, int ys, int *pre_stride) {
+  const int taps_before = MAX_FILTER_TAP / 2 - 1;
+  const int taps_after = MAX_FILTER_TAP / 2;
+  const int subpel_x = mv->col & SUBPEL_MASK;
+  const int subpel_y = mv->row & SUBPEL_MASK;
+  const int filter_x = subpel_x || xs != 16;
+  const int filter_y = subpel_y || ys != 16;
+  // Size of the part of the plane held by the reference frame.
+  int width = pre_buf->width, height = pre_buf->height;
+  int origin, x0, y0, x1, y1, b_w, b_h;
+
+  if (!xd->mc_buf) return pre;
+#if CONFIG_EXT_TILE
+  if (xd->mc_window.mi_row_end > 0) {
+    const TileInfo *const win = &xd->mc_window;
+    const int ss_x = pd->subsampling_x;
+    const int ss_y = pd->subsampling_y;
+    width = AOMMIN(width, (win->mi_col_end * MI_SIZE) >> ss_x) -
+            ((win->mi_col_start * MI_SIZE) >> ss_x);
+    height = AOMMIN(height, (win->mi_row_end * MI_SIZE) >> ss_y) -
+             ((win->mi_row_start * MI_SIZE) >> ss_y);
+  }
+#else
+  (void)pd;
+#endif  // CONFIG_EXT_TILE
+
+  // First and last integer samples of the block in the reference plane.
+  origin = (int)(pre_buf->buf - pre_buf->buf0);
+  x0 = origin % pre_buf->stride + x + (mv->col >> SUBPEL_BITS);
+  y0 = origin / pre_buf->stride + y + (mv->row >> SUBPEL_BITS);
+  x1 = x0 + ((subpel_x + (w - 1) * xs) >> SUBPEL_BITS);
+  y1 = y0 + ((subpel_y + (h - 1) * ys) >> SUBPEL_BITS);
+  if (x0 - (filter_x ? taps_before : 0) >= 0 &&
+      x1 + (filter_x ? taps_after : 0) < width &&
+      y0 - (filter_y ? taps_before : 0) >= 0 &&
+      y1 + (filter_y ? taps_after : 0) < height)
+    return pre;
+
+  // The taps are copied in both directions, as the convolve functions may
+  // read them with a zero weight.
+  b_w = x1 - x0 + 1 + taps_before + taps_after;
+  b_h = y1 - y0 + 1 + taps_before + taps_after;
+  assert(b_w <= MC_BUF_SIDE && b_h <= MC_BUF_SIDE);
+  *pre_stride = b_w;
+#if CONFIG_AOM_HIGHBITDEPTH
+  if (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) {
+    uint16_t *const mc_buf = (uint16_t *)xd->mc_buf;
+    highbd_build_mc_border(CONVERT_TO_SHORTPTR(pre_buf->buf0), pre_buf->stride,
+                           mc_buf, b_w, x0 - taps_before, y0 - taps_before,
+                           b_w, b_h, width, height);
+    return CONVERT_TO_BYTEPTR(mc_buf + taps_before * b_w + taps_before);
+  }
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+  build_mc_border(pre_buf->buf0, pre_buf->stride, xd->mc_buf, b_w,
+                  x0 - taps_before, y0 - taps_before, b_w, b_h, width, height);
+  return xd->mc_buf + taps_before * b_w + taps_before;
+}
+
 void build_inter_predictors(MACROBLOCKD *xd, int plane,
 #if CONFIG_MOTION_VAR
                             int mi_col_offset, int mi_row_offset,
@@ -888,8 +997,9 @@ void build_inter_predictors(MACROBLOCKD *xd, int plane,
           const MV mv_q4 = clamp_mv_to_umv_border_sb(
               xd, &mv, bw, bh, pd->subsampling_x, pd->subsampling_y);
           uint8_t *pre;
+          int pre_stride = pre_buf->stride;
           MV32 scaled_mv;
-          int xs, ys, subpel_x, subpel_y;
+          int xs, ys, subpel_x, subpel_y, pre_x, pre_y;
           const int is_scaled = av1_is_scaled(sf);
           ConvolveParams conv_params = get_conv_params(ref, plane);
 
@@ -904,24 +1014,33 @@ void build_inter_predictors(MACROBLOCKD *xd, int plane,
             scaled_mv = av1_scale_mv(&mv_q4, mi_x + x, mi_y + y, sf);
             xs = sf->x_step_q4;
             ys = sf->y_step_q4;
+            pre_x = sf->scale_value_x(x, sf);
+            pre_y = sf->scale_value_y(y, sf);
           } else {
             pre = pre_buf->buf + y * pre_buf->stride + x;
             scaled_mv.row = mv_q4.row;
             scaled_mv.col = mv_q4.col;
             xs = ys = 16;
+            pre_x = x;
+            pre_y = y;
           }
 
           subpel_x = scaled_mv.col & SUBPEL_MASK;
           subpel_y = scaled_mv.row & SUBPEL_MASK;
           pre += (scaled_mv.row >> SUBPEL_BITS) * pre_buf->stride +
                  (scaled_mv.col >> SUBPEL_BITS);
+#if CONFIG_GLOBAL_MOTION
+          if (!is_global[ref])
+#endif  // CONFIG_GLOBAL_MOTION
+            pre = extend_mc_border(xd, pd, pre_buf, pre, pre_x, pre_y,
+                                   &scaled_mv, w, h, xs, ys, &pre_stride);
 
 #if CONFIG_EXT_INTER
           if (ref &&
               is_masked_compound_type(mi->mbmi.interinter_compound_data.type))
             av1_make_masked_inter_predictor(
-                pre, pre_buf->stride, dst, dst_buf->stride, subpel_x, subpel_y,
-                sf, w, h, mi->mbmi.interp_filter, xs, ys,
+                pre, pre_stride, dst, dst_buf->stride, subpel_x, subpel_y, sf,
+                w, h, mi->mbmi.interp_filter, xs, ys,
 #if CONFIG_SUPERTX
                 wedge_offset_x, wedge_offset_y,
 #endif  // CONFIG_SUPERTX
@@ -934,8 +1053,8 @@ void build_inter_predictors(MACROBLOCKD *xd, int plane,
           else
 #endif  // CONFIG_EXT_INTER
             av1_make_inter_predictor(
-                pre, pre_buf->stride, dst, dst_buf->stride, subpel_x, subpel_y,
-                sf, x_step, y_step, &conv_params, mi->mbmi.interp_filter,
+                pre, pre_stride, dst, dst_buf->stride, subpel_x, subpel_y, sf,
+                x_step, y_step, &conv_params, mi->mbmi.interp_filter,
 #if CONFIG_GLOBAL_MOTION
                 is_global[ref], (mi_x >> pd->subsampling_x) + x,
                 (mi_y >> pd->subsampling_y) + y, plane, ref,
@@ -954,6 +1073,8 @@ void build_inter_predictors(MACROBLOCKD *xd, int plane,
     uint8_t *pre[2];
     MV32 scaled_mv[2];
     SubpelParams subpel_params[2];
+    // Offsets of the block from pd->pre[].buf in the reference planes.
+    int pre_x[2], pre_y[2];
 #if CONFIG_CONVOLVE_ROUND
     DECLARE_ALIGNED(16, int32_t, tmp_dst[MAX_SB_SIZE * MAX_SB_SIZE]);
     av1_zero(tmp_dst);
@@ -992,12 +1113,16 @@ void build_inter_predictors(MACROBLOCKD *xd, int plane,
         scaled_mv[ref] = av1_scale_mv(&mv_q4, mi_x + x, mi_y + y, sf);
         subpel_params[ref].xs = sf->x_step_q4;
         subpel_params[ref].ys = sf->y_step_q4;
+        pre_x[ref] = sf->scale_value_x(x, sf);
+        pre_y[ref] = sf->scale_value_y(y, sf);
       } else {
         pre[ref] = pre_buf->buf + (y * pre_buf->stride + x);
         scaled_mv[ref].row = mv_q4.row;
         scaled_mv[ref].col = mv_q4.col;
         subpel_params[ref].xs = 16;
         subpel_params[ref].ys = 16;
+        pre_x[ref] = x;
+        pre_y[ref] = y;
       }
 
       subpel_params[ref].subpel_x = scaled_mv[ref].col & SUBPEL_MASK;
@@ -1015,12 +1140,20 @@ void build_inter_predictors(MACROBLOCKD *xd, int plane,
     for (ref = 0; ref < 1 + is_compound; ++ref) {
       const struct scale_factors *const sf = &xd->block_refs[ref]->sf;
       struct buf_2d *const pre_buf = &pd->pre[ref];
+      int pre_stride = pre_buf->stride;
       conv_params.ref = ref;
+#if CONFIG_GLOBAL_MOTION
+      if (!is_global[ref])
+#endif  // CONFIG_GLOBAL_MOTION
+        pre[ref] = extend_mc_border(xd, pd, pre_buf, pre[ref], pre_x[ref],
+                                    pre_y[ref], &scaled_mv[ref], w, h,
+                                    subpel_params[ref].xs,
+                                    subpel_params[ref].ys, &pre_stride);
 #if CONFIG_EXT_INTER
       if (ref &&
           is_masked_compound_type(mi->mbmi.interinter_compound_data.type))
         av1_make_masked_inter_predictor(
-            pre[ref], pre_buf->stride, dst, dst_buf->stride,
+            pre[ref], pre_stride, dst, dst_buf->stride,
             subpel_params[ref].subpel_x, subpel_params[ref].subpel_y, sf, w, h,
             mi->mbmi.interp_filter, subpel_params[ref].xs,
             subpel_params[ref].ys,
@@ -1036,7 +1169,7 @@ void build_inter_predictors(MACROBLOCKD *xd, int plane,
       else
 #endif  // CONFIG_EXT_INTER
         av1_make_inter_predictor(
-            pre[ref], pre_buf->stride, dst, dst_buf->stride,
+            pre[ref], pre_stride, dst, dst_buf->stride,
             subpel_params[ref].subpel_x, subpel_params[ref].subpel_y, sf, w, h,
             &conv_params, mi->mbmi.interp_filter,
 #if CONFIG_GLOBAL_MOTION
@@ -1237,6 +1370,9 @@ void av1_setup_dst_planes(struct macroblockd_plane planes[MAX_MB_PLANE],
                                       src->uv_stride };
   int i;
 
+  // The planes start at the origin of the part of the frame src holds.
+  mi_row -= src->y_origin / MI_SIZE;
+  mi_col -= src->x_origin / MI_SIZE;
   for (i = 0; i < MAX_MB_PLANE; ++i) {
     struct macroblockd_plane *const pd = &planes[i];
     setup_pred_plane(&pd->dst, buffers[i], widths[i], heights[i], strides[i],
@@ -1258,6 +1394,10 @@ void av1_setup_pre_planes(MACROBLOCKD *xd, int idx,
                                         src->uv_crop_height };
     const int strides[MAX_MB_PLANE] = { src->y_stride, src->uv_stride,
                                         src->uv_stride };
+    // The planes start at the origin of the part of the frame src holds,
+    // which is only set on frames of the same size as the current frame.
+    mi_row -= src->y_origin / MI_SIZE;
+    mi_col -= src->x_origin / MI_SIZE;
     for (i = 0; i < MAX_MB_PLANE; ++i) {
       struct macroblockd_plane *const pd = &xd->plane[i];
       setup_pred_plane(&pd->pre[idx], buffers[i], widths[i], heights[i],
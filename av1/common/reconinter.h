@@ -24,6 +24,17 @@
 extern "C" {
 #endif
 
+// Side of MACROBLOCKD::mc_buf, in samples: a MAX_SB_SIZE block predicted from
+// a reference frame up to twice as large, with the filter taps around it.
+#define MC_BUF_SIDE (2 * MAX_SB_SIZE + MAX_FILTER_TAP)
+// Size of MACROBLOCKD::mc_buf in bytes. The extra row absorbs the reads of the
+// convolve functions past the samples they use.
+#if CONFIG_AOM_HIGHBITDEPTH
+#define MC_BUF_SIZE (MC_BUF_SIDE * (MC_BUF_SIDE + 1) * sizeof(uint16_t))
+#else
+#define MC_BUF_SIZE (MC_BUF_SIDE * (MC_BUF_SIDE + 1))
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+
 #if CONFIG_GLOBAL_MOTION
 static INLINE int is_global_mv_block(const MODE_INFO *mi, int block,
                                      TransformationType type) {
@@ -1399,3 +1399,210 @@ void av1_loop_restoration_frame(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
   loop_restoration_rows(frame, cm, start_mi_row, end_mi_row, components_pattern,
                         rsi, dst);
 }
+
+// Border around the staged copy of a restoration tile row. It covers the
+// lines the filters read around the tile row and the rounding of the Wiener
+// filter blocks up to multiples of 16.
+#define RESTORATION_STAGE_BORDER 32
+
+static void get_rest_plane_size(const AV1_COMMON *cm, int plane, int *width,
+                                int *height) {
+  *width = plane ? ROUND_POWER_OF_TWO(cm->width, cm->subsampling_x)
+                 : cm->width;
+  *height = plane ? ROUND_POWER_OF_TWO(cm->height, cm->subsampling_y)
+                  : cm->height;
+}
+
+int av1_get_rest_tile_row(const AV1_COMMON *cm, int plane, int tile_row,
+                          int *v_start, int *v_end) {
+  int width, height, tile_height, nvtiles;
+  get_rest_plane_size(cm, plane, &width, &height);
+  av1_get_rest_ntiles(width, height, cm->rst_info[plane].restoration_tilesize,
+                      NULL, &tile_height, NULL, &nvtiles);
+  *v_start = tile_row * tile_height;
+  *v_end = tile_row < nvtiles - 1 ? *v_start + tile_height : height;
+  return nvtiles;
+}
+
+size_t av1_loop_restoration_stage_size(const AV1_COMMON *cm) {
+  size_t size = 0;
+  int plane;
+  for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+    int width, height, v_start, v_end, tile_rows;
+    const int nvtiles = av1_get_rest_tile_row(cm, plane, 0, &v_start, &v_end);
+    // The last tile row may be taller or shorter than the others.
+    tile_rows = v_end - v_start;
+    av1_get_rest_tile_row(cm, plane, nvtiles - 1, &v_start, &v_end);
+    tile_rows = AOMMAX(tile_rows, v_end - v_start);
+    get_rest_plane_size(cm, plane, &width, &height);
+    size = AOMMAX(size, (size_t)(tile_rows + 2 * RESTORATION_STAGE_BORDER) *
+                            (width + 2 * RESTORATION_STAGE_BORDER));
+  }
+#if CONFIG_AOM_HIGHBITDEPTH
+  if (cm->use_highbitdepth) size *= sizeof(uint16_t);
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+  return size;
+}
+
+size_t av1_loop_restoration_lines_size(const AV1_COMMON *cm) {
+  size_t size = (WIENER_HALFWIN + WIENER_HALFWIN1) * cm->width;
+#if CONFIG_AOM_HIGHBITDEPTH
+  if (cm->use_highbitdepth) size *= sizeof(uint16_t);
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+  return size;
+}
+
+// Returns the plane buffer as raw bytes with its stride and the size of a
+// pixel in bytes.
+static uint8_t *get_rest_plane_buffer(const YV12_BUFFER_CONFIG *frame,
+                                      const AV1_COMMON *cm, int plane,
+                                      int *stride, int *bytes) {
+  uint8_t *const data = plane == AOM_PLANE_Y
+                            ? frame->y_buffer
+                            : plane == AOM_PLANE_U ? frame->u_buffer
+                                                   : frame->v_buffer;
+  *stride = plane ? frame->uv_stride : frame->y_stride;
+  *bytes = 1;
+#if CONFIG_AOM_HIGHBITDEPTH
+  if (cm->use_highbitdepth) {
+    *bytes = sizeof(uint16_t);
+    return (uint8_t *)CONVERT_TO_SHORTPTR(data);
+  }
+#else
+  (void)cm;
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+  return data;
+}
+
+void av1_loop_restoration_save_lines(const YV12_BUFFER_CONFIG *frame,
+                                     const AV1_COMMON *cm, int plane,
+                                     int tile_row, uint8_t *lines) {
+  int width, height, v_start, v_end, stride, bytes, i;
+  const uint8_t *const data =
+      get_rest_plane_buffer(frame, cm, plane, &stride, &bytes);
+  get_rest_plane_size(cm, plane, &width, &height);
+  av1_get_rest_tile_row(cm, plane, tile_row, &v_start, &v_end);
+  for (i = 0; i < WIENER_HALFWIN + WIENER_HALFWIN1; ++i) {
+    const int y = AOMMIN(v_start - WIENER_HALFWIN + i, height - 1);
+    memcpy(lines + (i * width) * bytes, data + (y * stride) * bytes,
+           width * bytes);
+  }
+}
+
+// Copies the lines of a plane that the filters of a tile row read, extended
+// past the edges of the plane the same way as extend_frame() does, into the
+// staging buffer. The lines above and below the tile row come from the saved
+// lines when they are given.
+static void stage_tile_row(const uint8_t *data, int width, int height,
+                           int stride, int v_start, int v_end,
+                           const uint8_t *above, const uint8_t *below,
+                           uint8_t *stage, int stage_stride, int bytes) {
+  const int border = RESTORATION_STAGE_BORDER;
+  // Lines further below than the filter taps reach only feed pixels outside
+  // of the tile row, so they repeat the last line that is read.
+  const int last = AOMMIN(height, v_end + WIENER_HALFWIN1) - 1;
+  int i, j;
+  for (i = v_start - WIENER_HALFWIN; i < v_end + border; ++i) {
+    const int y = AOMMAX(AOMMIN(i, last), 0);
+    uint8_t *const stage_p = stage + (i * stage_stride) * bytes;
+    const uint8_t *src_p;
+    if (y < v_start)
+      src_p = above + ((y - v_start + WIENER_HALFWIN) * width) * bytes;
+    else if (y >= v_end && below)
+      src_p = below + ((y - v_end + WIENER_HALFWIN) * width) * bytes;
+    else
+      src_p = data + (y * stride) * bytes;
+    memcpy(stage_p, src_p, width * bytes);
+#if CONFIG_AOM_HIGHBITDEPTH
+    if (bytes > 1) {
+      uint16_t *const stage16 = (uint16_t *)stage_p;
+      for (j = 1; j <= border; ++j) {
+        stage16[-j] = stage16[0];
+        stage16[width - 1 + j] = stage16[width - 1];
+      }
+      continue;
+    }
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+    (void)j;
+    memset(stage_p - border, stage_p[0], border);
+    memset(stage_p + width, stage_p[width - 1], border);
+  }
+}
+
+void av1_loop_restoration_tile_row(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
+                                   int plane, int tile_row,
+                                   const uint8_t *above, const uint8_t *below,
+                                   uint8_t *stage_buf, int32_t *tmpbuf) {
+  RestorationInfo *const rsi = &cm->rst_info[plane];
+  const int border = RESTORATION_STAGE_BORDER;
+  int width, height, tile_width, tile_height, nhtiles, nvtiles;
+  int v_start, v_end, stage_stride, stride, bytes;
+  int tile_col;
+  uint8_t *const data =
+      get_rest_plane_buffer(frame, cm, plane, &stride, &bytes);
+  uint8_t *stage;
+  get_rest_plane_size(cm, plane, &width, &height);
+  av1_get_rest_ntiles(width, height, rsi->restoration_tilesize, &tile_width,
+                      &tile_height, &nhtiles, &nvtiles);
+  av1_get_rest_tile_row(cm, plane, tile_row, &v_start, &v_end);
+  stage_stride = width + 2 * border;
+  // Offset the staging buffer so that it is addressed like the plane.
+  stage = stage_buf + ((border - v_start) * stage_stride + border) * bytes;
+  stage_tile_row(data, width, height, stride, v_start, v_end, above, below,
+                 stage, stage_stride, bytes);
+
+  for (tile_col = 0; tile_col < nhtiles; ++tile_col) {
+    const int tile_idx = tile_row * nhtiles + tile_col;
+    int h_start, h_end, tv_start, tv_end;
+    int i, j;
+    av1_get_rest_tile_limits(tile_idx, 0, 0, nhtiles, nvtiles, tile_width,
+                             tile_height, width, height, 0, 0, &h_start, &h_end,
+                             &tv_start, &tv_end);
+    if (rsi->restoration_type[tile_idx] == RESTORE_WIENER) {
+      // Filter in the same blocks as loop_wiener_filter_tile(), keeping only
+      // the part of each block that lies inside the tile.
+      DECLARE_ALIGNED(16, uint16_t, block[MAX_SB_SIZE * MAX_SB_SIZE]);
+      for (i = v_start; i < v_end; i += MAX_SB_SIZE) {
+        for (j = h_start; j < h_end; j += MAX_SB_SIZE) {
+          const int w = AOMMIN(MAX_SB_SIZE, (h_end - j + 15) & ~15);
+          const int h = AOMMIN(MAX_SB_SIZE, (v_end - i + 15) & ~15);
+          const int copy_w = AOMMIN(MAX_SB_SIZE, h_end - j) * bytes;
+          const int copy_h = AOMMIN(MAX_SB_SIZE, v_end - i);
+          const uint8_t *const block8 = (const uint8_t *)block;
+          int r;
+#if CONFIG_AOM_HIGHBITDEPTH
+          if (cm->use_highbitdepth)
+            aom_highbd_convolve8_add_src(
+                CONVERT_TO_BYTEPTR(stage + (i * stage_stride + j) * bytes),
+                stage_stride, CONVERT_TO_BYTEPTR(block), MAX_SB_SIZE,
+                rsi->wiener_info[tile_idx].hfilter, 16,
+                rsi->wiener_info[tile_idx].vfilter, 16, w, h, cm->bit_depth);
+          else
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+            aom_convolve8_add_src(stage + i * stage_stride + j, stage_stride,
+                                  (uint8_t *)block, MAX_SB_SIZE,
+                                  rsi->wiener_info[tile_idx].hfilter, 16,
+                                  rsi->wiener_info[tile_idx].vfilter, 16, w, h);
+          for (r = 0; r < copy_h; ++r)
+            memcpy(data + ((i + r) * stride + j) * bytes,
+                   block8 + r * MAX_SB_SIZE * bytes, copy_w);
+        }
+      }
+    } else if (rsi->restoration_type[tile_idx] == RESTORE_SGRPROJ) {
+#if CONFIG_AOM_HIGHBITDEPTH
+      if (cm->use_highbitdepth)
+        apply_selfguided_restoration_highbd(
+            (uint16_t *)stage + v_start * stage_stride + h_start,
+            h_end - h_start, v_end - v_start, stage_stride, cm->bit_depth,
+            rsi->sgrproj_info[tile_idx].ep, rsi->sgrproj_info[tile_idx].xqd,
+            (uint16_t *)data + v_start * stride + h_start, stride, tmpbuf);
+      else
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+        apply_selfguided_restoration(
+            stage + v_start * stage_stride + h_start, h_end - h_start,
+            v_end - v_start, stage_stride, rsi->sgrproj_info[tile_idx].ep,
+            rsi->sgrproj_info[tile_idx].xqd,
+            data + v_start * stride + h_start, stride, tmpbuf);
+    }
+  }
+}
@@ -227,6 +227,28 @@ void av1_loop_restoration_frame(YV12_BUFFER_CONFIG *frame, struct AV1Common *cm,
                                 RestorationInfo *rsi, int components_pattern,
                                 int partial_frame, YV12_BUFFER_CONFIG *dst);
 void av1_loop_restoration_precal();
+
+// Returns the number of restoration tile rows in a plane and sets
+// [*v_start, *v_end) to the rows of tile row tile_row.
+int av1_get_rest_tile_row(const struct AV1Common *cm, int plane, int tile_row,
+                          int *v_start, int *v_end);
+// Sizes in bytes of the buffers av1_loop_restoration_tile_row() needs.
+size_t av1_loop_restoration_stage_size(const struct AV1Common *cm);
+size_t av1_loop_restoration_lines_size(const struct AV1Common *cm);
+// Saves the unrestored lines of a plane that the tile rows on both sides of
+// the top of tile row tile_row read across it.
+void av1_loop_restoration_save_lines(const YV12_BUFFER_CONFIG *frame,
+                                     const struct AV1Common *cm, int plane,
+                                     int tile_row, uint8_t *lines);
+// Restores tile row tile_row of a plane in place. above holds the lines saved
+// for tile_row, unused for the first tile row. below holds the lines saved for
+// tile_row + 1, or is NULL when the rows below have not been restored yet.
+// tmpbuf holds RESTORATION_TMPBUF_SIZE bytes.
+void av1_loop_restoration_tile_row(YV12_BUFFER_CONFIG *frame,
+                                   struct AV1Common *cm, int plane,
+                                   int tile_row, const uint8_t *above,
+                                   const uint8_t *below, uint8_t *stage_buf,
+                                   int32_t *tmpbuf);
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -9,12 +9,22 @@
  * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
  */
 
+#include <assert.h>
+#include <stddef.h>
+
 #include "./aom_config.h"
 #include "aom_dsp/aom_dsp_common.h"
 #include "aom_mem/aom_mem.h"
 #include "av1/common/entropymode.h"
 #include "av1/common/thread_common.h"
 #include "av1/common/reconinter.h"
+#if CONFIG_CDEF
+#include "av1/common/clpf.h"
+#include "av1/common/dering.h"
+#endif  // CONFIG_CDEF
+#if CONFIG_LOOP_RESTORATION
+#include "av1/common/restoration.h"
+#endif  // CONFIG_LOOP_RESTORATION
 
 #if CONFIG_MULTITHREAD
 static INLINE void mutex_lock(pthread_mutex_t *const mutex) {
@@ -86,9 +96,12 @@ static INLINE void sync_write(AV1LfSync *const lf_sync, int r, int c,
 
 #if !CONFIG_EXT_PARTITION_TYPES
 static INLINE enum lf_path get_loop_filter_path(
-    int y_only, struct macroblockd_plane planes[MAX_MB_PLANE]) {
+    const AV1_COMMON *cm, int y_only,
+    struct macroblockd_plane planes[MAX_MB_PLANE]) {
   if (y_only)
     return LF_PATH_444;
+  else if (cm->lowbd_420)
+    return LF_PATH_LOWBD_420;
   else if (planes[1].subsampling_y == 1 && planes[1].subsampling_x == 1)
     return LF_PATH_420;
   else if (planes[1].subsampling_y == 0 && planes[1].subsampling_x == 0)
@@ -101,7 +114,9 @@ static INLINE void loop_filter_block_plane_ver(
     AV1_COMMON *cm, struct macroblockd_plane planes[MAX_MB_PLANE], int plane,
     MODE_INFO **mi, int mi_row, int mi_col, enum lf_path path,
     LOOP_FILTER_MASK *lfm) {
-  if (plane == 0) {
+  if (path == LF_PATH_LOWBD_420) {
+    av1_filter_block_plane_lowbd_420_ver(cm, &planes[plane], mi_row, lfm);
+  } else if (plane == 0) {
     av1_filter_block_plane_ss00_ver(cm, &planes[0], mi_row, lfm);
   } else {
     switch (path) {
@@ -115,6 +130,7 @@ static INLINE void loop_filter_block_plane_ver(
         av1_filter_block_plane_non420_ver(cm, &planes[plane], mi, mi_row,
                                           mi_col);
         break;
+      default: assert(0); break;
     }
   }
 }
@@ -123,7 +139,9 @@ static INLINE void loop_filter_block_plane_hor(
     AV1_COMMON *cm, struct macroblockd_plane planes[MAX_MB_PLANE], int plane,
     MODE_INFO **mi, int mi_row, int mi_col, enum lf_path path,
     LOOP_FILTER_MASK *lfm) {
-  if (plane == 0) {
+  if (path == LF_PATH_LOWBD_420) {
+    av1_filter_block_plane_lowbd_420_hor(cm, &planes[plane], mi_row, lfm);
+  } else if (plane == 0) {
     av1_filter_block_plane_ss00_hor(cm, &planes[0], mi_row, lfm);
   } else {
     switch (path) {
@@ -137,6 +155,7 @@ static INLINE void loop_filter_block_plane_hor(
         av1_filter_block_plane_non420_hor(cm, &planes[plane], mi, mi_row,
                                           mi_col);
         break;
+      default: assert(0); break;
     }
   }
 }
@@ -148,7 +167,8 @@ static int loop_filter_ver_row_worker(AV1LfSync *const lf_sync,
   const int num_planes = lf_data->y_only ? 1 : MAX_MB_PLANE;
   int mi_row, mi_col;
 #if !CONFIG_EXT_PARTITION_TYPES
-  enum lf_path path = get_loop_filter_path(lf_data->y_only, lf_data->planes);
+  enum lf_path path =
+      get_loop_filter_path(lf_data->cm, lf_data->y_only, lf_data->planes);
 #endif
   for (mi_row = lf_data->start; mi_row < lf_data->stop;
        mi_row += lf_sync->num_workers * lf_data->cm->mib_size) {
@@ -187,7 +207,8 @@ static int loop_filter_hor_row_worker(AV1LfSync *const lf_sync,
       mi_cols_aligned_to_sb(lf_data->cm) >> lf_data->cm->mib_size_log2;
   int mi_row, mi_col;
 #if !CONFIG_EXT_PARTITION_TYPES
-  enum lf_path path = get_loop_filter_path(lf_data->y_only, lf_data->planes);
+  enum lf_path path =
+      get_loop_filter_path(lf_data->cm, lf_data->y_only, lf_data->planes);
 #endif
 
   for (mi_row = lf_data->start; mi_row < lf_data->stop;
@@ -225,16 +246,60 @@ static int loop_filter_hor_row_worker(AV1LfSync *const lf_sync,
   return 1;
 }
 #else  //  CONFIG_PARALLEL_DEBLOCKING
-static int loop_filter_row_worker(AV1LfSync *const lf_sync,
-                                  LFWorkerData *const lf_data) {
+// Filters the superblock row at mi_row, each superblock once the row above
+// is far enough ahead.
+static void loop_filter_sb_row(AV1LfSync *const lf_sync,
+                               LFWorkerData *const lf_data, int mi_row) {
   const int num_planes = lf_data->y_only ? 1 : MAX_MB_PLANE;
   const int sb_cols =
       mi_cols_aligned_to_sb(lf_data->cm) >> lf_data->cm->mib_size_log2;
-  int mi_row, mi_col;
+  MODE_INFO **const mi =
+      lf_data->cm->mi_grid_visible + mi_row * lf_data->cm->mi_stride;
+  int mi_col;
 #if !CONFIG_EXT_PARTITION_TYPES
-  enum lf_path path = get_loop_filter_path(lf_data->y_only, lf_data->planes);
+  enum lf_path path =
+      get_loop_filter_path(lf_data->cm, lf_data->y_only, lf_data->planes);
 #endif  // !CONFIG_EXT_PARTITION_TYPES
 
+  for (mi_col = 0; mi_col < lf_data->cm->mi_cols;
+       mi_col += lf_data->cm->mib_size) {
+    const int r = mi_row >> lf_data->cm->mib_size_log2;
+    const int c = mi_col >> lf_data->cm->mib_size_log2;
+#if !CONFIG_EXT_PARTITION_TYPES
+    LOOP_FILTER_MASK lfm;
+#endif
+    int plane;
+
+    sync_read(lf_sync, r, c);
+
+    av1_setup_dst_planes(lf_data->planes, lf_data->frame_buffer, mi_row,
+                         mi_col);
+#if CONFIG_EXT_PARTITION_TYPES
+    for (plane = 0; plane < num_planes; ++plane) {
+      av1_filter_block_plane_non420_ver(lf_data->cm, &lf_data->planes[plane],
+                                        mi + mi_col, mi_row, mi_col);
+      av1_filter_block_plane_non420_hor(lf_data->cm, &lf_data->planes[plane],
+                                        mi + mi_col, mi_row, mi_col);
+    }
+#else
+    av1_setup_mask(lf_data->cm, mi_row, mi_col, mi + mi_col,
+                   lf_data->cm->mi_stride, &lfm);
+
+    for (plane = 0; plane < num_planes; ++plane) {
+      loop_filter_block_plane_ver(lf_data->cm, lf_data->planes, plane,
+                                  mi + mi_col, mi_row, mi_col, path, &lfm);
+      loop_filter_block_plane_hor(lf_data->cm, lf_data->planes, plane,
+                                  mi + mi_col, mi_row, mi_col, path, &lfm);
+    }
+#endif  // CONFIG_EXT_PARTITION_TYPES
+    sync_write(lf_sync, r, c, sb_cols);
+  }
+}
+
+static int loop_filter_row_worker(AV1LfSync *const lf_sync,
+                                  LFWorkerData *const lf_data) {
+  int mi_row;
+
 #if CONFIG_EXT_PARTITION
   printf(
       "STOPPING: This code has not been modified to work with the "
@@ -244,47 +309,24 @@ static int loop_filter_row_worker(AV1LfSync *const lf_sync,
 
   for (mi_row = lf_data->start; mi_row < lf_data->stop;
        mi_row += lf_sync->num_workers * lf_data->cm->mib_size) {
-    MODE_INFO **const mi =
-        lf_data->cm->mi_grid_visible + mi_row * lf_data->cm->mi_stride;
-
-    for (mi_col = 0; mi_col < lf_data->cm->mi_cols;
-         mi_col += lf_data->cm->mib_size) {
-      const int r = mi_row >> lf_data->cm->mib_size_log2;
-      const int c = mi_col >> lf_data->cm->mib_size_log2;
-#if !CONFIG_EXT_PARTITION_TYPES
-      LOOP_FILTER_MASK lfm;
-#endif
-      int plane;
-
-      sync_read(lf_sync, r, c);
-
-      av1_setup_dst_planes(lf_data->planes, lf_data->frame_buffer, mi_row,
-                           mi_col);
-#if CONFIG_EXT_PARTITION_TYPES
-      for (plane = 0; plane < num_planes; ++plane) {
-        av1_filter_block_plane_non420_ver(lf_data->cm, &lf_data->planes[plane],
-                                          mi + mi_col, mi_row, mi_col);
-        av1_filter_block_plane_non420_hor(lf_data->cm, &lf_data->planes[plane],
-                                          mi + mi_col, mi_row, mi_col);
-      }
-#else
-      av1_setup_mask(lf_data->cm, mi_row, mi_col, mi + mi_col,
-                     lf_data->cm->mi_stride, &lfm);
-
-      for (plane = 0; plane < num_planes; ++plane) {
-        loop_filter_block_plane_ver(lf_data->cm, lf_data->planes, plane,
-                                    mi + mi_col, mi_row, mi_col, path, &lfm);
-        loop_filter_block_plane_hor(lf_data->cm, lf_data->planes, plane,
-                                    mi + mi_col, mi_row, mi_col, path, &lfm);
-      }
-#endif  // CONFIG_EXT_PARTITION_TYPES
-      sync_write(lf_sync, r, c, sb_cols);
-    }
+    loop_filter_sb_row(lf_sync, lf_data, mi_row);
   }
   return 1;
 }
 #endif  //  CONFIG_PARALLEL_DEBLOCKING
 
+// Initializes cur_sb_col to -1 for all SB rows. When only part of the frame
+// is filtered, the SB row above the first filtered row is marked as done so
+// that the first row does not wait for it.
+static void reset_lf_sync(AV1LfSync *const lf_sync, const AV1_COMMON *cm,
+                          int start, int sb_rows) {
+  const int sb_cols = mi_cols_aligned_to_sb(cm) >> cm->mib_size_log2;
+  const int r = start >> cm->mib_size_log2;
+
+  memset(lf_sync->cur_sb_col, -1, sizeof(*lf_sync->cur_sb_col) * sb_rows);
+  if (r > 0) lf_sync->cur_sb_col[r - 1] = sb_cols + lf_sync->sync_range;
+}
+
 static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
                                 struct macroblockd_plane planes[MAX_MB_PLANE],
                                 int start, int stop, int y_only,
@@ -322,8 +364,7 @@ static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
 // then the number of workers used by the loopfilter should be revisited.
 
 #if CONFIG_PARALLEL_DEBLOCKING
-  // Initialize cur_sb_col to -1 for all SB rows.
-  memset(lf_sync->cur_sb_col, -1, sizeof(*lf_sync->cur_sb_col) * sb_rows);
+  reset_lf_sync(lf_sync, cm, start, sb_rows);
 
   // Filter all the vertical edges in the whole frame
   for (i = 0; i < num_workers; ++i) {
@@ -353,7 +394,7 @@ static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
     winterface->sync(&workers[i]);
   }
 
-  memset(lf_sync->cur_sb_col, -1, sizeof(*lf_sync->cur_sb_col) * sb_rows);
+  reset_lf_sync(lf_sync, cm, start, sb_rows);
   // Filter all the horizontal edges in the whole frame
   for (i = 0; i < num_workers; ++i) {
     AVxWorker *const worker = &workers[i];
@@ -382,8 +423,7 @@ static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
     winterface->sync(&workers[i]);
   }
 #else   // CONFIG_PARALLEL_DEBLOCKING
-  // Initialize cur_sb_col to -1 for all SB rows.
-  memset(lf_sync->cur_sb_col, -1, sizeof(*lf_sync->cur_sb_col) * sb_rows);
+  reset_lf_sync(lf_sync, cm, start, sb_rows);
 
   for (i = 0; i < num_workers; ++i) {
     AVxWorker *const worker = &workers[i];
@@ -515,15 +555,543 @@ void av1_loop_filter_dealloc(AV1LfSync *lf_sync) {
   }
 }
 
+// Stages of a superblock row task in the post-filter pipeline. Task r
+// deblocks superblock row r, derings row r - 1, applies the CLPF to row r - 2
+// and restores the restoration tile rows that the CLPF has finished.
+enum {
+  PF_DEBLOCKED = 1,
+  PF_DERING_SAVED,
+  PF_DERINGED,
+  PF_CLPF_SAVED,
+  PF_CLPF_DONE,
+};
+
+static void post_filter_wait(AV1PostFilterSync *const pf_sync, int task,
+                             int stage) {
+#if CONFIG_MULTITHREAD
+  if (task < 0) return;
+  mutex_lock(&pf_sync->mutex_[task]);
+  while (pf_sync->stage[task] < stage)
+    pthread_cond_wait(&pf_sync->cond_[task], &pf_sync->mutex_[task]);
+  pthread_mutex_unlock(&pf_sync->mutex_[task]);
+#else
+  (void)pf_sync;
+  (void)task;
+  (void)stage;
+#endif  // CONFIG_MULTITHREAD
+}
+
+static void post_filter_signal(AV1PostFilterSync *const pf_sync, int task,
+                               int stage) {
+#if CONFIG_MULTITHREAD
+  mutex_lock(&pf_sync->mutex_[task]);
+  pf_sync->stage[task] = stage;
+  pthread_cond_broadcast(&pf_sync->cond_[task]);
+  pthread_mutex_unlock(&pf_sync->mutex_[task]);
+#else
+  pf_sync->stage[task] = stage;
+#endif  // CONFIG_MULTITHREAD
+}
+
+#if CONFIG_CDEF
+// Points lines at the dering lines saved on one side of boundary b.
+static void get_dering_lines(const AV1PostFilterSync *pf_sync, int b,
+                             int below, int16_t *lines[3]) {
+  int pli;
+  for (pli = 0; pli < 3; ++pli)
+    lines[pli] = (int16_t *)(pf_sync->dering_lines +
+                             ((b * 2 + below) * 3 + pli) *
+                                 pf_sync->dering_lines_size);
+}
+
+static uint8_t *get_clpf_lines(const AV1PostFilterSync *pf_sync, int b,
+                               int plane) {
+  return pf_sync->clpf_lines + (b * 3 + plane) * pf_sync->clpf_lines_size;
+}
+
+static unsigned int get_clpf_strength(const AV1_COMMON *cm, int plane) {
+  const int strength = plane == AOM_PLANE_Y
+                           ? cm->clpf_strength_y
+                           : plane == AOM_PLANE_U ? cm->clpf_strength_u
+                                                  : cm->clpf_strength_v;
+  return strength + (strength == 3);
+}
+#endif  // CONFIG_CDEF
+
+#if CONFIG_LOOP_RESTORATION
+// Lines saved for restoration tile row tile_row of a plane.
+static uint8_t *get_rst_lines(const AV1PostFilterSync *pf_sync, int plane,
+                              int tile_row) {
+  return pf_sync->rst_lines +
+         (plane * pf_sync->rst_tile_rows + tile_row) * pf_sync->rst_lines_size;
+}
+
+static void rst_lock(AV1PostFilterSync *const pf_sync) {
+#if CONFIG_MULTITHREAD
+  mutex_lock(pf_sync->rst_mutex_);
+#else
+  (void)pf_sync;
+#endif  // CONFIG_MULTITHREAD
+}
+
+static void rst_unlock(AV1PostFilterSync *const pf_sync) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(pf_sync->rst_mutex_);
+#else
+  (void)pf_sync;
+#endif  // CONFIG_MULTITHREAD
+}
+#endif  // CONFIG_LOOP_RESTORATION
+
+static void output_lock(AV1PostFilterSync *const pf_sync) {
+#if CONFIG_MULTITHREAD
+  mutex_lock(pf_sync->output_mutex_);
+#else
+  (void)pf_sync;
+#endif  // CONFIG_MULTITHREAD
+}
+
+static void output_unlock(AV1PostFilterSync *const pf_sync) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(pf_sync->output_mutex_);
+#else
+  (void)pf_sync;
+#endif  // CONFIG_MULTITHREAD
+}
+
+// Reports the superblock rows that no filter changes anymore. Called with
+// the output mutex held, so the callback sees the rows in order.
+static void report_rows_done(AV1PostFilterSync *const pf_sync,
+                             const AV1_COMMON *const cm, int height) {
+  int rows = pf_sync->filtered_rows;
+#if CONFIG_LOOP_RESTORATION
+  int plane;
+  for (plane = 0; pf_sync->restore && plane < MAX_MB_PLANE; ++plane) {
+    const int ss_y = plane ? cm->subsampling_y : 0;
+    const int tile_row = pf_sync->rst_rows_restored[plane];
+    int v_start, v_end;
+    if (cm->rst_info[plane].frame_restoration_type == RESTORE_NONE) continue;
+    if (tile_row < av1_get_rest_tile_row(cm, plane, tile_row, &v_start, &v_end))
+      rows = AOMMIN(rows, v_start << ss_y);
+  }
+#else
+  (void)cm;
+#endif  // CONFIG_LOOP_RESTORATION
+  rows = rows < height ? rows & ~(MAX_SB_SIZE - 1) : height;
+  if (rows > pf_sync->rows_done) {
+    pf_sync->rows_done_cb(pf_sync->rows_done_priv, pf_sync->rows_done, rows);
+    pf_sync->rows_done = rows;
+  }
+}
+
+static int post_filter_row_worker(AV1PostFilterSync *const pf_sync,
+                                  PostFilterWorkerData *const pf_data) {
+  LFWorkerData *const lf_data = &pf_data->lf_data;
+  AV1_COMMON *const cm = lf_data->cm;
+  YV12_BUFFER_CONFIG *const frame = lf_data->frame_buffer;
+  const int sb_rows = (cm->mi_rows + MAX_MIB_SIZE - 1) / MAX_MIB_SIZE;
+  const int frame_height = frame->y_crop_height;
+  int r;
+
+  for (r = lf_data->start; r < sb_rows + 2; r += pf_sync->active_workers) {
+#if POST_FILTER_DEBLOCK
+    if (pf_sync->deblock && r < sb_rows)
+      loop_filter_sb_row(&pf_sync->lf_sync, lf_data, r * MAX_MIB_SIZE);
+#endif  // POST_FILTER_DEBLOCK
+    post_filter_signal(pf_sync, r, PF_DEBLOCKED);
+
+#if CONFIG_CDEF
+    if (pf_sync->dering) {
+      // Row r is deblocked, except for the lines the next row changes, and
+      // row r - 1 is final: save the lines around their boundary.
+      av1_setup_dst_planes(lf_data->planes, frame, 0, 0);
+      if (r > 0 && r < sb_rows) {
+        int16_t *lines[3];
+        get_dering_lines(pf_sync, r, 0, lines);
+        av1_dering_save_lines(cm, lf_data->planes, r, 0, lines);
+        get_dering_lines(pf_sync, r, 1, lines);
+        av1_dering_save_lines(cm, lf_data->planes, r, 1, lines);
+      }
+      post_filter_signal(pf_sync, r, PF_DERING_SAVED);
+
+      if (r > 0 && r <= sb_rows) {
+        int16_t *above[3], *below[3];
+        post_filter_wait(pf_sync, r - 1, PF_DERING_SAVED);
+        get_dering_lines(pf_sync, r - 1, 0, above);
+        if (r < sb_rows) get_dering_lines(pf_sync, r, 1, below);
+        av1_dering_sb_row(cm, lf_data->planes, cm->dering_level, r - 1, above,
+                          r < sb_rows ? below : NULL);
+      }
+    }
+    post_filter_signal(pf_sync, r, PF_DERINGED);
+
+    if (pf_sync->clpf) {
+      int plane;
+      // Row r - 1 is deringed: save the lines around its top boundary.
+      if (r > 1 && r <= sb_rows) {
+        post_filter_wait(pf_sync, r - 1, PF_DERINGED);
+        for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+          const int ss_y = plane ? cm->subsampling_y : 0;
+          if (!get_clpf_strength(cm, plane)) continue;
+          av1_clpf_save_lines(frame, plane, ((r - 1) * MAX_SB_SIZE) >> ss_y,
+                              get_clpf_lines(pf_sync, r - 1, plane));
+        }
+      }
+      post_filter_signal(pf_sync, r, PF_CLPF_SAVED);
+
+      if (r > 1) {
+        const int c = r - 2;
+        post_filter_wait(pf_sync, r - 1, PF_CLPF_SAVED);
+        for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+          const int ss_y = plane ? cm->subsampling_y : 0;
+          const int height =
+              plane ? frame->uv_crop_height : frame->y_crop_height;
+          const unsigned int strength = get_clpf_strength(cm, plane);
+          if (!strength) continue;
+          av1_clpf_rows(
+              frame, cm, plane == AOM_PLANE_Y && cm->clpf_size != CLPF_NOSIZE,
+              strength, plane == AOM_PLANE_Y ? 4 + cm->clpf_size : 4, plane,
+              (c * MAX_SB_SIZE) >> ss_y,
+              AOMMIN(((c + 1) * MAX_SB_SIZE) >> ss_y, height),
+              c > 0 ? get_clpf_lines(pf_sync, c, plane) : NULL,
+              c + 1 < sb_rows ? get_clpf_lines(pf_sync, c + 1, plane) : NULL,
+              pf_data->clpf_buf);
+        }
+      }
+    }
+#endif  // CONFIG_CDEF
+    // The CLPF stage of a task finishes after the ones before it, so that the
+    // rows above limit below are final once the previous task is done.
+    post_filter_wait(pf_sync, r - 1, PF_CLPF_DONE);
+    post_filter_signal(pf_sync, r, PF_CLPF_DONE);
+
+    if (pf_sync->rows_done_cb && r > 0) {
+      output_lock(pf_sync);
+      pf_sync->filtered_rows =
+          AOMMAX(pf_sync->filtered_rows,
+                 AOMMIN((r - 1) * MAX_SB_SIZE, frame_height));
+      report_rows_done(pf_sync, cm, frame_height);
+      output_unlock(pf_sync);
+    }
+
+#if CONFIG_LOOP_RESTORATION
+    if (pf_sync->restore) {
+      // The rows above limit have been through all the other filters. Each
+      // restoration tile row is claimed by one task, which saves the lines
+      // of the next tile row before restoring its own, so that the tile rows
+      // are restored in parallel.
+      const int done = r - 2 >= sb_rows - 1;
+      const int limit = (r - 1) * MAX_SB_SIZE;
+      int plane;
+      for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+        const int ss_y = plane ? cm->subsampling_y : 0;
+        if (cm->rst_info[plane].frame_restoration_type == RESTORE_NONE)
+          continue;
+        for (;;) {
+          int tile_row, nvtiles, v_start, v_end;
+          rst_lock(pf_sync);
+          tile_row = pf_sync->rst_tile_row[plane];
+          nvtiles =
+              av1_get_rest_tile_row(cm, plane, tile_row, &v_start, &v_end);
+          if (tile_row >= nvtiles ||
+              (!done && v_end + WIENER_HALFWIN1 > limit >> ss_y)) {
+            rst_unlock(pf_sync);
+            break;
+          }
+          if (tile_row + 1 < nvtiles)
+            av1_loop_restoration_save_lines(
+                frame, cm, plane, tile_row + 1,
+                get_rst_lines(pf_sync, plane, tile_row + 1));
+          ++pf_sync->rst_tile_row[plane];
+          rst_unlock(pf_sync);
+          av1_loop_restoration_tile_row(
+              frame, cm, plane, tile_row,
+              tile_row > 0 ? get_rst_lines(pf_sync, plane, tile_row) : NULL,
+              tile_row + 1 < nvtiles
+                  ? get_rst_lines(pf_sync, plane, tile_row + 1)
+                  : NULL,
+              pf_data->rst_stage, (int32_t *)pf_data->rst_tmpbuf);
+
+          if (pf_sync->rows_done_cb) {
+            uint8_t *const restored =
+                pf_sync->rst_restored + plane * pf_sync->rst_tile_rows;
+            int *const rows_restored = &pf_sync->rst_rows_restored[plane];
+            output_lock(pf_sync);
+            restored[tile_row] = 1;
+            while (*rows_restored < nvtiles && restored[*rows_restored])
+              ++*rows_restored;
+            report_rows_done(pf_sync, cm, frame_height);
+            output_unlock(pf_sync);
+          }
+        }
+      }
+    }
+#endif  // CONFIG_LOOP_RESTORATION
+  }
+  return 1;
+}
+
+// Grows a buffer of the post-filter pipeline to at least size bytes.
+static void post_filter_grow(AV1_COMMON *cm, uint8_t **buf, size_t *allocated,
+                             size_t size) {
+  if (size <= *allocated) return;
+  aom_free(*buf);
+  *allocated = 0;
+  CHECK_MEM_ERROR(cm, *buf, (uint8_t *)aom_memalign(32, size));
+  *allocated = size;
+}
+
+static void post_filter_alloc(AV1PostFilterSync *pf_sync, AV1_COMMON *cm,
+                              int rows, int num_workers) {
+  pf_sync->rows = rows;
+#if CONFIG_MULTITHREAD
+  {
+    int i;
+
+    CHECK_MEM_ERROR(cm, pf_sync->mutex_,
+                    aom_malloc(sizeof(*pf_sync->mutex_) * rows));
+    if (pf_sync->mutex_) {
+      for (i = 0; i < rows; ++i) {
+        pthread_mutex_init(&pf_sync->mutex_[i], NULL);
+      }
+    }
+
+    CHECK_MEM_ERROR(cm, pf_sync->cond_,
+                    aom_malloc(sizeof(*pf_sync->cond_) * rows));
+    if (pf_sync->cond_) {
+      for (i = 0; i < rows; ++i) {
+        pthread_cond_init(&pf_sync->cond_[i], NULL);
+      }
+    }
+
+    CHECK_MEM_ERROR(cm, pf_sync->rst_mutex_,
+                    aom_malloc(sizeof(*pf_sync->rst_mutex_)));
+    if (pf_sync->rst_mutex_) pthread_mutex_init(pf_sync->rst_mutex_, NULL);
+
+    CHECK_MEM_ERROR(cm, pf_sync->output_mutex_,
+                    aom_malloc(sizeof(*pf_sync->output_mutex_)));
+    if (pf_sync->output_mutex_)
+      pthread_mutex_init(pf_sync->output_mutex_, NULL);
+  }
+#endif  // CONFIG_MULTITHREAD
+
+  CHECK_MEM_ERROR(cm, pf_sync->stage,
+                  aom_malloc(sizeof(*pf_sync->stage) * rows));
+
+  CHECK_MEM_ERROR(cm, pf_sync->pfdata,
+                  aom_calloc(num_workers, sizeof(*pf_sync->pfdata)));
+  pf_sync->num_workers = num_workers;
+}
+
+void av1_post_filter_dealloc(AV1PostFilterSync *pf_sync) {
+  if (pf_sync != NULL) {
+    int i;
+#if CONFIG_MULTITHREAD
+    if (pf_sync->mutex_ != NULL) {
+      for (i = 0; i < pf_sync->rows; ++i) {
+        pthread_mutex_destroy(&pf_sync->mutex_[i]);
+      }
+      aom_free(pf_sync->mutex_);
+    }
+    if (pf_sync->cond_ != NULL) {
+      for (i = 0; i < pf_sync->rows; ++i) {
+        pthread_cond_destroy(&pf_sync->cond_[i]);
+      }
+      aom_free(pf_sync->cond_);
+    }
+    if (pf_sync->rst_mutex_ != NULL) {
+      pthread_mutex_destroy(pf_sync->rst_mutex_);
+      aom_free(pf_sync->rst_mutex_);
+    }
+    if (pf_sync->output_mutex_ != NULL) {
+      pthread_mutex_destroy(pf_sync->output_mutex_);
+      aom_free(pf_sync->output_mutex_);
+    }
+#endif  // CONFIG_MULTITHREAD
+    aom_free(pf_sync->stage);
+    if (pf_sync->pfdata != NULL) {
+      for (i = 0; i < pf_sync->num_workers; ++i) {
+        aom_free(pf_sync->pfdata[i].clpf_buf);
+        aom_free(pf_sync->pfdata[i].rst_stage);
+        aom_free(pf_sync->pfdata[i].rst_tmpbuf);
+      }
+      aom_free(pf_sync->pfdata);
+    }
+    aom_free(pf_sync->dering_lines);
+    aom_free(pf_sync->clpf_lines);
+    aom_free(pf_sync->rst_lines);
+    aom_free(pf_sync->rst_restored);
+    av1_loop_filter_dealloc(&pf_sync->lf_sync);
+    av1_zero(*pf_sync);
+  }
+}
+
+void av1_post_filter_frame_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
+                              struct macroblockd_plane planes[MAX_MB_PLANE],
+                              int deblock, AVxWorker *workers, int num_workers,
+                              AV1PostFilterSync *pf_sync,
+                              av1_rows_done_cb_fn_t rows_done_cb,
+                              void *rows_done_priv) {
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  const int sb_rows = (cm->mi_rows + MAX_MIB_SIZE - 1) / MAX_MIB_SIZE;
+  size_t worker_buf_size[3] = { 0, 0, 0 };
+  int i;
+
+#if !CONFIG_MULTITHREAD
+  // The tasks only run in order on a single thread.
+  num_workers = 1;
+#endif  // !CONFIG_MULTITHREAD
+
+  if (sb_rows + 2 > pf_sync->rows || num_workers > pf_sync->num_workers) {
+    av1_post_filter_dealloc(pf_sync);
+    post_filter_alloc(pf_sync, cm, sb_rows + 2, num_workers);
+  }
+  pf_sync->active_workers = num_workers;
+
+#if POST_FILTER_DEBLOCK
+  pf_sync->deblock = deblock && cm->lf.filter_level;
+  if (pf_sync->deblock) {
+    AV1LfSync *const lf_sync = &pf_sync->lf_sync;
+    assert(cm->mib_size == MAX_MIB_SIZE);
+    if (!lf_sync->sync_range || sb_rows != lf_sync->rows) {
+      av1_loop_filter_dealloc(lf_sync);
+      av1_loop_filter_alloc(lf_sync, cm, sb_rows, cm->width, 1);
+    }
+    reset_lf_sync(lf_sync, cm, 0, sb_rows);
+  }
+#else
+  assert(!deblock);
+  pf_sync->deblock = 0;
+#endif  // POST_FILTER_DEBLOCK
+
+#if CONFIG_CDEF
+  pf_sync->dering = cm->dering_level != 0;
+  pf_sync->clpf =
+      cm->clpf_strength_y || cm->clpf_strength_u || cm->clpf_strength_v;
+  if (pf_sync->dering) {
+    pf_sync->dering_lines_size =
+        sizeof(int16_t) * OD_FILT_VBORDER * av1_dering_line_stride(cm);
+    post_filter_grow(cm, &pf_sync->dering_lines, &pf_sync->dering_alloc,
+                     sb_rows * 2 * 3 * pf_sync->dering_lines_size);
+  }
+  if (pf_sync->clpf) {
+    pf_sync->clpf_lines_size = av1_clpf_lines_size(frame, AOM_PLANE_Y);
+    post_filter_grow(cm, &pf_sync->clpf_lines, &pf_sync->clpf_alloc,
+                     sb_rows * 3 * pf_sync->clpf_lines_size);
+    worker_buf_size[0] = av1_clpf_rows_buf_size(frame);
+  }
+#else
+  pf_sync->dering = pf_sync->clpf = 0;
+#endif  // CONFIG_CDEF
+
+#if CONFIG_LOOP_RESTORATION
+  pf_sync->restore = 0;
+  pf_sync->rst_tile_rows = 0;
+  for (i = 0; i < MAX_MB_PLANE; ++i) {
+    int v_start, v_end;
+    if (cm->rst_info[i].frame_restoration_type == RESTORE_NONE) continue;
+    pf_sync->restore = 1;
+    pf_sync->rst_tile_rows =
+        AOMMAX(pf_sync->rst_tile_rows,
+               av1_get_rest_tile_row(cm, i, 0, &v_start, &v_end));
+  }
+  memset(pf_sync->rst_tile_row, 0, sizeof(pf_sync->rst_tile_row));
+  if (pf_sync->restore) {
+    pf_sync->rst_lines_size = av1_loop_restoration_lines_size(cm);
+    post_filter_grow(cm, &pf_sync->rst_lines, &pf_sync->rst_lines_alloc,
+                     MAX_MB_PLANE * pf_sync->rst_tile_rows *
+                         pf_sync->rst_lines_size);
+    worker_buf_size[1] = av1_loop_restoration_stage_size(cm);
+    worker_buf_size[2] = RESTORATION_TMPBUF_SIZE;
+    if (rows_done_cb) {
+      const size_t size = MAX_MB_PLANE * pf_sync->rst_tile_rows;
+      post_filter_grow(cm, &pf_sync->rst_restored,
+                       &pf_sync->rst_restored_alloc, size);
+      memset(pf_sync->rst_restored, 0, size);
+    }
+  }
+  memset(pf_sync->rst_rows_restored, 0, sizeof(pf_sync->rst_rows_restored));
+#else
+  pf_sync->restore = 0;
+#endif  // CONFIG_LOOP_RESTORATION
+
+  memset(pf_sync->stage, 0, sizeof(*pf_sync->stage) * (sb_rows + 2));
+  pf_sync->rows_done_cb = rows_done_cb;
+  pf_sync->rows_done_priv = rows_done_priv;
+  pf_sync->rows_done = 0;
+  pf_sync->filtered_rows = 0;
+
+  for (i = 0; i < num_workers; ++i) {
+    PostFilterWorkerData *const pf_data = &pf_sync->pfdata[i];
+    post_filter_grow(cm, &pf_data->clpf_buf, &pf_data->clpf_buf_size,
+                     worker_buf_size[0]);
+    post_filter_grow(cm, &pf_data->rst_stage, &pf_data->rst_stage_size,
+                     worker_buf_size[1]);
+    post_filter_grow(cm, &pf_data->rst_tmpbuf, &pf_data->rst_tmpbuf_size,
+                     worker_buf_size[2]);
+  }
+
+  for (i = 0; i < num_workers; ++i) {
+    AVxWorker *const worker = &workers[i];
+    PostFilterWorkerData *const pf_data = &pf_sync->pfdata[i];
+
+    worker->hook = (AVxWorkerHook)post_filter_row_worker;
+    worker->data1 = pf_sync;
+    worker->data2 = pf_data;
+
+    av1_loop_filter_data_reset(&pf_data->lf_data, frame, cm, planes);
+    pf_data->lf_data.start = i;
+
+    if (i == num_workers - 1) {
+      winterface->execute(worker);
+    } else {
+      winterface->launch(worker);
+    }
+  }
+
+  for (i = 0; i < num_workers; ++i) {
+    winterface->sync(&workers[i]);
+  }
+}
+
+static void accumulate_counts(unsigned int *acc, const unsigned int *cnt,
+                              size_t n_counts) {
+  size_t i;
+  for (i = 0; i < n_counts; i++) acc[i] += cnt[i];
+}
+
 // Accumulate frame counts. FRAME_COUNTS consist solely of 'unsigned int'
-// members, so we treat it as an array, and sum over the whole length.
+// members, so we treat it as an array, and sum over the whole length. The
+// coef and eob_branch counts make up most of it, so only the groups that were
+// coded are summed.
 void av1_accumulate_frame_counts(FRAME_COUNTS *acc_counts,
                                  FRAME_COUNTS *counts) {
   unsigned int *const acc = (unsigned int *)acc_counts;
   const unsigned int *const cnt = (unsigned int *)counts;
 
-  const unsigned int n_counts = sizeof(FRAME_COUNTS) / sizeof(unsigned int);
-  unsigned int i;
-
-  for (i = 0; i < n_counts; i++) acc[i] += cnt[i];
+  const size_t n_counts = sizeof(FRAME_COUNTS) / sizeof(unsigned int);
+  const size_t coef_begin = offsetof(FRAME_COUNTS, coef) / sizeof(unsigned int);
+  const size_t coef_end =
+      (offsetof(FRAME_COUNTS, eob_branch) + sizeof(counts->eob_branch)) /
+      sizeof(unsigned int);
+  int t, i, j;
+
+  assert(offsetof(FRAME_COUNTS, eob_branch) ==
+         offsetof(FRAME_COUNTS, coef) + sizeof(counts->coef));
+  accumulate_counts(acc, cnt, coef_begin);
+  for (t = 0; t < TX_SIZES; t++) {
+    for (i = 0; i < PLANE_TYPES; i++) {
+      for (j = 0; j < REF_TYPES; j++) {
+        if (counts->coef_blocks[t][i][j] == 0) continue;
+        accumulate_counts(&acc_counts->coef[t][i][j][0][0][0],
+                          &counts->coef[t][i][j][0][0][0],
+                          sizeof(counts->coef[t][i][j]) / sizeof(unsigned int));
+        accumulate_counts(
+            &acc_counts->eob_branch[t][i][j][0][0],
+            &counts->eob_branch[t][i][j][0][0],
+            sizeof(counts->eob_branch[t][i][j]) / sizeof(unsigned int));
+      }
+    }
+  }
+  accumulate_counts(acc + coef_end, cnt + coef_end, n_counts - coef_end);
 }
@@ -54,6 +54,109 @@ void av1_loop_filter_frame_mt(YV12_BUFFER_CONFIG *frame, struct AV1Common *cm,
                               int partial_frame, AVxWorker *workers,
                               int num_workers, AV1LfSync *lf_sync);
 
+// The superblock row post-filter pipeline also deblocks the rows when the
+// row-based loop filter filters each superblock completely in one pass, the
+// same way as the frame-based one.
+#define POST_FILTER_DEBLOCK                                   \
+  (!CONFIG_VAR_TX && !CONFIG_PARALLEL_DEBLOCKING &&           \
+   !CONFIG_EXT_PARTITION && !CONFIG_EXT_PARTITION_TYPES &&    \
+   !CONFIG_CB4X4)
+
+// Reports that the luma rows [row_start, row_end) of a frame are final.
+typedef void (*av1_rows_done_cb_fn_t)(void *priv, int row_start, int row_end);
+
+// Superblock row post-filter pipeline per-thread data
+typedef struct PostFilterWorkerData {
+  LFWorkerData lf_data;
+  // Scratch buffers of the CLPF and loop restoration stages and their sizes
+  // in bytes.
+  uint8_t *clpf_buf;
+  uint8_t *rst_stage;
+  uint8_t *rst_tmpbuf;
+  size_t clpf_buf_size;
+  size_t rst_stage_size;
+  size_t rst_tmpbuf_size;
+} PostFilterWorkerData;
+
+// Superblock row post-filter pipeline synchronization
+typedef struct AV1PostFilterSync {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t *mutex_;
+  pthread_cond_t *cond_;
+#endif
+  // Last post-filter stage finished by each superblock row task.
+  int *stage;
+  int rows;
+
+  // Column synchronization of the deblocking stage.
+  AV1LfSync lf_sync;
+  // Post filters applied to the current frame.
+  int deblock;
+  int dering;
+  int clpf;
+  int restore;
+
+  // Unfiltered lines on both sides of each superblock row boundary, saved
+  // before the deringing and the CLPF of the rows next to it.
+  uint8_t *dering_lines;
+  uint8_t *clpf_lines;
+  size_t dering_lines_size;
+  size_t clpf_lines_size;
+  // Unrestored lines around the top of each restoration tile row, saved
+  // before the tile row above it is restored, rst_tile_rows per plane.
+  uint8_t *rst_lines;
+  size_t rst_lines_size;
+  int rst_tile_rows;
+  // Next restoration tile row of each plane to restore.
+  int rst_tile_row[MAX_MB_PLANE];
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t *rst_mutex_;
+#endif
+
+  // Allocated sizes of the line buffers, in bytes.
+  size_t dering_alloc;
+  size_t clpf_alloc;
+  size_t rst_lines_alloc;
+
+  // Callback told of the superblock rows that are final, in order, and the
+  // luma rows reported to it so far.
+  av1_rows_done_cb_fn_t rows_done_cb;
+  void *rows_done_priv;
+  int rows_done;
+  // Luma rows that only the loop restoration may still change.
+  int filtered_rows;
+  // Restored flag of each restoration tile row, rst_tile_rows per plane, and
+  // the number of tile rows of each plane restored without a gap.
+  uint8_t *rst_restored;
+  size_t rst_restored_alloc;
+  int rst_rows_restored[MAX_MB_PLANE];
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t *output_mutex_;
+#endif
+
+  PostFilterWorkerData *pfdata;
+  int num_workers;
+  // Number of workers running the current frame.
+  int active_workers;
+} AV1PostFilterSync;
+
+// Deallocate the post-filter pipeline synchronization and buffers.
+void av1_post_filter_dealloc(AV1PostFilterSync *pf_sync);
+
+// Multi-threaded post filters using the tile threads. Each thread takes
+// every num_workers-th superblock row, runs the deringing and the CLPF of the
+// rows above it as soon as the rows they read are ready, and deblocks it
+// first when deblock is set. The restoration tile rows are restored in
+// parallel by the threads as soon as the CLPF has finished them. When
+// rows_done_cb is not NULL, it is called from the threads with the rows of
+// the frame that are final, in order and one call at a time.
+void av1_post_filter_frame_mt(YV12_BUFFER_CONFIG *frame, struct AV1Common *cm,
+                              struct macroblockd_plane planes[MAX_MB_PLANE],
+                              int deblock, AVxWorker *workers, int num_workers,
+                              AV1PostFilterSync *pf_sync,
+                              av1_rows_done_cb_fn_t rows_done_cb,
+                              void *rows_done_priv);
+
 void av1_accumulate_frame_counts(struct FRAME_COUNTS *acc_counts,
                                  struct FRAME_COUNTS *counts);
 
@@ -62,6 +62,17 @@
 #define MAX_AV1_HEADER_SIZE 80
 #define ACCT_STR __func__
 
+// The row pipelined decoder needs the parse stage of a block to be independent
+// of its reconstruction, which does not hold for the tools below.
+#define DEC_ROW_PIPELINE                                         \
+  (!CONFIG_PVQ && !CONFIG_SUPERTX && !CONFIG_COEF_INTERLEAVE && \
+   !(CONFIG_MOTION_VAR && CONFIG_NCOBMC))
+
+// Worst case storage of one superblock in the parse stage: every coefficient
+// of the three planes plus a (eob, max_scan_line) header per 2x2 transform.
+#define DEC_SB_COEFFS (3 * MAX_SB_SQUARE + 2 * 3 * MAX_SB_SQUARE / 4)
+#define DEC_SB_COLOR_MAPS (2 * MAX_SB_SQUARE)
+
 #if CONFIG_PVQ
 #include "av1/common/partition.h"
 #include "av1/common/pvq.h"
@@ -344,6 +355,57 @@ static void inverse_transform_block(MACROBLOCKD *xd, int plane,
   memset(dqcoeff, 0, (scan_line + 1) * sizeof(dqcoeff[0]));
 }
 
+// The functions below take the block apart in the two stages of the row
+// pipelined decoder. With rd == NULL the block is parsed and reconstructed at
+// once. Otherwise a non-NULL reader only parses the block and appends its
+// coefficients to rd, and a NULL reader reconstructs it from what rd holds.
+#if !CONFIG_PVQ || (CONFIG_VAR_TX && !CONFIG_COEF_INTERLEAVE)
+static int decode_tx_coeffs(AV1_COMMON *cm, MACROBLOCKD *const xd,
+                            aom_reader *const r, DecSbRowData *const rd,
+                            int plane, int row, int col, TX_SIZE tx_size,
+                            TX_TYPE tx_type, int is_inter, int segment_id,
+                            int16_t *max_scan_line) {
+  struct macroblockd_plane *const pd = &xd->plane[plane];
+  int eob;
+
+  if (r == NULL) {
+    const tran_low_t *const coeffs = rd->coeffs + rd->coeffs_pos;
+    eob = coeffs[0];
+    *max_scan_line = coeffs[1];
+    rd->coeffs_pos += 2;
+    if (eob) {
+      memcpy(pd->dqcoeff, coeffs + 2,
+             (*max_scan_line + 1) * sizeof(pd->dqcoeff[0]));
+      rd->coeffs_pos += *max_scan_line + 1;
+    }
+    return eob;
+  }
+
+  eob = av1_decode_block_tokens(xd, plane,
+                                get_scan(cm, tx_size, tx_type, is_inter), col,
+                                row, tx_size, tx_type, max_scan_line, r,
+                                segment_id);
+#if CONFIG_ADAPT_SCAN
+  if (xd->counts)
+    av1_update_scan_count_facade(cm, xd->counts, tx_size, tx_type, pd->dqcoeff,
+                                 eob);
+#endif
+  if (rd != NULL) {
+    tran_low_t *const coeffs = rd->coeffs + rd->coeffs_size;
+    coeffs[0] = eob;
+    coeffs[1] = *max_scan_line;
+    rd->coeffs_size += 2;
+    if (eob) {
+      const int count = *max_scan_line + 1;
+      memcpy(coeffs + 2, pd->dqcoeff, count * sizeof(pd->dqcoeff[0]));
+      memset(pd->dqcoeff, 0, count * sizeof(pd->dqcoeff[0]));
+      rd->coeffs_size += count;
+    }
+  }
+  return eob;
+}
+#endif  // !CONFIG_PVQ || (CONFIG_VAR_TX && !CONFIG_COEF_INTERLEAVE)
+
 #if CONFIG_PVQ
 static int av1_pvq_decode_helper(od_dec_ctx *dec, tran_low_t *ref_coeff,
                                  tran_low_t *dqcoeff, int16_t *quant, int pli,
@@ -497,14 +559,17 @@ static int av1_pvq_decode_helper2(AV1_COMMON *cm, MACROBLOCKD *const xd,
 
 static void predict_and_reconstruct_intra_block(
     AV1_COMMON *cm, MACROBLOCKD *const xd, aom_reader *const r,
-    MB_MODE_INFO *const mbmi, int plane, int row, int col, TX_SIZE tx_size) {
+    DecSbRowData *const rd, MB_MODE_INFO *const mbmi, int plane, int row,
+    int col, TX_SIZE tx_size) {
   struct macroblockd_plane *const pd = &xd->plane[plane];
   PREDICTION_MODE mode = (plane == 0) ? mbmi->mode : mbmi->uv_mode;
   PLANE_TYPE plane_type = get_plane_type(plane);
   uint8_t *dst;
   const int block_idx = (row << 1) + col;
+  const int recon = rd == NULL || r == NULL;
 #if CONFIG_PVQ
   (void)r;
+  (void)rd;
 #endif
   dst = &pd->dst.buf[(row * pd->dst.stride + col) << tx_size_wide_log2[0]];
 
@@ -512,24 +577,20 @@ static void predict_and_reconstruct_intra_block(
   if (mbmi->sb_type < BLOCK_8X8)
     if (plane == 0) mode = xd->mi[0]->bmi[block_idx].as_mode;
 #endif
-  av1_predict_intra_block(xd, pd->width, pd->height, txsize_to_bsize[tx_size],
-                          mode, dst, pd->dst.stride, dst, pd->dst.stride, col,
-                          row, plane);
+  if (recon)
+    av1_predict_intra_block(xd, pd->width, pd->height,
+                            txsize_to_bsize[tx_size], mode, dst,
+                            pd->dst.stride, dst, pd->dst.stride, col, row,
+                            plane);
 
   if (!mbmi->skip) {
     TX_TYPE tx_type = get_tx_type(plane_type, xd, block_idx, tx_size);
 #if !CONFIG_PVQ
-    const SCAN_ORDER *scan_order = get_scan(cm, tx_size, tx_type, 0);
     int16_t max_scan_line = 0;
     const int eob =
-        av1_decode_block_tokens(xd, plane, scan_order, col, row, tx_size,
-                                tx_type, &max_scan_line, r, mbmi->segment_id);
-#if CONFIG_ADAPT_SCAN
-    if (xd->counts)
-      av1_update_scan_count_facade(cm, xd->counts, tx_size, tx_type,
-                                   pd->dqcoeff, eob);
-#endif
-    if (eob)
+        decode_tx_coeffs(cm, xd, r, rd, plane, row, col, tx_size, tx_type, 0,
+                         mbmi->segment_id, &max_scan_line);
+    if (eob && recon)
       inverse_transform_block(xd, plane, tx_type, tx_size, dst, pd->dst.stride,
                               max_scan_line, eob);
 #else
@@ -540,9 +601,10 @@ static void predict_and_reconstruct_intra_block(
 
 #if CONFIG_VAR_TX && !CONFIG_COEF_INTERLEAVE
 static void decode_reconstruct_tx(AV1_COMMON *cm, MACROBLOCKD *const xd,
-                                  aom_reader *r, MB_MODE_INFO *const mbmi,
-                                  int plane, BLOCK_SIZE plane_bsize,
-                                  int blk_row, int blk_col, TX_SIZE tx_size,
+                                  aom_reader *r, DecSbRowData *const rd,
+                                  MB_MODE_INFO *const mbmi, int plane,
+                                  BLOCK_SIZE plane_bsize, int blk_row,
+                                  int blk_col, TX_SIZE tx_size,
                                   int *eob_total) {
   const struct macroblockd_plane *const pd = &xd->plane[plane];
   const BLOCK_SIZE bsize = txsize_to_bsize[tx_size];
@@ -561,20 +623,16 @@ static void decode_reconstruct_tx(AV1_COMMON *cm, MACROBLOCKD *const xd,
     PLANE_TYPE plane_type = get_plane_type(plane);
     int block_idx = (blk_row << 1) + blk_col;
     TX_TYPE tx_type = get_tx_type(plane_type, xd, block_idx, plane_tx_size);
-    const SCAN_ORDER *sc = get_scan(cm, plane_tx_size, tx_type, 1);
     int16_t max_scan_line = 0;
     const int eob =
-        av1_decode_block_tokens(xd, plane, sc, blk_col, blk_row, plane_tx_size,
-                                tx_type, &max_scan_line, r, mbmi->segment_id);
-#if CONFIG_ADAPT_SCAN
-    if (xd->counts)
-      av1_update_scan_count_facade(cm, xd->counts, tx_size, tx_type,
-                                   pd->dqcoeff, eob);
-#endif
-    inverse_transform_block(xd, plane, tx_type, plane_tx_size,
-                            &pd->dst.buf[(blk_row * pd->dst.stride + blk_col)
-                                         << tx_size_wide_log2[0]],
-                            pd->dst.stride, max_scan_line, eob);
+        decode_tx_coeffs(cm, xd, r, rd, plane, blk_row, blk_col, plane_tx_size,
+                         tx_type, 1, mbmi->segment_id, &max_scan_line);
+    if (rd == NULL || r == NULL)
+      inverse_transform_block(
+          xd, plane, tx_type, plane_tx_size,
+          &pd->dst.buf[(blk_row * pd->dst.stride + blk_col)
+                       << tx_size_wide_log2[0]],
+          pd->dst.stride, max_scan_line, eob);
     *eob_total += eob;
   } else {
     const TX_SIZE sub_txs = sub_tx_size_map[tx_size];
@@ -589,7 +647,7 @@ static void decode_reconstruct_tx(AV1_COMMON *cm, MACROBLOCKD *const xd,
 
       if (offsetr >= max_blocks_high || offsetc >= max_blocks_wide) continue;
 
-      decode_reconstruct_tx(cm, xd, r, mbmi, plane, plane_bsize, offsetr,
+      decode_reconstruct_tx(cm, xd, r, rd, mbmi, plane, plane_bsize, offsetr,
                             offsetc, sub_txs, eob_total);
     }
   }
@@ -599,8 +657,8 @@ static void decode_reconstruct_tx(AV1_COMMON *cm, MACROBLOCKD *const xd,
 #if !CONFIG_VAR_TX || CONFIG_SUPERTX || CONFIG_COEF_INTERLEAVE || \
     (!CONFIG_VAR_TX && CONFIG_EXT_TX && CONFIG_RECT_TX)
 static int reconstruct_inter_block(AV1_COMMON *cm, MACROBLOCKD *const xd,
-                                   aom_reader *const r, int segment_id,
-                                   int plane, int row, int col,
+                                   aom_reader *const r, DecSbRowData *const rd,
+                                   int segment_id, int plane, int row, int col,
                                    TX_SIZE tx_size) {
   PLANE_TYPE plane_type = get_plane_type(plane);
   int block_idx = (row << 1) + col;
@@ -608,25 +666,19 @@ static int reconstruct_inter_block(AV1_COMMON *cm, MACROBLOCKD *const xd,
 #if CONFIG_PVQ
   int eob;
   (void)r;
+  (void)rd;
   (void)segment_id;
 #else
   struct macroblockd_plane *const pd = &xd->plane[plane];
 #endif
 
 #if !CONFIG_PVQ
-  const SCAN_ORDER *scan_order = get_scan(cm, tx_size, tx_type, 1);
   int16_t max_scan_line = 0;
-  const int eob =
-      av1_decode_block_tokens(xd, plane, scan_order, col, row, tx_size, tx_type,
-                              &max_scan_line, r, segment_id);
+  const int eob = decode_tx_coeffs(cm, xd, r, rd, plane, row, col, tx_size,
+                                   tx_type, 1, segment_id, &max_scan_line);
   uint8_t *dst =
       &pd->dst.buf[(row * pd->dst.stride + col) << tx_size_wide_log2[0]];
-#if CONFIG_ADAPT_SCAN
-  if (xd->counts)
-    av1_update_scan_count_facade(cm, xd->counts, tx_size, tx_type, pd->dqcoeff,
-                                 eob);
-#endif
-  if (eob)
+  if (eob && (rd == NULL || r == NULL))
     inverse_transform_block(xd, plane, tx_type, tx_size, dst, pd->dst.stride,
                             max_scan_line, eob);
 #else
@@ -675,6 +727,29 @@ static void set_offsets(AV1_COMMON *const cm, MACROBLOCKD *const xd,
   av1_setup_dst_planes(xd->plane, get_frame_new_buffer(cm), mi_row, mi_col);
 }
 
+// Same as set_offsets() for a block whose mode info has already been parsed,
+// leaving the mode info grid and the entropy contexts untouched.
+static void set_recon_offsets(AV1_COMMON *const cm, MACROBLOCKD *const xd,
+                              BLOCK_SIZE bsize, int mi_row, int mi_col, int bw,
+                              int bh) {
+  const TileInfo *const tile = &xd->tile;
+
+  xd->mi = cm->mi_grid_visible + mi_row * cm->mi_stride + mi_col;
+  set_plane_n4(xd, bw, bh);
+#if CONFIG_VAR_TX
+  xd->max_tx_size = max_txsize_lookup[bsize];
+#else
+  (void)bsize;
+#endif
+#if CONFIG_DEPENDENT_HORZTILES
+  set_mi_row_col(xd, tile, mi_row, bh, mi_col, bw, cm->mi_rows, cm->mi_cols,
+                 cm->dependent_horz_tiles);
+#else
+  set_mi_row_col(xd, tile, mi_row, bh, mi_col, bw, cm->mi_rows, cm->mi_cols);
+#endif
+  av1_setup_dst_planes(xd->plane, get_frame_new_buffer(cm), mi_row, mi_col);
+}
+
 #if CONFIG_SUPERTX
 static MB_MODE_INFO *set_offsets_extend(AV1_COMMON *const cm,
                                         MACROBLOCKD *const xd,
@@ -771,7 +846,7 @@ static void set_param_topblock(AV1_COMMON *const cm, MACROBLOCKD *const xd,
       xd->mi[y * cm->mi_stride + x]->mbmi.tx_type = txfm;
     }
 #if CONFIG_VAR_TX
-  xd->above_txfm_context = cm->above_txfm_context + mi_col;
+  xd->above_txfm_context = xd->above_txfm_context_buffer + mi_col;
   xd->left_txfm_context =
       xd->left_txfm_context_buffer + (mi_row & MAX_MIB_MASK);
   set_txfm_ctxs(xd->mi[0]->mbmi.tx_size, bw, bh, skip, xd);
@@ -1490,9 +1565,91 @@ static void decode_mbmi_block(AV1Decoder *const pbi, MACROBLOCKD *const xd,
   aom_merge_corrupted_flag(&xd->corrupted, reader_corrupted_flag);
 }
 
+#if CONFIG_PALETTE
+static void decode_palette_color_map(MACROBLOCKD *const xd, int plane,
+                                     aom_reader *r, DecSbRowData *const rd) {
+  struct macroblockd_plane *const pd = &xd->plane[plane];
+  int width, height;
+
+  if (rd == NULL) {
+    av1_decode_palette_tokens(xd, plane, r);
+    return;
+  }
+
+  av1_get_block_dimensions(xd->mi[0]->mbmi.sb_type, plane, xd, &width,
+                           &height, NULL, NULL);
+  if (r == NULL) {
+    pd->color_index_map = rd->color_maps + rd->color_maps_pos;
+    rd->color_maps_pos += width * height;
+  } else {
+    av1_decode_palette_tokens(xd, plane, r);
+    memcpy(rd->color_maps + rd->color_maps_size, pd->color_index_map,
+           width * height);
+    rd->color_maps_size += width * height;
+  }
+}
+#endif  // CONFIG_PALETTE
+
+static void predict_inter_block(AV1_COMMON *cm, MACROBLOCKD *const xd,
+                                MB_MODE_INFO *const mbmi, int mi_row,
+                                int mi_col, BLOCK_SIZE bsize) {
+  int ref;
+
+  for (ref = 0; ref < 1 + has_second_ref(mbmi); ++ref) {
+    const MV_REFERENCE_FRAME frame = mbmi->ref_frame[ref];
+    RefBuffer *ref_buf = &cm->frame_refs[frame - LAST_FRAME];
+
+    xd->block_refs[ref] = ref_buf;
+    if ((!av1_is_valid_scale(&ref_buf->sf)))
+      aom_internal_error(xd->error_info, AOM_CODEC_UNSUP_BITSTREAM,
+                         "Reference frame has invalid dimensions");
+    av1_setup_pre_planes(xd, ref, ref_buf->buf, mi_row, mi_col, &ref_buf->sf);
+  }
+#if CONFIG_WARPED_MOTION
+  if (mbmi->motion_mode == WARPED_CAUSAL) {
+    int i;
+    for (i = 0; i < 3; ++i) {
+      const struct macroblockd_plane *pd = &xd->plane[i];
+
+      av1_warp_plane(&mbmi->wm_params[0],
+#if CONFIG_AOM_HIGHBITDEPTH
+                     xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH, xd->bd,
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+                     pd->pre[0].buf0, pd->pre[0].width, pd->pre[0].height,
+                     pd->pre[0].stride, pd->dst.buf,
+                     ((mi_col * MI_SIZE) >> pd->subsampling_x),
+                     ((mi_row * MI_SIZE) >> pd->subsampling_y),
+                     xd->n8_w * (MI_SIZE >> pd->subsampling_x),
+                     xd->n8_h * (MI_SIZE >> pd->subsampling_y),
+                     pd->dst.stride, pd->subsampling_x, pd->subsampling_y, 16,
+                     16, 0);
+    }
+  } else {
+#endif  // CONFIG_WARPED_MOTION
+#if CONFIG_CB4X4
+    av1_build_inter_predictors_sb(xd, mi_row, mi_col, NULL, bsize);
+#else
+  av1_build_inter_predictors_sb(xd, mi_row, mi_col, NULL,
+                                AOMMAX(bsize, BLOCK_8X8));
+#endif
+#if CONFIG_WARPED_MOTION
+  }
+#endif  // CONFIG_WARPED_MOTION
+#if CONFIG_MOTION_VAR
+  if (mbmi->motion_mode == OBMC_CAUSAL) {
+#if CONFIG_NCOBMC
+    av1_build_ncobmc_inter_predictors_sb(cm, xd, mi_row, mi_col);
+#else
+    av1_build_obmc_inter_predictors_sb(cm, xd, mi_row, mi_col);
+#endif
+  }
+#endif  // CONFIG_MOTION_VAR
+}
+
 static void decode_token_and_recon_block(AV1Decoder *const pbi,
                                          MACROBLOCKD *const xd, int mi_row,
                                          int mi_col, aom_reader *r,
+                                         DecSbRowData *const rd,
                                          BLOCK_SIZE bsize) {
   AV1_COMMON *const cm = &pbi->common;
   const int bw = mi_size_wide[bsize];
@@ -1500,11 +1657,14 @@ static void decode_token_and_recon_block(AV1Decoder *const pbi,
   const int x_mis = AOMMIN(bw, cm->mi_cols - mi_col);
   const int y_mis = AOMMIN(bh, cm->mi_rows - mi_row);
 
-  set_offsets(cm, xd, bsize, mi_row, mi_col, bw, bh, x_mis, y_mis);
+  if (r == NULL)
+    set_recon_offsets(cm, xd, bsize, mi_row, mi_col, bw, bh);
+  else
+    set_offsets(cm, xd, bsize, mi_row, mi_col, bw, bh, x_mis, y_mis);
   MB_MODE_INFO *mbmi = &xd->mi[0]->mbmi;
 
 #if CONFIG_DELTA_Q
-  if (cm->delta_q_present_flag) {
+  if (cm->delta_q_present_flag && r != NULL) {
     int i;
     for (i = 0; i < MAX_SEGMENTS; i++) {
       xd->plane[0].seg_dequant[i][0] =
@@ -1524,9 +1684,10 @@ static void decode_token_and_recon_block(AV1Decoder *const pbi,
 #endif
 
 #if CONFIG_CB4X4
-  if (mbmi->skip) reset_skip_context(xd, bsize);
+  if (mbmi->skip && r != NULL) reset_skip_context(xd, bsize);
 #else
-  if (mbmi->skip) reset_skip_context(xd, AOMMAX(BLOCK_8X8, bsize));
+  if (mbmi->skip && r != NULL)
+    reset_skip_context(xd, AOMMAX(BLOCK_8X8, bsize));
 #endif
 
 #if CONFIG_COEF_INTERLEAVE
@@ -1573,16 +1734,17 @@ static void decode_token_and_recon_block(AV1Decoder *const pbi,
       for (row_y = 0; row_y < tu_num_h_y; row_y++) {
         for (col_y = 0; col_y < tu_num_w_y; col_y++) {
           // luma
-          predict_and_reconstruct_intra_block(
-              cm, xd, r, mbmi, 0, row_y * tx_sz_y, col_y * tx_sz_y, tx_log2_y);
+          predict_and_reconstruct_intra_block(cm, xd, r, NULL, mbmi, 0,
+                                              row_y * tx_sz_y, col_y * tx_sz_y,
+                                              tx_log2_y);
           // chroma
           if (tu_idx_c < tu_num_c) {
             row_c = (tu_idx_c / tu_num_w_c) * tx_sz_c;
             col_c = (tu_idx_c % tu_num_w_c) * tx_sz_c;
-            predict_and_reconstruct_intra_block(cm, xd, r, mbmi, 1, row_c,
-                                                col_c, tx_log2_c);
-            predict_and_reconstruct_intra_block(cm, xd, r, mbmi, 2, row_c,
-                                                col_c, tx_log2_c);
+            predict_and_reconstruct_intra_block(cm, xd, r, NULL, mbmi, 1,
+                                                row_c, col_c, tx_log2_c);
+            predict_and_reconstruct_intra_block(cm, xd, r, NULL, mbmi, 2,
+                                                row_c, col_c, tx_log2_c);
             tu_idx_c++;
           }
         }
@@ -1592,10 +1754,10 @@ static void decode_token_and_recon_block(AV1Decoder *const pbi,
       while (tu_idx_c < tu_num_c) {
         row_c = (tu_idx_c / tu_num_w_c) * tx_sz_c;
         col_c = (tu_idx_c % tu_num_w_c) * tx_sz_c;
-        predict_and_reconstruct_intra_block(cm, xd, r, mbmi, 1, row_c, col_c,
-                                            tx_log2_c);
-        predict_and_reconstruct_intra_block(cm, xd, r, mbmi, 2, row_c, col_c,
-                                            tx_log2_c);
+        predict_and_reconstruct_intra_block(cm, xd, r, NULL, mbmi, 1, row_c,
+                                            col_c, tx_log2_c);
+        predict_and_reconstruct_intra_block(cm, xd, r, NULL, mbmi, 2, row_c,
+                                            col_c, tx_log2_c);
         tu_idx_c++;
       }
     } else {
@@ -1612,17 +1774,17 @@ static void decode_token_and_recon_block(AV1Decoder *const pbi,
         for (row_y = 0; row_y < tu_num_h_y; row_y++) {
           for (col_y = 0; col_y < tu_num_w_y; col_y++) {
             // luma
-            eobtotal += reconstruct_inter_block(cm, xd, r, mbmi->segment_id, 0,
-                                                row_y * tx_sz_y,
-                                                col_y * tx_sz_y, tx_log2_y);
+            eobtotal += reconstruct_inter_block(
+                cm, xd, r, NULL, mbmi->segment_id, 0, row_y * tx_sz_y,
+                col_y * tx_sz_y, tx_log2_y);
             // chroma
             if (tu_idx_c < tu_num_c) {
               row_c = (tu_idx_c / tu_num_w_c) * tx_sz_c;
               col_c = (tu_idx_c % tu_num_w_c) * tx_sz_c;
-              eobtotal += reconstruct_inter_block(cm, xd, r, mbmi->segment_id,
-                                                  1, row_c, col_c, tx_log2_c);
-              eobtotal += reconstruct_inter_block(cm, xd, r, mbmi->segment_id,
-                                                  2, row_c, col_c, tx_log2_c);
+              eobtotal += reconstruct_inter_block(
+                  cm, xd, r, NULL, mbmi->segment_id, 1, row_c, col_c, tx_log2_c);
+              eobtotal += reconstruct_inter_block(
+                  cm, xd, r, NULL, mbmi->segment_id, 2, row_c, col_c, tx_log2_c);
               tu_idx_c++;
             }
           }
@@ -1632,10 +1794,10 @@ static void decode_token_and_recon_block(AV1Decoder *const pbi,
         while (tu_idx_c < tu_num_c) {
           row_c = (tu_idx_c / tu_num_w_c) * tx_sz_c;
           col_c = (tu_idx_c % tu_num_w_c) * tx_sz_c;
-          eobtotal += reconstruct_inter_block(cm, xd, r, mbmi->segment_id, 1,
-                                              row_c, col_c, tx_log2_c);
-          eobtotal += reconstruct_inter_block(cm, xd, r, mbmi->segment_id, 2,
-                                              row_c, col_c, tx_log2_c);
+          eobtotal += reconstruct_inter_block(cm, xd, r, NULL, mbmi->segment_id,
+                                              1, row_c, col_c, tx_log2_c);
+          eobtotal += reconstruct_inter_block(cm, xd, r, NULL, mbmi->segment_id,
+                                              2, row_c, col_c, tx_log2_c);
           tu_idx_c++;
         }
 
@@ -1654,7 +1816,7 @@ static void decode_token_and_recon_block(AV1Decoder *const pbi,
 #if CONFIG_PALETTE
     for (plane = 0; plane <= 1; ++plane) {
       if (mbmi->palette_mode_info.palette_size[plane])
-        av1_decode_palette_tokens(xd, plane, r);
+        decode_palette_color_map(xd, plane, r, rd);
     }
 #endif  // CONFIG_PALETTE
     for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
@@ -1683,61 +1845,12 @@ static void decode_token_and_recon_block(AV1Decoder *const pbi,
 
       for (row = 0; row < max_blocks_high; row += stepr)
         for (col = 0; col < max_blocks_wide; col += stepc)
-          predict_and_reconstruct_intra_block(cm, xd, r, mbmi, plane, row, col,
-                                              tx_size);
+          predict_and_reconstruct_intra_block(cm, xd, r, rd, mbmi, plane, row,
+                                              col, tx_size);
     }
   } else {
-    int ref;
-
-    for (ref = 0; ref < 1 + has_second_ref(mbmi); ++ref) {
-      const MV_REFERENCE_FRAME frame = mbmi->ref_frame[ref];
-      RefBuffer *ref_buf = &cm->frame_refs[frame - LAST_FRAME];
-
-      xd->block_refs[ref] = ref_buf;
-      if ((!av1_is_valid_scale(&ref_buf->sf)))
-        aom_internal_error(xd->error_info, AOM_CODEC_UNSUP_BITSTREAM,
-                           "Reference frame has invalid dimensions");
-      av1_setup_pre_planes(xd, ref, ref_buf->buf, mi_row, mi_col, &ref_buf->sf);
-    }
-#if CONFIG_WARPED_MOTION
-    if (mbmi->motion_mode == WARPED_CAUSAL) {
-      int i;
-      for (i = 0; i < 3; ++i) {
-        const struct macroblockd_plane *pd = &xd->plane[i];
-
-        av1_warp_plane(&mbmi->wm_params[0],
-#if CONFIG_AOM_HIGHBITDEPTH
-                       xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH, xd->bd,
-#endif  // CONFIG_AOM_HIGHBITDEPTH
-                       pd->pre[0].buf0, pd->pre[0].width, pd->pre[0].height,
-                       pd->pre[0].stride, pd->dst.buf,
-                       ((mi_col * MI_SIZE) >> pd->subsampling_x),
-                       ((mi_row * MI_SIZE) >> pd->subsampling_y),
-                       xd->n8_w * (MI_SIZE >> pd->subsampling_x),
-                       xd->n8_h * (MI_SIZE >> pd->subsampling_y),
-                       pd->dst.stride, pd->subsampling_x, pd->subsampling_y, 16,
-                       16, 0);
-      }
-    } else {
-#endif  // CONFIG_WARPED_MOTION
-#if CONFIG_CB4X4
-      av1_build_inter_predictors_sb(xd, mi_row, mi_col, NULL, bsize);
-#else
-    av1_build_inter_predictors_sb(xd, mi_row, mi_col, NULL,
-                                  AOMMAX(bsize, BLOCK_8X8));
-#endif
-#if CONFIG_WARPED_MOTION
-    }
-#endif  // CONFIG_WARPED_MOTION
-#if CONFIG_MOTION_VAR
-    if (mbmi->motion_mode == OBMC_CAUSAL) {
-#if CONFIG_NCOBMC
-      av1_build_ncobmc_inter_predictors_sb(cm, xd, mi_row, mi_col);
-#else
-      av1_build_obmc_inter_predictors_sb(cm, xd, mi_row, mi_col);
-#endif
-    }
-#endif  // CONFIG_MOTION_VAR
+    if (rd == NULL || r == NULL)
+      predict_inter_block(cm, xd, mbmi, mi_row, mi_col, bsize);
 
     // Reconstruction
     if (!mbmi->skip) {
@@ -1772,15 +1885,15 @@ static void decode_token_and_recon_block(AV1Decoder *const pbi,
         const int bw_var_tx = tx_size_wide_unit[max_tx_size];
         for (row = 0; row < max_blocks_high; row += bh_var_tx)
           for (col = 0; col < max_blocks_wide; col += bw_var_tx)
-            decode_reconstruct_tx(cm, xd, r, mbmi, plane, plane_bsize, row, col,
-                                  max_tx_size, &eobtotal);
+            decode_reconstruct_tx(cm, xd, r, rd, mbmi, plane, plane_bsize, row,
+                                  col, max_tx_size, &eobtotal);
 #else
         const TX_SIZE tx_size = get_tx_size(plane, xd);
         const int stepr = tx_size_high_unit[tx_size];
         const int stepc = tx_size_wide_unit[tx_size];
         for (row = 0; row < max_blocks_high; row += stepr)
           for (col = 0; col < max_blocks_wide; col += stepc)
-            eobtotal += reconstruct_inter_block(cm, xd, r, mbmi->segment_id,
+            eobtotal += reconstruct_inter_block(cm, xd, r, rd, mbmi->segment_id,
                                                 plane, row, col, tx_size);
 #endif
       }
@@ -1788,14 +1901,14 @@ static void decode_token_and_recon_block(AV1Decoder *const pbi,
   }
 #endif
 
-  int reader_corrupted_flag = aom_reader_has_error(r);
-  aom_merge_corrupted_flag(&xd->corrupted, reader_corrupted_flag);
+  if (r != NULL)
+    aom_merge_corrupted_flag(&xd->corrupted, aom_reader_has_error(r));
 }
 
-#if CONFIG_NCOBMC && CONFIG_MOTION_VAR
+#if (CONFIG_NCOBMC && CONFIG_MOTION_VAR) || DEC_ROW_PIPELINE
 static void detoken_and_recon_sb(AV1Decoder *const pbi, MACROBLOCKD *const xd,
                                  int mi_row, int mi_col, aom_reader *r,
-                                 BLOCK_SIZE bsize) {
+                                 DecSbRowData *const rd, BLOCK_SIZE bsize) {
   AV1_COMMON *const cm = &pbi->common;
   const int hbs = mi_size_wide[bsize] >> 1;
 #if CONFIG_CB4X4
@@ -1819,51 +1932,58 @@ static void detoken_and_recon_sb(AV1Decoder *const pbi, MACROBLOCKD *const xd,
   if (!hbs && !unify_bsize) {
     xd->bmode_blocks_wl = 1 >> !!(partition & PARTITION_VERT);
     xd->bmode_blocks_hl = 1 >> !!(partition & PARTITION_HORZ);
-    decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, subsize);
+    decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, rd, subsize);
   } else {
     switch (partition) {
       case PARTITION_NONE:
-        decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, bsize);
+        decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, rd, bsize);
         break;
       case PARTITION_HORZ:
-        decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, subsize);
+        decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, rd, subsize);
         if (has_rows)
-          decode_token_and_recon_block(pbi, xd, mi_row + hbs, mi_col, r,
+          decode_token_and_recon_block(pbi, xd, mi_row + hbs, mi_col, r, rd,
                                        subsize);
         break;
       case PARTITION_VERT:
-        decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, subsize);
+        decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, rd, subsize);
         if (has_cols)
-          decode_token_and_recon_block(pbi, xd, mi_row, mi_col + hbs, r,
+          decode_token_and_recon_block(pbi, xd, mi_row, mi_col + hbs, r, rd,
                                        subsize);
         break;
       case PARTITION_SPLIT:
-        detoken_and_recon_sb(pbi, xd, mi_row, mi_col, r, subsize);
-        detoken_and_recon_sb(pbi, xd, mi_row, mi_col + hbs, r, subsize);
-        detoken_and_recon_sb(pbi, xd, mi_row + hbs, mi_col, r, subsize);
-        detoken_and_recon_sb(pbi, xd, mi_row + hbs, mi_col + hbs, r, subsize);
+        detoken_and_recon_sb(pbi, xd, mi_row, mi_col, r, rd, subsize);
+        detoken_and_recon_sb(pbi, xd, mi_row, mi_col + hbs, r, rd, subsize);
+        detoken_and_recon_sb(pbi, xd, mi_row + hbs, mi_col, r, rd, subsize);
+        detoken_and_recon_sb(pbi, xd, mi_row + hbs, mi_col + hbs, r, rd,
+                             subsize);
         break;
 #if CONFIG_EXT_PARTITION_TYPES
       case PARTITION_HORZ_A:
-        decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, bsize2);
-        decode_token_and_recon_block(pbi, xd, mi_row, mi_col + hbs, r, bsize2);
-        decode_token_and_recon_block(pbi, xd, mi_row + hbs, mi_col, r, subsize);
+        decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, rd, bsize2);
+        decode_token_and_recon_block(pbi, xd, mi_row, mi_col + hbs, r, rd,
+                                     bsize2);
+        decode_token_and_recon_block(pbi, xd, mi_row + hbs, mi_col, r, rd,
+                                     subsize);
         break;
       case PARTITION_HORZ_B:
-        decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, subsize);
-        decode_token_and_recon_block(pbi, xd, mi_row + hbs, mi_col, r, bsize2);
-        decode_token_and_recon_block(pbi, xd, mi_row + hbs, mi_col + hbs, r,
+        decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, rd, subsize);
+        decode_token_and_recon_block(pbi, xd, mi_row + hbs, mi_col, r, rd,
+                                     bsize2);
+        decode_token_and_recon_block(pbi, xd, mi_row + hbs, mi_col + hbs, r, rd,
                                      bsize2);
         break;
       case PARTITION_VERT_A:
-        decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, bsize2);
-        decode_token_and_recon_block(pbi, xd, mi_row + hbs, mi_col, r, bsize2);
-        decode_token_and_recon_block(pbi, xd, mi_row, mi_col + hbs, r, subsize);
+        decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, rd, bsize2);
+        decode_token_and_recon_block(pbi, xd, mi_row + hbs, mi_col, r, rd,
+                                     bsize2);
+        decode_token_and_recon_block(pbi, xd, mi_row, mi_col + hbs, r, rd,
+                                     subsize);
         break;
       case PARTITION_VERT_B:
-        decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, subsize);
-        decode_token_and_recon_block(pbi, xd, mi_row, mi_col + hbs, r, bsize2);
-        decode_token_and_recon_block(pbi, xd, mi_row + hbs, mi_col + hbs, r,
+        decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, rd, subsize);
+        decode_token_and_recon_block(pbi, xd, mi_row, mi_col + hbs, r, rd,
+                                     bsize2);
+        decode_token_and_recon_block(pbi, xd, mi_row + hbs, mi_col + hbs, r, rd,
                                      bsize2);
         break;
 #endif
@@ -1895,7 +2015,8 @@ static void decode_block(AV1Decoder *const pbi, MACROBLOCKD *const xd,
 #if CONFIG_SUPERTX
   if (!supertx_enabled)
 #endif  // CONFIG_SUPERTX
-    decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r, bsize);
+    decode_token_and_recon_block(pbi, xd, mi_row, mi_col, r,
+                                 pbi->parse_row_data, bsize);
 #endif
 }
 
@@ -2293,8 +2414,9 @@ static void decode_partition(AV1Decoder *const pbi, MACROBLOCKD *const xd,
 
         for (row = 0; row < max_blocks_high; row += stepr)
           for (col = 0; col < max_blocks_wide; col += stepc)
-            eobtotal += reconstruct_inter_block(
-                cm, xd, r, mbmi->segment_id_supertx, i, row, col, tx_size);
+            eobtotal += reconstruct_inter_block(cm, xd, r, NULL,
+                                                mbmi->segment_id_supertx, i,
+                                                row, col, tx_size);
       }
       if ((unify_bsize || !(subsize < BLOCK_8X8)) && eobtotal == 0) skip = 1;
     }
@@ -2699,8 +2821,8 @@ static void setup_loopfilter(AV1_COMMON *cm, struct aom_read_bit_buffer *rb) {
 #if CONFIG_CDEF
 static void setup_clpf(AV1Decoder *pbi, struct aom_read_bit_buffer *rb) {
   AV1_COMMON *const cm = &pbi->common;
-  const int width = pbi->cur_buf->buf.y_crop_width;
-  const int height = pbi->cur_buf->buf.y_crop_height;
+  const int width = cm->width;
+  const int height = cm->height;
 
   cm->clpf_blocks = 0;
   cm->clpf_strength_y = aom_rb_read_literal(rb, 2);
@@ -2900,21 +3022,29 @@ static void resize_context_buffers(AV1_COMMON *cm, int width, int height) {
   }
 }
 
-static void setup_frame_size(AV1_COMMON *cm, struct aom_read_bit_buffer *rb) {
-  int width, height;
+// Allocates the new frame buffer. When only a window of the frame is decoded,
+// the buffer only holds the window, and records its origin in the frame.
+static void alloc_frame_buffer(AV1_COMMON *cm, const TileInfo *window) {
   BufferPool *const pool = cm->buffer_pool;
-  av1_read_frame_size(rb, &width, &height);
-  resize_context_buffers(cm, width, height);
-  setup_render_size(cm, rb);
+  YV12_BUFFER_CONFIG *const buf = get_frame_new_buffer(cm);
+  int x = 0, y = 0, width = cm->width, height = cm->height;
+
+  if (window != NULL) {
+    x = window->mi_col_start * MI_SIZE;
+    y = window->mi_row_start * MI_SIZE;
+    width = AOMMIN(cm->width, window->mi_col_end * MI_SIZE) - x;
+    height = AOMMIN(cm->height, window->mi_row_end * MI_SIZE) - y;
+  }
 
   lock_buffer_pool(pool);
   if (aom_realloc_frame_buffer(
-          get_frame_new_buffer(cm), cm->width, cm->height, cm->subsampling_x,
-          cm->subsampling_y,
+          buf, width, height, cm->subsampling_x, cm->subsampling_y,
 #if CONFIG_AOM_HIGHBITDEPTH
           cm->use_highbitdepth,
 #endif
-          AOM_BORDER_IN_PIXELS, cm->byte_alignment,
+          (cm->min_border || window != NULL) ? AOM_DEC_BORDER_IN_PIXELS
+                                             : AOM_BORDER_IN_PIXELS,
+          cm->byte_alignment,
           &pool->frame_bufs[cm->new_fb_idx].raw_frame_buffer, pool->get_fb_cb,
           pool->cb_priv)) {
     unlock_buffer_pool(pool);
@@ -2923,13 +3053,40 @@ static void setup_frame_size(AV1_COMMON *cm, struct aom_read_bit_buffer *rb) {
   }
   unlock_buffer_pool(pool);
 
-  pool->frame_bufs[cm->new_fb_idx].buf.subsampling_x = cm->subsampling_x;
-  pool->frame_bufs[cm->new_fb_idx].buf.subsampling_y = cm->subsampling_y;
-  pool->frame_bufs[cm->new_fb_idx].buf.bit_depth = (unsigned int)cm->bit_depth;
-  pool->frame_bufs[cm->new_fb_idx].buf.color_space = cm->color_space;
-  pool->frame_bufs[cm->new_fb_idx].buf.color_range = cm->color_range;
-  pool->frame_bufs[cm->new_fb_idx].buf.render_width = cm->render_width;
-  pool->frame_bufs[cm->new_fb_idx].buf.render_height = cm->render_height;
+  if (window != NULL) {
+    const int aligned_width = (cm->width + 7) & ~7;
+    const int aligned_height = (cm->height + 7) & ~7;
+    buf->x_origin = x;
+    buf->y_origin = y;
+    buf->y_crop_width = cm->width;
+    buf->y_crop_height = cm->height;
+    buf->y_width = aligned_width;
+    buf->y_height = aligned_height;
+    buf->uv_crop_width = (cm->width + cm->subsampling_x) >> cm->subsampling_x;
+    buf->uv_crop_height =
+        (cm->height + cm->subsampling_y) >> cm->subsampling_y;
+    buf->uv_width = aligned_width >> cm->subsampling_x;
+    buf->uv_height = aligned_height >> cm->subsampling_y;
+  }
+
+  buf->subsampling_x = cm->subsampling_x;
+  buf->subsampling_y = cm->subsampling_y;
+  buf->bit_depth = (unsigned int)cm->bit_depth;
+  buf->color_space = cm->color_space;
+  buf->color_range = cm->color_range;
+  buf->render_width = cm->render_width;
+  buf->render_height = cm->render_height;
+}
+
+static void setup_frame_size(AV1_COMMON *cm, struct aom_read_bit_buffer *rb) {
+  int width, height;
+  av1_read_frame_size(rb, &width, &height);
+  resize_context_buffers(cm, width, height);
+  setup_render_size(cm, rb);
+
+#if !CONFIG_EXT_TILE
+  alloc_frame_buffer(cm, NULL);
+#endif  // !CONFIG_EXT_TILE
 }
 
 static INLINE int valid_ref_frame_img_fmt(aom_bit_depth_t ref_bit_depth,
@@ -2945,7 +3102,6 @@ static void setup_frame_size_with_refs(AV1_COMMON *cm,
   int width, height;
   int found = 0, i;
   int has_valid_ref_frame = 0;
-  BufferPool *const pool = cm->buffer_pool;
   for (i = 0; i < INTER_REFS_PER_FRAME; ++i) {
     if (aom_rb_read_bit(rb)) {
       YV12_BUFFER_CONFIG *const buf = cm->frame_refs[i].buf;
@@ -2990,29 +3146,9 @@ static void setup_frame_size_with_refs(AV1_COMMON *cm,
 
   resize_context_buffers(cm, width, height);
 
-  lock_buffer_pool(pool);
-  if (aom_realloc_frame_buffer(
-          get_frame_new_buffer(cm), cm->width, cm->height, cm->subsampling_x,
-          cm->subsampling_y,
-#if CONFIG_AOM_HIGHBITDEPTH
-          cm->use_highbitdepth,
-#endif
-          AOM_BORDER_IN_PIXELS, cm->byte_alignment,
-          &pool->frame_bufs[cm->new_fb_idx].raw_frame_buffer, pool->get_fb_cb,
-          pool->cb_priv)) {
-    unlock_buffer_pool(pool);
-    aom_internal_error(&cm->error, AOM_CODEC_MEM_ERROR,
-                       "Failed to allocate frame buffer");
-  }
-  unlock_buffer_pool(pool);
-
-  pool->frame_bufs[cm->new_fb_idx].buf.subsampling_x = cm->subsampling_x;
-  pool->frame_bufs[cm->new_fb_idx].buf.subsampling_y = cm->subsampling_y;
-  pool->frame_bufs[cm->new_fb_idx].buf.bit_depth = (unsigned int)cm->bit_depth;
-  pool->frame_bufs[cm->new_fb_idx].buf.color_space = cm->color_space;
-  pool->frame_bufs[cm->new_fb_idx].buf.color_range = cm->color_range;
-  pool->frame_bufs[cm->new_fb_idx].buf.render_width = cm->render_width;
-  pool->frame_bufs[cm->new_fb_idx].buf.render_height = cm->render_height;
+#if !CONFIG_EXT_TILE
+  alloc_frame_buffer(cm, NULL);
+#endif  // !CONFIG_EXT_TILE
 }
 
 static void read_tile_info(AV1Decoder *const pbi,
@@ -3118,6 +3254,103 @@ static void read_tile_info(AV1Decoder *const pbi,
 #endif
 }
 
+#if CONFIG_EXT_TILE
+// Sets [*first, *first + *num) to the tiles of size tile_size spanning
+// [start, end) of a frame dimension of the given size. Returns 0 if the edges
+// of the tiles do not match.
+static int get_window_tiles(int start, int end, int tile_size, int size,
+                            unsigned int *first, unsigned int *num) {
+  if (start % tile_size || (end % tile_size && end != size)) return 0;
+  *first = start / tile_size;
+  *num = (end + tile_size - 1) / tile_size - *first;
+  return 1;
+}
+
+// Latches the window of the frames covered by the rectangle of tiles set with
+// AV1_SET_DECODE_TILE_RECT at key frames, and finds the tiles of the current
+// frame covering the window.
+static void setup_frame_window(AV1Decoder *pbi) {
+  AV1_COMMON *const cm = &pbi->common;
+  TileInfo *const win = &pbi->frame_window;
+
+  if (cm->frame_type == KEY_FRAME) {
+    const aom_image_rect_t *const rect = &pbi->dec_tile_rect;
+    const int row_start = AOMMIN((int)rect->y, cm->tile_rows - 1);
+    const int col_start = AOMMIN((int)rect->x, cm->tile_cols - 1);
+    const int row_end = AOMMIN(row_start + (int)rect->h, cm->tile_rows);
+    const int col_end = AOMMIN(col_start + (int)rect->w, cm->tile_cols);
+    TileInfo tile;
+
+    memset(win, 0, sizeof(*win));
+    if (rect->w > 0 && rect->h > 0 &&
+        (row_end - row_start < cm->tile_rows ||
+         col_end - col_start < cm->tile_cols)) {
+      av1_tile_init(&tile, cm, row_start, col_start);
+      win->mi_row_start = tile.mi_row_start;
+      win->mi_col_start = tile.mi_col_start;
+      av1_tile_init(&tile, cm, row_end - 1, col_end - 1);
+      win->mi_row_end = tile.mi_row_end;
+      win->mi_col_end = tile.mi_col_end;
+      pbi->frame_window_width = cm->width;
+      pbi->frame_window_height = cm->height;
+    }
+  }
+  pbi->mb.mc_window = *win;
+  if (!dec_has_frame_window(pbi)) return;
+
+  if (cm->width != pbi->frame_window_width ||
+      cm->height != pbi->frame_window_height)
+    aom_internal_error(&cm->error, AOM_CODEC_UNSUP_BITSTREAM,
+                       "Frame size changed while decoding a tile rectangle");
+  if (!get_window_tiles(win->mi_row_start, win->mi_row_end, cm->tile_height,
+                        cm->mi_rows, &pbi->window_tiles.y,
+                        &pbi->window_tiles.h) ||
+      !get_window_tiles(win->mi_col_start, win->mi_col_end, cm->tile_width,
+                        cm->mi_cols, &pbi->window_tiles.x,
+                        &pbi->window_tiles.w))
+    aom_internal_error(&cm->error, AOM_CODEC_UNSUP_BITSTREAM,
+                       "Tiles changed while decoding a tile rectangle");
+#if CONFIG_CDEF
+  if (cm->clpf_blocks &&
+      ((win->mi_row_start | win->mi_col_start) * MI_SIZE) &
+          ((1 << (4 + cm->clpf_size)) - 1))
+    aom_internal_error(&cm->error, AOM_CODEC_UNSUP_BITSTREAM,
+                       "CLPF blocks straddle the tile rectangle");
+#endif  // CONFIG_CDEF
+#if CONFIG_LOOP_RESTORATION
+  if (cm->rst_info[0].frame_restoration_type != RESTORE_NONE ||
+      cm->rst_info[1].frame_restoration_type != RESTORE_NONE ||
+      cm->rst_info[2].frame_restoration_type != RESTORE_NONE)
+    aom_internal_error(&cm->error, AOM_CODEC_UNSUP_BITSTREAM,
+                       "Loop restoration of a tile rectangle not supported");
+#endif  // CONFIG_LOOP_RESTORATION
+}
+
+// Returns the tiles of the frame to decode, those covering the tile window if
+// there is one, else the tile row and column selected with
+// AV1_SET_DECODE_TILE_ROW and AV1_SET_DECODE_TILE_COL, if any.
+static void get_dec_tile_range(const AV1Decoder *pbi, int *tile_rows_start,
+                               int *tile_rows_end, int *tile_cols_start,
+                               int *tile_cols_end) {
+  const AV1_COMMON *const cm = &pbi->common;
+  if (dec_has_frame_window(pbi)) {
+    *tile_rows_start = pbi->window_tiles.y;
+    *tile_rows_end = pbi->window_tiles.y + pbi->window_tiles.h;
+    *tile_cols_start = pbi->window_tiles.x;
+    *tile_cols_end = pbi->window_tiles.x + pbi->window_tiles.w;
+  } else {
+    const int single_row = pbi->dec_tile_row >= 0;
+    const int single_col = pbi->dec_tile_col >= 0;
+    *tile_rows_start =
+        single_row ? AOMMIN(pbi->dec_tile_row, cm->tile_rows) : 0;
+    *tile_rows_end = single_row ? *tile_rows_start + 1 : cm->tile_rows;
+    *tile_cols_start =
+        single_col ? AOMMIN(pbi->dec_tile_col, cm->tile_cols) : 0;
+    *tile_cols_end = single_col ? *tile_cols_start + 1 : cm->tile_cols;
+  }
+}
+#endif  // CONFIG_EXT_TILE
+
 static int mem_get_varsize(const uint8_t *src, const int sz) {
   switch (sz) {
     case 1: return src[0];
@@ -3200,21 +3433,14 @@ static void get_tile_buffers(
     tile_buffers[0][0].raw_data_end = NULL;
   } else {
     // We locate only the tile buffers that are required, which are the ones
-    // specified by pbi->dec_tile_col and pbi->dec_tile_row. Also, we always
+    // returned by get_dec_tile_range(). Also, we always
     // need the last (bottom right) tile buffer, as we need to know where the
     // end of the compressed frame buffer is for proper superframe decoding.
 
     const uint8_t *tile_col_data_end[MAX_TILE_COLS];
     const uint8_t *const data_start = data;
 
-    const int dec_tile_row = AOMMIN(pbi->dec_tile_row, tile_rows);
-    const int single_row = pbi->dec_tile_row >= 0;
-    const int tile_rows_start = single_row ? dec_tile_row : 0;
-    const int tile_rows_end = single_row ? tile_rows_start + 1 : tile_rows;
-    const int dec_tile_col = AOMMIN(pbi->dec_tile_col, tile_cols);
-    const int single_col = pbi->dec_tile_col >= 0;
-    const int tile_cols_start = single_col ? dec_tile_col : 0;
-    const int tile_cols_end = single_col ? tile_cols_start + 1 : tile_cols;
+    int tile_rows_start, tile_rows_end, tile_cols_start, tile_cols_end;
 
     const int tile_col_size_bytes = pbi->tile_col_size_bytes;
     const int tile_size_bytes = pbi->tile_size_bytes;
@@ -3222,6 +3448,9 @@ static void get_tile_buffers(
     size_t tile_col_size;
     int r, c;
 
+    get_dec_tile_range(pbi, &tile_rows_start, &tile_rows_end, &tile_cols_start,
+                       &tile_cols_end);
+
     // Read tile column sizes for all columns (we need the last tile buffer)
     for (c = 0; c < tile_cols; ++c) {
       const int is_last = c == tile_cols - 1;
@@ -3248,8 +3477,6 @@ static void get_tile_buffers(
 
       // Get the whole of the last column, otherwise stop at the required tile.
       for (r = 0; r < (is_last ? tile_rows : tile_rows_end); ++r) {
-        tile_buffers[r][c].col = c;
-
         get_tile_buffer(tile_col_data_end[c], &pbi->common.error, &data,
                         pbi->decrypt_cb, pbi->decrypt_state, tile_buffers,
                         tile_size_bytes, c, r);
@@ -3263,8 +3490,6 @@ static void get_tile_buffers(
       data = tile_col_data_end[c - 1];
 
       for (r = 0; r < tile_rows; ++r) {
-        tile_buffers[r][c].col = c;
-
         get_tile_buffer(tile_col_data_end[c], &pbi->common.error, &data,
                         pbi->decrypt_cb, pbi->decrypt_state, tile_buffers,
                         tile_size_bytes, c, r);
@@ -3337,7 +3562,6 @@ static void get_tile_buffers(
       const int is_last = (r == tile_rows - 1) && (c == tile_cols - 1);
       hdr_offset = (tc && tc == first_tile_in_tg) ? hdr_size : 0;
 
-      buf->col = c;
       if (hdr_offset) {
         init_read_bit_buffer(pbi, &rb_tg_hdr, data, data_end, clear_data);
         rb_tg_hdr.bit_offset = tg_size_bit_offset;
@@ -3370,7 +3594,6 @@ static void get_tile_buffers(
     for (c = 0; c < tile_cols; ++c) {
       const int is_last = (r == tile_rows - 1) && (c == tile_cols - 1);
       TileBufferDec *const buf = &tile_buffers[r][c];
-      buf->col = c;
       get_tile_buffer(data_end, pbi->tile_size_bytes, is_last, &cm->error,
                       &data, pbi->decrypt_cb, pbi->decrypt_state, buf);
     }
@@ -3430,85 +3653,440 @@ static void daala_dec_init(AV1_COMMON *const cm, daala_dec_ctx *daala_dec,
 }
 #endif  // #if CONFIG_PVQ
 
-static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
-                                   const uint8_t *data_end) {
+// TODO(jzern): See if we can remove the restriction of passing in max
+// threads to the decoder.
+static void init_tile_workers(AV1Decoder *pbi) {
   AV1_COMMON *const cm = &pbi->common;
   const AVxWorkerInterface *const winterface = aom_get_worker_interface();
-  const int tile_cols = cm->tile_cols;
-  const int tile_rows = cm->tile_rows;
-  const int n_tiles = tile_cols * tile_rows;
-  TileBufferDec(*const tile_buffers)[MAX_TILE_COLS] = pbi->tile_buffers;
-#if CONFIG_EXT_TILE
-  const int dec_tile_row = AOMMIN(pbi->dec_tile_row, tile_rows);
-  const int single_row = pbi->dec_tile_row >= 0;
-  const int tile_rows_start = single_row ? dec_tile_row : 0;
-  const int tile_rows_end = single_row ? dec_tile_row + 1 : tile_rows;
-  const int dec_tile_col = AOMMIN(pbi->dec_tile_col, tile_cols);
-  const int single_col = pbi->dec_tile_col >= 0;
-  const int tile_cols_start = single_col ? dec_tile_col : 0;
-  const int tile_cols_end = single_col ? tile_cols_start + 1 : tile_cols;
-  const int inv_col_order = pbi->inv_tile_order && !single_col;
-  const int inv_row_order = pbi->inv_tile_order && !single_row;
-#else
-  const int tile_rows_start = 0;
-  const int tile_rows_end = tile_rows;
-  const int tile_cols_start = 0;
-  const int tile_cols_end = tile_cols;
-  const int inv_col_order = pbi->inv_tile_order;
-  const int inv_row_order = pbi->inv_tile_order;
-#endif  // CONFIG_EXT_TILE
-  int tile_row, tile_col;
+  const int num_threads = pbi->max_threads;
+  int i;
 
-#if CONFIG_SUBFRAME_PROB_UPDATE
-  cm->do_subframe_update = n_tiles == 1;
-#endif  // CONFIG_SUBFRAME_PROB_UPDATE
+  // The tile worker data is freed between frames in low memory mode.
+  if (pbi->tile_worker_data == NULL) {
+    // Ensure tile data offsets will be properly aligned. This may fail on
+    // platforms without DECLARE_ALIGNED().
+    assert((sizeof(*pbi->tile_worker_data) % 16) == 0);
+    CHECK_MEM_ERROR(
+        cm, pbi->tile_worker_data,
+        aom_memalign(32, num_threads * sizeof(*pbi->tile_worker_data)));
+    memset(pbi->tile_worker_data, 0,
+           num_threads * sizeof(*pbi->tile_worker_data));
+  }
+  if (pbi->num_tile_workers > 0) return;
+
+  CHECK_MEM_ERROR(cm, pbi->tile_workers,
+                  aom_malloc(num_threads * sizeof(*pbi->tile_workers)));
+  CHECK_MEM_ERROR(cm, pbi->tile_worker_info,
+                  aom_malloc(num_threads * sizeof(*pbi->tile_worker_info)));
+  // The last worker runs on the calling thread.
+  for (i = 0; i < num_threads; ++i) {
+    AVxWorker *const worker = &pbi->tile_workers[i];
+    ++pbi->num_tile_workers;
 
-  if (cm->lf.filter_level && !cm->skip_loop_filter &&
-      pbi->lf_worker.data1 == NULL) {
-    CHECK_MEM_ERROR(cm, pbi->lf_worker.data1,
-                    aom_memalign(32, sizeof(LFWorkerData)));
-    pbi->lf_worker.hook = (AVxWorkerHook)av1_loop_filter_worker;
-    if (pbi->max_threads > 1 && !winterface->reset(&pbi->lf_worker)) {
+    winterface->init(worker);
+    worker->pool = pbi->thread_pool;
+    if (i < num_threads - 1 && !winterface->reset(worker)) {
       aom_internal_error(&cm->error, AOM_CODEC_ERROR,
-                         "Loop filter thread creation failed");
+                         "Tile decoder thread creation failed");
     }
   }
+}
 
-  if (cm->lf.filter_level && !cm->skip_loop_filter) {
-    LFWorkerData *const lf_data = (LFWorkerData *)pbi->lf_worker.data1;
-    // Be sure to sync as we might be resuming after a failed frame decode.
-    winterface->sync(&pbi->lf_worker);
-    av1_loop_filter_data_reset(lf_data, get_frame_new_buffer(cm), cm,
-                               pbi->mb.plane);
-  }
+// Returns the edge emulation buffer for the inter predictors of a thread,
+// allocated on first use, or NULL when the frames have extended borders.
+static uint8_t *get_mc_buf(AV1Decoder *pbi, uint8_t **mc_buf) {
+  AV1_COMMON *const cm = &pbi->common;
+  if (!cm->min_border && !dec_has_frame_window(pbi)) return NULL;
+  if (*mc_buf == NULL)
+    CHECK_MEM_ERROR(cm, *mc_buf, (uint8_t *)aom_memalign(32, MC_BUF_SIZE));
+  return *mc_buf;
+}
 
-  assert(tile_rows <= MAX_TILE_ROWS);
-  assert(tile_cols <= MAX_TILE_COLS);
+#if CONFIG_SUBFRAME_PROB_UPDATE
+static void update_subframe_probs(AV1_COMMON *cm, int mi_row, int mi_col) {
+  if (cm->do_subframe_update &&
+      cm->refresh_frame_context == REFRESH_FRAME_CONTEXT_BACKWARD) {
+    const int mi_rows_per_update =
+        MI_SIZE * AOMMAX(cm->mi_rows / MI_SIZE / COEF_PROBS_BUFS, 1);
+    if ((mi_row + MI_SIZE) % mi_rows_per_update == 0 &&
+        mi_row + MI_SIZE < cm->mi_rows &&
+        cm->coef_probs_update_idx < COEF_PROBS_BUFS - 1) {
+      av1_partial_adapt_probs(cm, mi_row, mi_col);
+      ++cm->coef_probs_update_idx;
+    }
+  }
+}
+#endif  // CONFIG_SUBFRAME_PROB_UPDATE
 
-  get_tile_buffers(pbi, data, data_end, tile_buffers);
+void av1_dec_row_mt_dealloc(AV1DecRowMTSync *row_mt_sync) {
+  int i;
 
-  if (pbi->tile_data == NULL || n_tiles != pbi->allocated_tiles) {
-    aom_free(pbi->tile_data);
-    CHECK_MEM_ERROR(cm, pbi->tile_data,
-                    aom_memalign(32, n_tiles * (sizeof(*pbi->tile_data))));
-    pbi->allocated_tiles = n_tiles;
+  if (row_mt_sync == NULL) return;
+#if CONFIG_MULTITHREAD
+  if (row_mt_sync->mutex_ != NULL) {
+    pthread_mutex_destroy(row_mt_sync->mutex_);
+    aom_free(row_mt_sync->mutex_);
   }
-#if CONFIG_ACCOUNTING
-  if (pbi->acct_enabled) {
-    aom_accounting_reset(&pbi->accounting);
+  if (row_mt_sync->cond_ != NULL) {
+    pthread_cond_destroy(row_mt_sync->cond_);
+    aom_free(row_mt_sync->cond_);
   }
-#endif
-  // Load all tile information into tile_data.
-  for (tile_row = tile_rows_start; tile_row < tile_rows_end; ++tile_row) {
-    for (tile_col = tile_cols_start; tile_col < tile_cols_end; ++tile_col) {
-      const TileBufferDec *const buf = &tile_buffers[tile_row][tile_col];
-      TileData *const td = pbi->tile_data + tile_cols * tile_row + tile_col;
+#endif  // CONFIG_MULTITHREAD
+  if (row_mt_sync->row_data != NULL) {
+    for (i = 0; i < row_mt_sync->allocated_rows; ++i) {
+      aom_free(row_mt_sync->row_data[i].coeffs);
+      aom_free(row_mt_sync->row_data[i].color_maps);
+    }
+    aom_free(row_mt_sync->row_data);
+  }
+  aom_free(row_mt_sync->parsed);
+  aom_free(row_mt_sync->cur_sb_col);
+  // clear the structure as the source of this call may be a resize in which
+  // case this call will be followed by an _alloc() which may fail.
+  av1_zero(*row_mt_sync);
+}
 
-      td->cm = cm;
-      td->xd = pbi->mb;
-      td->xd.corrupted = 0;
-      td->xd.counts =
-          cm->refresh_frame_context == REFRESH_FRAME_CONTEXT_BACKWARD
+#if DEC_ROW_PIPELINE && CONFIG_MULTITHREAD
+static void dec_row_mt_alloc(AV1_COMMON *cm, AV1DecRowMTSync *row_mt_sync,
+                             int rows) {
+  if (rows <= row_mt_sync->allocated_rows) return;
+
+  av1_dec_row_mt_dealloc(row_mt_sync);
+  CHECK_MEM_ERROR(cm, row_mt_sync->mutex_,
+                  aom_malloc(sizeof(*row_mt_sync->mutex_)));
+  pthread_mutex_init(row_mt_sync->mutex_, NULL);
+  CHECK_MEM_ERROR(cm, row_mt_sync->cond_,
+                  aom_malloc(sizeof(*row_mt_sync->cond_)));
+  pthread_cond_init(row_mt_sync->cond_, NULL);
+  CHECK_MEM_ERROR(cm, row_mt_sync->parsed,
+                  aom_malloc(rows * sizeof(*row_mt_sync->parsed)));
+  CHECK_MEM_ERROR(cm, row_mt_sync->cur_sb_col,
+                  aom_malloc(rows * sizeof(*row_mt_sync->cur_sb_col)));
+  CHECK_MEM_ERROR(cm, row_mt_sync->row_data,
+                  aom_calloc(rows, sizeof(*row_mt_sync->row_data)));
+  row_mt_sync->allocated_rows = rows;
+  // A superblock may only be reconstructed once the superblock above and to
+  // its right is, which the intra edge of its top row depends on.
+  row_mt_sync->sync_range = 1;
+}
+
+static void *grow_row_buffer(MACROBLOCKD *const xd, void *buf, int used,
+                             int *alloc, int needed, size_t elem_size) {
+  void *new_buf;
+  int new_alloc;
+
+  if (*alloc - used >= needed) return buf;
+  new_alloc = AOMMAX(2 * *alloc, used + needed);
+  new_buf = aom_malloc(new_alloc * elem_size);
+  if (new_buf == NULL)
+    aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
+                       "Failed to allocate superblock row data");
+  if (used > 0) memcpy(new_buf, buf, used * elem_size);
+  aom_free(buf);
+  *alloc = new_alloc;
+  return new_buf;
+}
+
+// Makes room for the worst case output of parsing one more superblock.
+static void reserve_sb_row_data(MACROBLOCKD *const xd, DecSbRowData *rd) {
+  rd->coeffs = (tran_low_t *)grow_row_buffer(xd, rd->coeffs, rd->coeffs_size,
+                                             &rd->coeffs_alloc, DEC_SB_COEFFS,
+                                             sizeof(*rd->coeffs));
+#if CONFIG_PALETTE
+  rd->color_maps = (uint8_t *)grow_row_buffer(
+      xd, rd->color_maps, rd->color_maps_size, &rd->color_maps_alloc,
+      DEC_SB_COLOR_MAPS, sizeof(*rd->color_maps));
+#endif  // CONFIG_PALETTE
+}
+
+static void dec_row_mt_abort(AV1DecRowMTSync *const row_mt_sync) {
+  pthread_mutex_lock(row_mt_sync->mutex_);
+  row_mt_sync->abort = 1;
+  pthread_cond_broadcast(row_mt_sync->cond_);
+  pthread_mutex_unlock(row_mt_sync->mutex_);
+}
+
+static void dec_row_mt_set_parsed(AV1DecRowMTSync *const row_mt_sync,
+                                  int sb_row) {
+  pthread_mutex_lock(row_mt_sync->mutex_);
+  row_mt_sync->parsed[sb_row] = 1;
+  pthread_cond_broadcast(row_mt_sync->cond_);
+  pthread_mutex_unlock(row_mt_sync->mutex_);
+}
+
+// Returns the next superblock row to reconstruct once it has been parsed, or
+// -1 when there is none left or decoding was aborted.
+static int dec_row_mt_next_row(AV1DecRowMTSync *const row_mt_sync) {
+  int sb_row = -1;
+
+  pthread_mutex_lock(row_mt_sync->mutex_);
+  if (row_mt_sync->next_row < row_mt_sync->num_rows) {
+    sb_row = row_mt_sync->next_row++;
+    while (!row_mt_sync->parsed[sb_row] && !row_mt_sync->abort)
+      pthread_cond_wait(row_mt_sync->cond_, row_mt_sync->mutex_);
+  }
+  if (row_mt_sync->abort) sb_row = -1;
+  pthread_mutex_unlock(row_mt_sync->mutex_);
+  return sb_row;
+}
+
+// Waits for the row above to be reconstructed far enough to the right of
+// sb_col. Returns 0 if decoding was aborted.
+static int dec_row_mt_sync_read(AV1DecRowMTSync *const row_mt_sync, int sb_row,
+                                int sb_col, int sb_cols) {
+  const int needed = AOMMIN(sb_col + row_mt_sync->sync_range, sb_cols - 1);
+  int abort;
+
+  if (sb_row == 0) return 1;
+  pthread_mutex_lock(row_mt_sync->mutex_);
+  while (row_mt_sync->cur_sb_col[sb_row - 1] < needed && !row_mt_sync->abort)
+    pthread_cond_wait(row_mt_sync->cond_, row_mt_sync->mutex_);
+  abort = row_mt_sync->abort;
+  pthread_mutex_unlock(row_mt_sync->mutex_);
+  return !abort;
+}
+
+static void dec_row_mt_sync_write(AV1DecRowMTSync *const row_mt_sync,
+                                  int sb_row, int sb_col) {
+  pthread_mutex_lock(row_mt_sync->mutex_);
+  row_mt_sync->cur_sb_col[sb_row] = sb_col;
+  pthread_cond_broadcast(row_mt_sync->cond_);
+  pthread_mutex_unlock(row_mt_sync->mutex_);
+}
+
+// Reconstructs superblock rows of the tile as the parse stage releases them.
+static int recon_row_worker_hook(TileWorkerData *const tile_data,
+                                 AV1DecRowMTSync *const row_mt_sync) {
+  AV1Decoder *const pbi = tile_data->pbi;
+  AV1_COMMON *const cm = &pbi->common;
+  const TileInfo *const tile = row_mt_sync->tile;
+  const int sb_cols =
+      (tile->mi_col_end - tile->mi_col_start + cm->mib_size - 1) >>
+      cm->mib_size_log2;
+  int sb_row;
+
+  if (setjmp(tile_data->error_info.jmp)) {
+    tile_data->error_info.setjmp = 0;
+    dec_row_mt_abort(row_mt_sync);
+    return 0;
+  }
+
+  tile_data->error_info.setjmp = 1;
+  tile_data->xd.error_info = &tile_data->error_info;
+
+  while ((sb_row = dec_row_mt_next_row(row_mt_sync)) >= 0) {
+    DecSbRowData *const rd = &row_mt_sync->row_data[sb_row];
+    const int mi_row = tile->mi_row_start + (sb_row << cm->mib_size_log2);
+    int sb_col;
+
+    rd->coeffs_pos = 0;
+    rd->color_maps_pos = 0;
+    for (sb_col = 0; sb_col < sb_cols; ++sb_col) {
+      const int mi_col = tile->mi_col_start + (sb_col << cm->mib_size_log2);
+      if (!dec_row_mt_sync_read(row_mt_sync, sb_row, sb_col, sb_cols)) {
+        tile_data->error_info.setjmp = 0;
+        return 0;
+      }
+      detoken_and_recon_sb(pbi, &tile_data->xd, mi_row, mi_col, NULL, rd,
+                           cm->sb_size);
+      dec_row_mt_sync_write(row_mt_sync, sb_row, sb_col);
+    }
+  }
+
+  tile_data->error_info.setjmp = 0;
+  return 1;
+}
+
+// Decodes a tile with its superblock rows parsed in order on the calling
+// thread while the tile workers reconstruct the rows parsed so far. The mode
+// info is kept in cm->mi as usual; the coefficients and palette color maps
+// are kept in per row buffers until the row is reconstructed.
+static void decode_tile_pipelined(AV1Decoder *pbi, TileData *const td,
+                                  const TileInfo *const tile) {
+  AV1_COMMON *const cm = &pbi->common;
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  AV1DecRowMTSync *const row_mt_sync = &pbi->row_mt_sync;
+  const int num_rows =
+      (tile->mi_row_end - tile->mi_row_start + cm->mib_size - 1) >>
+      cm->mib_size_log2;
+  struct aom_internal_error_info error_info;
+  int num_workers;
+  int mi_row, sb_row, i;
+
+  init_tile_workers(pbi);
+  num_workers = pbi->num_tile_workers;
+  dec_row_mt_alloc(cm, row_mt_sync,
+                   (cm->mi_rows + cm->mib_size - 1) >> cm->mib_size_log2);
+  for (i = 0; i < num_rows; ++i) {
+    row_mt_sync->parsed[i] = 0;
+    row_mt_sync->cur_sb_col[i] = -1;
+    row_mt_sync->row_data[i].coeffs_size = 0;
+    row_mt_sync->row_data[i].color_maps_size = 0;
+  }
+  row_mt_sync->tile = tile;
+  row_mt_sync->next_row = 0;
+  row_mt_sync->num_rows = num_rows;
+  row_mt_sync->abort = 0;
+
+  for (i = 0; i < num_workers; ++i) {
+    AVxWorker *const worker = &pbi->tile_workers[i];
+    TileWorkerData *const twd = &pbi->tile_worker_data[i];
+
+    winterface->sync(worker);
+    twd->pbi = pbi;
+    twd->xd = pbi->mb;
+    twd->xd.corrupted = 0;
+    twd->xd.counts = NULL;
+    twd->xd.tile = *tile;
+    twd->xd.mc_buf = get_mc_buf(pbi, &twd->mc_buf);
+    av1_zero(twd->dqcoeff);
+    av1_init_macroblockd(cm, &twd->xd, twd->dqcoeff);
+    worker->hook = (AVxWorkerHook)recon_row_worker_hook;
+    worker->data1 = twd;
+    worker->data2 = row_mt_sync;
+    worker->had_error = 0;
+    // The last worker joins the reconstruction once parsing is done.
+    if (i < num_workers - 1) winterface->launch(worker);
+  }
+
+  if (setjmp(error_info.jmp)) {
+    error_info.setjmp = 0;
+    dec_row_mt_abort(row_mt_sync);
+    for (i = 0; i < num_workers - 1; ++i)
+      winterface->sync(&pbi->tile_workers[i]);
+    pbi->parse_row_data = NULL;
+    td->xd.error_info = &cm->error;
+    aom_internal_error(&cm->error, error_info.error_code, "%s",
+                       error_info.has_detail ? error_info.detail : "");
+  }
+  error_info.setjmp = 1;
+  td->xd.error_info = &error_info;
+
+  for (mi_row = tile->mi_row_start, sb_row = 0; mi_row < tile->mi_row_end;
+       mi_row += cm->mib_size, ++sb_row) {
+    DecSbRowData *const rd = &row_mt_sync->row_data[sb_row];
+    int mi_col;
+
+    av1_zero_left_context(&td->xd);
+    pbi->parse_row_data = rd;
+    for (mi_col = tile->mi_col_start; mi_col < tile->mi_col_end;
+         mi_col += cm->mib_size) {
+      reserve_sb_row_data(&td->xd, rd);
+      av1_update_boundary_info(cm, tile, mi_row, mi_col);
+      decode_partition(pbi, &td->xd, mi_row, mi_col, &td->bit_reader,
+                       cm->sb_size, b_width_log2_lookup[cm->sb_size]);
+    }
+    pbi->parse_row_data = NULL;
+    aom_merge_corrupted_flag(&pbi->mb.corrupted, td->xd.corrupted);
+    if (pbi->mb.corrupted)
+      aom_internal_error(td->xd.error_info, AOM_CODEC_CORRUPT_FRAME,
+                         "Failed to decode tile data");
+#if CONFIG_SUBFRAME_PROB_UPDATE
+    update_subframe_probs(cm, mi_row, mi_col);
+#endif  // CONFIG_SUBFRAME_PROB_UPDATE
+    dec_row_mt_set_parsed(row_mt_sync, sb_row);
+  }
+  error_info.setjmp = 0;
+  td->xd.error_info = &cm->error;
+
+  winterface->execute(&pbi->tile_workers[num_workers - 1]);
+  for (i = 0; i < num_workers; ++i) {
+    AVxWorker *const worker = &pbi->tile_workers[i];
+    pbi->mb.corrupted |= !winterface->sync(worker);
+  }
+  if (pbi->mb.corrupted)
+    aom_internal_error(&cm->error, AOM_CODEC_CORRUPT_FRAME,
+                       "Failed to decode tile data");
+}
+#endif  // DEC_ROW_PIPELINE && CONFIG_MULTITHREAD
+
+static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
+                                   const uint8_t *data_end) {
+  AV1_COMMON *const cm = &pbi->common;
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  const int tile_cols = cm->tile_cols;
+  const int tile_rows = cm->tile_rows;
+  const int n_tiles = tile_cols * tile_rows;
+  TileBufferDec(*const tile_buffers)[MAX_TILE_COLS] = pbi->tile_buffers;
+#if CONFIG_EXT_TILE
+  int tile_rows_start, tile_rows_end, tile_cols_start, tile_cols_end;
+  int inv_col_order, inv_row_order;
+#else
+  const int tile_rows_start = 0;
+  const int tile_rows_end = tile_rows;
+  const int tile_cols_start = 0;
+  const int tile_cols_end = tile_cols;
+  const int inv_col_order = pbi->inv_tile_order;
+  const int inv_row_order = pbi->inv_tile_order;
+#endif  // CONFIG_EXT_TILE
+  // The superblock row post-filter pipeline deblocks the frame itself, and
+  // the tile window is deblocked once decoded.
+  const int do_loop_filter = cm->lf.filter_level && !cm->skip_loop_filter &&
+                             !pbi->post_filter_deblock &&
+                             !dec_has_frame_window(pbi);
+  int tile_row, tile_col;
+
+#if CONFIG_EXT_TILE
+  get_dec_tile_range(pbi, &tile_rows_start, &tile_rows_end, &tile_cols_start,
+                     &tile_cols_end);
+  inv_col_order = pbi->inv_tile_order && pbi->dec_tile_col < 0 &&
+                  !dec_has_frame_window(pbi);
+  inv_row_order = pbi->inv_tile_order && pbi->dec_tile_row < 0 &&
+                  !dec_has_frame_window(pbi);
+#endif  // CONFIG_EXT_TILE
+
+#if CONFIG_SUBFRAME_PROB_UPDATE
+  cm->do_subframe_update = n_tiles == 1;
+#endif  // CONFIG_SUBFRAME_PROB_UPDATE
+
+  if (do_loop_filter &&
+      pbi->lf_worker.data1 == NULL) {
+    CHECK_MEM_ERROR(cm, pbi->lf_worker.data1,
+                    aom_memalign(32, sizeof(LFWorkerData)));
+    pbi->lf_worker.hook = (AVxWorkerHook)av1_loop_filter_worker;
+    pbi->lf_worker.pool = pbi->thread_pool;
+    if (pbi->max_threads > 1 && !winterface->reset(&pbi->lf_worker)) {
+      aom_internal_error(&cm->error, AOM_CODEC_ERROR,
+                         "Loop filter thread creation failed");
+    }
+  }
+
+  if (do_loop_filter) {
+    LFWorkerData *const lf_data = (LFWorkerData *)pbi->lf_worker.data1;
+    // Be sure to sync as we might be resuming after a failed frame decode.
+    winterface->sync(&pbi->lf_worker);
+    av1_loop_filter_data_reset(lf_data, get_frame_new_buffer(cm), cm,
+                               pbi->mb.plane);
+  }
+
+  assert(tile_rows <= MAX_TILE_ROWS);
+  assert(tile_cols <= MAX_TILE_COLS);
+
+  get_tile_buffers(pbi, data, data_end, tile_buffers);
+
+  if (pbi->tile_data == NULL || n_tiles != pbi->allocated_tiles) {
+    aom_free(pbi->tile_data);
+    CHECK_MEM_ERROR(cm, pbi->tile_data,
+                    aom_memalign(32, n_tiles * (sizeof(*pbi->tile_data))));
+    pbi->allocated_tiles = n_tiles;
+  }
+#if CONFIG_ACCOUNTING
+  if (pbi->acct_enabled) {
+    aom_accounting_reset(&pbi->accounting);
+  }
+#endif
+  // Load all tile information into tile_data.
+  for (tile_row = tile_rows_start; tile_row < tile_rows_end; ++tile_row) {
+    for (tile_col = tile_cols_start; tile_col < tile_cols_end; ++tile_col) {
+      const TileBufferDec *const buf = &tile_buffers[tile_row][tile_col];
+      TileData *const td = pbi->tile_data + tile_cols * tile_row + tile_col;
+
+      td->cm = cm;
+      td->xd = pbi->mb;
+      td->xd.corrupted = 0;
+      td->xd.mc_buf = get_mc_buf(pbi, &pbi->mc_buf);
+      td->xd.counts =
+          cm->refresh_frame_context == REFRESH_FRAME_CONTEXT_BACKWARD
               ? &cm->counts
               : NULL;
       av1_zero(td->dqcoeff);
@@ -3583,6 +4161,14 @@ static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
       av1_zero_above_context(cm, tile_info.mi_col_start, tile_info.mi_col_end);
 #endif
 
+#if DEC_ROW_PIPELINE && CONFIG_MULTITHREAD
+      if (pbi->row_mt && pbi->max_threads > 1 && !cm->frame_parallel_decode) {
+        decode_tile_pipelined(pbi, td, &tile_info);
+        mi_row = tile_info.mi_row_end;
+        continue;
+      }
+#endif  // DEC_ROW_PIPELINE && CONFIG_MULTITHREAD
+
       for (mi_row = tile_info.mi_row_start; mi_row < tile_info.mi_row_end;
            mi_row += cm->mib_size) {
         int mi_col;
@@ -3600,7 +4186,7 @@ static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
                            b_width_log2_lookup[cm->sb_size]);
 #if CONFIG_NCOBMC && CONFIG_MOTION_VAR
           detoken_and_recon_sb(pbi, &td->xd, mi_row, mi_col, &td->bit_reader,
-                               cm->sb_size);
+                               NULL, cm->sb_size);
 #endif
         }
         aom_merge_corrupted_flag(&pbi->mb.corrupted, td->xd.corrupted);
@@ -3608,17 +4194,7 @@ static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
           aom_internal_error(&cm->error, AOM_CODEC_CORRUPT_FRAME,
                              "Failed to decode tile data");
 #if CONFIG_SUBFRAME_PROB_UPDATE
-        if (cm->do_subframe_update &&
-            cm->refresh_frame_context == REFRESH_FRAME_CONTEXT_BACKWARD) {
-          const int mi_rows_per_update =
-              MI_SIZE * AOMMAX(cm->mi_rows / MI_SIZE / COEF_PROBS_BUFS, 1);
-          if ((mi_row + MI_SIZE) % mi_rows_per_update == 0 &&
-              mi_row + MI_SIZE < cm->mi_rows &&
-              cm->coef_probs_update_idx < COEF_PROBS_BUFS - 1) {
-            av1_partial_adapt_probs(cm, mi_row, mi_col);
-            ++cm->coef_probs_update_idx;
-          }
-        }
+        update_subframe_probs(cm, mi_row, mi_col);
 #endif  // CONFIG_SUBFRAME_PROB_UPDATE
       }
     }
@@ -3630,7 +4206,7 @@ static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
 // after the entire frame is decoded.
 #if !CONFIG_VAR_TX && !CONFIG_PARALLEL_DEBLOCKING
     // Loopfilter one tile row.
-    if (cm->lf.filter_level && !cm->skip_loop_filter) {
+    if (do_loop_filter) {
       LFWorkerData *const lf_data = (LFWorkerData *)pbi->lf_worker.data1;
       const int lf_start = AOMMAX(0, tile_info.mi_row_start - cm->mib_size);
       const int lf_end = tile_info.mi_row_end - cm->mib_size;
@@ -3661,12 +4237,13 @@ static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
 
 #if CONFIG_VAR_TX
   // Loopfilter the whole frame.
-  av1_loop_filter_frame(get_frame_new_buffer(cm), cm, &pbi->mb,
-                        cm->lf.filter_level, 0, 0);
+  if (!dec_has_frame_window(pbi))
+    av1_loop_filter_frame(get_frame_new_buffer(cm), cm, &pbi->mb,
+                          cm->lf.filter_level, 0, 0);
 #else
 #if CONFIG_PARALLEL_DEBLOCKING
   // Loopfilter all rows in the frame in the frame.
-  if (cm->lf.filter_level && !cm->skip_loop_filter) {
+  if (do_loop_filter) {
     LFWorkerData *const lf_data = (LFWorkerData *)pbi->lf_worker.data1;
     winterface->sync(&pbi->lf_worker);
     lf_data->start = 0;
@@ -3675,7 +4252,7 @@ static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
   }
 #else
   // Loopfilter remaining rows in the frame.
-  if (cm->lf.filter_level && !cm->skip_loop_filter) {
+  if (do_loop_filter) {
     LFWorkerData *const lf_data = (LFWorkerData *)pbi->lf_worker.data1;
     winterface->sync(&pbi->lf_worker);
     lf_data->start = lf_data->stop;
@@ -3684,8 +4261,6 @@ static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
   }
 #endif  // CONFIG_PARALLEL_DEBLOCKING
 #endif  // CONFIG_VAR_TX
-  if (cm->frame_parallel_decode)
-    av1_frameworker_broadcast(pbi->cur_buf, INT_MAX);
 
 #if CONFIG_EXT_TILE
   if (n_tiles == 1) {
@@ -3712,10 +4287,130 @@ static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
 #endif  // CONFIG_EXT_TILE
 }
 
+// Returns 1 if a tile is decoded without the tile above it.
+static int tile_starts_tile_job(const AV1_COMMON *cm, int tile_row,
+                                int tile_col) {
+#if CONFIG_DEPENDENT_HORZTILES
+  if (!cm->dependent_horz_tiles || tile_row == 0) return 1;
+#if CONFIG_TILE_GROUPS
+  {
+    TileInfo tile;
+    av1_tile_init(&tile, cm, tile_row, tile_col);
+    return tile.tg_horz_boundary;
+  }
+#else
+  (void)tile_col;
+  return 0;
+#endif  // CONFIG_TILE_GROUPS
+#else
+  (void)cm;
+  (void)tile_row;
+  (void)tile_col;
+  return 1;
+#endif  // CONFIG_DEPENDENT_HORZTILES
+}
+
+// Points the above contexts of a tile worker at its own buffers, reallocated
+// when the frame gets wider.
+static void setup_tile_worker_above_context(AV1_COMMON *cm,
+                                            TileWorkerData *twd) {
+  const int aligned_mi_cols = mi_cols_aligned_to_sb(cm);
+  int i;
+
+  if (twd->above_context_cols < aligned_mi_cols) {
+    for (i = 0; i < MAX_MB_PLANE; ++i) {
+      aom_free(twd->above_context[i]);
+      CHECK_MEM_ERROR(cm, twd->above_context[i],
+                      (ENTROPY_CONTEXT *)aom_calloc(
+                          2 * aligned_mi_cols, sizeof(*twd->above_context[0])));
+    }
+    aom_free(twd->above_seg_context);
+    CHECK_MEM_ERROR(cm, twd->above_seg_context,
+                    (PARTITION_CONTEXT *)aom_calloc(
+                        aligned_mi_cols, sizeof(*twd->above_seg_context)));
+#if CONFIG_VAR_TX
+    aom_free(twd->above_txfm_context);
+    CHECK_MEM_ERROR(cm, twd->above_txfm_context,
+                    (TXFM_CONTEXT *)aom_calloc(
+                        aligned_mi_cols, sizeof(*twd->above_txfm_context)));
+#endif  // CONFIG_VAR_TX
+    twd->above_context_cols = aligned_mi_cols;
+  }
+}
+
+static void zero_tile_worker_above_context(const AV1_COMMON *cm,
+                                           TileWorkerData *twd,
+                                           const TileInfo *tile) {
+  const int width = tile->mi_col_end - tile->mi_col_start;
+  const int offset_y = 2 * tile->mi_col_start;
+  const int width_y = 2 * width;
+  const int offset_uv = offset_y >> cm->subsampling_x;
+  const int width_uv = width_y >> cm->subsampling_x;
+
+  av1_zero_array(twd->above_context[0] + offset_y, width_y);
+  av1_zero_array(twd->above_context[1] + offset_uv, width_uv);
+  av1_zero_array(twd->above_context[2] + offset_uv, width_uv);
+
+  av1_zero_array(twd->above_seg_context + tile->mi_col_start, width);
+
+#if CONFIG_VAR_TX
+  av1_zero_array(twd->above_txfm_context + tile->mi_col_start, width);
+#endif  // CONFIG_VAR_TX
+}
+
+static void init_tile_worker_tile(AV1Decoder *pbi, TileWorkerData *twd,
+                                  const TileBufferDec *buf,
+                                  const uint8_t *data_end, int tile_row,
+                                  int tile_col) {
+  AV1_COMMON *const cm = &pbi->common;
+  int i;
+
+  twd->xd = pbi->mb;
+  twd->xd.corrupted = 0;
+  twd->xd.mc_buf = get_mc_buf(pbi, &twd->mc_buf);
+  twd->xd.counts = cm->refresh_frame_context == REFRESH_FRAME_CONTEXT_BACKWARD
+                       ? &twd->counts
+                       : NULL;
+  av1_zero(twd->dqcoeff);
+  av1_tile_init(&twd->xd.tile, cm, tile_row, tile_col);
+  setup_bool_decoder(buf->data, data_end, buf->size, &twd->error_info,
+                     &twd->bit_reader,
+#if CONFIG_ANS && ANS_MAX_SYMBOLS
+                     1 << cm->ans_window_size_log2,
+#endif  // CONFIG_ANS && ANS_MAX_SYMBOLS
+                     pbi->decrypt_cb, pbi->decrypt_state);
+  av1_init_macroblockd(cm, &twd->xd,
+#if CONFIG_PVQ
+                       twd->pvq_ref_coeff,
+#endif
+                       twd->dqcoeff);
+  for (i = 0; i < MAX_MB_PLANE; ++i)
+    twd->xd.above_context[i] = twd->above_context[i];
+  twd->xd.above_seg_context = twd->above_seg_context;
+#if CONFIG_VAR_TX
+  twd->xd.above_txfm_context = twd->above_txfm_context;
+  twd->xd.above_txfm_context_buffer = twd->above_txfm_context;
+#endif  // CONFIG_VAR_TX
+#if CONFIG_PVQ
+  daala_dec_init(cm, &twd->xd.daala_dec, &twd->bit_reader);
+#endif
+#if CONFIG_EC_ADAPT
+  // Initialise the tile context from the frame context
+  twd->tctx = *cm->fc;
+  twd->xd.tile_ctx = &twd->tctx;
+#endif
+#if CONFIG_PALETTE
+  twd->xd.plane[0].color_index_map = twd->color_index_map[0];
+  twd->xd.plane[1].color_index_map = twd->color_index_map[1];
+#endif  // CONFIG_PALETTE
+}
+
+// Takes the tile jobs of the frame one at a time until there are none left.
 static int tile_worker_hook(TileWorkerData *const tile_data,
-                            const TileInfo *const tile) {
+                            TileInfo *const tile) {
   AV1Decoder *const pbi = tile_data->pbi;
   const AV1_COMMON *const cm = &pbi->common;
+  const uint8_t *const data_end = tile_data->data_end;
   int mi_row, mi_col;
 
   if (setjmp(tile_data->error_info.jmp)) {
@@ -3726,212 +4421,186 @@ static int tile_worker_hook(TileWorkerData *const tile_data,
 
   tile_data->error_info.setjmp = 1;
   tile_data->xd.error_info = &tile_data->error_info;
-#if CONFIG_DEPENDENT_HORZTILES
-#if CONFIG_TILE_GROUPS
-  if (!cm->dependent_horz_tiles || tile->tg_horz_boundary) {
-#else
-  if (!cm->dependent_horz_tiles) {
-#endif
-    av1_zero_above_context(&pbi->common, tile->mi_col_start, tile->mi_col_end);
-  }
-#else
-  av1_zero_above_context(&pbi->common, tile->mi_col_start, tile->mi_col_end);
-#endif
 
-  for (mi_row = tile->mi_row_start; mi_row < tile->mi_row_end;
-       mi_row += cm->mib_size) {
-    av1_zero_left_context(&tile_data->xd);
+  for (;;) {
+    const int job_idx = aom_atomic_add(&pbi->next_tile_job, 1) - 1;
+    const TileJobDec *job;
+    int tile_row;
+    if (job_idx >= pbi->num_tile_jobs) break;
+    job = &pbi->tile_jobs[job_idx];
+
+    for (tile_row = job->tile_row_start; tile_row < job->tile_row_end;
+         ++tile_row) {
+      init_tile_worker_tile(pbi, tile_data,
+                            &pbi->tile_buffers[tile_row][job->tile_col],
+                            data_end, tile_row, job->tile_col);
+      tile_data->xd.error_info = &tile_data->error_info;
+      av1_tile_init(tile, cm, tile_row, job->tile_col);
+      if (tile_row == job->tile_row_start)
+        zero_tile_worker_above_context(cm, tile_data, tile);
+
+      for (mi_row = tile->mi_row_start; mi_row < tile->mi_row_end;
+           mi_row += cm->mib_size) {
+        av1_zero_left_context(&tile_data->xd);
 
-    for (mi_col = tile->mi_col_start; mi_col < tile->mi_col_end;
-         mi_col += cm->mib_size) {
-      decode_partition(pbi, &tile_data->xd,
+        for (mi_col = tile->mi_col_start; mi_col < tile->mi_col_end;
+             mi_col += cm->mib_size) {
+          av1_update_boundary_info(cm, tile, mi_row, mi_col);
+          decode_partition(pbi, &tile_data->xd,
 #if CONFIG_SUPERTX
-                       0,
+                           0,
 #endif
-                       mi_row, mi_col, &tile_data->bit_reader, cm->sb_size,
-                       b_width_log2_lookup[cm->sb_size]);
+                           mi_row, mi_col, &tile_data->bit_reader, cm->sb_size,
+                           b_width_log2_lookup[cm->sb_size]);
 #if CONFIG_NCOBMC && CONFIG_MOTION_VAR
-      detoken_and_recon_sb(pbi, &tile_data->xd, mi_row, mi_col,
-                           &tile_data->bit_reader, cm->sb_size);
+          detoken_and_recon_sb(pbi, &tile_data->xd, mi_row, mi_col,
+                               &tile_data->bit_reader, NULL, cm->sb_size);
 #endif
+        }
+      }
+      if (tile_data->xd.corrupted) {
+        tile_data->error_info.setjmp = 0;
+        return 0;
+      }
+#if !(CONFIG_ANS || CONFIG_EXT_TILE)
+      if (tile_row == cm->tile_rows - 1 && job->tile_col == cm->tile_cols - 1)
+        pbi->tile_data_end = aom_reader_find_end(&tile_data->bit_reader);
+#endif  // !(CONFIG_ANS || CONFIG_EXT_TILE)
     }
   }
-  return !tile_data->xd.corrupted;
+  tile_data->error_info.setjmp = 0;
+  return 1;
 }
 
 // sorts in descending order
-static int compare_tile_buffers(const void *a, const void *b) {
-  const TileBufferDec *const buf1 = (const TileBufferDec *)a;
-  const TileBufferDec *const buf2 = (const TileBufferDec *)b;
-  return (int)(buf2->size - buf1->size);
+static int compare_tile_jobs(const void *a, const void *b) {
+  const TileJobDec *const job1 = (const TileJobDec *)a;
+  const TileJobDec *const job2 = (const TileJobDec *)b;
+  if (job1->size != job2->size) return job1->size < job2->size ? 1 : -1;
+  return 0;
+}
+
+// Returns 1 if the tiles of the frame are decoded in parallel on the tile
+// workers. Row-based multi-threading pipelines single tile columns instead.
+static int use_tile_workers(const AV1Decoder *pbi) {
+  const AV1_COMMON *const cm = &pbi->common;
+  int tile_rows = cm->tile_rows;
+  int tile_cols = cm->tile_cols;
+  if (pbi->max_threads <= 1) return 0;
+#if CONFIG_EXT_TILE
+  if (dec_has_frame_window(pbi)) {
+    tile_rows = pbi->window_tiles.h;
+    tile_cols = pbi->window_tiles.w;
+  } else {
+    if (pbi->dec_tile_col >= 0) return 0;  // Decoding a single column
+    if (pbi->dec_tile_row >= 0) tile_rows = 1;
+  }
+#endif  // CONFIG_EXT_TILE
+  if (tile_cols > 1) return 1;
+  return tile_rows > 1 && !pbi->row_mt;
 }
 
+// Decodes every tile, or every run of tiles that depend on each other, as a
+// separate job on the tile workers.
 static const uint8_t *decode_tiles_mt(AV1Decoder *pbi, const uint8_t *data,
                                       const uint8_t *data_end) {
   AV1_COMMON *const cm = &pbi->common;
   const AVxWorkerInterface *const winterface = aom_get_worker_interface();
   const int tile_cols = cm->tile_cols;
   const int tile_rows = cm->tile_rows;
-  const int num_workers = AOMMIN(pbi->max_threads & ~1, tile_cols);
   TileBufferDec(*const tile_buffers)[MAX_TILE_COLS] = pbi->tile_buffers;
 #if CONFIG_EXT_TILE
-  const int dec_tile_row = AOMMIN(pbi->dec_tile_row, tile_rows);
-  const int single_row = pbi->dec_tile_row >= 0;
-  const int tile_rows_start = single_row ? dec_tile_row : 0;
-  const int tile_rows_end = single_row ? dec_tile_row + 1 : tile_rows;
-  const int dec_tile_col = AOMMIN(pbi->dec_tile_col, tile_cols);
-  const int single_col = pbi->dec_tile_col >= 0;
-  const int tile_cols_start = single_col ? dec_tile_col : 0;
-  const int tile_cols_end = single_col ? tile_cols_start + 1 : tile_cols;
+  int tile_rows_start, tile_rows_end, tile_cols_start, tile_cols_end;
 #else
   const int tile_rows_start = 0;
   const int tile_rows_end = tile_rows;
   const int tile_cols_start = 0;
   const int tile_cols_end = tile_cols;
 #endif  // CONFIG_EXT_TILE
+  int num_workers;
   int tile_row, tile_col;
   int i;
 
-#if !(CONFIG_ANS || CONFIG_EXT_TILE)
-  int final_worker = -1;
-#endif  // !(CONFIG_ANS || CONFIG_EXT_TILE)
-
   assert(tile_rows <= MAX_TILE_ROWS);
   assert(tile_cols <= MAX_TILE_COLS);
 
   assert(tile_cols * tile_rows > 1);
 
-  // TODO(jzern): See if we can remove the restriction of passing in max
-  // threads to the decoder.
-  if (pbi->num_tile_workers == 0) {
-    const int num_threads = pbi->max_threads & ~1;
-    CHECK_MEM_ERROR(cm, pbi->tile_workers,
-                    aom_malloc(num_threads * sizeof(*pbi->tile_workers)));
-    // Ensure tile data offsets will be properly aligned. This may fail on
-    // platforms without DECLARE_ALIGNED().
-    assert((sizeof(*pbi->tile_worker_data) % 16) == 0);
+#if CONFIG_EXT_TILE
+  get_dec_tile_range(pbi, &tile_rows_start, &tile_rows_end, &tile_cols_start,
+                     &tile_cols_end);
+#endif  // CONFIG_EXT_TILE
+  init_tile_workers(pbi);
+
+  // Load tile data into tile_buffers
+  get_tile_buffers(pbi, data, data_end, tile_buffers);
+
+  if (pbi->allocated_tile_jobs < tile_rows * tile_cols) {
+    aom_free(pbi->tile_jobs);
+    pbi->allocated_tile_jobs = 0;
     CHECK_MEM_ERROR(
-        cm, pbi->tile_worker_data,
-        aom_memalign(32, num_threads * sizeof(*pbi->tile_worker_data)));
-    CHECK_MEM_ERROR(cm, pbi->tile_worker_info,
-                    aom_malloc(num_threads * sizeof(*pbi->tile_worker_info)));
-    for (i = 0; i < num_threads; ++i) {
-      AVxWorker *const worker = &pbi->tile_workers[i];
-      ++pbi->num_tile_workers;
-
-      winterface->init(worker);
-      if (i < num_threads - 1 && !winterface->reset(worker)) {
-        aom_internal_error(&cm->error, AOM_CODEC_ERROR,
-                           "Tile decoder thread creation failed");
+        cm, pbi->tile_jobs,
+        aom_malloc(tile_rows * tile_cols * sizeof(*pbi->tile_jobs)));
+    pbi->allocated_tile_jobs = tile_rows * tile_cols;
+  }
+
+  // Split each tile column into runs of dependent tiles and sort them by size
+  // in descending order, so that the largest, and presumably the most
+  // difficult, jobs are decoded first.
+  pbi->num_tile_jobs = 0;
+  for (tile_col = tile_cols_start; tile_col < tile_cols_end; ++tile_col) {
+    TileJobDec *job = NULL;
+    for (tile_row = tile_rows_start; tile_row < tile_rows_end; ++tile_row) {
+      if (job == NULL || tile_starts_tile_job(cm, tile_row, tile_col)) {
+        job = &pbi->tile_jobs[pbi->num_tile_jobs++];
+        job->tile_col = tile_col;
+        job->tile_row_start = tile_row;
+        job->size = 0;
       }
+      job->tile_row_end = tile_row + 1;
+      job->size += tile_buffers[tile_row][tile_col].size;
     }
   }
+  qsort(pbi->tile_jobs, pbi->num_tile_jobs, sizeof(*pbi->tile_jobs),
+        compare_tile_jobs);
+  pbi->next_tile_job = 0;
+  pbi->tile_data_end = NULL;
+
+  num_workers = AOMMIN(pbi->max_threads, pbi->num_tile_jobs);
 
-  // Reset tile decoding hook
   for (i = 0; i < num_workers; ++i) {
     AVxWorker *const worker = &pbi->tile_workers[i];
+    TileWorkerData *const twd = &pbi->tile_worker_data[i];
+
     winterface->sync(worker);
     worker->hook = (AVxWorkerHook)tile_worker_hook;
-    worker->data1 = &pbi->tile_worker_data[i];
+    worker->data1 = twd;
     worker->data2 = &pbi->tile_worker_info[i];
-  }
 
-  // Initialize thread frame counts.
-  if (cm->refresh_frame_context == REFRESH_FRAME_CONTEXT_BACKWARD) {
-    for (i = 0; i < num_workers; ++i) {
-      TileWorkerData *const twd = (TileWorkerData *)pbi->tile_workers[i].data1;
+    twd->pbi = pbi;
+    twd->data_end = data_end;
+    // Initialize thread frame counts.
+    if (cm->refresh_frame_context == REFRESH_FRAME_CONTEXT_BACKWARD)
       av1_zero(twd->counts);
-    }
+    setup_tile_worker_above_context(cm, twd);
   }
 
-  // Load tile data into tile_buffers
-  get_tile_buffers(pbi, data, data_end, tile_buffers);
-
-  for (tile_row = tile_rows_start; tile_row < tile_rows_end; ++tile_row) {
-    // Sort the buffers in this tile row based on size in descending order.
-    qsort(&tile_buffers[tile_row][tile_cols_start],
-          tile_cols_end - tile_cols_start, sizeof(tile_buffers[0][0]),
-          compare_tile_buffers);
-
-    // Rearrange the tile buffers in this tile row such that per-tile group
-    // the largest, and presumably the most difficult tile will be decoded in
-    // the main thread. This should help minimize the number of instances
-    // where the main thread is waiting for a worker to complete.
-    {
-      int group_start;
-      for (group_start = tile_cols_start; group_start < tile_cols_end;
-           group_start += num_workers) {
-        const int group_end = AOMMIN(group_start + num_workers, tile_cols);
-        const TileBufferDec largest = tile_buffers[tile_row][group_start];
-        memmove(&tile_buffers[tile_row][group_start],
-                &tile_buffers[tile_row][group_start + 1],
-                (group_end - group_start - 1) * sizeof(tile_buffers[0][0]));
-        tile_buffers[tile_row][group_end - 1] = largest;
-      }
+  for (i = 0; i < num_workers; ++i) {
+    AVxWorker *const worker = &pbi->tile_workers[i];
+    worker->had_error = 0;
+    if (i == num_workers - 1) {
+      winterface->execute(worker);
+    } else {
+      winterface->launch(worker);
     }
+  }
 
-    for (tile_col = tile_cols_start; tile_col < tile_cols_end;) {
-      // Launch workers for individual columns
-      for (i = 0; i < num_workers && tile_col < tile_cols_end;
-           ++i, ++tile_col) {
-        TileBufferDec *const buf = &tile_buffers[tile_row][tile_col];
-        AVxWorker *const worker = &pbi->tile_workers[i];
-        TileWorkerData *const twd = (TileWorkerData *)worker->data1;
-        TileInfo *const tile_info = (TileInfo *)worker->data2;
-
-        twd->pbi = pbi;
-        twd->xd = pbi->mb;
-        twd->xd.corrupted = 0;
-        twd->xd.counts =
-            cm->refresh_frame_context == REFRESH_FRAME_CONTEXT_BACKWARD
-                ? &twd->counts
-                : NULL;
-        av1_zero(twd->dqcoeff);
-        av1_tile_init(tile_info, cm, tile_row, buf->col);
-        av1_tile_init(&twd->xd.tile, cm, tile_row, buf->col);
-        setup_bool_decoder(buf->data, data_end, buf->size, &cm->error,
-                           &twd->bit_reader,
-#if CONFIG_ANS && ANS_MAX_SYMBOLS
-                           1 << cm->ans_window_size_log2,
-#endif  // CONFIG_ANS && ANS_MAX_SYMBOLS
-                           pbi->decrypt_cb, pbi->decrypt_state);
-        av1_init_macroblockd(cm, &twd->xd,
-#if CONFIG_PVQ
-                             twd->pvq_ref_coeff,
-#endif
-                             twd->dqcoeff);
-#if CONFIG_PVQ
-        daala_dec_init(cm, &twd->xd.daala_dec, &twd->bit_reader);
-#endif
-#if CONFIG_PALETTE
-        twd->xd.plane[0].color_index_map = twd->color_index_map[0];
-        twd->xd.plane[1].color_index_map = twd->color_index_map[1];
-#endif  // CONFIG_PALETTE
-
-        worker->had_error = 0;
-        if (i == num_workers - 1 || tile_col == tile_cols_end - 1) {
-          winterface->execute(worker);
-        } else {
-          winterface->launch(worker);
-        }
-
-#if !(CONFIG_ANS || CONFIG_EXT_TILE)
-        if (tile_row == tile_rows - 1 && buf->col == tile_cols - 1) {
-          final_worker = i;
-        }
-#endif  // !(CONFIG_ANS || CONFIG_EXT_TILE)
-      }
-
-      // Sync all workers
-      for (; i > 0; --i) {
-        AVxWorker *const worker = &pbi->tile_workers[i - 1];
-        // TODO(jzern): The tile may have specific error data associated with
-        // its aom_internal_error_info which could be propagated to the main
-        // info in cm. Additionally once the threads have been synced and an
-        // error is detected, there's no point in continuing to decode tiles.
-        pbi->mb.corrupted |= !winterface->sync(worker);
-      }
-    }
+  for (i = 0; i < num_workers; ++i) {
+    // TODO(jzern): The tile may have specific error data associated with
+    // its aom_internal_error_info which could be propagated to the main
+    // info in cm. Additionally once the threads have been synced and an
+    // error is detected, there's no point in continuing to decode tiles.
+    pbi->mb.corrupted |= !winterface->sync(&pbi->tile_workers[i]);
   }
 
   // Accumulate thread frame counts.
@@ -3949,12 +4618,8 @@ static const uint8_t *decode_tiles_mt(AV1Decoder *pbi, const uint8_t *data,
 #if CONFIG_ANS
   return data_end;
 #else
-  assert(final_worker != -1);
-  {
-    TileWorkerData *const twd =
-        (TileWorkerData *)pbi->tile_workers[final_worker].data1;
-    return aom_reader_find_end(&twd->bit_reader);
-  }
+  assert(pbi->tile_data_end != NULL || pbi->mb.corrupted);
+  return pbi->tile_data_end;
 #endif  // CONFIG_ANS
 #endif  // CONFIG_EXT_TILE
 }
@@ -4013,6 +4678,7 @@ static void read_bitdepth_colorspace_sampling(AV1_COMMON *cm,
                          "4:4:4 color not supported in profile 0 or 2");
     }
   }
+  av1_set_lowbd_420(cm);
 }
 
 #if CONFIG_REFERENCE_BUFFER
@@ -4079,15 +4745,13 @@ static size_t read_uncompressed_header(AV1Decoder *pbi,
                            "Reference buffer frame ID mismatch");
     }
 #endif
-    lock_buffer_pool(pool);
-    if (frame_to_show < 0 || frame_bufs[frame_to_show].ref_count < 1) {
-      unlock_buffer_pool(pool);
+    if (frame_to_show < 0 ||
+        aom_atomic_load(&frame_bufs[frame_to_show].ref_count) < 1) {
       aom_internal_error(&cm->error, AOM_CODEC_UNSUP_BITSTREAM,
                          "Buffer %d does not contain a decoded frame",
                          frame_to_show);
     }
     ref_cnt_fb(frame_bufs, &cm->new_fb_idx, frame_to_show);
-    unlock_buffer_pool(pool);
 
     cm->lf.filter_level = 0;
     cm->show_frame = 1;
@@ -4324,17 +4988,16 @@ static size_t read_uncompressed_header(AV1Decoder *pbi,
   cm->frame_context_idx = aom_rb_read_literal(rb, FRAME_CONTEXTS_LOG2);
 
   // Generate next_ref_frame_map.
-  lock_buffer_pool(pool);
   for (mask = pbi->refresh_frame_flags; mask; mask >>= 1) {
     if (mask & 1) {
       cm->next_ref_frame_map[ref_index] = cm->new_fb_idx;
-      ++frame_bufs[cm->new_fb_idx].ref_count;
+      aom_atomic_add(&frame_bufs[cm->new_fb_idx].ref_count, 1);
     } else {
       cm->next_ref_frame_map[ref_index] = cm->ref_frame_map[ref_index];
     }
     // Current thread holds the reference frame.
     if (cm->ref_frame_map[ref_index] >= 0)
-      ++frame_bufs[cm->ref_frame_map[ref_index]].ref_count;
+      aom_atomic_add(&frame_bufs[cm->ref_frame_map[ref_index]].ref_count, 1);
     ++ref_index;
   }
 
@@ -4343,9 +5006,8 @@ static size_t read_uncompressed_header(AV1Decoder *pbi,
 
     // Current thread holds the reference frame.
     if (cm->ref_frame_map[ref_index] >= 0)
-      ++frame_bufs[cm->ref_frame_map[ref_index]].ref_count;
+      aom_atomic_add(&frame_bufs[cm->ref_frame_map[ref_index]].ref_count, 1);
   }
-  unlock_buffer_pool(pool);
   pbi->hold_ref_buf = 1;
 
   if (frame_is_intra_only(cm) || cm->error_resilient_mode)
@@ -4423,6 +5085,13 @@ static size_t read_uncompressed_header(AV1Decoder *pbi,
 #endif  // CONFIG_EXT_TX
 
   read_tile_info(pbi, rb);
+#if CONFIG_EXT_TILE
+  // The frame buffer is allocated once the tiles are known, as it may only
+  // hold some of them.
+  setup_frame_window(pbi);
+  alloc_frame_buffer(cm,
+                     dec_has_frame_window(pbi) ? &pbi->frame_window : NULL);
+#endif  // CONFIG_EXT_TILE
   sz = aom_rb_read_literal(rb, 16);
 
   if (sz == 0)
@@ -4754,6 +5423,8 @@ static void debug_check_frame_counts(const AV1_COMMON *const cm) {
                  sizeof(cm->counts.uv_mode)));
   assert(!memcmp(cm->counts.partition, zero_counts.partition,
                  sizeof(cm->counts.partition)));
+  assert(!memcmp(cm->counts.coef_blocks, zero_counts.coef_blocks,
+                 sizeof(cm->counts.coef_blocks)));
   assert(!memcmp(cm->counts.coef, zero_counts.coef, sizeof(cm->counts.coef)));
   assert(!memcmp(cm->counts.eob_branch, zero_counts.eob_branch,
                  sizeof(cm->counts.eob_branch)));
@@ -4850,6 +5521,120 @@ BITSTREAM_PROFILE av1_read_profile(struct aom_read_bit_buffer *rb) {
   return (BITSTREAM_PROFILE)profile;
 }
 
+#if CONFIG_CDEF
+static void cdef_frame(AV1Decoder *pbi, YV12_BUFFER_CONFIG *frame) {
+  AV1_COMMON *const cm = &pbi->common;
+  if (cm->dering_level && !cm->skip_loop_filter) {
+    av1_dering_frame(frame, cm, &pbi->mb, cm->dering_level);
+  }
+  if (!cm->skip_loop_filter) {
+    if (cm->clpf_strength_y) {
+      av1_clpf_frame(frame, NULL, cm, cm->clpf_size != CLPF_NOSIZE,
+                     cm->clpf_strength_y + (cm->clpf_strength_y == 3),
+                     4 + cm->clpf_size, AOM_PLANE_Y, clpf_bit);
+    }
+    if (cm->clpf_strength_u) {
+      av1_clpf_frame(frame, NULL, cm, 0,  // No block signals for chroma
+                     cm->clpf_strength_u + (cm->clpf_strength_u == 3), 4,
+                     AOM_PLANE_U, NULL);
+    }
+    if (cm->clpf_strength_v) {
+      av1_clpf_frame(frame, NULL, cm, 0,  // No block signals for chroma
+                     cm->clpf_strength_v + (cm->clpf_strength_v == 3), 4,
+                     AOM_PLANE_V, NULL);
+    }
+  }
+}
+#endif  // CONFIG_CDEF
+
+// Returns 1 if the frame has filters to run after the loop filter.
+static int has_post_filters(const AV1_COMMON *cm) {
+#if CONFIG_CDEF
+  if (cm->dering_level || cm->clpf_strength_y || cm->clpf_strength_u ||
+      cm->clpf_strength_v)
+    return 1;
+#endif  // CONFIG_CDEF
+#if CONFIG_LOOP_RESTORATION
+  if (cm->rst_info[0].frame_restoration_type != RESTORE_NONE ||
+      cm->rst_info[1].frame_restoration_type != RESTORE_NONE ||
+      cm->rst_info[2].frame_restoration_type != RESTORE_NONE)
+    return 1;
+#endif  // CONFIG_LOOP_RESTORATION
+  (void)cm;
+  return 0;
+}
+
+#if CONFIG_EXT_TILE
+// Runs the loop filters over the tile window of the frame as if the window
+// were the whole frame, so that they only read the samples decoded. The mode
+// info and the CLPF flags of cm are narrowed to the window meanwhile.
+static void filter_frame_window(AV1Decoder *pbi, YV12_BUFFER_CONFIG *frame) {
+  AV1_COMMON *const cm = &pbi->common;
+  const TileInfo *const win = &pbi->frame_window;
+  const int ss_x = frame->subsampling_x;
+  const int ss_y = frame->subsampling_y;
+  const int x = win->mi_col_start * MI_SIZE;
+  const int y = win->mi_row_start * MI_SIZE;
+  const int mi_offset = win->mi_row_start * cm->mi_stride + win->mi_col_start;
+  const int mi_rows = cm->mi_rows;
+  const int mi_cols = cm->mi_cols;
+#if CONFIG_CDEF
+  int8_t *const clpf_blocks = cm->clpf_blocks;
+#endif  // CONFIG_CDEF
+  jmp_buf frame_jmp;
+  YV12_BUFFER_CONFIG view = *frame;
+
+  view.x_origin = 0;
+  view.y_origin = 0;
+  view.y_crop_width = AOMMIN(cm->width, win->mi_col_end * MI_SIZE) - x;
+  view.y_crop_height = AOMMIN(cm->height, win->mi_row_end * MI_SIZE) - y;
+  view.y_width = (view.y_crop_width + 7) & ~7;
+  view.y_height = (view.y_crop_height + 7) & ~7;
+  view.uv_crop_width = (view.y_crop_width + ss_x) >> ss_x;
+  view.uv_crop_height = (view.y_crop_height + ss_y) >> ss_y;
+  view.uv_width = view.y_width >> ss_x;
+  view.uv_height = view.y_height >> ss_y;
+
+  // Restore cm before passing on the errors of the filters.
+  memcpy(frame_jmp, cm->error.jmp, sizeof(frame_jmp));
+  if (setjmp(cm->error.jmp)) {
+    cm->mi_rows = mi_rows;
+    cm->mi_cols = mi_cols;
+    cm->mi -= mi_offset;
+    cm->mi_grid_visible -= mi_offset;
+#if CONFIG_CDEF
+    cm->clpf_blocks = clpf_blocks;
+#endif  // CONFIG_CDEF
+    memcpy(cm->error.jmp, frame_jmp, sizeof(frame_jmp));
+    longjmp(cm->error.jmp, 1);
+  }
+  cm->mi_rows = win->mi_row_end - win->mi_row_start;
+  cm->mi_cols = win->mi_col_end - win->mi_col_start;
+  cm->mi += mi_offset;
+  cm->mi_grid_visible += mi_offset;
+#if CONFIG_CDEF
+  if (clpf_blocks) {
+    cm->clpf_blocks += (y / MIN_FB_SIZE) * cm->clpf_stride + x / MIN_FB_SIZE;
+  }
+#endif  // CONFIG_CDEF
+
+  if (cm->lf.filter_level && !cm->skip_loop_filter)
+    av1_loop_filter_frame(&view, cm, &pbi->mb, cm->lf.filter_level, 0, 0);
+#if CONFIG_CDEF
+  cdef_frame(pbi, &view);
+#endif  // CONFIG_CDEF
+
+  cm->mi_rows = mi_rows;
+  cm->mi_cols = mi_cols;
+  cm->mi -= mi_offset;
+  cm->mi_grid_visible -= mi_offset;
+#if CONFIG_CDEF
+  cm->clpf_blocks = clpf_blocks;
+#endif  // CONFIG_CDEF
+  memcpy(cm->error.jmp, frame_jmp, sizeof(frame_jmp));
+}
+#endif  // CONFIG_EXT_TILE
+
 void av1_decode_frame(AV1Decoder *pbi, const uint8_t *data,
                       const uint8_t *data_end, const uint8_t **p_data_end) {
   AV1_COMMON *const cm = &pbi->common;
@@ -4879,6 +5664,8 @@ void av1_decode_frame(AV1Decoder *pbi, const uint8_t *data,
   if (!first_partition_size) {
     // showing a frame directly
     *p_data_end = data + aom_rb_bytes_read(&rb);
+    if (pbi->rows_done_cb)
+      pbi->rows_done_cb(pbi->rows_done_priv, 0, new_fb->y_crop_height);
     return;
   }
 
@@ -4954,7 +5741,7 @@ void av1_decode_frame(AV1Decoder *pbi, const uint8_t *data,
       cm->frame_contexts[cm->frame_context_idx] = *cm->fc;
     }
     av1_frameworker_lock_stats(worker);
-    pbi->cur_buf->row = -1;
+    aom_atomic_store(&pbi->cur_buf->row, -1);
     pbi->cur_buf->col = -1;
     frame_worker_data->frame_context_ready = 1;
     // Signal the main thread that context is ready.
@@ -4962,25 +5749,65 @@ void av1_decode_frame(AV1Decoder *pbi, const uint8_t *data,
     av1_frameworker_unlock_stats(worker);
   }
 
+  // The post filters and the border extension of a frame follow the decoding
+  // of its rows, so the inter predictors wait for their reference frames to
+  // be complete. The motion vector references also read the motion vectors
+  // of the previous frame below the row being decoded.
+  if (cm->frame_parallel_decode && !frame_is_intra_only(cm)) {
+    RefCntBuffer *const frame_bufs = cm->buffer_pool->frame_bufs;
+    int i;
+    for (i = 0; i < INTER_REFS_PER_FRAME; ++i) {
+      av1_frameworker_wait(pbi->frame_worker_owner,
+                           &frame_bufs[cm->frame_refs[i].idx], INT_MAX);
+    }
+    if (cm->use_prev_frame_mvs)
+      av1_frameworker_wait(pbi->frame_worker_owner, cm->prev_frame, INT_MAX);
+  }
+
 #if CONFIG_SUBFRAME_PROB_UPDATE
   av1_copy(cm->starting_coef_probs, cm->fc->coef_probs);
   cm->coef_probs_update_idx = 0;
 #endif  // CONFIG_SUBFRAME_PROB_UPDATE
 
-  if (pbi->max_threads > 1
+#if CONFIG_MULTITHREAD
+  // With multiple threads the post filters of the whole frame are pipelined
+  // over its superblock rows. Row-based multi-threading also deblocks the
+  // rows in the pipeline.
+  pbi->post_filter_rows = pbi->max_threads > 1 &&
+                          !cm->frame_parallel_decode && !cm->skip_loop_filter
 #if CONFIG_EXT_TILE
-      && pbi->dec_tile_col < 0  // Decoding all columns
-#endif                          // CONFIG_EXT_TILE
-      && cm->tile_cols > 1) {
+                          && pbi->dec_tile_row < 0 && pbi->dec_tile_col < 0 &&
+                          !dec_has_frame_window(pbi)
+#endif  // CONFIG_EXT_TILE
+      ;
+#else
+  pbi->post_filter_rows = 0;
+#endif  // CONFIG_MULTITHREAD
+  pbi->post_filter_deblock = POST_FILTER_DEBLOCK && pbi->row_mt &&
+                             pbi->post_filter_rows && cm->lf.filter_level;
+  // Without a filter to run nor rows to post, the pipeline would only hand the
+  // rows from thread to thread.
+  if (!pbi->post_filter_deblock && !has_post_filters(cm) &&
+      !(pbi->rows_done_cb && cm->show_frame))
+    pbi->post_filter_rows = 0;
+
+  if (use_tile_workers(pbi)) {
     // Multi-threaded tile decoder
     *p_data_end = decode_tiles_mt(pbi, data + first_partition_size, data_end);
     if (!xd->corrupted) {
-      if (!cm->skip_loop_filter) {
+      if (!cm->skip_loop_filter && !pbi->post_filter_deblock &&
+          !dec_has_frame_window(pbi)) {
+#if CONFIG_VAR_TX
+        // The transform size contexts the loop filter keeps in cm are shared
+        // by all its superblock rows, so filter the frame in this thread.
+        av1_loop_filter_frame(new_fb, cm, &pbi->mb, cm->lf.filter_level, 0, 0);
+#else
         // If multiple threads are used to decode tiles, then we use those
         // threads to do parallel loopfiltering.
         av1_loop_filter_frame_mt(new_fb, cm, pbi->mb.plane, cm->lf.filter_level,
                                  0, 0, pbi->tile_workers, pbi->num_tile_workers,
                                  &pbi->lf_row_sync);
+#endif  // CONFIG_VAR_TX
       }
     } else {
       aom_internal_error(&cm->error, AOM_CODEC_CORRUPT_FRAME,
@@ -4990,38 +5817,36 @@ void av1_decode_frame(AV1Decoder *pbi, const uint8_t *data,
     *p_data_end = decode_tiles(pbi, data + first_partition_size, data_end);
   }
 
+#if CONFIG_EXT_TILE
+  if (dec_has_frame_window(pbi)) {
+    filter_frame_window(pbi, new_fb);
+  } else
+#endif  // CONFIG_EXT_TILE
+  if (pbi->post_filter_rows) {
+    init_tile_workers(pbi);
+    av1_post_filter_frame_mt(new_fb, cm, pbi->mb.plane,
+                             pbi->post_filter_deblock, pbi->tile_workers,
+                             pbi->num_tile_workers, &pbi->pf_row_sync,
+                             cm->show_frame ? pbi->rows_done_cb : NULL,
+                             pbi->rows_done_priv);
+  } else {
 #if CONFIG_CDEF
-  if (cm->dering_level && !cm->skip_loop_filter) {
-    av1_dering_frame(&pbi->cur_buf->buf, cm, &pbi->mb, cm->dering_level);
-  }
-  if (!cm->skip_loop_filter) {
-    const YV12_BUFFER_CONFIG *const frame = &pbi->cur_buf->buf;
-    if (cm->clpf_strength_y) {
-      av1_clpf_frame(frame, NULL, cm, cm->clpf_size != CLPF_NOSIZE,
-                     cm->clpf_strength_y + (cm->clpf_strength_y == 3),
-                     4 + cm->clpf_size, AOM_PLANE_Y, clpf_bit);
-    }
-    if (cm->clpf_strength_u) {
-      av1_clpf_frame(frame, NULL, cm, 0,  // No block signals for chroma
-                     cm->clpf_strength_u + (cm->clpf_strength_u == 3), 4,
-                     AOM_PLANE_U, NULL);
-    }
-    if (cm->clpf_strength_v) {
-      av1_clpf_frame(frame, NULL, cm, 0,  // No block signals for chroma
-                     cm->clpf_strength_v + (cm->clpf_strength_v == 3), 4,
-                     AOM_PLANE_V, NULL);
-    }
-  }
-  if (cm->clpf_blocks) aom_free(cm->clpf_blocks);
+    cdef_frame(pbi, &pbi->cur_buf->buf);
 #endif  // CONFIG_CDEF
 
 #if CONFIG_LOOP_RESTORATION
-  if (cm->rst_info[0].frame_restoration_type != RESTORE_NONE ||
-      cm->rst_info[1].frame_restoration_type != RESTORE_NONE ||
-      cm->rst_info[2].frame_restoration_type != RESTORE_NONE) {
-    av1_loop_restoration_frame(new_fb, cm, cm->rst_info, 7, 0, NULL);
-  }
+    if (cm->rst_info[0].frame_restoration_type != RESTORE_NONE ||
+        cm->rst_info[1].frame_restoration_type != RESTORE_NONE ||
+        cm->rst_info[2].frame_restoration_type != RESTORE_NONE) {
+      av1_loop_restoration_frame(new_fb, cm, cm->rst_info, 7, 0, NULL);
+    }
 #endif  // CONFIG_LOOP_RESTORATION
+    if (pbi->rows_done_cb && cm->show_frame && !xd->corrupted)
+      pbi->rows_done_cb(pbi->rows_done_priv, 0, new_fb->y_crop_height);
+  }
+#if CONFIG_CDEF
+  if (cm->clpf_blocks) aom_free(cm->clpf_blocks);
+#endif  // CONFIG_CDEF
 
   if (!xd->corrupted) {
     if (cm->refresh_frame_context == REFRESH_FRAME_CONTEXT_BACKWARD) {
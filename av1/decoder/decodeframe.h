@@ -17,6 +17,7 @@ extern "C" {
 #endif
 
 struct AV1Decoder;
+struct AV1DecRowMTSync;
 struct aom_read_bit_buffer;
 
 #if CONFIG_REFERENCE_BUFFER
@@ -32,6 +33,9 @@ BITSTREAM_PROFILE av1_read_profile(struct aom_read_bit_buffer *rb);
 void av1_decode_frame(struct AV1Decoder *pbi, const uint8_t *data,
                       const uint8_t *data_end, const uint8_t **p_data_end);
 
+// Frees the buffers of the row pipelined decoder.
+void av1_dec_row_mt_dealloc(struct AV1DecRowMTSync *row_mt_sync);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
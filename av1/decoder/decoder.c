@@ -150,6 +150,114 @@ AV1Decoder *av1_decoder_create(BufferPool *const pool) {
   return pbi;
 }
 
+// Frees the buffers of the tile decoding and of the post filters. The next
+// frame allocates them again.
+static void free_tile_scratch(AV1Decoder *pbi) {
+  int i;
+
+  aom_free(pbi->tile_data);
+  pbi->tile_data = NULL;
+  pbi->allocated_tiles = 0;
+  aom_free(pbi->tile_jobs);
+  pbi->tile_jobs = NULL;
+  pbi->allocated_tile_jobs = 0;
+  aom_free(pbi->mc_buf);
+  pbi->mc_buf = NULL;
+  if (pbi->tile_worker_data != NULL) {
+    for (i = 0; i < pbi->num_tile_workers; ++i) {
+      TileWorkerData *const twd = &pbi->tile_worker_data[i];
+      int j;
+      for (j = 0; j < MAX_MB_PLANE; ++j) aom_free(twd->above_context[j]);
+      aom_free(twd->above_seg_context);
+#if CONFIG_VAR_TX
+      aom_free(twd->above_txfm_context);
+#endif
+      aom_free(twd->mc_buf);
+    }
+    aom_free(pbi->tile_worker_data);
+    pbi->tile_worker_data = NULL;
+  }
+
+  if (pbi->num_tile_workers > 0) {
+    av1_loop_filter_dealloc(&pbi->lf_row_sync);
+    av1_post_filter_dealloc(&pbi->pf_row_sync);
+  }
+  av1_dec_row_mt_dealloc(&pbi->row_mt_sync);
+}
+
+// Frees the motion vectors of the frame buffers that are neither held nor
+// the previous frame, whose motion vectors the next frame may use.
+static void free_unused_mvs(AV1_COMMON *cm) {
+  RefCntBuffer *const frame_bufs = cm->buffer_pool->frame_bufs;
+  int i;
+
+  for (i = 0; i < FRAME_BUFFERS; ++i) {
+    RefCntBuffer *const buf = &frame_bufs[i];
+    if (buf->mvs == NULL || buf == cm->prev_frame ||
+        aom_atomic_load(&buf->ref_count) > 0)
+      continue;
+    aom_free(buf->mvs);
+    buf->mvs = NULL;
+    buf->mi_rows = 0;
+    buf->mi_cols = 0;
+  }
+}
+
+static size_t above_context_size(int cols) {
+  size_t size = 2 * MAX_MB_PLANE * sizeof(ENTROPY_CONTEXT);
+  size += sizeof(PARTITION_CONTEXT);
+#if CONFIG_VAR_TX
+  size += sizeof(TXFM_CONTEXT);
+#endif
+  return cols * size;
+}
+
+size_t av1_decoder_mem_usage(const AV1Decoder *pbi) {
+  const AV1_COMMON *const cm = &pbi->common;
+  const AV1DecRowMTSync *const row_mt_sync = &pbi->row_mt_sync;
+  size_t size = sizeof(*pbi) + (1 + FRAME_CONTEXTS) * sizeof(*cm->fc);
+  int i;
+
+  size += cm->mi_alloc_size * (sizeof(*cm->mip) + sizeof(*cm->mi_grid_base));
+  size += cm->seg_map_alloc_size * NUM_PING_PONG_BUFFERS;
+  size += above_context_size(cm->above_context_alloc_cols);
+
+  size += pbi->allocated_tiles * sizeof(*pbi->tile_data);
+  size += pbi->allocated_tile_jobs * sizeof(*pbi->tile_jobs);
+  if (pbi->mc_buf) size += MC_BUF_SIZE;
+  if (pbi->tile_worker_data != NULL) {
+    size += pbi->num_tile_workers * sizeof(*pbi->tile_worker_data);
+    for (i = 0; i < pbi->num_tile_workers; ++i) {
+      const TileWorkerData *const twd = &pbi->tile_worker_data[i];
+      size += above_context_size(twd->above_context_cols);
+      if (twd->mc_buf) size += MC_BUF_SIZE;
+    }
+  }
+  for (i = 0; i < row_mt_sync->allocated_rows; ++i) {
+    const DecSbRowData *const rd = &row_mt_sync->row_data[i];
+    size += rd->coeffs_alloc * sizeof(*rd->coeffs);
+    size += rd->color_maps_alloc * sizeof(*rd->color_maps);
+  }
+  size += pbi->pf_row_sync.dering_alloc + pbi->pf_row_sync.clpf_alloc;
+  size += pbi->pf_row_sync.rst_lines_alloc;
+  size += pbi->pf_row_sync.rst_restored_alloc;
+  return size;
+}
+
+size_t av1_buffer_pool_mem_usage(const BufferPool *pool) {
+  const InternalFrameBufferList *const list = &pool->int_frame_buffers;
+  size_t size = 0;
+  int i;
+
+  for (i = 0; i < list->num_internal_frame_buffers; ++i)
+    if (list->int_fb[i].data) size += list->int_fb[i].size;
+  for (i = 0; i < FRAME_BUFFERS; ++i) {
+    const RefCntBuffer *const buf = &pool->frame_bufs[i];
+    if (buf->mvs) size += buf->mi_rows * buf->mi_cols * sizeof(*buf->mvs);
+  }
+  return size;
+}
+
 void av1_decoder_remove(AV1Decoder *pbi) {
   int i;
 
@@ -157,19 +265,12 @@ void av1_decoder_remove(AV1Decoder *pbi) {
 
   aom_get_worker_interface()->end(&pbi->lf_worker);
   aom_free(pbi->lf_worker.data1);
-  aom_free(pbi->tile_data);
-  for (i = 0; i < pbi->num_tile_workers; ++i) {
-    AVxWorker *const worker = &pbi->tile_workers[i];
-    aom_get_worker_interface()->end(worker);
-  }
-  aom_free(pbi->tile_worker_data);
+  for (i = 0; i < pbi->num_tile_workers; ++i)
+    aom_get_worker_interface()->end(&pbi->tile_workers[i]);
+  free_tile_scratch(pbi);
   aom_free(pbi->tile_worker_info);
   aom_free(pbi->tile_workers);
 
-  if (pbi->num_tile_workers > 0) {
-    av1_loop_filter_dealloc(&pbi->lf_row_sync);
-  }
-
 #if CONFIG_ACCOUNTING
   aom_accounting_clear(&pbi->accounting);
 #endif
@@ -290,7 +391,6 @@ static void swap_frame_buffers(AV1Decoder *pbi) {
   BufferPool *const pool = cm->buffer_pool;
   RefCntBuffer *const frame_bufs = cm->buffer_pool->frame_bufs;
 
-  lock_buffer_pool(pool);
   for (mask = pbi->refresh_frame_flags; mask; mask >>= 1) {
     const int old_idx = cm->ref_frame_map[ref_index];
     // Current thread releases the holding of reference frame.
@@ -310,17 +410,13 @@ static void swap_frame_buffers(AV1Decoder *pbi) {
     cm->ref_frame_map[ref_index] = cm->next_ref_frame_map[ref_index];
   }
 
-  unlock_buffer_pool(pool);
   pbi->hold_ref_buf = 0;
   cm->frame_to_show = get_frame_new_buffer(cm);
 
   // TODO(zoeliu): To fix the ref frame buffer update for the scenario of
   //               cm->frame_parellel_decode == 1
-  if (!cm->frame_parallel_decode || !cm->show_frame) {
-    lock_buffer_pool(pool);
-    --frame_bufs[cm->new_fb_idx].ref_count;
-    unlock_buffer_pool(pool);
-  }
+  if (!cm->frame_parallel_decode || !cm->show_frame)
+    aom_atomic_add(&frame_bufs[cm->new_fb_idx].ref_count, -1);
 
   // Invalidate these references until the next frame starts.
   for (ref_index = 0; ref_index < INTER_REFS_PER_FRAME; ref_index++) {
@@ -379,7 +475,7 @@ int av1_receive_compressed_data(AV1Decoder *pbi, size_t size,
     frame_bufs[cm->new_fb_idx].frame_worker_owner = worker;
     // Reset decoding progress.
     pbi->cur_buf = &frame_bufs[cm->new_fb_idx];
-    pbi->cur_buf->row = -1;
+    aom_atomic_store(&pbi->cur_buf->row, -1);
     pbi->cur_buf->col = -1;
     av1_frameworker_unlock_stats(worker);
   } else {
@@ -400,7 +496,6 @@ int av1_receive_compressed_data(AV1Decoder *pbi, size_t size,
       winterface->sync(&pbi->tile_workers[i]);
     }
 
-    lock_buffer_pool(pool);
     // Release all the reference buffers if worker thread is holding them.
     if (pbi->hold_ref_buf == 1) {
       int ref_index = 0, mask;
@@ -424,7 +519,6 @@ int av1_receive_compressed_data(AV1Decoder *pbi, size_t size,
     }
     // Release current frame.
     decrease_ref_count(cm->new_fb_idx, frame_bufs, pool);
-    unlock_buffer_pool(pool);
 
     aom_clear_system_state();
     return -1;
@@ -435,13 +529,17 @@ int av1_receive_compressed_data(AV1Decoder *pbi, size_t size,
 
   swap_frame_buffers(pbi);
 
+  // The inter predictors replicate the edges of the frames decoded with a
+  // minimal border, and of the tile windows.
+  if (!cm->min_border && !dec_has_frame_window(pbi)) {
 #if CONFIG_EXT_TILE
-  // For now, we only extend the frame borders when the whole frame is decoded.
-  // Later, if needed, extend the border for the decoded tile on the frame
-  // border.
-  if (pbi->dec_tile_row == -1 && pbi->dec_tile_col == -1)
+    // For now, we only extend the frame borders when the whole frame is
+    // decoded. Later, if needed, extend the border for the decoded tile on the
+    // frame border.
+    if (pbi->dec_tile_row == -1 && pbi->dec_tile_col == -1)
 #endif  // CONFIG_EXT_TILE
-    aom_extend_frame_inner_borders(cm->frame_to_show);
+      aom_extend_frame_inner_borders(cm->frame_to_show);
+  }
 
   aom_clear_system_state();
 
@@ -464,6 +562,8 @@ int av1_receive_compressed_data(AV1Decoder *pbi, size_t size,
     // be accessing this buffer.
     AVxWorker *const worker = pbi->frame_worker_owner;
     FrameWorkerData *const frame_worker_data = worker->data1;
+    // The frame is filtered and its borders are extended.
+    av1_frameworker_broadcast(pbi->cur_buf, INT_MAX);
     av1_frameworker_lock_stats(worker);
 
     if (cm->show_frame) {
@@ -481,6 +581,18 @@ int av1_receive_compressed_data(AV1Decoder *pbi, size_t size,
     }
   }
 
+  {
+    const size_t mem_usage =
+        av1_decoder_mem_usage(pbi) + av1_buffer_pool_mem_usage(pool);
+    pbi->peak_mem_usage = AOMMAX(pbi->peak_mem_usage, mem_usage);
+  }
+  if (pbi->low_memory) {
+    free_tile_scratch(pbi);
+    // Other frame workers may still read the motion vectors of frames they
+    // no longer hold.
+    if (!cm->frame_parallel_decode) free_unused_mvs(cm);
+  }
+
   cm->error.setjmp = 0;
   return retcode;
 }
@@ -15,6 +15,7 @@
 #include "./aom_config.h"
 
 #include "aom/aom_codec.h"
+#include "aom/aom_image.h"
 #include "aom_dsp/bitreader.h"
 #include "aom_scale/yv12config.h"
 #include "aom_util/aom_thread.h"
@@ -60,6 +61,7 @@ typedef struct TileData {
 
 typedef struct TileWorkerData {
   struct AV1Decoder *pbi;
+  const uint8_t *data_end;
   aom_reader bit_reader;
   FRAME_COUNTS counts;
   DECLARE_ALIGNED(16, MACROBLOCKD, xd);
@@ -76,16 +78,72 @@ typedef struct TileWorkerData {
   DECLARE_ALIGNED(16, uint8_t, color_index_map[2][MAX_SB_SQUARE]);
 #endif  // CONFIG_PALETTE
   struct aom_internal_error_info error_info;
+  // Above contexts of the worker, as wide as the frame. Tiles of the same
+  // tile column run on several workers at once.
+  ENTROPY_CONTEXT *above_context[MAX_MB_PLANE];
+  PARTITION_CONTEXT *above_seg_context;
+#if CONFIG_VAR_TX
+  TXFM_CONTEXT *above_txfm_context;
+#endif
+  int above_context_cols;
+  // Edge emulation buffer of the worker, see MACROBLOCKD::mc_buf.
+  uint8_t *mc_buf;
 } TileWorkerData;
 
+// Coefficients and palette color maps of one superblock row in the order they
+// were parsed, kept for the reconstruction stage of the row pipelined decoder.
+typedef struct DecSbRowData {
+  tran_low_t *coeffs;
+  int coeffs_size;
+  int coeffs_alloc;
+  uint8_t *color_maps;
+  int color_maps_size;
+  int color_maps_alloc;
+  // Read positions of the reconstruction stage.
+  int coeffs_pos;
+  int color_maps_pos;
+} DecSbRowData;
+
+// Synchronization of the parse and reconstruction stages of the row pipelined
+// decoder. The superblock rows of a tile are parsed in order on one thread and
+// reconstructed on the others with a wavefront dependency on the row above.
+typedef struct AV1DecRowMTSync {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t *mutex_;
+  pthread_cond_t *cond_;
+#endif
+  // Set once a superblock row of the tile has been parsed.
+  int *parsed;
+  // Index of the last reconstructed superblock in each superblock row.
+  int *cur_sb_col;
+  DecSbRowData *row_data;
+  int sync_range;
+  int allocated_rows;
+  // Reconstruction jobs of the tile being decoded, one per superblock row.
+  const TileInfo *tile;
+  int next_row;
+  int num_rows;
+  // Set when a stage fails so that the others stop waiting for it.
+  int abort;
+} AV1DecRowMTSync;
+
 typedef struct TileBufferDec {
   const uint8_t *data;
   size_t size;
   const uint8_t *raw_data_end;  // The end of the raw tile buffer in the
                                 // bit stream.
-  int col;                      // only used with multi-threaded decoding
 } TileBufferDec;
 
+// Tile rows [tile_row_start, tile_row_end) of a tile column, decoded in order
+// by one tile worker. Each tile of a job but the first depends on the one
+// above it, the jobs are independent.
+typedef struct TileJobDec {
+  int tile_col;
+  int tile_row_start;
+  int tile_row_end;
+  size_t size;
+} TileJobDec;
+
 typedef struct AV1Decoder {
   DECLARE_ALIGNED(16, MACROBLOCKD, mb);
 
@@ -100,6 +158,9 @@ typedef struct AV1Decoder {
   RefCntBuffer *cur_buf;  //  Current decoding frame buffer.
 
   AVxWorker *frame_worker_owner;  // frame_worker that owns this pbi.
+  // Threads shared by the tile and loop filter workers, owned by the codec
+  // instance.
+  AVxThreadPool *thread_pool;
   AVxWorker lf_worker;
   AVxWorker *tile_workers;
   TileWorkerData *tile_worker_data;
@@ -108,14 +169,52 @@ typedef struct AV1Decoder {
 
   TileData *tile_data;
   int allocated_tiles;
+  // Edge emulation buffer of the tiles decoded on the calling thread.
+  uint8_t *mc_buf;
+
+  // Jobs of the multi-threaded tile decoder, largest first, and the next one
+  // for a tile worker to take.
+  TileJobDec *tile_jobs;
+  int num_tile_jobs;
+  int allocated_tile_jobs;
+  int next_tile_job;
+  // End of the data of the last tile of the frame.
+  const uint8_t *tile_data_end;
 
   TileBufferDec tile_buffers[MAX_TILE_ROWS][MAX_TILE_COLS];
 
   AV1LfSync lf_row_sync;
 
+  // Run the post filters of the current frame as a pipeline over the
+  // superblock rows on the tile workers. The pipeline deblocks the rows too
+  // when post_filter_deblock is set, instead of the tile decoding loop.
+  int post_filter_rows;
+  int post_filter_deblock;
+  AV1PostFilterSync pf_row_sync;
+
+  // Decode single tile columns with the parse and reconstruction stages
+  // pipelined across the tile workers.
+  int row_mt;
+  AV1DecRowMTSync row_mt_sync;
+  // Row buffer that the parse stage stores coefficients into, NULL when
+  // blocks are reconstructed as soon as they are parsed.
+  DecSbRowData *parse_row_data;
+
   aom_decrypt_cb decrypt_cb;
   void *decrypt_state;
 
+  // Told of the rows of a shown frame as they become final, in order. It is
+  // called from the tile workers when the post filters run as a pipeline,
+  // and once for the whole frame otherwise.
+  av1_rows_done_cb_fn_t rows_done_cb;
+  void *rows_done_priv;
+
+  // Free the scratch buffers of the tile decoding and the post filters after
+  // each frame, and the motion vectors of the frame buffers no longer held.
+  int low_memory;
+  // Most memory held at the end of a frame, see av1_decoder_mem_usage().
+  size_t peak_mem_usage;
+
   int max_threads;
   int inv_tile_order;
   int need_resync;   // wait for key/intra-only frame.
@@ -125,6 +224,14 @@ typedef struct AV1Decoder {
 #if CONFIG_EXT_TILE
   int tile_col_size_bytes;
   int dec_tile_row, dec_tile_col;
+  // Rectangle of tiles to decode, set with AV1_SET_DECODE_TILE_RECT, and the
+  // window of the frames it covers, latched at each key frame with the frame
+  // size. The window is empty (mi_row_end == 0) when decoding whole frames.
+  aom_image_rect_t dec_tile_rect;
+  TileInfo frame_window;
+  int frame_window_width, frame_window_height;
+  // Tiles of the current frame covering the window.
+  aom_image_rect_t window_tiles;
 #endif  // CONFIG_EXT_TILE
 #if CONFIG_ACCOUNTING
   int acct_enabled;
@@ -182,21 +289,55 @@ struct AV1Decoder *av1_decoder_create(BufferPool *const pool);
 
 void av1_decoder_remove(struct AV1Decoder *pbi);
 
+// Returns the bytes held by the decoder for its mode info, context and scratch
+// buffers. The frame buffers of the pool are counted by
+// av1_buffer_pool_mem_usage().
+size_t av1_decoder_mem_usage(const struct AV1Decoder *pbi);
+
+// Returns the bytes held by the internal frame buffers and the motion vector
+// buffers of the pool. Frame buffers supplied by the application through the
+// frame buffer callbacks are not counted.
+size_t av1_buffer_pool_mem_usage(const BufferPool *pool);
+
 static INLINE void decrease_ref_count(int idx, RefCntBuffer *const frame_bufs,
                                       BufferPool *const pool) {
   if (idx >= 0) {
-    --frame_bufs[idx].ref_count;
     // A worker may only get a free framebuffer index when calling get_free_fb.
     // But the private buffer is not set up until finish decoding header.
     // So any error happens during decoding header, the frame_bufs will not
     // have valid priv buffer.
-    if (frame_bufs[idx].ref_count == 0 &&
-        frame_bufs[idx].raw_frame_buffer.priv) {
-      pool->release_fb_cb(pool->cb_priv, &frame_bufs[idx].raw_frame_buffer);
+    RefCntBuffer *const buf = &frame_bufs[idx];
+    for (;;) {
+      const int ref_count = aom_atomic_load(&buf->ref_count);
+      if (ref_count == 1) {
+        // This is the last reference. Release the buffer while the count is
+        // still held, as get_free_fb() may claim it as soon as it reads 0.
+        if (buf->raw_frame_buffer.priv) {
+          lock_buffer_pool(pool);
+          pool->release_fb_cb(pool->cb_priv, &buf->raw_frame_buffer);
+          unlock_buffer_pool(pool);
+        }
+        aom_atomic_add(&buf->ref_count, -1);
+        break;
+      }
+      if (aom_atomic_compare_exchange(&buf->ref_count, ref_count,
+                                      ref_count - 1))
+        break;
     }
   }
 }
 
+// Returns 1 if only the tiles in pbi->frame_window are decoded, in which case
+// the frame buffers only hold the window.
+static INLINE int dec_has_frame_window(const AV1Decoder *pbi) {
+#if CONFIG_EXT_TILE
+  return pbi->frame_window.mi_row_end > 0;
+#else
+  (void)pbi;
+  return 0;
+#endif  // CONFIG_EXT_TILE
+}
+
 #if CONFIG_EXT_REFS
 static INLINE int dec_is_ref_frame_buf(AV1Decoder *const pbi,
                                        RefCntBuffer *frame_buf) {
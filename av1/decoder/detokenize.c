@@ -118,6 +118,7 @@ static int decode_coefs(MACROBLOCKD *xd, PLANE_TYPE type, tran_low_t *dqcoeff,
 #endif  // CONFIG_AOM_QM
 
   if (counts) {
+    ++counts->coef_blocks[tx_size_ctx][type][ref];
     coef_counts = counts->coef[tx_size_ctx][type][ref];
     eob_branch_count = counts->eob_branch[tx_size_ctx][type][ref];
 #if CONFIG_NEW_TOKENSET
@@ -52,24 +52,16 @@ void av1_frameworker_signal_stats(AVxWorker *const worker) {
 #endif
 }
 
-// This macro prevents thread_sanitizer from reporting known concurrent writes.
-#if defined(__has_feature)
-#if __has_feature(thread_sanitizer)
-#define BUILDING_WITH_TSAN
-#endif
-#endif
-
 // TODO(hkuang): Remove worker parameter as it is only used in debug code.
 void av1_frameworker_wait(AVxWorker *const worker, RefCntBuffer *const ref_buf,
                           int row) {
 #if CONFIG_MULTITHREAD
   if (!ref_buf) return;
 
-#ifndef BUILDING_WITH_TSAN
-  // The following line of code will get harmless tsan error but it is the key
-  // to get best performance.
-  if (ref_buf->row >= row && ref_buf->buf.corrupted != 1) return;
-#endif
+  // Only take the lock of the owner when the reference frame has not been
+  // decoded far enough yet.
+  if (aom_atomic_load(&ref_buf->row) >= row && ref_buf->buf.corrupted != 1)
+    return;
 
   {
     // Find the worker thread that owns the reference frame. If the reference
@@ -89,11 +81,15 @@ void av1_frameworker_wait(AVxWorker *const worker, RefCntBuffer *const ref_buf,
 #endif
 
     av1_frameworker_lock_stats(ref_worker);
-    while (ref_buf->row < row && pbi->cur_buf == ref_buf &&
+    // Register as a waiter before checking the progress again, so that the
+    // owner either sees the waiter or this thread sees the new progress.
+    aom_atomic_add(&ref_buf->row_waiters, 1);
+    while (aom_atomic_load(&ref_buf->row) < row && pbi->cur_buf == ref_buf &&
            ref_buf->buf.corrupted != 1) {
       pthread_cond_wait(&ref_worker_data->stats_cond,
                         &ref_worker_data->stats_mutex);
     }
+    aom_atomic_add(&ref_buf->row_waiters, -1);
 
     if (ref_buf->buf.corrupted == 1) {
       FrameWorkerData *const worker_data = (FrameWorkerData *)worker->data1;
@@ -124,10 +120,13 @@ void av1_frameworker_broadcast(RefCntBuffer *const buf, int row) {
   }
 #endif
 
-  av1_frameworker_lock_stats(worker);
-  buf->row = row;
-  av1_frameworker_signal_stats(worker);
-  av1_frameworker_unlock_stats(worker);
+  aom_atomic_store(&buf->row, row);
+  // Wake the workers waiting for this frame, if any.
+  if (aom_atomic_load(&buf->row_waiters) > 0) {
+    av1_frameworker_lock_stats(worker);
+    av1_frameworker_signal_stats(worker);
+    av1_frameworker_unlock_stats(worker);
+  }
 #else
   (void)buf;
   (void)row;
@@ -171,12 +170,23 @@ void av1_frameworker_copy_context(AVxWorker *const dst_worker,
       !src_cm->show_existing_frame ? src_cm->height : src_cm->last_height;
   dst_cm->subsampling_x = src_cm->subsampling_x;
   dst_cm->subsampling_y = src_cm->subsampling_y;
+  dst_cm->lowbd_420 = src_cm->lowbd_420;
   dst_cm->frame_type = src_cm->frame_type;
   dst_cm->last_show_frame = !src_cm->show_existing_frame
                                 ? src_cm->show_frame
                                 : src_cm->last_show_frame;
   for (i = 0; i < REF_FRAMES; ++i)
     dst_cm->ref_frame_map[i] = src_cm->next_ref_frame_map[i];
+#if CONFIG_REFERENCE_BUFFER
+  dst_cm->current_frame_id = src_cm->current_frame_id;
+  memcpy(dst_cm->ref_frame_id, src_cm->ref_frame_id,
+         sizeof(dst_cm->ref_frame_id));
+  memcpy(dst_cm->valid_for_referencing, src_cm->valid_for_referencing,
+         sizeof(dst_cm->valid_for_referencing));
+#endif  // CONFIG_REFERENCE_BUFFER
+#if CONFIG_ANS && ANS_MAX_SYMBOLS
+  dst_cm->ans_window_size_log2 = src_cm->ans_window_size_log2;
+#endif  // CONFIG_ANS && ANS_MAX_SYMBOLS
 
   memcpy(dst_cm->lf_info.lfthr, src_cm->lf_info.lfthr,
          (MAX_LOOP_FILTER + 1) * sizeof(loop_filter_thresh));
@@ -130,11 +130,13 @@ static struct av1_token switchable_restore_encodings[RESTORE_SWITCHABLE_TYPES];
 static void write_uncompressed_header(AV1_COMP *cpi,
                                       struct aom_write_bit_buffer *wb);
 static uint32_t write_compressed_header(AV1_COMP *cpi, uint8_t *data);
+#if !AV1_PACK_TILES_SEPARATELY
 static int remux_tiles(const AV1_COMMON *const cm, uint8_t *dst,
                        const uint32_t data_size, const uint32_t max_tile_size,
                        const uint32_t max_tile_col_size,
                        int *const tile_size_bytes,
                        int *const tile_col_size_bytes);
+#endif  // !AV1_PACK_TILES_SEPARATELY
 
 void av1_encode_token_init(void) {
 #if CONFIG_EXT_TX || CONFIG_PALETTE
@@ -1305,8 +1307,8 @@ static void write_intra_angle_info(const AV1_COMMON *cm, const MACROBLOCKD *xd,
 }
 #endif  // CONFIG_EXT_INTRA
 
-static void write_mb_interp_filter(AV1_COMP *cpi, const MACROBLOCKD *xd,
-                                   aom_writer *w) {
+static void write_mb_interp_filter(AV1_COMP *cpi, ThreadData *const td,
+                                   const MACROBLOCKD *xd, aom_writer *w) {
   AV1_COMMON *const cm = &cpi->common;
   const MB_MODE_INFO *const mbmi = &xd->mi[0]->mbmi;
 #if CONFIG_EC_ADAPT
@@ -1335,7 +1337,7 @@ static void write_mb_interp_filter(AV1_COMP *cpi, const MACROBLOCKD *xd,
                         ec_ctx->switchable_interp_prob[ctx],
                         &switchable_interp_encodings[mbmi->interp_filter[dir]]);
 #endif
-        ++cpi->interp_filter_selected[0][mbmi->interp_filter[dir]];
+        ++td->interp_filter_selected[mbmi->interp_filter[dir]];
       } else {
         assert(mbmi->interp_filter[dir] == EIGHTTAP_REGULAR);
       }
@@ -1351,7 +1353,7 @@ static void write_mb_interp_filter(AV1_COMP *cpi, const MACROBLOCKD *xd,
                       ec_ctx->switchable_interp_prob[ctx],
                       &switchable_interp_encodings[mbmi->interp_filter]);
 #endif
-      ++cpi->interp_filter_selected[0][mbmi->interp_filter];
+      ++td->interp_filter_selected[mbmi->interp_filter];
     }
 #endif  // CONFIG_DUAL_FILTER
   }
@@ -1522,18 +1524,19 @@ static void write_intra_uv_mode(FRAME_CONTEXT *frame_ctx,
 #endif
 }
 
-static void pack_inter_mode_mvs(AV1_COMP *cpi, const MODE_INFO *mi,
-                                const int mi_row, const int mi_col,
+static void pack_inter_mode_mvs(AV1_COMP *cpi, ThreadData *const td,
+                                const MODE_INFO *mi, const int mi_row,
+                                const int mi_col,
 #if CONFIG_SUPERTX
                                 int supertx_enabled,
 #endif
                                 aom_writer *w) {
   AV1_COMMON *const cm = &cpi->common;
 #if CONFIG_DELTA_Q || CONFIG_EC_ADAPT
-  MACROBLOCK *const x = &cpi->td.mb;
+  MACROBLOCK *const x = &td->mb;
   MACROBLOCKD *const xd = &x->e_mbd;
 #else
-  const MACROBLOCK *x = &cpi->td.mb;
+  const MACROBLOCK *x = &td->mb;
   const MACROBLOCKD *xd = &x->e_mbd;
 #endif
 #if CONFIG_EC_ADAPT
@@ -1709,7 +1712,7 @@ static void pack_inter_mode_mvs(AV1_COMP *cpi, const MODE_INFO *mi,
     }
 
 #if !CONFIG_DUAL_FILTER && !CONFIG_WARPED_MOTION && !CONFIG_GLOBAL_MOTION
-    write_mb_interp_filter(cpi, xd, w);
+    write_mb_interp_filter(cpi, td, xd, w);
 #endif  // !CONFIG_DUAL_FILTER && !CONFIG_WARPED_MOTION
 
     if (bsize < BLOCK_8X8 && !unify_bsize) {
@@ -1906,7 +1909,7 @@ static void pack_inter_mode_mvs(AV1_COMP *cpi, const MODE_INFO *mi,
     if (mbmi->motion_mode != WARPED_CAUSAL)
 #endif  // CONFIG_WARPED_MOTION
 #if CONFIG_DUAL_FILTER || CONFIG_WARPED_MOTION || CONFIG_GLOBAL_MOTION
-      write_mb_interp_filter(cpi, xd, w);
+      write_mb_interp_filter(cpi, td, xd, w);
 #endif  // CONFIG_DUAL_FILTE || CONFIG_WARPED_MOTION
   }
 
@@ -2021,13 +2024,14 @@ static void write_mb_modes_kf(AV1_COMMON *cm, const MACROBLOCKD *xd,
 }
 
 #if CONFIG_SUPERTX
-#define write_modes_b_wrapper(cpi, tile, w, tok, tok_end, supertx_enabled, \
-                              mi_row, mi_col)                              \
-  write_modes_b(cpi, tile, w, tok, tok_end, supertx_enabled, mi_row, mi_col)
+#define write_modes_b_wrapper(cpi, td, tile, w, tok, tok_end,            \
+                              supertx_enabled, mi_row, mi_col)          \
+  write_modes_b(cpi, td, tile, w, tok, tok_end, supertx_enabled, mi_row, \
+                mi_col)
 #else
-#define write_modes_b_wrapper(cpi, tile, w, tok, tok_end, supertx_enabled, \
-                              mi_row, mi_col)                              \
-  write_modes_b(cpi, tile, w, tok, tok_end, mi_row, mi_col)
+#define write_modes_b_wrapper(cpi, td, tile, w, tok, tok_end, \
+                              supertx_enabled, mi_row, mi_col) \
+  write_modes_b(cpi, td, tile, w, tok, tok_end, mi_row, mi_col)
 #endif  // CONFIG_SUPERTX
 
 #if CONFIG_RD_DEBUG
@@ -2073,14 +2077,14 @@ static int rd_token_stats_mismatch(RD_STATS *rd_stats, TOKEN_STATS *token_stats,
 }
 #endif
 
-static void write_mbmi_b(AV1_COMP *cpi, const TileInfo *const tile,
-                         aom_writer *w,
+static void write_mbmi_b(AV1_COMP *cpi, ThreadData *const td,
+                         const TileInfo *const tile, aom_writer *w,
 #if CONFIG_SUPERTX
                          int supertx_enabled,
 #endif
                          int mi_row, int mi_col) {
   AV1_COMMON *const cm = &cpi->common;
-  MACROBLOCKD *const xd = &cpi->td.mb.e_mbd;
+  MACROBLOCKD *const xd = &td->mb.e_mbd;
   MODE_INFO *m;
   int bh, bw;
   xd->mi = cm->mi_grid_visible + (mi_row * cm->mi_stride + mi_col);
@@ -2091,7 +2095,7 @@ static void write_mbmi_b(AV1_COMP *cpi, const TileInfo *const tile,
   bh = mi_size_high[m->mbmi.sb_type];
   bw = mi_size_wide[m->mbmi.sb_type];
 
-  cpi->td.mb.mbmi_ext = cpi->mbmi_ext_base + (mi_row * cm->mi_cols + mi_col);
+  td->mb.mbmi_ext = cpi->mbmi_ext_base + (mi_row * cm->mi_cols + mi_col);
 
 #if CONFIG_DEPENDENT_HORZTILES
   set_mi_row_col(xd, tile, mi_row, bh, mi_col, bw, cm->mi_rows, cm->mi_cols,
@@ -2138,7 +2142,7 @@ static void write_mbmi_b(AV1_COMP *cpi, const TileInfo *const tile,
              m->mbmi.ref_frame[0], m->mbmi.ref_frame[1]);
     }
 #endif  // 0
-    pack_inter_mode_mvs(cpi, m, mi_row, mi_col,
+    pack_inter_mode_mvs(cpi, td, m, mi_row, mi_col,
 #if CONFIG_SUPERTX
                         supertx_enabled,
 #endif
@@ -2146,18 +2150,19 @@ static void write_mbmi_b(AV1_COMP *cpi, const TileInfo *const tile,
   }
 }
 
-static void write_tokens_b(AV1_COMP *cpi, const TileInfo *const tile,
-                           aom_writer *w, const TOKENEXTRA **tok,
+static void write_tokens_b(AV1_COMP *cpi, ThreadData *const td,
+                           const TileInfo *const tile, aom_writer *w,
+                           const TOKENEXTRA **tok,
                            const TOKENEXTRA *const tok_end, int mi_row,
                            int mi_col) {
   AV1_COMMON *const cm = &cpi->common;
-  MACROBLOCKD *const xd = &cpi->td.mb.e_mbd;
+  MACROBLOCKD *const xd = &td->mb.e_mbd;
   MODE_INFO *const m = xd->mi[0];
   MB_MODE_INFO *const mbmi = &m->mbmi;
   int plane;
   int bh, bw;
 #if CONFIG_PVQ
-  MACROBLOCK *const x = &cpi->td.mb;
+  MACROBLOCK *const x = &td->mb;
   (void)tok;
   (void)tok_end;
 #endif
@@ -2167,7 +2172,7 @@ static void write_tokens_b(AV1_COMP *cpi, const TileInfo *const tile,
 
   bh = mi_size_high[mbmi->sb_type];
   bw = mi_size_wide[mbmi->sb_type];
-  cpi->td.mb.mbmi_ext = cpi->mbmi_ext_base + (mi_row * cm->mi_cols + mi_col);
+  td->mb.mbmi_ext = cpi->mbmi_ext_base + (mi_row * cm->mi_cols + mi_col);
 
 #if CONFIG_DEPENDENT_HORZTILES
   set_mi_row_col(xd, tile, mi_row, bh, mi_col, bw, cm->mi_rows, cm->mi_cols,
@@ -2367,8 +2372,9 @@ static void write_tokens_b(AV1_COMP *cpi, const TileInfo *const tile,
 }
 
 #if CONFIG_MOTION_VAR && CONFIG_NCOBMC
-static void write_tokens_sb(AV1_COMP *cpi, const TileInfo *const tile,
-                            aom_writer *w, const TOKENEXTRA **tok,
+static void write_tokens_sb(AV1_COMP *cpi, ThreadData *const td,
+                            const TileInfo *const tile, aom_writer *w,
+                            const TOKENEXTRA **tok,
                             const TOKENEXTRA *const tok_end, int mi_row,
                             int mi_col, BLOCK_SIZE bsize) {
   const AV1_COMMON *const cm = &cpi->common;
@@ -2387,51 +2393,54 @@ static void write_tokens_sb(AV1_COMP *cpi, const TileInfo *const tile,
   subsize = get_subsize(bsize, partition);
 
   if (subsize < BLOCK_8X8 && !unify_bsize) {
-    write_tokens_b(cpi, tile, w, tok, tok_end, mi_row, mi_col);
+    write_tokens_b(cpi, td, tile, w, tok, tok_end, mi_row, mi_col);
   } else {
     switch (partition) {
       case PARTITION_NONE:
-        write_tokens_b(cpi, tile, w, tok, tok_end, mi_row, mi_col);
+        write_tokens_b(cpi, td, tile, w, tok, tok_end, mi_row, mi_col);
         break;
       case PARTITION_HORZ:
-        write_tokens_b(cpi, tile, w, tok, tok_end, mi_row, mi_col);
+        write_tokens_b(cpi, td, tile, w, tok, tok_end, mi_row, mi_col);
         if (mi_row + hbs < cm->mi_rows)
-          write_tokens_b(cpi, tile, w, tok, tok_end, mi_row + hbs, mi_col);
+          write_tokens_b(cpi, td, tile, w, tok, tok_end, mi_row + hbs, mi_col);
         break;
       case PARTITION_VERT:
-        write_tokens_b(cpi, tile, w, tok, tok_end, mi_row, mi_col);
+        write_tokens_b(cpi, td, tile, w, tok, tok_end, mi_row, mi_col);
         if (mi_col + hbs < cm->mi_cols)
-          write_tokens_b(cpi, tile, w, tok, tok_end, mi_row, mi_col + hbs);
+          write_tokens_b(cpi, td, tile, w, tok, tok_end, mi_row, mi_col + hbs);
         break;
       case PARTITION_SPLIT:
-        write_tokens_sb(cpi, tile, w, tok, tok_end, mi_row, mi_col, subsize);
-        write_tokens_sb(cpi, tile, w, tok, tok_end, mi_row, mi_col + hbs,
+        write_tokens_sb(cpi, td, tile, w, tok, tok_end, mi_row, mi_col,
                         subsize);
-        write_tokens_sb(cpi, tile, w, tok, tok_end, mi_row + hbs, mi_col,
+        write_tokens_sb(cpi, td, tile, w, tok, tok_end, mi_row, mi_col + hbs,
                         subsize);
-        write_tokens_sb(cpi, tile, w, tok, tok_end, mi_row + hbs, mi_col + hbs,
+        write_tokens_sb(cpi, td, tile, w, tok, tok_end, mi_row + hbs, mi_col,
                         subsize);
+        write_tokens_sb(cpi, td, tile, w, tok, tok_end, mi_row + hbs,
+                        mi_col + hbs, subsize);
         break;
 #if CONFIG_EXT_PARTITION_TYPES
       case PARTITION_HORZ_A:
-        write_tokens_b(cpi, tile, w, tok, tok_end, mi_row, mi_col);
-        write_tokens_b(cpi, tile, w, tok, tok_end, mi_row, mi_col + hbs);
-        write_tokens_b(cpi, tile, w, tok, tok_end, mi_row + hbs, mi_col);
+        write_tokens_b(cpi, td, tile, w, tok, tok_end, mi_row, mi_col);
+        write_tokens_b(cpi, td, tile, w, tok, tok_end, mi_row, mi_col + hbs);
+        write_tokens_b(cpi, td, tile, w, tok, tok_end, mi_row + hbs, mi_col);
         break;
       case PARTITION_HORZ_B:
-        write_tokens_b(cpi, tile, w, tok, tok_end, mi_row, mi_col);
-        write_tokens_b(cpi, tile, w, tok, tok_end, mi_row + hbs, mi_col);
-        write_tokens_b(cpi, tile, w, tok, tok_end, mi_row + hbs, mi_col + hbs);
+        write_tokens_b(cpi, td, tile, w, tok, tok_end, mi_row, mi_col);
+        write_tokens_b(cpi, td, tile, w, tok, tok_end, mi_row + hbs, mi_col);
+        write_tokens_b(cpi, td, tile, w, tok, tok_end, mi_row + hbs,
+                       mi_col + hbs);
         break;
       case PARTITION_VERT_A:
-        write_tokens_b(cpi, tile, w, tok, tok_end, mi_row, mi_col);
-        write_tokens_b(cpi, tile, w, tok, tok_end, mi_row + hbs, mi_col);
-        write_tokens_b(cpi, tile, w, tok, tok_end, mi_row, mi_col + hbs);
+        write_tokens_b(cpi, td, tile, w, tok, tok_end, mi_row, mi_col);
+        write_tokens_b(cpi, td, tile, w, tok, tok_end, mi_row + hbs, mi_col);
+        write_tokens_b(cpi, td, tile, w, tok, tok_end, mi_row, mi_col + hbs);
         break;
       case PARTITION_VERT_B:
-        write_tokens_b(cpi, tile, w, tok, tok_end, mi_row, mi_col);
-        write_tokens_b(cpi, tile, w, tok, tok_end, mi_row, mi_col + hbs);
-        write_tokens_b(cpi, tile, w, tok, tok_end, mi_row + hbs, mi_col + hbs);
+        write_tokens_b(cpi, td, tile, w, tok, tok_end, mi_row, mi_col);
+        write_tokens_b(cpi, td, tile, w, tok, tok_end, mi_row, mi_col + hbs);
+        write_tokens_b(cpi, td, tile, w, tok, tok_end, mi_row + hbs,
+                       mi_col + hbs);
         break;
 #endif  // CONFIG_EXT_PARTITION_TYPES
       default: assert(0);
@@ -2440,14 +2449,15 @@ static void write_tokens_sb(AV1_COMP *cpi, const TileInfo *const tile,
 }
 #endif
 
-static void write_modes_b(AV1_COMP *cpi, const TileInfo *const tile,
-                          aom_writer *w, const TOKENEXTRA **tok,
+static void write_modes_b(AV1_COMP *cpi, ThreadData *const td,
+                          const TileInfo *const tile, aom_writer *w,
+                          const TOKENEXTRA **tok,
                           const TOKENEXTRA *const tok_end,
 #if CONFIG_SUPERTX
                           int supertx_enabled,
 #endif
                           int mi_row, int mi_col) {
-  write_mbmi_b(cpi, tile, w,
+  write_mbmi_b(cpi, td, tile, w,
 #if CONFIG_SUPERTX
                supertx_enabled,
 #endif
@@ -2459,7 +2469,7 @@ static void write_modes_b(AV1_COMP *cpi, const TileInfo *const tile,
 #if !CONFIG_PVQ && CONFIG_SUPERTX
   if (!supertx_enabled)
 #endif
-    write_tokens_b(cpi, tile, w, tok, tok_end, mi_row, mi_col);
+    write_tokens_b(cpi, td, tile, w, tok, tok_end, mi_row, mi_col);
 #endif
 }
 
@@ -2522,25 +2532,26 @@ static void write_partition(const AV1_COMMON *const cm,
 }
 
 #if CONFIG_SUPERTX
-#define write_modes_sb_wrapper(cpi, tile, w, tok, tok_end, supertx_enabled,   \
-                               mi_row, mi_col, bsize)                         \
-  write_modes_sb(cpi, tile, w, tok, tok_end, supertx_enabled, mi_row, mi_col, \
-                 bsize)
+#define write_modes_sb_wrapper(cpi, td, tile, w, tok, tok_end,            \
+                               supertx_enabled, mi_row, mi_col, bsize)   \
+  write_modes_sb(cpi, td, tile, w, tok, tok_end, supertx_enabled, mi_row, \
+                 mi_col, bsize)
 #else
-#define write_modes_sb_wrapper(cpi, tile, w, tok, tok_end, supertx_enabled, \
-                               mi_row, mi_col, bsize)                       \
-  write_modes_sb(cpi, tile, w, tok, tok_end, mi_row, mi_col, bsize)
+#define write_modes_sb_wrapper(cpi, td, tile, w, tok, tok_end,          \
+                               supertx_enabled, mi_row, mi_col, bsize) \
+  write_modes_sb(cpi, td, tile, w, tok, tok_end, mi_row, mi_col, bsize)
 #endif  // CONFIG_SUPERTX
 
-static void write_modes_sb(AV1_COMP *const cpi, const TileInfo *const tile,
-                           aom_writer *const w, const TOKENEXTRA **tok,
+static void write_modes_sb(AV1_COMP *const cpi, ThreadData *const td,
+                           const TileInfo *const tile, aom_writer *const w,
+                           const TOKENEXTRA **tok,
                            const TOKENEXTRA *const tok_end,
 #if CONFIG_SUPERTX
                            int supertx_enabled,
 #endif
                            int mi_row, int mi_col, BLOCK_SIZE bsize) {
   const AV1_COMMON *const cm = &cpi->common;
-  MACROBLOCKD *const xd = &cpi->td.mb.e_mbd;
+  MACROBLOCKD *const xd = &td->mb.e_mbd;
   const int hbs = mi_size_wide[bsize] / 2;
   const PARTITION_TYPE partition = get_partition(cm, mi_row, mi_col, bsize);
   const BLOCK_SIZE subsize = get_subsize(bsize, partition);
@@ -2584,69 +2595,69 @@ static void write_modes_sb(AV1_COMP *const cpi, const TileInfo *const tile,
   }
 #endif  // CONFIG_SUPERTX
   if (subsize < BLOCK_8X8 && !unify_bsize) {
-    write_modes_b_wrapper(cpi, tile, w, tok, tok_end, supertx_enabled, mi_row,
-                          mi_col);
+    write_modes_b_wrapper(cpi, td, tile, w, tok, tok_end, supertx_enabled,
+                          mi_row, mi_col);
   } else {
     switch (partition) {
       case PARTITION_NONE:
-        write_modes_b_wrapper(cpi, tile, w, tok, tok_end, supertx_enabled,
+        write_modes_b_wrapper(cpi, td, tile, w, tok, tok_end, supertx_enabled,
                               mi_row, mi_col);
         break;
       case PARTITION_HORZ:
-        write_modes_b_wrapper(cpi, tile, w, tok, tok_end, supertx_enabled,
+        write_modes_b_wrapper(cpi, td, tile, w, tok, tok_end, supertx_enabled,
                               mi_row, mi_col);
         if (mi_row + hbs < cm->mi_rows)
-          write_modes_b_wrapper(cpi, tile, w, tok, tok_end, supertx_enabled,
+          write_modes_b_wrapper(cpi, td, tile, w, tok, tok_end, supertx_enabled,
                                 mi_row + hbs, mi_col);
         break;
       case PARTITION_VERT:
-        write_modes_b_wrapper(cpi, tile, w, tok, tok_end, supertx_enabled,
+        write_modes_b_wrapper(cpi, td, tile, w, tok, tok_end, supertx_enabled,
                               mi_row, mi_col);
         if (mi_col + hbs < cm->mi_cols)
-          write_modes_b_wrapper(cpi, tile, w, tok, tok_end, supertx_enabled,
+          write_modes_b_wrapper(cpi, td, tile, w, tok, tok_end, supertx_enabled,
                                 mi_row, mi_col + hbs);
         break;
       case PARTITION_SPLIT:
-        write_modes_sb_wrapper(cpi, tile, w, tok, tok_end, supertx_enabled,
+        write_modes_sb_wrapper(cpi, td, tile, w, tok, tok_end, supertx_enabled,
                                mi_row, mi_col, subsize);
-        write_modes_sb_wrapper(cpi, tile, w, tok, tok_end, supertx_enabled,
+        write_modes_sb_wrapper(cpi, td, tile, w, tok, tok_end, supertx_enabled,
                                mi_row, mi_col + hbs, subsize);
-        write_modes_sb_wrapper(cpi, tile, w, tok, tok_end, supertx_enabled,
+        write_modes_sb_wrapper(cpi, td, tile, w, tok, tok_end, supertx_enabled,
                                mi_row + hbs, mi_col, subsize);
-        write_modes_sb_wrapper(cpi, tile, w, tok, tok_end, supertx_enabled,
+        write_modes_sb_wrapper(cpi, td, tile, w, tok, tok_end, supertx_enabled,
                                mi_row + hbs, mi_col + hbs, subsize);
         break;
 #if CONFIG_EXT_PARTITION_TYPES
       case PARTITION_HORZ_A:
-        write_modes_b_wrapper(cpi, tile, w, tok, tok_end, supertx_enabled,
+        write_modes_b_wrapper(cpi, td, tile, w, tok, tok_end, supertx_enabled,
                               mi_row, mi_col);
-        write_modes_b_wrapper(cpi, tile, w, tok, tok_end, supertx_enabled,
+        write_modes_b_wrapper(cpi, td, tile, w, tok, tok_end, supertx_enabled,
                               mi_row, mi_col + hbs);
-        write_modes_b_wrapper(cpi, tile, w, tok, tok_end, supertx_enabled,
+        write_modes_b_wrapper(cpi, td, tile, w, tok, tok_end, supertx_enabled,
                               mi_row + hbs, mi_col);
         break;
       case PARTITION_HORZ_B:
-        write_modes_b_wrapper(cpi, tile, w, tok, tok_end, supertx_enabled,
+        write_modes_b_wrapper(cpi, td, tile, w, tok, tok_end, supertx_enabled,
                               mi_row, mi_col);
-        write_modes_b_wrapper(cpi, tile, w, tok, tok_end, supertx_enabled,
+        write_modes_b_wrapper(cpi, td, tile, w, tok, tok_end, supertx_enabled,
                               mi_row + hbs, mi_col);
-        write_modes_b_wrapper(cpi, tile, w, tok, tok_end, supertx_enabled,
+        write_modes_b_wrapper(cpi, td, tile, w, tok, tok_end, supertx_enabled,
                               mi_row + hbs, mi_col + hbs);
         break;
       case PARTITION_VERT_A:
-        write_modes_b_wrapper(cpi, tile, w, tok, tok_end, supertx_enabled,
+        write_modes_b_wrapper(cpi, td, tile, w, tok, tok_end, supertx_enabled,
                               mi_row, mi_col);
-        write_modes_b_wrapper(cpi, tile, w, tok, tok_end, supertx_enabled,
+        write_modes_b_wrapper(cpi, td, tile, w, tok, tok_end, supertx_enabled,
                               mi_row + hbs, mi_col);
-        write_modes_b_wrapper(cpi, tile, w, tok, tok_end, supertx_enabled,
+        write_modes_b_wrapper(cpi, td, tile, w, tok, tok_end, supertx_enabled,
                               mi_row, mi_col + hbs);
         break;
       case PARTITION_VERT_B:
-        write_modes_b_wrapper(cpi, tile, w, tok, tok_end, supertx_enabled,
+        write_modes_b_wrapper(cpi, td, tile, w, tok, tok_end, supertx_enabled,
                               mi_row, mi_col);
-        write_modes_b_wrapper(cpi, tile, w, tok, tok_end, supertx_enabled,
+        write_modes_b_wrapper(cpi, td, tile, w, tok, tok_end, supertx_enabled,
                               mi_row, mi_col + hbs);
-        write_modes_b_wrapper(cpi, tile, w, tok, tok_end, supertx_enabled,
+        write_modes_b_wrapper(cpi, td, tile, w, tok, tok_end, supertx_enabled,
                               mi_row + hbs, mi_col + hbs);
         break;
 #endif  // CONFIG_EXT_PARTITION_TYPES
@@ -2829,11 +2840,12 @@ static void write_modes_sb(AV1_COMP *const cpi, const TileInfo *const tile,
 #endif  // CONFIG_CDEF
 }
 
-static void write_modes(AV1_COMP *const cpi, const TileInfo *const tile,
-                        aom_writer *const w, const TOKENEXTRA **tok,
+static void write_modes(AV1_COMP *const cpi, ThreadData *const td,
+                        const TileInfo *const tile, aom_writer *const w,
+                        const TOKENEXTRA **tok,
                         const TOKENEXTRA *const tok_end) {
   AV1_COMMON *const cm = &cpi->common;
-  MACROBLOCKD *const xd = &cpi->td.mb.e_mbd;
+  MACROBLOCKD *const xd = &td->mb.e_mbd;
   const int mi_row_start = tile->mi_row_start;
   const int mi_row_end = tile->mi_row_end;
   const int mi_col_start = tile->mi_col_start;
@@ -2853,7 +2865,7 @@ static void write_modes(AV1_COMP *const cpi, const TileInfo *const tile,
   av1_zero_above_context(cm, mi_col_start, mi_col_end);
 #endif
 #if CONFIG_PVQ
-  assert(cpi->td.mb.pvq_q->curr_pos == 0);
+  assert(td->mb.pvq_q->curr_pos == 0);
 #endif
 #if CONFIG_DELTA_Q
   if (cpi->common.delta_q_present_flag) {
@@ -2865,19 +2877,20 @@ static void write_modes(AV1_COMP *const cpi, const TileInfo *const tile,
     av1_zero_left_context(xd);
 
     for (mi_col = mi_col_start; mi_col < mi_col_end; mi_col += cm->mib_size) {
-      write_modes_sb_wrapper(cpi, tile, w, tok, tok_end, 0, mi_row, mi_col,
+      write_modes_sb_wrapper(cpi, td, tile, w, tok, tok_end, 0, mi_row, mi_col,
                              cm->sb_size);
 #if CONFIG_MOTION_VAR && CONFIG_NCOBMC
-      write_tokens_sb(cpi, tile, w, tok, tok_end, mi_row, mi_col, cm->sb_size);
+      write_tokens_sb(cpi, td, tile, w, tok, tok_end, mi_row, mi_col,
+                      cm->sb_size);
 #endif
     }
   }
 #if CONFIG_PVQ
   // Check that the number of PVQ blocks encoded and written to the bitstream
   // are the same
-  assert(cpi->td.mb.pvq_q->curr_pos == cpi->td.mb.pvq_q->last_pos);
+  assert(td->mb.pvq_q->curr_pos == td->mb.pvq_q->last_pos);
   // Reset curr_pos in case we repack the bitstream
-  cpi->td.mb.pvq_q->curr_pos = 0;
+  td->mb.pvq_q->curr_pos = 0;
 #endif
 }
 
@@ -3878,6 +3891,193 @@ static INLINE int find_identical_tile(
 }
 #endif  // CONFIG_EXT_TILE
 
+static int choose_size_bytes(uint32_t size, int spare_msbs) {
+  // Choose the number of bytes required to represent size, without
+  // using the 'spare_msbs' number of most significant bits.
+
+  // Make sure we will fit in 4 bytes to start with..
+  if (spare_msbs > 0 && size >> (32 - spare_msbs) != 0) return -1;
+
+  // Normalise to 32 bits
+  size <<= spare_msbs;
+
+  if (size >> 24 != 0)
+    return 4;
+  else if (size >> 16 != 0)
+    return 3;
+  else if (size >> 8 != 0)
+    return 2;
+  else
+    return 1;
+}
+
+static void mem_put_varsize(uint8_t *const dst, const int sz, const int val) {
+  switch (sz) {
+    case 1: dst[0] = (uint8_t)(val & 0xff); break;
+    case 2: mem_put_le16(dst, val); break;
+    case 3: mem_put_le24(dst, val); break;
+    case 4: mem_put_le32(dst, val); break;
+    default: assert("Invalid size" && 0); break;
+  }
+}
+#if AV1_PACK_TILES_SEPARATELY
+void av1_pack_tile(AV1_COMP *const cpi, ThreadData *const td, int tile_row,
+                   int tile_col) {
+  const AV1_COMMON *const cm = &cpi->common;
+  TileBufferEnc *const buf = &cpi->tile_buffers[tile_row][tile_col];
+  const TOKENEXTRA *tok = cpi->tile_tok[tile_row][tile_col];
+  const TOKENEXTRA *const tok_end = tok + cpi->tok_count[tile_row][tile_col];
+#if CONFIG_EC_ADAPT
+  TileDataEnc *const this_tile =
+      &cpi->tile_data[tile_row * cm->tile_cols + tile_col];
+#endif
+  TileInfo tile_info;
+  aom_writer mode_bc;
+
+  av1_tile_init(&tile_info, cm, tile_row, tile_col);
+
+  aom_start_encode_pooled(&mode_bc, buf->data, &cpi->writer_pool,
+                          tile_row * cm->tile_cols + tile_col);
+  aom_writer_set_buffer_size(&mode_bc, (unsigned int)buf->size);
+#if CONFIG_EC_ADAPT
+  // Initialise tile context from the frame context
+  this_tile->tctx = *cm->fc;
+  td->mb.e_mbd.tile_ctx = &this_tile->tctx;
+#endif
+  write_modes(cpi, td, &tile_info, &mode_bc, &tok, tok_end);
+  assert(tok == tok_end);
+  aom_stop_encode(&mode_bc);
+  buf->size = mode_bc.pos;
+}
+
+// Buffer size to pack a tile into: its raw pixels plus some room for tiles
+// that do not compress at all. The last tile rows or columns may start past
+// the end of the frame and be empty.
+static size_t get_tile_buf_size(const AV1_COMMON *const cm,
+                                const TileInfo *const tile) {
+  const int mi_rows = AOMMAX(tile->mi_row_end - tile->mi_row_start, 0);
+  const int mi_cols = AOMMAX(tile->mi_col_end - tile->mi_col_start, 0);
+  const size_t luma = (size_t)mi_rows * mi_cols * MI_SIZE * MI_SIZE;
+  size_t size = luma + 2 * (luma >> (cm->subsampling_x + cm->subsampling_y));
+#if CONFIG_AOM_HIGHBITDEPTH
+  if (cm->use_highbitdepth) size *= 2;
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+  return size + (size >> 3) + 16;
+}
+
+// Packs the tiles into buffers of get_tile_buf_size() << shift bytes each,
+// concurrently when there are worker threads. Returns 0 if a tile did not fit
+// in its buffer.
+static int pack_tiles(AV1_COMP *const cpi, int shift) {
+  AV1_COMMON *const cm = &cpi->common;
+  TileBufferEnc(*const tile_buffers)[MAX_TILE_COLS] = cpi->tile_buffers;
+  const int tile_cols = cm->tile_cols;
+  const int tile_rows = cm->tile_rows;
+  size_t buf_size = 0;
+  int tile_row, tile_col;
+
+  for (tile_row = 0; tile_row < tile_rows; tile_row++) {
+    for (tile_col = 0; tile_col < tile_cols; tile_col++) {
+      TileInfo tile_info;
+      av1_tile_init(&tile_info, cm, tile_row, tile_col);
+      tile_buffers[tile_row][tile_col].size = get_tile_buf_size(cm, &tile_info)
+                                              << shift;
+      buf_size += tile_buffers[tile_row][tile_col].size;
+    }
+  }
+  // The writers count the bytes of a tile in an unsigned int.
+  if (buf_size > UINT_MAX)
+    aom_internal_error(&cm->error, AOM_CODEC_MEM_ERROR,
+                       "Tile buffers too large");
+
+  if (buf_size > cpi->tile_pack_buf_size) {
+    aom_free(cpi->tile_pack_buf);
+    CHECK_MEM_ERROR(cm, cpi->tile_pack_buf, aom_malloc(buf_size));
+    cpi->tile_pack_buf_size = buf_size;
+  }
+
+  buf_size = 0;
+  for (tile_row = 0; tile_row < tile_rows; tile_row++) {
+    for (tile_col = 0; tile_col < tile_cols; tile_col++) {
+      TileBufferEnc *const buf = &tile_buffers[tile_row][tile_col];
+      buf->data = cpi->tile_pack_buf + buf_size;
+      buf_size += buf->size;
+    }
+  }
+
+  if (cpi->oxcf.max_threads > 1 && tile_cols > 1 && !CONFIG_BITSTREAM_DEBUG) {
+    av1_pack_tiles_mt(cpi);
+  } else {
+    for (tile_row = 0; tile_row < tile_rows; tile_row++)
+      for (tile_col = 0; tile_col < tile_cols; tile_col++)
+        av1_pack_tile(cpi, &cpi->td, tile_row, tile_col);
+  }
+
+  // av1_pack_tile() set the size each tile needs, and cut its data short if
+  // that is more than its buffer holds.
+  for (tile_row = 0; tile_row < tile_rows; tile_row++) {
+    for (tile_col = 0; tile_col < tile_cols; tile_col++) {
+      TileInfo tile_info;
+      av1_tile_init(&tile_info, cm, tile_row, tile_col);
+      if (tile_buffers[tile_row][tile_col].size >
+          get_tile_buf_size(cm, &tile_info) << shift)
+        return 0;
+    }
+  }
+  return 1;
+}
+
+// Packs each tile into its own buffer, then joins them in dst. The tile size
+// fields are written directly on the number of bytes needed by the largest
+// tile, so no remux is needed.
+static uint32_t write_tiles_separately(AV1_COMP *const cpi, uint8_t *const dst,
+                                       unsigned int *max_tile_size) {
+  AV1_COMMON *const cm = &cpi->common;
+  TileBufferEnc(*const tile_buffers)[MAX_TILE_COLS] = cpi->tile_buffers;
+  const int tile_cols = cm->tile_cols;
+  const int tile_rows = cm->tile_rows;
+  size_t total_size = 0;
+  int tile_row, tile_col, tile_size_bytes, shift = 0;
+
+  // Tiles that do not fit in their buffers are packed again into larger
+  // ones, counting their interpolation filters anew.
+  while (!pack_tiles(cpi, shift)) {
+    av1_zero(cpi->td.interp_filter_selected);
+    ++shift;
+  }
+
+  // The last tile does not have a header.
+  *max_tile_size = 0;
+  for (tile_row = 0; tile_row < tile_rows; tile_row++) {
+    for (tile_col = 0; tile_col < tile_cols; tile_col++) {
+      const int is_last_tile =
+          tile_row == tile_rows - 1 && tile_col == tile_cols - 1;
+      assert(tile_buffers[tile_row][tile_col].size > 0);
+      if (!is_last_tile)
+        *max_tile_size = AOMMAX(*max_tile_size,
+                                tile_buffers[tile_row][tile_col].size);
+    }
+  }
+  tile_size_bytes = choose_size_bytes(*max_tile_size, 0);
+
+  for (tile_row = 0; tile_row < tile_rows; tile_row++) {
+    for (tile_col = 0; tile_col < tile_cols; tile_col++) {
+      const TileBufferEnc *const buf = &tile_buffers[tile_row][tile_col];
+      const int is_last_tile =
+          tile_row == tile_rows - 1 && tile_col == tile_cols - 1;
+      if (!is_last_tile) {
+        mem_put_varsize(dst + total_size, tile_size_bytes, (int)buf->size);
+        total_size += tile_size_bytes;
+      }
+      memcpy(dst + total_size, buf->data, buf->size);
+      total_size += buf->size;
+    }
+  }
+
+  return (uint32_t)total_size;
+}
+#endif  // AV1_PACK_TILES_SEPARATELY
+
 #if CONFIG_TILE_GROUPS
 static uint32_t write_tiles(AV1_COMP *const cpi,
                             struct aom_write_bit_buffer *wb,
@@ -3928,9 +4128,12 @@ static uint32_t write_tiles(AV1_COMP *const cpi, uint8_t *const dst,
 
   *max_tile_size = 0;
   *max_tile_col_size = 0;
+  // Counted while packing; av1_pack_bitstream() accumulates them per frame.
+  av1_zero(cpi->td.interp_filter_selected);
 
-// All tile size fields are output on 4 bytes. A call to remux_tiles will
-// later compact the data if smaller headers are adequate.
+// Unless the tiles are packed separately, all tile size fields are output on
+// 4 bytes. A call to remux_tiles will later compact the data if smaller
+// headers are adequate.
 
 #if CONFIG_EXT_TILE
   for (tile_col = 0; tile_col < tile_cols; tile_col++) {
@@ -3957,14 +4160,16 @@ static uint32_t write_tiles(AV1_COMP *const cpi, uint8_t *const dst,
       // even for the last one, unless no tiling is used at all.
       total_size += data_offset;
 #if !CONFIG_ANS
-      aom_start_encode(&mode_bc, buf->data + data_offset);
-      write_modes(cpi, &tile_info, &mode_bc, &tok, tok_end);
+      aom_start_encode_pooled(&mode_bc, buf->data + data_offset,
+                              &cpi->writer_pool,
+                              tile_row * tile_cols + tile_col);
+      write_modes(cpi, &cpi->td, &tile_info, &mode_bc, &tok, tok_end);
       assert(tok == tok_end);
       aom_stop_encode(&mode_bc);
       tile_size = mode_bc.pos;
 #else
       buf_ans_write_init(buf_ans, buf->data + data_offset);
-      write_modes(cpi, &tile_info, buf_ans, &tok, tok_end);
+      write_modes(cpi, &cpi->td, &tile_info, buf_ans, &tok, tok_end);
       assert(tok == tok_end);
       aom_buf_ans_flush(buf_ans);
       tile_size = buf_ans_write_end(buf_ans);
@@ -4043,6 +4248,11 @@ static uint32_t write_tiles(AV1_COMP *const cpi, uint8_t *const dst,
   total_size += hdr_size;
 #endif
 
+#if AV1_PACK_TILES_SEPARATELY
+  if (tile_rows * tile_cols > 1)
+    return write_tiles_separately(cpi, dst, max_tile_size);
+#endif  // AV1_PACK_TILES_SEPARATELY
+
   for (tile_row = 0; tile_row < tile_rows; tile_row++) {
     TileInfo tile_info;
     const int is_last_row = (tile_row == tile_rows - 1);
@@ -4125,12 +4335,13 @@ static uint32_t write_tiles(AV1_COMP *const cpi, uint8_t *const dst,
 
 #if CONFIG_ANS
       buf_ans_write_init(buf_ans, dst + total_size);
-      write_modes(cpi, &tile_info, buf_ans, &tok, tok_end);
+      write_modes(cpi, &cpi->td, &tile_info, buf_ans, &tok, tok_end);
       assert(tok == tok_end);
       aom_buf_ans_flush(buf_ans);
       tile_size = buf_ans_write_end(buf_ans);
 #else
-      aom_start_encode(&mode_bc, dst + total_size);
+      aom_start_encode_pooled(&mode_bc, dst + total_size, &cpi->writer_pool,
+                              tile_row * tile_cols + tile_col);
 #if CONFIG_PVQ
       // NOTE: This will not work with CONFIG_ANS turned on.
       od_adapt_ctx_reset(&cpi->td.mb.daala_enc.state.adapt, 0);
@@ -4141,7 +4352,7 @@ static uint32_t write_tiles(AV1_COMP *const cpi, uint8_t *const dst,
       this_tile->tctx = *cm->fc;
       cpi->td.mb.e_mbd.tile_ctx = &this_tile->tctx;
 #endif
-      write_modes(cpi, &tile_info, &mode_bc, &tok, tok_end);
+      write_modes(cpi, &cpi->td, &tile_info, &mode_bc, &tok, tok_end);
       assert(tok == tok_end);
       aom_stop_encode(&mode_bc);
       tile_size = mode_bc.pos;
@@ -4632,7 +4843,9 @@ static uint32_t write_compressed_header(AV1_COMP *cpi, uint8_t *data) {
 #else
   aom_writer real_header_bc;
   header_bc = &real_header_bc;
-  aom_start_encode(header_bc, data);
+  // The entry after those of the tiles is kept for the compressed header.
+  aom_start_encode_pooled(header_bc, data, &cpi->writer_pool,
+                          cm->tile_rows * cm->tile_cols);
 #endif
 
 #if CONFIG_LOOP_RESTORATION
@@ -4857,35 +5070,7 @@ static uint32_t write_compressed_header(AV1_COMP *cpi, uint8_t *data) {
 #endif  // CONFIG_ANS
 }
 
-static int choose_size_bytes(uint32_t size, int spare_msbs) {
-  // Choose the number of bytes required to represent size, without
-  // using the 'spare_msbs' number of most significant bits.
-
-  // Make sure we will fit in 4 bytes to start with..
-  if (spare_msbs > 0 && size >> (32 - spare_msbs) != 0) return -1;
-
-  // Normalise to 32 bits
-  size <<= spare_msbs;
-
-  if (size >> 24 != 0)
-    return 4;
-  else if (size >> 16 != 0)
-    return 3;
-  else if (size >> 8 != 0)
-    return 2;
-  else
-    return 1;
-}
-
-static void mem_put_varsize(uint8_t *const dst, const int sz, const int val) {
-  switch (sz) {
-    case 1: dst[0] = (uint8_t)(val & 0xff); break;
-    case 2: mem_put_le16(dst, val); break;
-    case 3: mem_put_le24(dst, val); break;
-    case 4: mem_put_le32(dst, val); break;
-    default: assert("Invalid size" && 0); break;
-  }
-}
+#if !AV1_PACK_TILES_SEPARATELY
 static int remux_tiles(const AV1_COMMON *const cm, uint8_t *dst,
                        const uint32_t data_size, const uint32_t max_tile_size,
                        const uint32_t max_tile_col_size,
@@ -4983,6 +5168,23 @@ static int remux_tiles(const AV1_COMMON *const cm, uint8_t *dst,
     return wpos;
   }
 }
+#endif  // !AV1_PACK_TILES_SEPARATELY
+
+// Makes sure the writer pool has an entry for each tile plus one for the
+// compressed header. The entries start with room for a quarter of the
+// uncompressed size of an average tile, and any growth beyond that is kept
+// from one frame to the next.
+static void alloc_writer_pool(AV1_COMP *const cpi) {
+  AV1_COMMON *const cm = &cpi->common;
+  const int num_tiles = cm->tile_rows * cm->tile_cols;
+  if (cpi->writer_pool.size < num_tiles + 1) {
+    const uint32_t frame_bytes = (uint32_t)(cm->width * cm->height * 3 / 2);
+    if (aom_writer_pool_alloc(&cpi->writer_pool, num_tiles + 1,
+                              frame_bytes / 4 / num_tiles))
+      aom_internal_error(&cm->error, AOM_CODEC_MEM_ERROR,
+                         "Failed to allocate entropy writer pool");
+  }
+}
 
 void av1_pack_bitstream(AV1_COMP *const cpi, uint8_t *dst, size_t *size) {
   uint8_t *data = dst;
@@ -4996,14 +5198,19 @@ void av1_pack_bitstream(AV1_COMP *const cpi, uint8_t *dst, size_t *size) {
 
   unsigned int max_tile_size;
   unsigned int max_tile_col_size;
+  int i;
 
 #if CONFIG_BITSTREAM_DEBUG
   bitstream_queue_reset_write();
 #endif
 
+  alloc_writer_pool(cpi);
+
 #if !CONFIG_TILE_GROUPS
   int tile_size_bytes;
+#if !AV1_PACK_TILES_SEPARATELY
   int tile_col_size_bytes;
+#endif  // !AV1_PACK_TILES_SEPARATELY
   AV1_COMMON *const cm = &cpi->common;
   const int have_tiles = cm->tile_cols * cm->tile_rows > 1;
 
@@ -5047,11 +5254,19 @@ void av1_pack_bitstream(AV1_COMP *const cpi, uint8_t *dst, size_t *size) {
 #else
   data_size = write_tiles(cpi, &wb, &max_tile_size, &max_tile_col_size);
 #endif
+  for (i = 0; i < SWITCHABLE; ++i)
+    cpi->interp_filter_selected[0][i] += cpi->td.interp_filter_selected[i];
 #if !CONFIG_TILE_GROUPS
   if (have_tiles) {
+#if AV1_PACK_TILES_SEPARATELY
+    // The tile size fields have already been written on this many bytes.
+    tile_size_bytes = choose_size_bytes(max_tile_size, 0);
+    (void)max_tile_col_size;
+#else
     data_size =
         remux_tiles(cm, data, data_size, max_tile_size, max_tile_col_size,
                     &tile_size_bytes, &tile_col_size_bytes);
+#endif  // AV1_PACK_TILES_SEPARATELY
   }
 
   data += data_size;
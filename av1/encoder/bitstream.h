@@ -22,8 +22,21 @@ extern "C" {
 void write_sequence_header(SequenceHeader *seq_params);
 #endif
 
+// Multi-tile frames are packed into separate buffers, in parallel when
+// there are worker threads, and then joined with tile size fields of the
+// final width. The other configurations still pack the tiles in place and
+// remux the tile size fields afterwards.
+#define AV1_PACK_TILES_SEPARATELY \
+  (!CONFIG_EXT_TILE && !CONFIG_TILE_GROUPS && !CONFIG_ANS && !CONFIG_PVQ)
+
 void av1_pack_bitstream(AV1_COMP *const cpi, uint8_t *dest, size_t *size);
 
+#if AV1_PACK_TILES_SEPARATELY
+// Packs the modes and tokens of one tile into cpi->tile_buffers.
+void av1_pack_tile(AV1_COMP *const cpi, ThreadData *const td, int tile_row,
+                   int tile_col);
+#endif  // AV1_PACK_TILES_SEPARATELY
+
 void av1_encode_token_init(void);
 
 static INLINE int av1_preserve_existing_gf(AV1_COMP *cpi) {
@@ -169,8 +169,9 @@ struct macroblock {
   int skip_chroma_rd;
 #endif
 
-  // note that token_costs is the cost when eob node is skipped
-  av1_coeff_cost token_costs[TX_SIZES];
+  // note that token_costs is the cost when eob node is skipped. The table is
+  // owned by AV1_COMP and shared by all threads.
+  av1_coeff_cost *token_costs;
 
   int optimize;
 
@@ -14,6 +14,9 @@
 #include "aom/aom_image.h"
 #include "aom/aom_integer.h"
 #include "av1/common/quant_common.h"
+#include "av1/encoder/clpf_rdo.h"
+#include "av1/encoder/encoder.h"
+#include "av1/encoder/ethread.h"
 
 // Calculate the error of a filtered and unfiltered block
 void aom_clpf_detect_c(const uint8_t *rec, const uint8_t *org, int rstride,
@@ -183,6 +186,58 @@ int av1_clpf_decision(int k, int l, const YV12_BUFFER_CONFIG *rec,
   return *res;
 }
 
+void av1_clpf_detect_row(const AV1_COMMON *cm, const ClpfRdoJob *job,
+                         int row) {
+  const YV12_BUFFER_CONFIG *const rec = job->rec;
+  const YV12_BUFFER_CONFIG *const org = job->org;
+  const int plane = job->plane;
+  const int bs = MI_SIZE;
+  const int bslog = get_msb(bs);
+  const int rows = 1 << (MAX_FB_SIZE_LOG2 - bslog);
+  const int row_end = AOMMIN((row + 1) * rows, job->block_rows);
+  uint8_t *rec_buffer =
+      plane != AOM_PLANE_Y
+          ? (plane == AOM_PLANE_U ? rec->u_buffer : rec->v_buffer)
+          : rec->y_buffer;
+  uint8_t *org_buffer =
+      plane != AOM_PLANE_Y
+          ? (plane == AOM_PLANE_U ? org->u_buffer : org->v_buffer)
+          : org->y_buffer;
+  int rec_width = plane != AOM_PLANE_Y ? rec->uv_crop_width : rec->y_crop_width;
+  int rec_height =
+      plane != AOM_PLANE_Y ? rec->uv_crop_height : rec->y_crop_height;
+  int rec_stride = plane != AOM_PLANE_Y ? rec->uv_stride : rec->y_stride;
+  int org_stride = plane != AOM_PLANE_Y ? org->uv_stride : org->y_stride;
+  int damping =
+      cm->bit_depth - 5 - (plane != AOM_PLANE_Y) + (cm->base_qindex >> 6);
+  int m, n;
+
+  for (m = row * rows; m < row_end; m++) {
+    for (n = 0; n < job->block_cols; n++) {
+      int *const sum = job->block_sums[m * job->block_cols + n];
+      int xpos = n << bslog;
+      int ypos = m << bslog;
+      sum[0] = sum[1] = sum[2] = sum[3] = 0;
+#if CONFIG_AOM_HIGHBITDEPTH
+      if (cm->use_highbitdepth) {
+        aom_clpf_detect_multi_hbd(
+            CONVERT_TO_SHORTPTR(rec_buffer), CONVERT_TO_SHORTPTR(org_buffer),
+            rec_stride, org_stride, xpos, ypos, rec_width, rec_height, sum, bs,
+            cm->bit_depth, damping);
+      } else {
+        aom_clpf_detect_multi(rec_buffer, org_buffer, rec_stride, org_stride,
+                              xpos, ypos, rec_width, rec_height, sum, bs,
+                              damping);
+      }
+#else
+      aom_clpf_detect_multi(rec_buffer, org_buffer, rec_stride, org_stride,
+                            xpos, ypos, rec_width, rec_height, sum, bs,
+                            damping);
+#endif
+    }
+  }
+}
+
 // Calculate the square error of all filter settings.  Result:
 // res[0][0]   : unfiltered
 // res[0][1-3] : strength=1,2,4, no signals
@@ -195,30 +250,16 @@ int av1_clpf_decision(int k, int l, const YV12_BUFFER_CONFIG *rec,
 // res[2][1-3] : strength=1,2,4, fb size = 64
 // res[3][0]   : (bit count, fb size = 32)
 // res[3][1-3] : strength=1,2,4, fb size = 32
-static int clpf_rdo(int y, int x, const YV12_BUFFER_CONFIG *rec,
-                    const YV12_BUFFER_CONFIG *org, const AV1_COMMON *cm,
+// The square errors of the blocks are read from job->block_sums.
+static int clpf_rdo(int y, int x, const ClpfRdoJob *job, const AV1_COMMON *cm,
                     unsigned int block_size, unsigned int fb_size_log2, int w,
-                    int h, int64_t res[4][8], int plane) {
+                    int h, int64_t res[4][8]) {
   int c, m, n, filtered = 0;
   int sum[8];
-  const int subx = plane != AOM_PLANE_Y && rec->subsampling_x;
-  const int suby = plane != AOM_PLANE_Y && rec->subsampling_y;
+  const int plane = job->plane;
+  const int subx = plane != AOM_PLANE_Y && job->rec->subsampling_x;
+  const int suby = plane != AOM_PLANE_Y && job->rec->subsampling_y;
   int bslog = get_msb(block_size);
-  uint8_t *rec_buffer =
-      plane != AOM_PLANE_Y
-          ? (plane == AOM_PLANE_U ? rec->u_buffer : rec->v_buffer)
-          : rec->y_buffer;
-  uint8_t *org_buffer =
-      plane != AOM_PLANE_Y
-          ? (plane == AOM_PLANE_U ? org->u_buffer : org->v_buffer)
-          : org->y_buffer;
-  int rec_width = plane != AOM_PLANE_Y ? rec->uv_crop_width : rec->y_crop_width;
-  int rec_height =
-      plane != AOM_PLANE_Y ? rec->uv_crop_height : rec->y_crop_height;
-  int rec_stride = plane != AOM_PLANE_Y ? rec->uv_stride : rec->y_stride;
-  int org_stride = plane != AOM_PLANE_Y ? org->uv_stride : org->y_stride;
-  int damping =
-      cm->bit_depth - 5 - (plane != AOM_PLANE_Y) + (cm->base_qindex >> 6);
 
   sum[0] = sum[1] = sum[2] = sum[3] = sum[4] = sum[5] = sum[6] = sum[7] = 0;
   if (plane == AOM_PLANE_Y &&
@@ -237,17 +278,16 @@ static int clpf_rdo(int y, int x, const YV12_BUFFER_CONFIG *rec,
     oldfiltered = (int)res[i][0];
     res[i][0] = 0;
 
-    filtered |= clpf_rdo(y, x, rec, org, cm, block_size, fb_size_log2, w1, h1,
-                         res, plane);
+    filtered |= clpf_rdo(y, x, job, cm, block_size, fb_size_log2, w1, h1, res);
     if (1 << (fb_size_log2 - bslog) < w)
-      filtered |= clpf_rdo(y, x + (1 << fb_size_log2), rec, org, cm, block_size,
-                           fb_size_log2, w2, h1, res, plane);
+      filtered |= clpf_rdo(y, x + (1 << fb_size_log2), job, cm, block_size,
+                           fb_size_log2, w2, h1, res);
     if (1 << (fb_size_log2 - bslog) < h) {
-      filtered |= clpf_rdo(y + (1 << fb_size_log2), x, rec, org, cm, block_size,
-                           fb_size_log2, w1, h2, res, plane);
+      filtered |= clpf_rdo(y + (1 << fb_size_log2), x, job, cm, block_size,
+                           fb_size_log2, w1, h2, res);
       filtered |=
-          clpf_rdo(y + (1 << fb_size_log2), x + (1 << fb_size_log2), rec, org,
-                   cm, block_size, fb_size_log2, w2, h2, res, plane);
+          clpf_rdo(y + (1 << fb_size_log2), x + (1 << fb_size_log2), job, cm,
+                   block_size, fb_size_log2, w2, h2, res);
     }
 
     // Correct sums for unfiltered blocks
@@ -274,22 +314,12 @@ static int clpf_rdo(int y, int x, const YV12_BUFFER_CONFIG *rec,
           !!cm->mi_grid_visible[(ypos << suby) / MI_SIZE * cm->mi_stride +
                                 (xpos << subx) / MI_SIZE]
                 ->mbmi.skip;
-#if CONFIG_AOM_HIGHBITDEPTH
-      if (cm->use_highbitdepth) {
-        aom_clpf_detect_multi_hbd(
-            CONVERT_TO_SHORTPTR(rec_buffer), CONVERT_TO_SHORTPTR(org_buffer),
-            rec_stride, org_stride, xpos, ypos, rec_width, rec_height,
-            sum + skip, block_size, cm->bit_depth, damping);
-      } else {
-        aom_clpf_detect_multi(rec_buffer, org_buffer, rec_stride, org_stride,
-                              xpos, ypos, rec_width, rec_height, sum + skip,
-                              block_size, damping);
-      }
-#else
-      aom_clpf_detect_multi(rec_buffer, org_buffer, rec_stride, org_stride,
-                            xpos, ypos, rec_width, rec_height, sum + skip,
-                            block_size, damping);
-#endif
+      const int *const block_sum =
+          job->block_sums[(ypos >> bslog) * job->block_cols + (xpos >> bslog)];
+      sum[skip] += block_sum[0];
+      sum[skip + 1] += block_sum[1];
+      sum[skip + 2] += block_sum[2];
+      sum[skip + 3] += block_sum[3];
       filtered |= !skip;
     }
   }
@@ -309,9 +339,11 @@ static int clpf_rdo(int y, int x, const YV12_BUFFER_CONFIG *rec,
   return filtered;
 }
 
-void av1_clpf_test_frame(const YV12_BUFFER_CONFIG *rec,
-                         const YV12_BUFFER_CONFIG *org, const AV1_COMMON *cm,
-                         int *best_strength, int *best_bs, int plane) {
+void av1_clpf_test_frame(AV1_COMP *cpi, const YV12_BUFFER_CONFIG *rec,
+                         const YV12_BUFFER_CONFIG *org, int *best_strength,
+                         int *best_bs, int plane) {
+  AV1_COMMON *const cm = &cpi->common;
+  ClpfRdoJob job;
   int c, j, k, l;
   int64_t best, sums[4][8];
   int width = plane != AOM_PLANE_Y ? rec->uv_crop_width : rec->y_crop_width;
@@ -321,6 +353,32 @@ void av1_clpf_test_frame(const YV12_BUFFER_CONFIG *rec,
   int fb_size_log2 = get_msb(MAX_FB_SIZE);
   int num_fb_ver = (height + (1 << fb_size_log2) - bs) >> fb_size_log2;
   int num_fb_hor = (width + (1 << fb_size_log2) - bs) >> fb_size_log2;
+  int size;
+
+  // Only whole blocks inside the frame are measured.
+  job.rec = rec;
+  job.org = org;
+  job.plane = plane;
+  job.block_cols = width >> bslog;
+  job.block_rows = height >> bslog;
+  job.num_rows = (job.block_rows + (1 << (fb_size_log2 - bslog)) - 1) >>
+                 (fb_size_log2 - bslog);
+  size = job.block_cols * job.block_rows;
+  if (size > cpi->clpf_block_sums_size) {
+    aom_free(cpi->clpf_block_sums);
+    cpi->clpf_block_sums_size = 0;
+    CHECK_MEM_ERROR(cm, cpi->clpf_block_sums,
+                    aom_malloc(size * sizeof(*cpi->clpf_block_sums)));
+    cpi->clpf_block_sums_size = size;
+  }
+  job.block_sums = cpi->clpf_block_sums;
+
+  // Every block row only writes its own square errors.
+  if (cpi->oxcf.max_threads > 1 && job.num_rows > 1) {
+    av1_clpf_detect_rows_mt(cpi, &job);
+  } else {
+    for (k = 0; k < job.num_rows; k++) av1_clpf_detect_row(cm, &job, k);
+  }
 
   memset(sums, 0, sizeof(sums));
 
@@ -328,8 +386,8 @@ void av1_clpf_test_frame(const YV12_BUFFER_CONFIG *rec,
     // Use a block size of MI_SIZE regardless of the subsampling.  This
     // This is accurate enough to determine the best strength and
     // we don't need to add SIMD optimisations for 4x4 blocks.
-    clpf_rdo(0, 0, rec, org, cm, bs, fb_size_log2, width >> bslog,
-             height >> bslog, sums, plane);
+    clpf_rdo(0, 0, &job, cm, bs, fb_size_log2, width >> bslog, height >> bslog,
+             sums);
   else
     for (k = 0; k < num_fb_ver; k++) {
       for (l = 0; l < num_fb_hor; l++) {
@@ -340,8 +398,8 @@ void av1_clpf_test_frame(const YV12_BUFFER_CONFIG *rec,
             AOMMIN(width, (l + 1) << fb_size_log2) & ((1 << fb_size_log2) - 1);
         h += !h << fb_size_log2;
         w += !w << fb_size_log2;
-        clpf_rdo(k << fb_size_log2, l << fb_size_log2, rec, org, cm, MI_SIZE,
-                 fb_size_log2, w >> bslog, h >> bslog, sums, plane);
+        clpf_rdo(k << fb_size_log2, l << fb_size_log2, &job, cm, MI_SIZE,
+                 fb_size_log2, w >> bslog, h >> bslog, sums);
       }
     }
 
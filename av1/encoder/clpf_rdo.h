@@ -14,13 +14,31 @@
 
 #include "av1/common/reconinter.h"
 
+struct AV1_COMP;
+
+// Rows of 8x8 blocks of one plane measured by the CLPF strength search.
+typedef struct ClpfRdoJob {
+  const YV12_BUFFER_CONFIG *rec;
+  const YV12_BUFFER_CONFIG *org;
+  int plane;
+  int block_cols;
+  int block_rows;
+  // Number of rows of MAX_FB_SIZE pixels.
+  int num_rows;
+  // Square errors of each block: unfiltered and strength=1,2,4.
+  int (*block_sums)[4];
+} ClpfRdoJob;
+
+void av1_clpf_detect_row(const AV1_COMMON *cm, const ClpfRdoJob *job,
+                         int row);
+
 int av1_clpf_decision(int k, int l, const YV12_BUFFER_CONFIG *rec,
                       const YV12_BUFFER_CONFIG *org, const AV1_COMMON *cm,
                       int block_size, int w, int h, unsigned int strength,
                       unsigned int fb_size_log2, int8_t *res, int plane);
 
-void av1_clpf_test_frame(const YV12_BUFFER_CONFIG *rec,
-                         const YV12_BUFFER_CONFIG *org, const AV1_COMMON *cm,
-                         int *best_strength, int *best_bs, int plane);
+void av1_clpf_test_frame(struct AV1_COMP *cpi, const YV12_BUFFER_CONFIG *rec,
+                         const YV12_BUFFER_CONFIG *org, int *best_strength,
+                         int *best_bs, int plane);
 
 #endif
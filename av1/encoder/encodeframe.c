@@ -4539,12 +4539,17 @@ static void rd_pick_partition(const AV1_COMP *const cpi, ThreadData *td,
 
 static void encode_rd_sb_row(AV1_COMP *cpi, ThreadData *td,
                              TileDataEnc *tile_data, int mi_row,
-                             TOKENEXTRA **tp) {
+                             TOKENEXTRA **tp, AV1RowMTSync *const row_mt_sync) {
   AV1_COMMON *const cm = &cpi->common;
   const TileInfo *const tile_info = &tile_data->tile_info;
   MACROBLOCK *const x = &td->mb;
   MACROBLOCKD *const xd = &x->e_mbd;
   SPEED_FEATURES *const sf = &cpi->sf;
+  const int sb_row_in_tile =
+      (mi_row - tile_info->mi_row_start) >> cm->mib_size_log2;
+  const int sb_cols_in_tile =
+      (tile_info->mi_col_end - tile_info->mi_col_start + cm->mib_size - 1) >>
+      cm->mib_size_log2;
   int mi_col;
 #if CONFIG_EXT_PARTITION
   const int leaf_nodes = 256;
@@ -4577,6 +4582,12 @@ static void encode_rd_sb_row(AV1_COMP *cpi, ThreadData *td,
     const int idx_str = cm->mi_stride * mi_row + mi_col;
     MODE_INFO **mi = cm->mi_grid_visible + idx_str;
     PC_TREE *const pc_root = td->pc_root[cm->mib_size_log2 - MIN_MIB_SIZE_LOG2];
+    const int sb_col_in_tile =
+        (mi_col - tile_info->mi_col_start) >> cm->mib_size_log2;
+
+    // Wait for the above-right superblock to be coded.
+    if (row_mt_sync != NULL)
+      av1_row_mt_sync_read(row_mt_sync, sb_row_in_tile, sb_col_in_tile);
 
     av1_update_boundary_info(cm, tile_info, mi_row, mi_col);
 
@@ -4672,6 +4683,10 @@ static void encode_rd_sb_row(AV1_COMP *cpi, ThreadData *td,
 #endif  // CONFIG_SUPERTX
                         INT64_MAX, pc_root);
     }
+
+    if (row_mt_sync != NULL)
+      av1_row_mt_sync_write(row_mt_sync, sb_row_in_tile, sb_col_in_tile,
+                            sb_cols_in_tile);
   }
 #if CONFIG_SUBFRAME_PROB_UPDATE
   if (cm->do_subframe_update &&
@@ -4695,7 +4710,8 @@ static void encode_rd_sb_row(AV1_COMP *cpi, ThreadData *td,
                cpi->td.rd_counts.coef_counts);
       av1_copy(subframe_stats->eob_counts_buf[cm->coef_probs_update_idx],
                cm->counts.eob_branch);
-      av1_fill_token_costs(x->token_costs, cm->fc->coef_probs);
+      av1_fill_token_costs(cpi->token_costs, cpi->token_cost_probs,
+                           cm->fc->coef_probs);
     }
   }
 #endif  // CONFIG_SUBFRAME_PROB_UPDATE
@@ -4837,17 +4853,9 @@ void av1_init_tile_data(AV1_COMP *cpi) {
   }
 }
 
-void av1_encode_tile(AV1_COMP *cpi, ThreadData *td, int tile_row,
-                     int tile_col) {
-  AV1_COMMON *const cm = &cpi->common;
-  TileDataEnc *const this_tile =
-      &cpi->tile_data[tile_row * cm->tile_cols + tile_col];
-  const TileInfo *const tile_info = &this_tile->tile_info;
-  TOKENEXTRA *tok = cpi->tile_tok[tile_row][tile_col];
-  int mi_row;
-#if CONFIG_PVQ
-  od_adapt_ctx *adapt;
-#endif
+static void init_tile_above_context(AV1_COMMON *const cm,
+                                    const TileInfo *const tile_info,
+                                    int tile_row) {
 #if CONFIG_DEPENDENT_HORZTILES
 #if CONFIG_TILE_GROUPS
   if ((!cm->dependent_horz_tiles) || (tile_row == 0) ||
@@ -4858,8 +4866,24 @@ void av1_encode_tile(AV1_COMP *cpi, ThreadData *td, int tile_row,
     av1_zero_above_context(cm, tile_info->mi_col_start, tile_info->mi_col_end);
   }
 #else
+  (void)tile_row;
   av1_zero_above_context(cm, tile_info->mi_col_start, tile_info->mi_col_end);
 #endif
+}
+
+void av1_encode_tile(AV1_COMP *cpi, ThreadData *td, int tile_row,
+                     int tile_col) {
+  AV1_COMMON *const cm = &cpi->common;
+  TileDataEnc *const this_tile =
+      &cpi->tile_data[tile_row * cm->tile_cols + tile_col];
+  const TileInfo *const tile_info = &this_tile->tile_info;
+  TOKENEXTRA *tok = cpi->tile_tok[tile_row][tile_col];
+  int mi_row;
+#if CONFIG_PVQ
+  od_adapt_ctx *adapt;
+#endif
+
+  init_tile_above_context(cm, tile_info, tile_row);
 
   // Set up pointers to per thread motion search counters.
   this_tile->m_search_count = 0;   // Count of motion search hits.
@@ -4946,7 +4970,7 @@ void av1_encode_tile(AV1_COMP *cpi, ThreadData *td, int tile_row,
 
   for (mi_row = tile_info->mi_row_start; mi_row < tile_info->mi_row_end;
        mi_row += cm->mib_size) {
-    encode_rd_sb_row(cpi, td, this_tile, mi_row, &tok);
+    encode_rd_sb_row(cpi, td, this_tile, mi_row, &tok, NULL);
   }
 
   cpi->tok_count[tile_row][tile_col] =
@@ -4968,6 +4992,104 @@ void av1_encode_tile(AV1_COMP *cpi, ThreadData *td, int tile_row,
 #endif
 }
 
+void av1_init_tile_row_mt(AV1_COMP *cpi, int tile_row, int tile_col) {
+  AV1_COMMON *const cm = &cpi->common;
+  const TileInfo *const tile_info =
+      &cpi->tile_data[tile_row * cm->tile_cols + tile_col].tile_info;
+  AV1RowMTSync *const row_mt_sync = &cpi->row_mt_info.sync[tile_col];
+#if CONFIG_CB4X4
+  const int tile_mb_cols =
+      (tile_info->mi_col_end - tile_info->mi_col_start + 2) >> 2;
+#else
+  const int tile_mb_cols =
+      (tile_info->mi_col_end - tile_info->mi_col_start + 1) >> 1;
+#endif
+  unsigned int tok_start = 0;
+  int mi_row, sb_row = 0;
+
+  init_tile_above_context(cm, tile_info, tile_row);
+
+  // Split the token buffer of the tile into one region per superblock row,
+  // each sized the same way as the tile allocation.
+  for (mi_row = tile_info->mi_row_start; mi_row < tile_info->mi_row_end;
+       mi_row += cm->mib_size, ++sb_row) {
+    const int row_mi_rows =
+        AOMMIN(cm->mib_size, tile_info->mi_row_end - mi_row);
+#if CONFIG_CB4X4
+    const int row_mb_rows = (row_mi_rows + 2) >> 2;
+#else
+    const int row_mb_rows = (row_mi_rows + 1) >> 1;
+#endif
+    row_mt_sync->tok_start[sb_row] = tok_start;
+    row_mt_sync->tok_count[sb_row] = 0;
+    row_mt_sync->cur_sb_col[sb_row] = -1;
+    tok_start += get_token_alloc(row_mb_rows, tile_mb_cols);
+  }
+  assert(tok_start <= allocated_tokens(*tile_info));
+}
+
+void av1_encode_sb_row(AV1_COMP *cpi, ThreadData *td, TileDataEnc *row_data,
+                       int tile_row, int tile_col, int mi_row) {
+  AV1_COMMON *const cm = &cpi->common;
+  TileDataEnc *const this_tile =
+      &cpi->tile_data[tile_row * cm->tile_cols + tile_col];
+  const TileInfo *const tile_info = &this_tile->tile_info;
+  AV1RowMTSync *const row_mt_sync = &cpi->row_mt_info.sync[tile_col];
+  const int sb_row = (mi_row - tile_info->mi_row_start) >> cm->mib_size_log2;
+  TOKENEXTRA *const tok_start =
+      cpi->tile_tok[tile_row][tile_col] + row_mt_sync->tok_start[sb_row];
+  TOKENEXTRA *tok = tok_start;
+
+  // Each superblock row starts from the adaptive mode search state the tile
+  // had at the beginning of the frame, so that the output does not depend on
+  // the number of threads or the order in which rows are picked up.
+  row_data->tile_info = this_tile->tile_info;
+  memcpy(row_data->thresh_freq_fact, this_tile->thresh_freq_fact,
+         sizeof(this_tile->thresh_freq_fact));
+  memcpy(row_data->mode_map, this_tile->mode_map, sizeof(this_tile->mode_map));
+  row_data->m_search_count = 0;
+  row_data->ex_search_count = 0;
+  td->mb.m_search_count_ptr = &row_data->m_search_count;
+  td->mb.ex_search_count_ptr = &row_data->ex_search_count;
+
+  encode_rd_sb_row(cpi, td, row_data, mi_row, &tok, row_mt_sync);
+
+  row_mt_sync->tok_count[sb_row] = (unsigned int)(tok - tok_start);
+
+  // The bottom row has seen the most of the frame; keep its state for the
+  // next frame. All other rows of the tile have taken their copy by now.
+  if (mi_row + cm->mib_size >= tile_info->mi_row_end) {
+    memcpy(this_tile->thresh_freq_fact, row_data->thresh_freq_fact,
+           sizeof(this_tile->thresh_freq_fact));
+    memcpy(this_tile->mode_map, row_data->mode_map,
+           sizeof(this_tile->mode_map));
+  }
+}
+
+void av1_finish_tile_row_mt(AV1_COMP *cpi, int tile_row, int tile_col) {
+  AV1_COMMON *const cm = &cpi->common;
+  const TileInfo *const tile_info =
+      &cpi->tile_data[tile_row * cm->tile_cols + tile_col].tile_info;
+  const AV1RowMTSync *const row_mt_sync = &cpi->row_mt_info.sync[tile_col];
+  TOKENEXTRA *const tile_tok = cpi->tile_tok[tile_row][tile_col];
+  const int sb_rows =
+      (tile_info->mi_row_end - tile_info->mi_row_start + cm->mib_size - 1) >>
+      cm->mib_size_log2;
+  unsigned int tok_count = 0;
+  int sb_row;
+
+  // Pack the tokens of all superblock rows back to back, as the bitstream
+  // writer expects.
+  for (sb_row = 0; sb_row < sb_rows; ++sb_row) {
+    if (row_mt_sync->tok_start[sb_row] != tok_count)
+      memmove(tile_tok + tok_count, tile_tok + row_mt_sync->tok_start[sb_row],
+              row_mt_sync->tok_count[sb_row] * sizeof(*tile_tok));
+    tok_count += row_mt_sync->tok_count[sb_row];
+  }
+  cpi->tok_count[tile_row][tile_col] = tok_count;
+  assert(tok_count <= allocated_tokens(*tile_info));
+}
+
 static void encode_tiles(AV1_COMP *cpi) {
   AV1_COMMON *const cm = &cpi->common;
   int tile_col, tile_row;
@@ -4979,6 +5101,54 @@ static void encode_tiles(AV1_COMP *cpi) {
       av1_encode_tile(cpi, &cpi->td, tile_row, tile_col);
 }
 
+#if CONFIG_GLOBAL_MOTION
+void av1_global_motion_search_ref(AV1_COMP *cpi, int frame) {
+  AV1_COMMON *const cm = &cpi->common;
+  const MACROBLOCKD *const xd = &cpi->td.mb.e_mbd;
+  YV12_BUFFER_CONFIG *const ref_buf = get_ref_frame_buffer(cpi, frame);
+  double erroradvantage = 0;
+  double params[8] = { 0, 0, 1, 0, 0, 1, 0, 0 };
+  TransformationType model;
+  int *correspondences;
+  int num_correspondences;
+
+  if (!ref_buf || !cpi->Source->corners || !ref_buf->corners) return;
+
+  aom_clear_system_state();
+  // The matches between the two frames do not depend on the model, so they
+  // are shared by all the models that are tried.
+  correspondences = (int *)aom_malloc(AOMMAX(cpi->Source->num_corners, 1) * 4 *
+                                      sizeof(*correspondences));
+  if (!correspondences) return;
+  num_correspondences =
+      av1_compute_correspondences(cpi->Source, ref_buf, correspondences);
+
+  for (model = ROTZOOM; model < GLOBAL_TRANS_TYPES; ++model) {
+    if (av1_fit_global_motion(model, correspondences, num_correspondences,
+                              params)) {
+      convert_model_to_params(params, &cm->global_motion[frame]);
+      if (cm->global_motion[frame].wmtype != IDENTITY) {
+        erroradvantage = refine_integerized_param(
+            &cm->global_motion[frame], cm->global_motion[frame].wmtype,
+#if CONFIG_AOM_HIGHBITDEPTH
+            xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH, xd->bd,
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+            ref_buf->y_buffer, ref_buf->y_width, ref_buf->y_height,
+            ref_buf->y_stride, cpi->Source->y_buffer, cpi->Source->y_width,
+            cpi->Source->y_height, cpi->Source->y_stride, 3);
+        if (erroradvantage >
+            gm_advantage_thresh[cm->global_motion[frame].wmtype]) {
+          set_default_gmparams(&cm->global_motion[frame]);
+        }
+      }
+    }
+    if (cm->global_motion[frame].wmtype != IDENTITY) break;
+  }
+  aom_free(correspondences);
+  aom_clear_system_state();
+}
+#endif  // CONFIG_GLOBAL_MOTION
+
 #if CONFIG_FP_MB_STATS
 static int input_fpmb_stats(FIRSTPASS_MB_STATS *firstpass_mb_stats,
                             AV1_COMMON *cm, uint8_t **this_frame_mb_stats) {
@@ -5018,43 +5188,33 @@ static void encode_frame_internal(AV1_COMP *cpi) {
   av1_zero(cpi->global_motion_used);
   if (cpi->common.frame_type == INTER_FRAME && cpi->Source &&
       !cpi->global_motion_search_done) {
-    YV12_BUFFER_CONFIG *ref_buf;
     int frame;
-    double erroradvantage = 0;
-    double params[8] = { 0, 0, 1, 0, 0, 1, 0, 0 };
-    for (frame = LAST_FRAME; frame <= ALTREF_FRAME; ++frame) {
-      ref_buf = get_ref_frame_buffer(cpi, frame);
-      if (ref_buf) {
-        TransformationType model;
-        aom_clear_system_state();
-        for (model = ROTZOOM; model < GLOBAL_TRANS_TYPES; ++model) {
-          if (compute_global_motion_feature_based(model, cpi->Source, ref_buf,
+    // The source corners are detected once per frame. Reference frame
+    // corners stay cached on their buffers for as long as they are used.
+    aom_clear_system_state();
 #if CONFIG_AOM_HIGHBITDEPTH
-                                                  cpi->common.bit_depth,
+    av1_compute_frame_corners(cpi->Source, cm->bit_depth, 1);
+#else
+    av1_compute_frame_corners(cpi->Source, 1);
 #endif  // CONFIG_AOM_HIGHBITDEPTH
-                                                  params)) {
-            convert_model_to_params(params, &cm->global_motion[frame]);
-            if (cm->global_motion[frame].wmtype != IDENTITY) {
-              erroradvantage = refine_integerized_param(
-                  &cm->global_motion[frame], cm->global_motion[frame].wmtype,
+    for (frame = LAST_FRAME; frame <= ALTREF_FRAME; ++frame) {
+      YV12_BUFFER_CONFIG *const ref_buf = get_ref_frame_buffer(cpi, frame);
+      if (ref_buf) {
 #if CONFIG_AOM_HIGHBITDEPTH
-                  xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH, xd->bd,
+        av1_compute_frame_corners(ref_buf, cm->bit_depth, 0);
+#else
+        av1_compute_frame_corners(ref_buf, 0);
 #endif  // CONFIG_AOM_HIGHBITDEPTH
-                  ref_buf->y_buffer, ref_buf->y_width, ref_buf->y_height,
-                  ref_buf->y_stride, cpi->Source->y_buffer,
-                  cpi->Source->y_width, cpi->Source->y_height,
-                  cpi->Source->y_stride, 3);
-              if (erroradvantage >
-                  gm_advantage_thresh[cm->global_motion[frame].wmtype]) {
-                set_default_gmparams(&cm->global_motion[frame]);
-              }
-            }
-          }
-          if (cm->global_motion[frame].wmtype != IDENTITY) break;
-        }
-        aom_clear_system_state();
       }
     }
+    aom_clear_system_state();
+
+    if (cpi->oxcf.max_threads > 1) {
+      av1_global_motion_search_mt(cpi);
+    } else {
+      for (frame = LAST_FRAME; frame <= ALTREF_FRAME; ++frame)
+        av1_global_motion_search_ref(cpi, frame);
+    }
     cpi->global_motion_search_done = 1;
   }
 #endif  // CONFIG_GLOBAL_MOTION
@@ -5145,7 +5305,10 @@ static void encode_frame_internal(AV1_COMP *cpi) {
     // TODO(geza.lore): The multi-threaded encoder is not safe with more than
     // 1 tile rows, as it uses the single above_context et al arrays from
     // cpi->common
-    if (AOMMIN(cpi->oxcf.max_threads, cm->tile_cols) > 1 && cm->tile_rows == 1)
+    if (av1_row_mt_allowed(cpi))
+      av1_encode_tiles_row_mt(cpi);
+    else if (AOMMIN(cpi->oxcf.max_threads, cm->tile_cols) > 1 &&
+             cm->tile_rows == 1)
       av1_encode_tiles_mt(cpi);
     else
       encode_tiles(cpi);
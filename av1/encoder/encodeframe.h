@@ -22,6 +22,7 @@ struct macroblock;
 struct yv12_buffer_config;
 struct AV1_COMP;
 struct ThreadData;
+struct TileDataEnc;
 
 // Constants used in SOURCE_VAR_BASED_PARTITION
 #define VAR_HIST_MAX_BG_VAR 1000
@@ -40,8 +41,23 @@ void av1_init_tile_data(struct AV1_COMP *cpi);
 void av1_encode_tile(struct AV1_COMP *cpi, struct ThreadData *td, int tile_row,
                      int tile_col);
 
+// Row based multi-threading: av1_init_tile_row_mt() prepares a tile before
+// its superblock rows are encoded with av1_encode_sb_row(), and
+// av1_finish_tile_row_mt() packs the per-row tokens once all rows are done.
+void av1_init_tile_row_mt(struct AV1_COMP *cpi, int tile_row, int tile_col);
+void av1_encode_sb_row(struct AV1_COMP *cpi, struct ThreadData *td,
+                       struct TileDataEnc *row_data, int tile_row, int tile_col,
+                       int mi_row);
+void av1_finish_tile_row_mt(struct AV1_COMP *cpi, int tile_row, int tile_col);
+
 void av1_set_variance_partition_thresholds(struct AV1_COMP *cpi, int q);
 
+#if CONFIG_GLOBAL_MOTION
+// Estimates the global motion between the source and one reference frame,
+// once the corners of both have been detected.
+void av1_global_motion_search_ref(struct AV1_COMP *cpi, int frame);
+#endif  // CONFIG_GLOBAL_MOTION
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -21,6 +21,7 @@
 #include "av1/common/clpf.h"
 #include "av1/encoder/clpf_rdo.h"
 #include "av1/common/dering.h"
+#include "av1/encoder/pickdering.h"
 #endif  // CONFIG_CDEF
 #include "av1/common/filter.h"
 #include "av1/common/idct.h"
@@ -462,6 +463,16 @@ static void dealloc_compressor_data(AV1_COMP *cpi) {
   for (i = 0; i < MAX_MB_PLANE; ++i)
     av1_free_restoration_struct(&cpi->rst_search[i]);
 #endif  // CONFIG_LOOP_RESTORATION
+#if CONFIG_CDEF
+  aom_free(cpi->dering_src);
+  cpi->dering_src = NULL;
+  aom_free(cpi->dering_ref);
+  cpi->dering_ref = NULL;
+  cpi->dering_buf_size = 0;
+  aom_free(cpi->clpf_block_sums);
+  cpi->clpf_block_sums = NULL;
+  cpi->clpf_block_sums_size = 0;
+#endif  // CONFIG_CDEF
   aom_free_frame_buffer(&cpi->scaled_source);
   aom_free_frame_buffer(&cpi->scaled_last_source);
   aom_free_frame_buffer(&cpi->alt_ref_buffer);
@@ -470,6 +481,11 @@ static void dealloc_compressor_data(AV1_COMP *cpi) {
   aom_free(cpi->tile_tok[0][0]);
   cpi->tile_tok[0][0] = 0;
 
+  aom_free(cpi->tile_pack_buf);
+  cpi->tile_pack_buf = NULL;
+  cpi->tile_pack_buf_size = 0;
+  aom_writer_pool_free(&cpi->writer_pool);
+
   av1_free_pc_tree(&cpi->td);
   av1_free_var_tree(&cpi->td);
 
@@ -538,6 +554,9 @@ static void restore_coding_context(AV1_COMP *cpi) {
 
   av1_copy(cpi->nmvcosts, cc->nmvcosts);
   av1_copy(cpi->nmvcosts_hp, cc->nmvcosts_hp);
+  // The restored MV cost tables no longer match the probabilities they were
+  // last built from, so force a rebuild.
+  av1_zero(cpi->nmv_cost_ctx);
 
   av1_copy(cm->lf.last_ref_deltas, cc->last_ref_lf_deltas);
   av1_copy(cm->lf.last_mode_deltas, cc->last_mode_lf_deltas);
@@ -2267,6 +2286,8 @@ AV1_COMP *av1_create_compressor(AV1EncoderConfig *oxcf,
 
   cpi->first_time_stamp_ever = INT64_MAX;
 
+  cpi->td.mb.token_costs = cpi->token_costs;
+
 #if CONFIG_REF_MV
   for (i = 0; i < NMV_CONTEXTS; ++i) {
     cpi->td.mb.nmvcost[i][0] = &cpi->nmv_costs[i][0][MV_MAX];
@@ -2638,15 +2659,21 @@ void av1_remove_compressor(AV1_COMP *cpi) {
         aom_free(thread_data->td->mb.palette_buffer);
 #endif  // CONFIG_PALETTE
       aom_free(thread_data->td->counts);
+#if CONFIG_LOOP_RESTORATION
+      aom_free(thread_data->td->rst_tmpbuf);
+#endif  // CONFIG_LOOP_RESTORATION
       av1_free_pc_tree(thread_data->td);
       av1_free_var_tree(thread_data->td);
       aom_free(thread_data->td);
     }
+    aom_free(thread_data->row_tile_data);
   }
   aom_free(cpi->tile_thr_data);
   aom_free(cpi->workers);
+  aom_thread_pool_release(cpi->thread_pool);
 
   if (cpi->num_workers > 1) av1_loop_filter_dealloc(&cpi->lf_row_sync);
+  av1_row_mt_dealloc(&cpi->row_mt_info);
 
   dealloc_compressor_data(cpi);
 
@@ -2661,6 +2688,8 @@ void av1_remove_compressor(AV1_COMP *cpi) {
     cpi->twopass.frame_mb_stats_buf = NULL;
   }
 #endif
+  aom_free(cpi->twopass.fp_row_data);
+  cpi->twopass.fp_row_data = NULL;
 #if CONFIG_INTERNAL_STATS
   aom_free(cpi->ssim_vars);
   cpi->ssim_vars = NULL;
@@ -3508,7 +3537,7 @@ static void loopfilter_frame(AV1_COMP *cpi, AV1_COMMON *cm) {
     cm->dering_level = 0;
   } else {
     cm->dering_level =
-        av1_dering_search(cm->frame_to_show, cpi->Source, cm, xd);
+        av1_dering_search(cpi, cm->frame_to_show, cpi->Source);
     av1_dering_frame(cm->frame_to_show, cm, xd, cm->dering_level);
   }
   cm->clpf_strength_y = cm->clpf_strength_u = cm->clpf_strength_v = 0;
@@ -3534,10 +3563,10 @@ static void loopfilter_frame(AV1_COMP *cpi, AV1_COMMON *cm) {
 
     // Find the best strength and block size for the entire frame
     int fb_size_log2, strength_y, strength_u, strength_v;
-    av1_clpf_test_frame(frame, cpi->Source, cm, &strength_y, &fb_size_log2,
+    av1_clpf_test_frame(cpi, frame, cpi->Source, &strength_y, &fb_size_log2,
                         AOM_PLANE_Y);
-    av1_clpf_test_frame(frame, cpi->Source, cm, &strength_u, 0, AOM_PLANE_U);
-    av1_clpf_test_frame(frame, cpi->Source, cm, &strength_v, 0, AOM_PLANE_V);
+    av1_clpf_test_frame(cpi, frame, cpi->Source, &strength_u, 0, AOM_PLANE_U);
+    av1_clpf_test_frame(cpi, frame, cpi->Source, &strength_v, 0, AOM_PLANE_V);
 
     if (strength_y) {
       // Apply the filter using the chosen strength
@@ -5140,6 +5169,7 @@ static void check_initial_width(AV1_COMP *cpi,
 #if CONFIG_AOM_HIGHBITDEPTH
     cm->use_highbitdepth = use_highbitdepth;
 #endif
+    av1_set_lowbd_420(cm);
 
     alloc_raw_frame_buffers(cpi);
     init_ref_frame_bufs(cm);
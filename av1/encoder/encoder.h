@@ -26,9 +26,11 @@
 #include "aom_dsp/ans.h"
 #include "aom_dsp/buf_ans.h"
 #endif
+#include "aom_dsp/bitwriter.h"
 #include "av1/encoder/av1_quantize.h"
 #include "av1/encoder/context_tree.h"
 #include "av1/encoder/encodemb.h"
+#include "av1/encoder/ethread.h"
 #include "av1/encoder/firstpass.h"
 #include "av1/encoder/lookahead.h"
 #include "av1/encoder/mbgraph.h"
@@ -36,6 +38,7 @@
 #include "av1/encoder/ratectrl.h"
 #include "av1/encoder/rd.h"
 #include "av1/encoder/speed_features.h"
+#include "av1/encoder/temporal_filter.h"
 #include "av1/encoder/tokenize.h"
 #include "av1/encoder/variance_tree.h"
 #if CONFIG_XIPHRC
@@ -253,6 +256,8 @@ typedef struct AV1EncoderConfig {
 #endif  // CONFIG_LOOPFILTERING_ACROSS_TILES
 
   int max_threads;
+  // Encode superblock rows of a tile in parallel.
+  int row_mt;
 
   aom_fixed_buf_t two_pass_stats_in;
   struct aom_codec_pkt_list *output_pkt_list;
@@ -314,6 +319,15 @@ typedef struct ThreadData {
 
   VAR_TREE *var_tree;
   VAR_TREE *var_root[MAX_MIB_SIZE_LOG2 - MIN_MIB_SIZE_LOG2 + 1];
+
+  // Switchable interpolation filters written while packing the bitstream.
+  int interp_filter_selected[SWITCHABLE];
+
+#if CONFIG_LOOP_RESTORATION
+  // Scratch buffer of the restoration filter search. The main thread uses
+  // cm->rst_internal.tmpbuf instead.
+  int32_t *rst_tmpbuf;
+#endif  // CONFIG_LOOP_RESTORATION
 } ThreadData;
 
 struct EncWorkerData;
@@ -423,6 +437,15 @@ typedef struct AV1_COMP {
   uint8_t *extra_rstbuf;  // Extra buffers used in restoration search
   RestorationInfo rst_search[MAX_MB_PLANE];  // Used for encoder side search
 #endif                                       // CONFIG_LOOP_RESTORATION
+#if CONFIG_CDEF
+  // Luma planes of the dering search, kept across frames.
+  int16_t *dering_src;
+  int16_t *dering_ref;
+  int dering_buf_size;
+  // Square errors of the 8x8 blocks in the CLPF strength search.
+  int (*clpf_block_sums)[4];
+  int clpf_block_sums_size;
+#endif  // CONFIG_CDEF
 
   // Ambient reconstruction err target for force key frames
   int64_t ambient_err;
@@ -434,6 +457,12 @@ typedef struct AV1_COMP {
 #if CONFIG_REF_MV
   int nmv_costs[NMV_CONTEXTS][2][MV_VALS];
   int nmv_costs_hp[NMV_CONTEXTS][2][MV_VALS];
+  // MV probabilities and precision the MV cost tables were last built from.
+  nmv_context nmv_cost_ctx[NMV_CONTEXTS];
+  int nmv_cost_hp[NMV_CONTEXTS];
+#else
+  nmv_context nmv_cost_ctx;
+  int nmv_cost_hp;
 #endif
 
   int nmvcosts[2][MV_VALS];
@@ -491,6 +520,7 @@ typedef struct AV1_COMP {
   TWO_PASS twopass;
 
   YV12_BUFFER_CONFIG alt_ref_buffer;
+  ARNRFilterData arnr_filter_data;
 
 #if CONFIG_INTERNAL_STATS
   unsigned int mode_chosen_counts[MAX_MODES];
@@ -558,6 +588,9 @@ typedef struct AV1_COMP {
                                        [INTER_COMPOUND_MODES];
   unsigned int interintra_mode_cost[BLOCK_SIZE_GROUPS][INTERINTRA_MODES];
 #endif  // CONFIG_EXT_INTER
+  av1_coeff_cost token_costs[TX_SIZES];
+  // Coefficient probabilities token_costs was last built from.
+  av1_coeff_probs_model token_cost_probs[TX_SIZES][PLANE_TYPES];
 #if CONFIG_MOTION_VAR || CONFIG_WARPED_MOTION
   int motion_mode_cost[BLOCK_SIZES][MOTION_MODES];
 #if CONFIG_MOTION_VAR && CONFIG_WARPED_MOTION
@@ -614,6 +647,11 @@ typedef struct AV1_COMP {
   unsigned int tok_count[MAX_TILE_ROWS][MAX_TILE_COLS];
 
   TileBufferEnc tile_buffers[MAX_TILE_ROWS][MAX_TILE_COLS];
+  // Scratch space the tiles are packed into before being joined.
+  uint8_t *tile_pack_buf;
+  size_t tile_pack_buf_size;
+  // Entropy writer buffers, reused by the tiles of every frame.
+  aom_writer_pool writer_pool;
 
   int resize_pending;
   int resize_state;
@@ -640,8 +678,11 @@ typedef struct AV1_COMP {
   // Multi-threading
   int num_workers;
   AVxWorker *workers;
+  // Threads shared by all the workers.
+  AVxThreadPool *thread_pool;
   struct EncWorkerData *tile_thr_data;
   AV1LfSync lf_row_sync;
+  AV1RowMTInfo row_mt_info;
 #if CONFIG_SUBFRAME_PROB_UPDATE
   SUBFRAME_STATS subframe_stats;
   // TODO(yaowu): minimize the size of count buffers
@@ -9,9 +9,21 @@
  * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
  */
 
+#include "av1/encoder/bitstream.h"
+#if CONFIG_CDEF
+#include "av1/encoder/clpf_rdo.h"
+#endif  // CONFIG_CDEF
 #include "av1/encoder/encodeframe.h"
 #include "av1/encoder/encoder.h"
 #include "av1/encoder/ethread.h"
+#include "av1/encoder/firstpass.h"
+#if CONFIG_CDEF
+#include "av1/encoder/pickdering.h"
+#endif  // CONFIG_CDEF
+#include "av1/encoder/picklpf.h"
+#if CONFIG_LOOP_RESTORATION
+#include "av1/encoder/pickrst.h"
+#endif  // CONFIG_LOOP_RESTORATION
 #include "aom_dsp/aom_dsp_common.h"
 
 static void accumulate_rd_opt(ThreadData *td, ThreadData *td_t) {
@@ -22,12 +34,15 @@ static void accumulate_rd_opt(ThreadData *td, ThreadData *td_t) {
 
   for (i = 0; i < TX_SIZES; i++)
     for (j = 0; j < PLANE_TYPES; j++)
-      for (k = 0; k < REF_TYPES; k++)
+      for (k = 0; k < REF_TYPES; k++) {
+        // Skip the groups this thread never tokenized.
+        if (td_t->counts->coef_blocks[i][j][k] == 0) continue;
         for (l = 0; l < COEF_BANDS; l++)
           for (m = 0; m < COEFF_CONTEXTS; m++)
             for (n = 0; n < ENTROPY_TOKENS; n++)
               td->rd_counts.coef_counts[i][j][k][l][m][n] +=
                   td_t->rd_counts.coef_counts[i][j][k][l][m][n];
+      }
 }
 
 static int enc_worker_hook(EncWorkerData *const thread_data, void *unused) {
@@ -35,12 +50,12 @@ static int enc_worker_hook(EncWorkerData *const thread_data, void *unused) {
   const AV1_COMMON *const cm = &cpi->common;
   const int tile_cols = cm->tile_cols;
   const int tile_rows = cm->tile_rows;
+  const int num_workers = AOMMIN(cpi->num_workers, tile_cols);
   int t;
 
   (void)unused;
 
-  for (t = thread_data->start; t < tile_rows * tile_cols;
-       t += cpi->num_workers) {
+  for (t = thread_data->start; t < tile_rows * tile_cols; t += num_workers) {
     int tile_row = t / tile_cols;
     int tile_col = t % tile_cols;
 
@@ -50,69 +65,79 @@ static int enc_worker_hook(EncWorkerData *const thread_data, void *unused) {
   return 0;
 }
 
-void av1_encode_tiles_mt(AV1_COMP *cpi) {
+// Creates the worker pool. Only run once, with one worker per allowed thread,
+// as every multi-threaded stage shares the pool and limits the number of
+// workers it launches itself. The last worker is run on the main thread and
+// uses the thread data in cpi. The other workers run on the threads of
+// cpi->thread_pool.
+static void create_enc_workers(AV1_COMP *cpi) {
   AV1_COMMON *const cm = &cpi->common;
-  const int tile_cols = cm->tile_cols;
   const AVxWorkerInterface *const winterface = aom_get_worker_interface();
-  const int num_workers = AOMMIN(cpi->oxcf.max_threads, tile_cols);
+  const int num_workers = AOMMAX(cpi->oxcf.max_threads, 1);
   int i;
 
-  av1_init_tile_data(cpi);
+  CHECK_MEM_ERROR(cm, cpi->workers,
+                  aom_malloc(num_workers * sizeof(*cpi->workers)));
 
-  // Only run once to create threads and allocate thread data.
-  if (cpi->num_workers == 0) {
-    CHECK_MEM_ERROR(cm, cpi->workers,
-                    aom_malloc(num_workers * sizeof(*cpi->workers)));
-
-    CHECK_MEM_ERROR(cm, cpi->tile_thr_data,
-                    aom_calloc(num_workers, sizeof(*cpi->tile_thr_data)));
-
-    for (i = 0; i < num_workers; i++) {
-      AVxWorker *const worker = &cpi->workers[i];
-      EncWorkerData *const thread_data = &cpi->tile_thr_data[i];
-
-      ++cpi->num_workers;
-      winterface->init(worker);
-
-      thread_data->cpi = cpi;
-
-      if (i < num_workers - 1) {
-        // Allocate thread data.
-        CHECK_MEM_ERROR(cm, thread_data->td,
-                        aom_memalign(32, sizeof(*thread_data->td)));
-        av1_zero(*thread_data->td);
-
-        // Set up pc_tree.
-        thread_data->td->leaf_tree = NULL;
-        thread_data->td->pc_tree = NULL;
-        av1_setup_pc_tree(cm, thread_data->td);
-
-        // Set up variance tree if needed.
-        if (cpi->sf.partition_search_type == VAR_BASED_PARTITION)
-          av1_setup_var_tree(cm, thread_data->td);
-
-        // Allocate frame counters in thread data.
-        CHECK_MEM_ERROR(cm, thread_data->td->counts,
-                        aom_calloc(1, sizeof(*thread_data->td->counts)));
-
-        // Create threads
-        if (!winterface->reset(worker))
-          aom_internal_error(&cm->error, AOM_CODEC_ERROR,
-                             "Tile encoder thread creation failed");
-      } else {
-        // Main thread acts as a worker and uses the thread data in cpi.
-        thread_data->td = &cpi->td;
-      }
+  // Without a pool, each worker falls back to a thread of its own.
+  if (num_workers > 1 && cpi->thread_pool == NULL)
+    cpi->thread_pool = aom_thread_pool_create(num_workers - 1);
+
+  CHECK_MEM_ERROR(cm, cpi->tile_thr_data,
+                  aom_calloc(num_workers, sizeof(*cpi->tile_thr_data)));
 
-      winterface->sync(worker);
+  for (i = 0; i < num_workers; i++) {
+    AVxWorker *const worker = &cpi->workers[i];
+    EncWorkerData *const thread_data = &cpi->tile_thr_data[i];
+
+    ++cpi->num_workers;
+    winterface->init(worker);
+    worker->pool = cpi->thread_pool;
+
+    thread_data->cpi = cpi;
+
+    if (i < num_workers - 1) {
+      // Allocate thread data.
+      CHECK_MEM_ERROR(cm, thread_data->td,
+                      aom_memalign(32, sizeof(*thread_data->td)));
+      av1_zero(*thread_data->td);
+
+      // Set up pc_tree.
+      thread_data->td->leaf_tree = NULL;
+      thread_data->td->pc_tree = NULL;
+      av1_setup_pc_tree(cm, thread_data->td);
+
+      // Set up variance tree if needed.
+      if (cpi->sf.partition_search_type == VAR_BASED_PARTITION)
+        av1_setup_var_tree(cm, thread_data->td);
+
+      // Allocate frame counters in thread data.
+      CHECK_MEM_ERROR(cm, thread_data->td->counts,
+                      aom_calloc(1, sizeof(*thread_data->td->counts)));
+
+      // Create threads
+      if (!winterface->reset(worker))
+        aom_internal_error(&cm->error, AOM_CODEC_ERROR,
+                           "Tile encoder thread creation failed");
+    } else {
+      // Main thread acts as a worker and uses the thread data in cpi.
+      thread_data->td = &cpi->td;
     }
+
+    winterface->sync(worker);
   }
+}
+
+static void prepare_enc_workers(AV1_COMP *cpi, AVxWorkerHook hook,
+                                int num_workers) {
+  AV1_COMMON *const cm = &cpi->common;
+  int i;
 
   for (i = 0; i < num_workers; i++) {
     AVxWorker *const worker = &cpi->workers[i];
     EncWorkerData *thread_data;
 
-    worker->hook = (AVxWorkerHook)enc_worker_hook;
+    worker->hook = hook;
     worker->data1 = &cpi->tile_thr_data[i];
     worker->data2 = NULL;
     thread_data = (EncWorkerData *)worker->data1;
@@ -122,22 +147,25 @@ void av1_encode_tiles_mt(AV1_COMP *cpi) {
       thread_data->td->mb = cpi->td.mb;
       thread_data->td->rd_counts = cpi->td.rd_counts;
     }
-    if (thread_data->td->counts != &cpi->common.counts) {
-      memcpy(thread_data->td->counts, &cpi->common.counts,
-             sizeof(cpi->common.counts));
+    if (thread_data->td->counts != &cm->counts) {
+      memcpy(thread_data->td->counts, &cm->counts, sizeof(cm->counts));
     }
 
 #if CONFIG_PALETTE
     // Allocate buffers used by palette coding mode.
-    if (cpi->common.allow_screen_content_tools && i < num_workers - 1) {
+    if (cm->allow_screen_content_tools && thread_data->td != &cpi->td) {
       MACROBLOCK *x = &thread_data->td->mb;
       CHECK_MEM_ERROR(cm, x->palette_buffer,
                       aom_memalign(16, sizeof(*x->palette_buffer)));
     }
 #endif  // CONFIG_PALETTE
   }
+}
+
+static void launch_enc_workers(AV1_COMP *cpi, int num_workers) {
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  int i;
 
-  // Encode a frame
   for (i = 0; i < num_workers; i++) {
     AVxWorker *const worker = &cpi->workers[i];
     EncWorkerData *const thread_data = (EncWorkerData *)worker->data1;
@@ -145,26 +173,628 @@ void av1_encode_tiles_mt(AV1_COMP *cpi) {
     // Set the starting tile for each thread.
     thread_data->start = i;
 
-    if (i == cpi->num_workers - 1)
+    if (i == num_workers - 1)
       winterface->execute(worker);
     else
       winterface->launch(worker);
   }
 
-  // Encoding ends.
   for (i = 0; i < num_workers; i++) {
     AVxWorker *const worker = &cpi->workers[i];
     winterface->sync(worker);
   }
+}
+
+static void accumulate_enc_workers(AV1_COMP *cpi, int num_workers) {
+  int i;
 
   for (i = 0; i < num_workers; i++) {
     AVxWorker *const worker = &cpi->workers[i];
     EncWorkerData *const thread_data = (EncWorkerData *)worker->data1;
 
     // Accumulate counters.
-    if (i < cpi->num_workers - 1) {
-      av1_accumulate_frame_counts(&cm->counts, thread_data->td->counts);
+    if (thread_data->td != &cpi->td) {
+      av1_accumulate_frame_counts(&cpi->common.counts, thread_data->td->counts);
       accumulate_rd_opt(&cpi->td, thread_data->td);
     }
   }
 }
+
+void av1_encode_tiles_mt(AV1_COMP *cpi) {
+  AV1_COMMON *const cm = &cpi->common;
+  const int tile_cols = cm->tile_cols;
+  int num_workers;
+
+  av1_init_tile_data(cpi);
+
+  if (cpi->num_workers == 0)
+    create_enc_workers(cpi);
+  num_workers = AOMMIN(cpi->num_workers, tile_cols);
+
+  prepare_enc_workers(cpi, (AVxWorkerHook)enc_worker_hook, num_workers);
+  launch_enc_workers(cpi, num_workers);
+  accumulate_enc_workers(cpi, num_workers);
+}
+
+#if CONFIG_MULTITHREAD
+static INLINE void mutex_lock(pthread_mutex_t *const mutex) {
+  const int kMaxTryLocks = 4000;
+  int locked = 0;
+  int i;
+
+  for (i = 0; i < kMaxTryLocks; ++i) {
+    if (!pthread_mutex_trylock(mutex)) {
+      locked = 1;
+      break;
+    }
+  }
+
+  if (!locked) pthread_mutex_lock(mutex);
+}
+#endif  // CONFIG_MULTITHREAD
+
+// Superblock row r of a tile may code superblock c once row r - 1 has coded
+// superblock c + sync_range, which covers the above-right dependency.
+void av1_row_mt_sync_read(AV1RowMTSync *const row_mt_sync, int r, int c) {
+#if CONFIG_MULTITHREAD
+  const int nsync = row_mt_sync->sync_range;
+
+  if (r && !(c & (nsync - 1))) {
+    pthread_mutex_t *const mutex = &row_mt_sync->mutex_[r - 1];
+    mutex_lock(mutex);
+
+    while (c > row_mt_sync->cur_sb_col[r - 1] - nsync) {
+      pthread_cond_wait(&row_mt_sync->cond_[r - 1], mutex);
+    }
+    pthread_mutex_unlock(mutex);
+  }
+#else
+  (void)row_mt_sync;
+  (void)r;
+  (void)c;
+#endif  // CONFIG_MULTITHREAD
+}
+
+void av1_row_mt_sync_write(AV1RowMTSync *const row_mt_sync, int r, int c,
+                           const int sb_cols) {
+#if CONFIG_MULTITHREAD
+  const int nsync = row_mt_sync->sync_range;
+  int cur;
+  // Only signal when there are enough coded SB for next row to run.
+  int sig = 1;
+
+  if (c < sb_cols - 1) {
+    cur = c;
+    if (c % nsync) sig = 0;
+  } else {
+    cur = sb_cols + nsync;
+  }
+
+  if (sig) {
+    mutex_lock(&row_mt_sync->mutex_[r]);
+
+    row_mt_sync->cur_sb_col[r] = cur;
+
+    pthread_cond_signal(&row_mt_sync->cond_[r]);
+    pthread_mutex_unlock(&row_mt_sync->mutex_[r]);
+  }
+#else
+  (void)row_mt_sync;
+  (void)r;
+  (void)c;
+  (void)sb_cols;
+#endif  // CONFIG_MULTITHREAD
+}
+
+static void row_mt_sync_alloc(AV1RowMTSync *row_mt_sync, AV1_COMMON *cm,
+                              int rows) {
+  row_mt_sync->rows = rows;
+#if CONFIG_MULTITHREAD
+  {
+    int i;
+
+    CHECK_MEM_ERROR(cm, row_mt_sync->mutex_,
+                    aom_malloc(sizeof(*row_mt_sync->mutex_) * rows));
+    if (row_mt_sync->mutex_) {
+      for (i = 0; i < rows; ++i) {
+        pthread_mutex_init(&row_mt_sync->mutex_[i], NULL);
+      }
+    }
+
+    CHECK_MEM_ERROR(cm, row_mt_sync->cond_,
+                    aom_malloc(sizeof(*row_mt_sync->cond_) * rows));
+    if (row_mt_sync->cond_) {
+      for (i = 0; i < rows; ++i) {
+        pthread_cond_init(&row_mt_sync->cond_[i], NULL);
+      }
+    }
+  }
+#endif  // CONFIG_MULTITHREAD
+
+  CHECK_MEM_ERROR(cm, row_mt_sync->cur_sb_col,
+                  aom_malloc(sizeof(*row_mt_sync->cur_sb_col) * rows));
+  CHECK_MEM_ERROR(cm, row_mt_sync->tok_start,
+                  aom_malloc(sizeof(*row_mt_sync->tok_start) * rows));
+  CHECK_MEM_ERROR(cm, row_mt_sync->tok_count,
+                  aom_malloc(sizeof(*row_mt_sync->tok_count) * rows));
+
+  // Coding a superblock takes far longer than synchronizing on it, so wait
+  // for a single above-right superblock only.
+  row_mt_sync->sync_range = 1;
+}
+
+static void row_mt_sync_dealloc(AV1RowMTSync *row_mt_sync) {
+  if (row_mt_sync != NULL) {
+#if CONFIG_MULTITHREAD
+    int i;
+
+    if (row_mt_sync->mutex_ != NULL) {
+      for (i = 0; i < row_mt_sync->rows; ++i) {
+        pthread_mutex_destroy(&row_mt_sync->mutex_[i]);
+      }
+      aom_free(row_mt_sync->mutex_);
+    }
+    if (row_mt_sync->cond_ != NULL) {
+      for (i = 0; i < row_mt_sync->rows; ++i) {
+        pthread_cond_destroy(&row_mt_sync->cond_[i]);
+      }
+      aom_free(row_mt_sync->cond_);
+    }
+#endif  // CONFIG_MULTITHREAD
+    aom_free(row_mt_sync->cur_sb_col);
+    aom_free(row_mt_sync->tok_start);
+    aom_free(row_mt_sync->tok_count);
+    av1_zero(*row_mt_sync);
+  }
+}
+
+void av1_row_mt_dealloc(AV1RowMTInfo *row_mt_info) {
+  int i;
+
+  if (row_mt_info->sync != NULL) {
+    for (i = 0; i < row_mt_info->allocated_tile_cols; ++i)
+      row_mt_sync_dealloc(&row_mt_info->sync[i]);
+    aom_free(row_mt_info->sync);
+  }
+#if CONFIG_MULTITHREAD
+  if (row_mt_info->job_mutex_ != NULL) {
+    pthread_mutex_destroy(row_mt_info->job_mutex_);
+    aom_free(row_mt_info->job_mutex_);
+  }
+#endif  // CONFIG_MULTITHREAD
+  av1_zero(*row_mt_info);
+}
+
+static void row_mt_alloc(AV1_COMP *cpi, int tile_cols, int sb_rows) {
+  AV1_COMMON *const cm = &cpi->common;
+  AV1RowMTInfo *const row_mt_info = &cpi->row_mt_info;
+  int i;
+
+  if (row_mt_info->sync != NULL &&
+      tile_cols <= row_mt_info->allocated_tile_cols &&
+      sb_rows <= row_mt_info->allocated_sb_rows)
+    return;
+
+  av1_row_mt_dealloc(row_mt_info);
+
+#if CONFIG_MULTITHREAD
+  CHECK_MEM_ERROR(cm, row_mt_info->job_mutex_,
+                  aom_malloc(sizeof(*row_mt_info->job_mutex_)));
+  if (row_mt_info->job_mutex_)
+    pthread_mutex_init(row_mt_info->job_mutex_, NULL);
+#endif  // CONFIG_MULTITHREAD
+
+  CHECK_MEM_ERROR(cm, row_mt_info->sync,
+                  aom_calloc(tile_cols, sizeof(*row_mt_info->sync)));
+  row_mt_info->allocated_tile_cols = tile_cols;
+  for (i = 0; i < tile_cols; ++i)
+    row_mt_sync_alloc(&row_mt_info->sync[i], cm, sb_rows);
+  row_mt_info->allocated_sb_rows = sb_rows;
+}
+
+static int get_next_row_job(AV1RowMTInfo *const row_mt_info) {
+  int job = -1;
+
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(row_mt_info->job_mutex_);
+#endif  // CONFIG_MULTITHREAD
+  if (row_mt_info->next_job < row_mt_info->num_jobs)
+    job = row_mt_info->next_job++;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(row_mt_info->job_mutex_);
+#endif  // CONFIG_MULTITHREAD
+
+  return job;
+}
+
+static int enc_row_mt_worker_hook(EncWorkerData *const thread_data,
+                                  void *unused) {
+  AV1_COMP *const cpi = thread_data->cpi;
+  const AV1_COMMON *const cm = &cpi->common;
+  AV1RowMTInfo *const row_mt_info = &cpi->row_mt_info;
+  const int tile_cols = cm->tile_cols;
+  const int tile_row = row_mt_info->tile_row;
+  int job;
+
+  (void)unused;
+
+  // Jobs are handed out in raster order, so the row above a job has always
+  // been picked up by a running worker before the job itself.
+  while ((job = get_next_row_job(row_mt_info)) >= 0) {
+    const int tile_col = job % tile_cols;
+    const TileInfo *const tile_info =
+        &cpi->tile_data[tile_row * tile_cols + tile_col].tile_info;
+    const int mi_row =
+        tile_info->mi_row_start + (job / tile_cols) * cm->mib_size;
+
+    av1_encode_sb_row(cpi, thread_data->td, thread_data->row_tile_data,
+                      tile_row, tile_col, mi_row);
+  }
+
+  return 1;
+}
+
+int av1_row_mt_allowed(const AV1_COMP *cpi) {
+#if CONFIG_PVQ || CONFIG_EC_ADAPT
+  // Both adapt per-tile state in superblock coding order.
+  (void)cpi;
+  return 0;
+#else
+  const AV1_COMMON *const cm = &cpi->common;
+
+  if (!cpi->oxcf.row_mt) return 0;
+#if CONFIG_SUBFRAME_PROB_UPDATE
+  if (cm->do_subframe_update) return 0;
+#endif  // CONFIG_SUBFRAME_PROB_UPDATE
+#if CONFIG_DELTA_Q
+  // The q index of a superblock is coded relative to the previous one.
+  if (cm->delta_q_present_flag) return 0;
+#endif  // CONFIG_DELTA_Q
+  (void)cm;
+  return 1;
+#endif  // CONFIG_PVQ || CONFIG_EC_ADAPT
+}
+
+void av1_encode_tiles_row_mt(AV1_COMP *cpi) {
+  AV1_COMMON *const cm = &cpi->common;
+  AV1RowMTInfo *const row_mt_info = &cpi->row_mt_info;
+  const int tile_cols = cm->tile_cols;
+  const int tile_rows = cm->tile_rows;
+  const int sb_rows = mi_rows_aligned_to_sb(cm) >> cm->mib_size_log2;
+  int num_workers, tile_row, tile_col, i;
+
+  av1_init_tile_data(cpi);
+
+  if (cpi->num_workers == 0)
+    create_enc_workers(cpi);
+  num_workers = cpi->num_workers;
+
+  row_mt_alloc(cpi, tile_cols, sb_rows);
+
+  for (i = 0; i < num_workers; i++) {
+    EncWorkerData *const thread_data = &cpi->tile_thr_data[i];
+    if (thread_data->row_tile_data == NULL)
+      CHECK_MEM_ERROR(cm, thread_data->row_tile_data,
+                      aom_memalign(32, sizeof(*thread_data->row_tile_data)));
+  }
+
+  prepare_enc_workers(cpi, (AVxWorkerHook)enc_row_mt_worker_hook,
+                      num_workers);
+
+  // Tile rows share the above context arrays, so they are encoded one after
+  // the other with all superblock rows of a tile row spread over the workers.
+  for (tile_row = 0; tile_row < tile_rows; ++tile_row) {
+    const TileInfo *const tile_info =
+        &cpi->tile_data[tile_row * tile_cols].tile_info;
+    const int tile_sb_rows =
+        (tile_info->mi_row_end - tile_info->mi_row_start + cm->mib_size - 1) >>
+        cm->mib_size_log2;
+
+    for (tile_col = 0; tile_col < tile_cols; ++tile_col)
+      av1_init_tile_row_mt(cpi, tile_row, tile_col);
+
+    row_mt_info->tile_row = tile_row;
+    row_mt_info->next_job = 0;
+    row_mt_info->num_jobs = tile_sb_rows * tile_cols;
+
+    launch_enc_workers(cpi, AOMMIN(num_workers, row_mt_info->num_jobs));
+
+    for (tile_col = 0; tile_col < tile_cols; ++tile_col)
+      av1_finish_tile_row_mt(cpi, tile_row, tile_col);
+  }
+
+  accumulate_enc_workers(cpi, num_workers);
+}
+
+static int first_pass_worker_hook(EncWorkerData *const thread_data,
+                                  void *unused) {
+  AV1_COMP *const cpi = thread_data->cpi;
+  AV1RowMTInfo *const row_mt_info = &cpi->row_mt_info;
+  int mb_row;
+
+  (void)unused;
+
+  while ((mb_row = get_next_row_job(row_mt_info)) >= 0)
+    av1_first_pass_mb_row(cpi, thread_data->td, mb_row, &row_mt_info->sync[0]);
+
+  return 1;
+}
+
+void av1_first_pass_row_mt(AV1_COMP *cpi) {
+  AV1_COMMON *const cm = &cpi->common;
+  AV1RowMTInfo *const row_mt_info = &cpi->row_mt_info;
+  int num_workers, i;
+
+  if (cpi->num_workers == 0)
+    create_enc_workers(cpi);
+  num_workers = AOMMIN(cpi->num_workers, cm->mb_rows);
+
+  // The first pass ignores tiling; its macroblock rows are synchronized like
+  // the superblock rows of a single tile.
+  row_mt_alloc(cpi, 1, cm->mb_rows);
+  for (i = 0; i < cm->mb_rows; ++i) row_mt_info->sync[0].cur_sb_col[i] = -1;
+
+  row_mt_info->tile_row = 0;
+  row_mt_info->next_job = 0;
+  row_mt_info->num_jobs = cm->mb_rows;
+
+  prepare_enc_workers(cpi, (AVxWorkerHook)first_pass_worker_hook,
+                      num_workers);
+  launch_enc_workers(cpi, num_workers);
+}
+
+static int temporal_filter_worker_hook(EncWorkerData *const thread_data,
+                                       void *unused) {
+  AV1_COMP *const cpi = thread_data->cpi;
+  AV1RowMTInfo *const row_mt_info = &cpi->row_mt_info;
+  int mb_row;
+
+  (void)unused;
+
+  while ((mb_row = get_next_row_job(row_mt_info)) >= 0)
+    av1_temporal_filter_iterate_row_c(cpi, thread_data->td, mb_row);
+
+  return 1;
+}
+
+void av1_temporal_filter_row_mt(AV1_COMP *cpi) {
+  const ARNRFilterData *const arnr_filter_data = &cpi->arnr_filter_data;
+  const YV12_BUFFER_CONFIG *const f =
+      arnr_filter_data->frames[arnr_filter_data->alt_ref_index];
+  const int mb_rows = (f->y_crop_height + 15) >> 4;
+  AV1RowMTInfo *const row_mt_info = &cpi->row_mt_info;
+  int num_workers;
+
+  if (cpi->num_workers == 0)
+    create_enc_workers(cpi);
+  num_workers = AOMMIN(cpi->num_workers, mb_rows);
+
+  // Macroblocks are filtered independently, so only the job queue is used.
+  row_mt_alloc(cpi, 1, mb_rows);
+  row_mt_info->tile_row = 0;
+  row_mt_info->next_job = 0;
+  row_mt_info->num_jobs = mb_rows;
+
+  prepare_enc_workers(cpi, (AVxWorkerHook)temporal_filter_worker_hook,
+                      num_workers);
+  launch_enc_workers(cpi, num_workers);
+}
+
+#if AV1_PACK_TILES_SEPARATELY
+static int pack_tiles_worker_hook(EncWorkerData *const thread_data,
+                                  void *unused) {
+  AV1_COMP *const cpi = thread_data->cpi;
+  const AV1_COMMON *const cm = &cpi->common;
+  const int num_workers = AOMMIN(cpi->num_workers, cm->tile_cols);
+  int tile_row, tile_col;
+
+  (void)unused;
+
+  // Tiles of the same column share the above context, so a worker packs
+  // whole tile columns from top to bottom.
+  for (tile_col = thread_data->start; tile_col < cm->tile_cols;
+       tile_col += num_workers) {
+    for (tile_row = 0; tile_row < cm->tile_rows; ++tile_row)
+      av1_pack_tile(cpi, thread_data->td, tile_row, tile_col);
+  }
+
+  return 1;
+}
+
+void av1_pack_tiles_mt(AV1_COMP *cpi) {
+  const int tile_cols = cpi->common.tile_cols;
+  int num_workers, i, j;
+
+  if (cpi->num_workers == 0)
+    create_enc_workers(cpi);
+  num_workers = AOMMIN(cpi->num_workers, tile_cols);
+
+  for (i = 0; i < num_workers; i++) {
+    AVxWorker *const worker = &cpi->workers[i];
+    EncWorkerData *const thread_data = &cpi->tile_thr_data[i];
+
+    worker->hook = (AVxWorkerHook)pack_tiles_worker_hook;
+    worker->data1 = thread_data;
+    worker->data2 = NULL;
+
+    // Packing only needs the macroblockd state of cpi; the rest of the
+    // thread data is left as the encoding stage set it up.
+    if (thread_data->td != &cpi->td) {
+      thread_data->td->mb.e_mbd = cpi->td.mb.e_mbd;
+      av1_zero(thread_data->td->interp_filter_selected);
+    }
+  }
+
+  launch_enc_workers(cpi, num_workers);
+
+  for (i = 0; i < num_workers; i++) {
+    const ThreadData *const td = cpi->tile_thr_data[i].td;
+    if (td == &cpi->td) continue;
+    for (j = 0; j < SWITCHABLE; ++j)
+      cpi->td.interp_filter_selected[j] += td->interp_filter_selected[j];
+  }
+}
+#endif  // AV1_PACK_TILES_SEPARATELY
+
+static int lpf_search_worker_hook(EncWorkerData *const thread_data,
+                                  const LpfRowJob *const job) {
+  AV1_COMP *const cpi = thread_data->cpi;
+  const int start = job->restore ? job->filt_start : 0;
+  const int end = job->restore ? job->filt_end : job->num_rows;
+  int row;
+
+  for (row = start + thread_data->start; row < end; row += cpi->num_workers)
+    av1_lpf_search_row(cpi, job, row);
+
+  return 1;
+}
+
+void av1_lpf_search_rows_mt(AV1_COMP *cpi, LpfRowJob *job) {
+  int i;
+
+  // Every superblock row writes its own SSE and pixels.
+  for (i = 0; i < cpi->num_workers; i++) {
+    AVxWorker *const worker = &cpi->workers[i];
+    worker->hook = (AVxWorkerHook)lpf_search_worker_hook;
+    worker->data1 = &cpi->tile_thr_data[i];
+    worker->data2 = job;
+  }
+
+  launch_enc_workers(cpi, cpi->num_workers);
+}
+
+#if CONFIG_LOOP_RESTORATION
+static int restoration_fit_worker_hook(EncWorkerData *const thread_data,
+                                       const RestorationFitJob *const job) {
+  AV1_COMP *const cpi = thread_data->cpi;
+  const int num_workers = AOMMIN(cpi->num_workers, job->ntiles);
+  int32_t *const tmpbuf = thread_data->td == &cpi->td
+                              ? cpi->common.rst_internal.tmpbuf
+                              : thread_data->td->rst_tmpbuf;
+  int tile_idx;
+
+  for (tile_idx = thread_data->start; tile_idx < job->ntiles;
+       tile_idx += num_workers)
+    av1_fit_restoration_tile(cpi, job, tile_idx, tmpbuf);
+
+  return 1;
+}
+
+void av1_fit_restoration_tiles_mt(AV1_COMP *cpi, RestorationFitJob *job) {
+  AV1_COMMON *const cm = &cpi->common;
+  int num_workers, i;
+
+  if (cpi->num_workers == 0)
+    create_enc_workers(cpi);
+  num_workers = AOMMIN(cpi->num_workers, job->ntiles);
+
+  // Each tile only writes its own filter and type.
+  for (i = 0; i < num_workers; i++) {
+    AVxWorker *const worker = &cpi->workers[i];
+    EncWorkerData *const thread_data = &cpi->tile_thr_data[i];
+
+    worker->hook = (AVxWorkerHook)restoration_fit_worker_hook;
+    worker->data1 = thread_data;
+    worker->data2 = job;
+
+    if (thread_data->td != &cpi->td && !thread_data->td->rst_tmpbuf)
+      CHECK_MEM_ERROR(cm, thread_data->td->rst_tmpbuf,
+                      (int32_t *)aom_memalign(16, RESTORATION_TMPBUF_SIZE));
+  }
+
+  launch_enc_workers(cpi, num_workers);
+}
+#endif  // CONFIG_LOOP_RESTORATION
+
+#if CONFIG_CDEF
+static int dering_search_worker_hook(EncWorkerData *const thread_data,
+                                     const DeringSearchJob *const job) {
+  AV1_COMP *const cpi = thread_data->cpi;
+  int sbr;
+
+  for (sbr = thread_data->start; sbr < job->nvsb; sbr += cpi->num_workers)
+    av1_dering_search_row(cpi, job, sbr);
+
+  return 1;
+}
+
+void av1_dering_search_rows_mt(AV1_COMP *cpi, DeringSearchJob *job) {
+  int i;
+
+  if (cpi->num_workers == 0)
+    create_enc_workers(cpi);
+
+  // Each superblock only writes the dering gain of its own mode info.
+  for (i = 0; i < cpi->num_workers; i++) {
+    AVxWorker *const worker = &cpi->workers[i];
+    worker->hook = (AVxWorkerHook)dering_search_worker_hook;
+    worker->data1 = &cpi->tile_thr_data[i];
+    worker->data2 = job;
+  }
+
+  launch_enc_workers(cpi, cpi->num_workers);
+}
+
+static int clpf_detect_worker_hook(EncWorkerData *const thread_data,
+                                const ClpfRdoJob *const job) {
+  AV1_COMP *const cpi = thread_data->cpi;
+  int row;
+
+  for (row = thread_data->start; row < job->num_rows; row += cpi->num_workers)
+    av1_clpf_detect_row(&cpi->common, job, row);
+
+  return 1;
+}
+
+void av1_clpf_detect_rows_mt(AV1_COMP *cpi, ClpfRdoJob *job) {
+  int i;
+
+  if (cpi->num_workers == 0)
+    create_enc_workers(cpi);
+
+  // Each block row only writes its own square errors.
+  for (i = 0; i < cpi->num_workers; i++) {
+    AVxWorker *const worker = &cpi->workers[i];
+    worker->hook = (AVxWorkerHook)clpf_detect_worker_hook;
+    worker->data1 = &cpi->tile_thr_data[i];
+    worker->data2 = job;
+  }
+
+  launch_enc_workers(cpi, cpi->num_workers);
+}
+#endif  // CONFIG_CDEF
+
+#if CONFIG_GLOBAL_MOTION
+static int global_motion_worker_hook(EncWorkerData *const thread_data,
+                                     void *unused) {
+  AV1_COMP *const cpi = thread_data->cpi;
+  const int num_workers = AOMMIN(cpi->num_workers, INTER_REFS_PER_FRAME);
+  int frame;
+
+  (void)unused;
+
+  for (frame = LAST_FRAME + thread_data->start; frame <= ALTREF_FRAME;
+       frame += num_workers)
+    av1_global_motion_search_ref(cpi, frame);
+
+  return 1;
+}
+
+void av1_global_motion_search_mt(AV1_COMP *cpi) {
+  int num_workers, i;
+
+  if (cpi->num_workers == 0)
+    create_enc_workers(cpi);
+  num_workers = AOMMIN(cpi->num_workers, INTER_REFS_PER_FRAME);
+
+  // Each reference frame only writes its own global motion parameters.
+  for (i = 0; i < num_workers; i++) {
+    AVxWorker *const worker = &cpi->workers[i];
+    worker->hook = (AVxWorkerHook)global_motion_worker_hook;
+    worker->data1 = &cpi->tile_thr_data[i];
+    worker->data2 = NULL;
+  }
+
+  launch_enc_workers(cpi, num_workers);
+}
+#endif  // CONFIG_GLOBAL_MOTION
@@ -12,21 +12,117 @@
 #ifndef AV1_ENCODER_ETHREAD_H_
 #define AV1_ENCODER_ETHREAD_H_
 
+#include "./aom_config.h"
+#include "aom_util/aom_thread.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 struct AV1_COMP;
 struct ThreadData;
+struct TileDataEnc;
+struct LpfRowJob;
+struct RestorationFitJob;
+struct DeringSearchJob;
+struct ClpfRdoJob;
 
 typedef struct EncWorkerData {
   struct AV1_COMP *cpi;
   struct ThreadData *td;
   int start;
+  // Private copy of the tile data used while encoding one superblock row in
+  // row based multi-threading mode.
+  struct TileDataEnc *row_tile_data;
 } EncWorkerData;
 
+// Superblock row synchronization of one tile for the row based
+// multi-threaded encoder.
+typedef struct AV1RowMTSyncData {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t *mutex_;
+  pthread_cond_t *cond_;
+#endif
+  // Index of the last encoded superblock in each superblock row of the tile.
+  int *cur_sb_col;
+  // Offset into the tile token buffer and number of tokens written by each
+  // superblock row of the tile.
+  unsigned int *tok_start;
+  unsigned int *tok_count;
+  int sync_range;
+  int rows;
+} AV1RowMTSync;
+
+typedef struct AV1RowMTInfo {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t *job_mutex_;
+#endif
+  // One AV1RowMTSync per tile column; tile rows are encoded one at a time.
+  AV1RowMTSync *sync;
+  int allocated_tile_cols;
+  int allocated_sb_rows;
+  // Job queue of the tile row being encoded. Job j encodes superblock row
+  // (j / tile_cols) of tile column (j % tile_cols).
+  int tile_row;
+  int next_job;
+  int num_jobs;
+} AV1RowMTInfo;
+
 void av1_encode_tiles_mt(struct AV1_COMP *cpi);
 
+// Encodes the frame with superblock rows of each tile distributed across the
+// worker threads.
+void av1_encode_tiles_row_mt(struct AV1_COMP *cpi);
+
+// Returns 1 if the current frame can be encoded with row based
+// multi-threading.
+int av1_row_mt_allowed(const struct AV1_COMP *cpi);
+
+void av1_row_mt_sync_read(AV1RowMTSync *const row_mt_sync, int r, int c);
+void av1_row_mt_sync_write(AV1RowMTSync *const row_mt_sync, int r, int c,
+                           const int sb_cols);
+
+void av1_row_mt_dealloc(AV1RowMTInfo *row_mt_info);
+
+// Runs the first pass analysis with macroblock rows distributed across the
+// worker threads.
+void av1_first_pass_row_mt(struct AV1_COMP *cpi);
+
+// Runs the ARNR filter of the alt-ref frame with macroblock rows distributed
+// across the worker threads.
+void av1_temporal_filter_row_mt(struct AV1_COMP *cpi);
+
+// Packs the tiles of the frame into their own buffers, with tile columns
+// distributed across the worker threads.
+void av1_pack_tiles_mt(struct AV1_COMP *cpi);
+
+// Measures, saves or restores the superblock rows of a loop filter level
+// search pass on the worker threads.
+void av1_lpf_search_rows_mt(struct AV1_COMP *cpi, struct LpfRowJob *job);
+
+#if CONFIG_LOOP_RESTORATION
+// Fits the loop restoration filters of the tiles of one plane on the worker
+// threads.
+void av1_fit_restoration_tiles_mt(struct AV1_COMP *cpi,
+                                  struct RestorationFitJob *job);
+#endif  // CONFIG_LOOP_RESTORATION
+
+#if CONFIG_CDEF
+// Searches the dering gains of the superblock rows on the worker threads.
+void av1_dering_search_rows_mt(struct AV1_COMP *cpi,
+                               struct DeringSearchJob *job);
+
+// Measures the CLPF square errors of the block rows of one plane on the worker
+// threads.
+void av1_clpf_detect_rows_mt(struct AV1_COMP *cpi, struct ClpfRdoJob *job);
+#endif  // CONFIG_CDEF
+
+#if CONFIG_GLOBAL_MOTION
+// Runs the global motion search of the reference frames on the worker
+// threads.
+void av1_global_motion_search_mt(struct AV1_COMP *cpi);
+#endif  // CONFIG_GLOBAL_MOTION
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -12,6 +12,7 @@
 #ifndef AV1_ENCODER_FIRSTPASS_H_
 #define AV1_ENCODER_FIRSTPASS_H_
 
+#include "av1/common/mv.h"
 #include "av1/encoder/lookahead.h"
 #include "av1/encoder/ratectrl.h"
 
@@ -79,6 +80,36 @@ typedef struct {
   double count;
 } FIRSTPASS_STATS;
 
+// Partial first pass statistics of one macroblock row. Rows are coded
+// independently and summed in raster order, which keeps the frame statistics
+// identical for any number of threads.
+typedef struct {
+  int64_t intra_error;
+  int64_t coded_error;
+  int64_t sr_coded_error;
+  int64_t sum_mvrs;
+  int64_t sum_mvcs;
+  int sum_mvr;
+  int sum_mvc;
+  int sum_mvr_abs;
+  int sum_mvc_abs;
+  int mvcount;
+  int intercount;
+  int second_ref_count;
+  int intra_skip_count;
+  int new_mv_count;
+  int sum_in_vectors;
+  // Row index if the row contains image data, -1 otherwise.
+  int image_data_start_row;
+  double intra_factor;
+  double brightness_factor;
+  double neutral_count;
+  // First and last non-zero motion vectors of the row, used to count new
+  // motion vectors across row boundaries.
+  MV first_mv;
+  MV last_mv;
+} FIRSTPASS_DATA;
+
 typedef enum {
   KF_UPDATE = 0,
   LF_UPDATE = 1,
@@ -151,6 +182,10 @@ typedef struct {
 
   int sr_update_lag;
 
+  // Per macroblock row statistics of the frame being analysed.
+  FIRSTPASS_DATA *fp_row_data;
+  int fp_row_data_rows;
+
   int kf_zeromotion_pct;
   int last_kfgroup_zeromotion_pct;
   int gf_zeromotion_pct;
@@ -164,13 +199,24 @@ typedef struct {
 } TWO_PASS;
 
 struct AV1_COMP;
+struct AV1RowMTSyncData;
+struct ThreadData;
 
 void av1_init_first_pass(struct AV1_COMP *cpi);
 void av1_rc_get_first_pass_params(struct AV1_COMP *cpi);
 void av1_first_pass(struct AV1_COMP *cpi, const struct lookahead_entry *source);
+// Analyses one macroblock row of the first pass frame into
+// cpi->twopass.fp_row_data[mb_row]. row_mt_sync may be NULL when the rows are
+// processed in order on a single thread.
+void av1_first_pass_mb_row(struct AV1_COMP *cpi, struct ThreadData *td,
+                           int mb_row, struct AV1RowMTSyncData *row_mt_sync);
 void av1_end_first_pass(struct AV1_COMP *cpi);
 
 void av1_init_second_pass(struct AV1_COMP *cpi);
+// Limits the second pass to the first pass stats of frames [start, end),
+// which begin with a key frame, and gives them their share of the bits.
+// Called before the first frame of the chunk is encoded.
+void av1_twopass_restrict_to_chunk(struct AV1_COMP *cpi, int start, int end);
 void av1_rc_get_second_pass_params(struct AV1_COMP *cpi);
 void av1_twopass_postencode_update(struct AV1_COMP *cpi);
 
@@ -257,20 +257,81 @@ static int compute_global_motion_params(TransformationType type,
 }
 
 #if CONFIG_AOM_HIGHBITDEPTH
-unsigned char *downconvert_frame(YV12_BUFFER_CONFIG *frm, int bit_depth) {
+static void downconvert_luma(YV12_BUFFER_CONFIG *frm, int bit_depth,
+                             uint8_t *buf) {
   int i, j;
   uint16_t *orig_buf = CONVERT_TO_SHORTPTR(frm->y_buffer);
-  uint8_t *buf = malloc(frm->y_height * frm->y_stride * sizeof(*buf));
 
   for (i = 0; i < frm->y_height; ++i)
     for (j = 0; j < frm->y_width; ++j)
       buf[i * frm->y_stride + j] =
           orig_buf[i * frm->y_stride + j] >> (bit_depth - 8);
+}
 
+unsigned char *downconvert_frame(YV12_BUFFER_CONFIG *frm, int bit_depth) {
+  uint8_t *buf = malloc(frm->y_height * frm->y_stride * sizeof(*buf));
+  if (buf) downconvert_luma(frm, bit_depth, buf);
   return buf;
 }
 #endif
 
+static unsigned char *get_luma_8bit(YV12_BUFFER_CONFIG *frm) {
+#if CONFIG_AOM_HIGHBITDEPTH
+  if (frm->flags & YV12_FLAG_HIGHBITDEPTH) return frm->y_buffer_8bit;
+#endif
+  return frm->y_buffer;
+}
+
+void av1_compute_frame_corners(YV12_BUFFER_CONFIG *frm,
+#if CONFIG_AOM_HIGHBITDEPTH
+                               int bit_depth,
+#endif
+                               int refresh) {
+  int corners[2 * MAX_CORNERS];
+
+  if (frm->corners && !refresh) return;
+
+#if CONFIG_AOM_HIGHBITDEPTH
+  if (frm->flags & YV12_FLAG_HIGHBITDEPTH) {
+    // The frame buffer is 16-bit, so we need to convert to 8 bits for the
+    // following code. We cache the result until the frame is released.
+    if (!frm->y_buffer_8bit)
+      frm->y_buffer_8bit = downconvert_frame(frm, bit_depth);
+    else if (refresh)
+      downconvert_luma(frm, bit_depth, frm->y_buffer_8bit);
+    if (!frm->y_buffer_8bit) return;
+  }
+#endif
+
+  free(frm->corners);
+  frm->num_corners =
+      fast_corner_detect(get_luma_8bit(frm), frm->y_width, frm->y_height,
+                         frm->y_stride, corners, MAX_CORNERS);
+  frm->corners =
+      (int *)malloc(AOMMAX(frm->num_corners, 1) * 2 * sizeof(*frm->corners));
+  if (frm->corners)
+    memcpy(frm->corners, corners, frm->num_corners * 2 * sizeof(*corners));
+  else
+    frm->num_corners = 0;
+}
+
+int av1_compute_correspondences(YV12_BUFFER_CONFIG *frm,
+                                YV12_BUFFER_CONFIG *ref,
+                                int *correspondences) {
+  assert(frm->corners && ref->corners);
+  return determine_correspondence(
+      get_luma_8bit(frm), frm->corners, frm->num_corners, get_luma_8bit(ref),
+      ref->corners, ref->num_corners, frm->y_width, frm->y_height,
+      frm->y_stride, ref->y_stride, correspondences);
+}
+
+int av1_fit_global_motion(TransformationType type, int *correspondences,
+                          int num_correspondences, double *params) {
+  const int num_inliers = compute_global_motion_params(
+      type, correspondences, num_correspondences, params);
+  return (num_inliers > 0);
+}
+
 int compute_global_motion_feature_based(TransformationType type,
                                         YV12_BUFFER_CONFIG *frm,
                                         YV12_BUFFER_CONFIG *ref,
@@ -278,47 +339,28 @@ int compute_global_motion_feature_based(TransformationType type,
                                         int bit_depth,
 #endif
                                         double *params) {
-  int num_frm_corners, num_ref_corners;
   int num_correspondences;
   int *correspondences;
-  int num_inliers;
-  int frm_corners[2 * MAX_CORNERS], ref_corners[2 * MAX_CORNERS];
-  unsigned char *frm_buffer = frm->y_buffer;
-  unsigned char *ref_buffer = ref->y_buffer;
+  int result;
 
+  // compute interest points in images using FAST features
 #if CONFIG_AOM_HIGHBITDEPTH
-  if (frm->flags & YV12_FLAG_HIGHBITDEPTH) {
-    // The frame buffer is 16-bit, so we need to convert to 8 bits for the
-    // following code. We cache the result until the frame is released.
-    if (frm->y_buffer_8bit)
-      frm_buffer = frm->y_buffer_8bit;
-    else
-      frm_buffer = frm->y_buffer_8bit = downconvert_frame(frm, bit_depth);
-  }
-  if (ref->flags & YV12_FLAG_HIGHBITDEPTH) {
-    if (ref->y_buffer_8bit)
-      ref_buffer = ref->y_buffer_8bit;
-    else
-      ref_buffer = ref->y_buffer_8bit = downconvert_frame(ref, bit_depth);
-  }
+  av1_compute_frame_corners(frm, bit_depth, 0);
+  av1_compute_frame_corners(ref, bit_depth, 0);
+#else
+  av1_compute_frame_corners(frm, 0);
+  av1_compute_frame_corners(ref, 0);
 #endif
-
-  // compute interest points in images using FAST features
-  num_frm_corners = fast_corner_detect(frm_buffer, frm->y_width, frm->y_height,
-                                       frm->y_stride, frm_corners, MAX_CORNERS);
-  num_ref_corners = fast_corner_detect(ref_buffer, ref->y_width, ref->y_height,
-                                       ref->y_stride, ref_corners, MAX_CORNERS);
+  if (!frm->corners || !ref->corners) return 0;
 
   // find correspondences between the two images
   correspondences =
-      (int *)malloc(num_frm_corners * 4 * sizeof(*correspondences));
-  num_correspondences = determine_correspondence(
-      frm_buffer, (int *)frm_corners, num_frm_corners, ref_buffer,
-      (int *)ref_corners, num_ref_corners, frm->y_width, frm->y_height,
-      frm->y_stride, ref->y_stride, correspondences);
+      (int *)malloc(AOMMAX(frm->num_corners, 1) * 4 * sizeof(*correspondences));
+  if (!correspondences) return 0;
+  num_correspondences = av1_compute_correspondences(frm, ref, correspondences);
 
-  num_inliers = compute_global_motion_params(type, correspondences,
-                                             num_correspondences, params);
+  result = av1_fit_global_motion(type, correspondences, num_correspondences,
+                                 params);
   free(correspondences);
-  return (num_inliers > 0);
+  return result;
 }
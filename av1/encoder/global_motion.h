@@ -42,6 +42,26 @@ double refine_integerized_param(WarpedMotionParams *wm,
                                 int r_stride, uint8_t *dst, int d_width,
                                 int d_height, int d_stride, int n_refinements);
 
+// Detects the FAST corners of the luma plane of frm, along with an 8-bit
+// copy of the luma for high bitdepth buffers, and caches them on the buffer
+// until it is reallocated. Buffers that receive new content without being
+// reallocated, such as the source frame, must be passed with refresh set.
+void av1_compute_frame_corners(YV12_BUFFER_CONFIG *frm,
+#if CONFIG_AOM_HIGHBITDEPTH
+                               int bit_depth,
+#endif
+                               int refresh);
+
+// Matches the cached corners of frm with those of ref. correspondences must
+// have room for 4 * frm->num_corners entries. Returns the number of matches.
+int av1_compute_correspondences(YV12_BUFFER_CONFIG *frm,
+                                YV12_BUFFER_CONFIG *ref, int *correspondences);
+
+// Fits a motion model of the given type to the correspondences using
+// RANSAC. Returns 1 if a model was found.
+int av1_fit_global_motion(TransformationType type, int *correspondences,
+                          int num_correspondences, double *params);
+
 /*
   Computes global motion parameters between two frames. The array
   "params" should be length 9, where the first 2 slots are translation
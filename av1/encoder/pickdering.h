@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#ifndef AV1_ENCODER_PICKDERING_H_
+#define AV1_ENCODER_PICKDERING_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "av1/encoder/encoder.h"
+
+struct AV1_COMP;
+
+// Superblock rows of the luma plane handled by the dering gain search.
+typedef struct DeringSearchJob {
+  // Reconstructed and source luma planes, copied into cpi->dering_src and
+  // cpi->dering_ref.
+  const int16_t *src;
+  const int16_t *ref_coeff;
+  int stride;
+  int nvsb;
+  int nhsb;
+  int best_level;
+} DeringSearchJob;
+
+void av1_dering_search_row(struct AV1_COMP *cpi, const DeringSearchJob *job,
+                           int sbr);
+
+int av1_dering_search(struct AV1_COMP *cpi, YV12_BUFFER_CONFIG *frame,
+                      const YV12_BUFFER_CONFIG *ref);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AV1_ENCODER_PICKDERING_H_
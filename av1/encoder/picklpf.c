@@ -25,6 +25,7 @@
 
 #include "av1/encoder/av1_quantize.h"
 #include "av1/encoder/encoder.h"
+#include "av1/encoder/ethread.h"
 #include "av1/encoder/picklpf.h"
 
 int av1_get_max_filter_level(const AV1_COMP *cpi) {
@@ -36,11 +37,111 @@ int av1_get_max_filter_level(const AV1_COMP *cpi) {
   }
 }
 
-static int64_t try_filter_frame(const YV12_BUFFER_CONFIG *sd,
-                                AV1_COMP *const cpi, int filt_level,
-                                int partial_frame) {
+static int lpf_row_height(const AV1_COMMON *cm) {
+  return 1 << (cm->mib_size_log2 + MI_SIZE_LOG2);
+}
+
+static void copy_y_rows(const YV12_BUFFER_CONFIG *src, YV12_BUFFER_CONFIG *dst,
+                        int start, int end) {
+  const uint8_t *src_row = src->y_buffer + start * src->y_stride;
+  uint8_t *dst_row = dst->y_buffer + start * dst->y_stride;
+  int row;
+
+#if CONFIG_AOM_HIGHBITDEPTH
+  if (src->flags & YV12_FLAG_HIGHBITDEPTH) {
+    const uint16_t *src16 = CONVERT_TO_SHORTPTR(src_row);
+    uint16_t *dst16 = CONVERT_TO_SHORTPTR(dst_row);
+    for (row = start; row < end; ++row) {
+      memcpy(dst16, src16, src->y_width * sizeof(uint16_t));
+      src16 += src->y_stride;
+      dst16 += dst->y_stride;
+    }
+    return;
+  }
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+
+  for (row = start; row < end; ++row) {
+    memcpy(dst_row, src_row, src->y_width);
+    src_row += src->y_stride;
+    dst_row += dst->y_stride;
+  }
+}
+
+void av1_lpf_search_row(AV1_COMP *cpi, const LpfRowJob *job, int row) {
   AV1_COMMON *const cm = &cpi->common;
-  int64_t filt_err;
+  YV12_BUFFER_CONFIG *const frame = cm->frame_to_show;
+  const int row_height = lpf_row_height(cm);
+  const int start = row * row_height;
+  const int end = AOMMIN(start + row_height, frame->y_height);
+  const int crop_end = AOMMIN(end, frame->y_crop_height);
+  const int filtered = row >= job->filt_start && row < job->filt_end;
+
+  if (!job->restore && filtered) {
+    copy_y_rows(frame, &cpi->last_frame_uf, start, end);
+    return;
+  }
+
+  job->row_sse[row] = 0;
+  if (crop_end > start) {
+#if CONFIG_AOM_HIGHBITDEPTH
+    if (cm->use_highbitdepth)
+      job->row_sse[row] = aom_highbd_get_y_sse_part(
+          job->sd, frame, 0, frame->y_crop_width, start, crop_end - start);
+    else
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+      job->row_sse[row] = aom_get_y_sse_part(
+          job->sd, frame, 0, frame->y_crop_width, start, crop_end - start);
+  }
+
+  // Re-instate the unfiltered rows
+  if (job->restore) copy_y_rows(&cpi->last_frame_uf, frame, start, end);
+}
+
+static void lpf_search_rows(AV1_COMP *cpi, LpfRowJob *job) {
+  const int start = job->restore ? job->filt_start : 0;
+  const int end = job->restore ? job->filt_end : job->num_rows;
+  int row;
+
+  if (cpi->num_workers > 1) {
+    av1_lpf_search_rows_mt(cpi, job);
+    return;
+  }
+
+  for (row = start; row < end; ++row) av1_lpf_search_row(cpi, job, row);
+}
+
+static void setup_row_job(AV1_COMP *cpi, const YV12_BUFFER_CONFIG *sd,
+                          int partial_frame, LpfRowJob *job) {
+  AV1_COMMON *const cm = &cpi->common;
+  const int row_height = lpf_row_height(cm);
+  int start_mi_row = 0;
+  int mi_rows_to_filter = cm->mi_rows;
+  int start, end;
+
+  // Same rows as av1_loop_filter_frame().
+  if (partial_frame && cm->mi_rows > 8) {
+    start_mi_row = cm->mi_rows >> 1;
+    start_mi_row &= 0xfffffff8;
+    mi_rows_to_filter = AOMMAX(cm->mi_rows / 8, 8);
+  }
+  // Filtering the first horizontal edge also changes the pixels above it.
+  start = AOMMAX(start_mi_row * MI_SIZE - 8, 0);
+  end = (start_mi_row + mi_rows_to_filter) * MI_SIZE;
+
+  job->sd = sd;
+  job->num_rows = (cm->frame_to_show->y_height + row_height - 1) / row_height;
+  job->filt_start = start / row_height;
+  job->filt_end = AOMMIN((end + row_height - 1) / row_height, job->num_rows);
+  job->restore = 0;
+  CHECK_MEM_ERROR(cm, job->row_sse,
+                  aom_calloc(job->num_rows, sizeof(*job->row_sse)));
+}
+
+static int64_t try_filter_frame(AV1_COMP *const cpi, LpfRowJob *job,
+                                int filt_level, int partial_frame) {
+  AV1_COMMON *const cm = &cpi->common;
+  int64_t filt_err = 0;
+  int row;
 
 #if CONFIG_VAR_TX || CONFIG_EXT_PARTITION
   av1_loop_filter_frame(cm->frame_to_show, cm, &cpi->td.mb.e_mbd, filt_level, 1,
@@ -55,18 +156,12 @@ static int64_t try_filter_frame(const YV12_BUFFER_CONFIG *sd,
                           1, partial_frame);
 #endif
 
-#if CONFIG_AOM_HIGHBITDEPTH
-  if (cm->use_highbitdepth) {
-    filt_err = aom_highbd_get_y_sse(sd, cm->frame_to_show);
-  } else {
-    filt_err = aom_get_y_sse(sd, cm->frame_to_show);
-  }
-#else
-  filt_err = aom_get_y_sse(sd, cm->frame_to_show);
-#endif  // CONFIG_AOM_HIGHBITDEPTH
+  // Only the rows the filter can reach are measured and restored; the SSE of
+  // the others was computed once when the search started.
+  job->restore = 1;
+  lpf_search_rows(cpi, job);
 
-  // Re-instate the unfiltered frame
-  aom_yv12_copy_y(&cpi->last_frame_uf, cm->frame_to_show);
+  for (row = 0; row < job->num_rows; ++row) filt_err += job->row_sse[row];
 
   return filt_err;
 }
@@ -88,14 +183,17 @@ int av1_search_filter_level(const YV12_BUFFER_CONFIG *sd, AV1_COMP *cpi,
   int filter_step = filt_mid < 16 ? 4 : filt_mid / 4;
   // Sum squared error at each filter level
   int64_t ss_err[MAX_LOOP_FILTER + 1];
+  LpfRowJob job;
 
   // Set each entry to -1
   memset(ss_err, 0xFF, sizeof(ss_err));
 
+  setup_row_job(cpi, sd, partial_frame, &job);
+
   //  Make a copy of the unfiltered / processed recon buffer
-  aom_yv12_copy_y(cm->frame_to_show, &cpi->last_frame_uf);
+  lpf_search_rows(cpi, &job);
 
-  best_err = try_filter_frame(sd, cpi, filt_mid, partial_frame);
+  best_err = try_filter_frame(cpi, &job, filt_mid, partial_frame);
   filt_best = filt_mid;
   ss_err[filt_mid] = best_err;
 
@@ -115,7 +213,7 @@ int av1_search_filter_level(const YV12_BUFFER_CONFIG *sd, AV1_COMP *cpi,
     if (filt_direction <= 0 && filt_low != filt_mid) {
       // Get Low filter error score
       if (ss_err[filt_low] < 0) {
-        ss_err[filt_low] = try_filter_frame(sd, cpi, filt_low, partial_frame);
+        ss_err[filt_low] = try_filter_frame(cpi, &job, filt_low, partial_frame);
       }
       // If value is close to the best so far then bias towards a lower loop
       // filter value.
@@ -131,7 +229,8 @@ int av1_search_filter_level(const YV12_BUFFER_CONFIG *sd, AV1_COMP *cpi,
     // Now look at filt_high
     if (filt_direction >= 0 && filt_high != filt_mid) {
       if (ss_err[filt_high] < 0) {
-        ss_err[filt_high] = try_filter_frame(sd, cpi, filt_high, partial_frame);
+        ss_err[filt_high] =
+            try_filter_frame(cpi, &job, filt_high, partial_frame);
       }
       // If value is significantly better than previous best, bias added against
       // raising filter value
@@ -154,6 +253,8 @@ int av1_search_filter_level(const YV12_BUFFER_CONFIG *sd, AV1_COMP *cpi,
   // Update best error
   best_err = ss_err[filt_best];
 
+  aom_free(job.row_sse);
+
   if (best_cost_ret)
     *best_cost_ret = RDCOST_DBL(x->rdmult, x->rddiv, 0, best_err);
   return filt_best;
@@ -20,6 +20,25 @@ extern "C" {
 
 struct yv12_buffer_config;
 struct AV1_COMP;
+
+// Superblock rows of the luma plane handled by one pass of the loop filter
+// level search.
+typedef struct LpfRowJob {
+  const YV12_BUFFER_CONFIG *sd;
+  // Luma SSE of each superblock row against the source frame.
+  int64_t *row_sse;
+  int num_rows;
+  // Superblock rows [filt_start, filt_end) can be changed by the filter.
+  int filt_start;
+  int filt_end;
+  // When set, the rows the filter can change are measured and then restored
+  // from last_frame_uf. Otherwise, those rows are saved to last_frame_uf and
+  // the SSE of the rows the filter leaves alone is measured once.
+  int restore;
+} LpfRowJob;
+
+void av1_lpf_search_row(struct AV1_COMP *cpi, const LpfRowJob *job, int row);
+
 int av1_get_max_filter_level(const AV1_COMP *cpi);
 int av1_search_filter_level(const YV12_BUFFER_CONFIG *sd, AV1_COMP *cpi,
                             int partial_frame, double *err);
@@ -27,6 +27,7 @@
 
 #include "av1/encoder/av1_quantize.h"
 #include "av1/encoder/encoder.h"
+#include "av1/encoder/ethread.h"
 #include "av1/encoder/picklpf.h"
 #include "av1/encoder/pickrst.h"
 
@@ -45,6 +46,11 @@ typedef double (*search_restore_type)(const YV12_BUFFER_CONFIG *src,
 
 const int frame_level_restore_bits[RESTORE_TYPES] = { 2, 2, 2, 2 };
 
+static void fit_restoration_tiles(const YV12_BUFFER_CONFIG *src, AV1_COMP *cpi,
+                                  RestorationType rtype, int plane,
+                                  RestorationInfo *rsi, RestorationType *type,
+                                  int ntiles);
+
 static int64_t sse_restoration_tile(const YV12_BUFFER_CONFIG *src,
                                     const YV12_BUFFER_CONFIG *dst,
                                     const AV1_COMMON *cm, int h_start,
@@ -351,7 +357,6 @@ static double search_sgrproj(const YV12_BUFFER_CONFIG *src, AV1_COMP *cpi,
   int bits;
   MACROBLOCK *x = &cpi->td.mb;
   AV1_COMMON *const cm = &cpi->common;
-  const YV12_BUFFER_CONFIG *dgd = cm->frame_to_show;
   RestorationInfo *rsi = &cpi->rst_search[0];
   int tile_idx, tile_width, tile_height, nhtiles, nvtiles;
   int h_start, h_end, v_start, v_end;
@@ -365,6 +370,8 @@ static double search_sgrproj(const YV12_BUFFER_CONFIG *src, AV1_COMP *cpi,
     rsi->restoration_type[tile_idx] = RESTORE_NONE;
   }
   // Compute best Sgrproj filters for each tile
+  fit_restoration_tiles(src, cpi, RESTORE_SGRPROJ, AOM_PLANE_Y, rsi, type,
+                        ntiles);
   for (tile_idx = 0; tile_idx < ntiles; ++tile_idx) {
     av1_get_rest_tile_limits(tile_idx, 0, 0, nhtiles, nvtiles, tile_width,
                              tile_height, cm->width, cm->height, 0, 0, &h_start,
@@ -375,17 +382,6 @@ static double search_sgrproj(const YV12_BUFFER_CONFIG *src, AV1_COMP *cpi,
     bits = av1_cost_bit(RESTORE_NONE_SGRPROJ_PROB, 0);
     cost_norestore = RDCOST_DBL(x->rdmult, x->rddiv, (bits >> 4), err);
     best_tile_cost[tile_idx] = DBL_MAX;
-    search_selfguided_restoration(
-        dgd->y_buffer + v_start * dgd->y_stride + h_start, h_end - h_start,
-        v_end - v_start, dgd->y_stride,
-        src->y_buffer + v_start * src->y_stride + h_start, src->y_stride,
-#if CONFIG_AOM_HIGHBITDEPTH
-        cm->bit_depth,
-#else
-        8,
-#endif  // CONFIG_AOM_HIGHBITDEPTH
-        &rsi->sgrproj_info[tile_idx].ep, rsi->sgrproj_info[tile_idx].xqd,
-        cm->rst_internal.tmpbuf);
     rsi->restoration_type[tile_idx] = RESTORE_SGRPROJ;
     err = try_restoration_tile(src, cpi, rsi, 1, partial_frame, tile_idx, 0, 0,
                                dst_frame);
@@ -737,6 +733,130 @@ static void quantize_sym_filter(double *f, InterpKernel fi) {
   fi[3] = -2 * (fi[0] + fi[1] + fi[2]);
 }
 
+static void fit_wiener_tile(AV1_COMP *cpi, const RestorationFitJob *job,
+                            int tile_idx) {
+  AV1_COMMON *const cm = &cpi->common;
+  const YV12_BUFFER_CONFIG *const src = job->src;
+  const YV12_BUFFER_CONFIG *const dgd = cm->frame_to_show;
+  WienerInfo *const wiener_info = &job->rsi->wiener_info[tile_idx];
+  double M[WIENER_WIN2];
+  double H[WIENER_WIN2 * WIENER_WIN2];
+  double vfilterd[WIENER_WIN], hfilterd[WIENER_WIN];
+  uint8_t *dgd_buf, *src_buf;
+  int width, height, dgd_stride, src_stride, border;
+  int tile_width, tile_height, nhtiles, nvtiles;
+  int h_start, h_end, v_start, v_end;
+
+  if (job->plane == AOM_PLANE_Y) {
+    width = cm->width;
+    height = cm->height;
+    dgd_buf = dgd->y_buffer;
+    src_buf = src->y_buffer;
+    dgd_stride = dgd->y_stride;
+    src_stride = src->y_stride;
+    border = 0;
+  } else {
+    width = src->uv_crop_width;
+    height = src->uv_crop_height;
+    dgd_buf = job->plane == AOM_PLANE_U ? dgd->u_buffer : dgd->v_buffer;
+    src_buf = job->plane == AOM_PLANE_U ? src->u_buffer : src->v_buffer;
+    dgd_stride = dgd->uv_stride;
+    src_stride = src->uv_stride;
+    border = WIENER_HALFWIN;
+  }
+  av1_get_rest_ntiles(width, height,
+                      cm->rst_info[job->plane > 0].restoration_tilesize,
+                      &tile_width, &tile_height, &nhtiles, &nvtiles);
+  av1_get_rest_tile_limits(tile_idx, 0, 0, nhtiles, nvtiles, tile_width,
+                           tile_height, width, height, border, border, &h_start,
+                           &h_end, &v_start, &v_end);
+#if CONFIG_AOM_HIGHBITDEPTH
+  if (cm->use_highbitdepth)
+    compute_stats_highbd(dgd_buf, src_buf, h_start, h_end, v_start, v_end,
+                         dgd_stride, src_stride, M, H);
+  else
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+    compute_stats(dgd_buf, src_buf, h_start, h_end, v_start, v_end, dgd_stride,
+                  src_stride, M, H);
+
+  job->type[tile_idx] = RESTORE_WIENER;
+
+  if (!wiener_decompose_sep_sym(M, H, vfilterd, hfilterd)) {
+    job->type[tile_idx] = RESTORE_NONE;
+    return;
+  }
+  quantize_sym_filter(vfilterd, wiener_info->vfilter);
+  quantize_sym_filter(hfilterd, wiener_info->hfilter);
+
+  // Filter score computes the value of the function x'*A*x - x'*b for the
+  // learned filter and compares it against identity filer. If there is no
+  // reduction in the function, the filter is reverted back to identity
+  if (compute_score(M, H, wiener_info->vfilter, wiener_info->hfilter) > 0.0)
+    job->type[tile_idx] = RESTORE_NONE;
+}
+
+static void fit_sgrproj_tile(AV1_COMP *cpi, const RestorationFitJob *job,
+                             int tile_idx, int32_t *tmpbuf) {
+  AV1_COMMON *const cm = &cpi->common;
+  const YV12_BUFFER_CONFIG *const src = job->src;
+  const YV12_BUFFER_CONFIG *const dgd = cm->frame_to_show;
+  SgrprojInfo *const sgrproj_info = &job->rsi->sgrproj_info[tile_idx];
+  int tile_width, tile_height, nhtiles, nvtiles;
+  int h_start, h_end, v_start, v_end;
+
+  assert(job->plane == AOM_PLANE_Y);
+  av1_get_rest_ntiles(cm->width, cm->height,
+                      cm->rst_info[0].restoration_tilesize, &tile_width,
+                      &tile_height, &nhtiles, &nvtiles);
+  av1_get_rest_tile_limits(tile_idx, 0, 0, nhtiles, nvtiles, tile_width,
+                           tile_height, cm->width, cm->height, 0, 0, &h_start,
+                           &h_end, &v_start, &v_end);
+  search_selfguided_restoration(
+      dgd->y_buffer + v_start * dgd->y_stride + h_start, h_end - h_start,
+      v_end - v_start, dgd->y_stride,
+      src->y_buffer + v_start * src->y_stride + h_start, src->y_stride,
+#if CONFIG_AOM_HIGHBITDEPTH
+      cm->bit_depth,
+#else
+      8,
+#endif  // CONFIG_AOM_HIGHBITDEPTH
+      &sgrproj_info->ep, sgrproj_info->xqd, tmpbuf);
+}
+
+void av1_fit_restoration_tile(AV1_COMP *cpi, const RestorationFitJob *job,
+                              int tile_idx, int32_t *tmpbuf) {
+  if (job->rtype == RESTORE_WIENER)
+    fit_wiener_tile(cpi, job, tile_idx);
+  else
+    fit_sgrproj_tile(cpi, job, tile_idx, tmpbuf);
+}
+
+// Fits the filters of all the tiles of a plane, on the worker threads when
+// more than one thread is allowed.
+static void fit_restoration_tiles(const YV12_BUFFER_CONFIG *src, AV1_COMP *cpi,
+                                  RestorationType rtype, int plane,
+                                  RestorationInfo *rsi, RestorationType *type,
+                                  int ntiles) {
+  RestorationFitJob job;
+  int tile_idx;
+
+  job.src = src;
+  job.rsi = rsi;
+  job.type = type;
+  job.rtype = rtype;
+  job.plane = plane;
+  job.ntiles = ntiles;
+
+  if (cpi->oxcf.max_threads > 1 && ntiles > 1) {
+    av1_fit_restoration_tiles_mt(cpi, &job);
+    return;
+  }
+
+  for (tile_idx = 0; tile_idx < ntiles; ++tile_idx)
+    av1_fit_restoration_tile(cpi, &job, tile_idx,
+                             cpi->common.rst_internal.tmpbuf);
+}
+
 static double search_wiener_uv(const YV12_BUFFER_CONFIG *src, AV1_COMP *cpi,
                                int partial_frame, int plane,
                                RestorationInfo *info, RestorationType *type,
@@ -748,22 +868,15 @@ static double search_wiener_uv(const YV12_BUFFER_CONFIG *src, AV1_COMP *cpi,
   int bits;
   double cost_wiener, cost_norestore, cost_wiener_frame, cost_norestore_frame;
   MACROBLOCK *x = &cpi->td.mb;
-  double M[WIENER_WIN2];
-  double H[WIENER_WIN2 * WIENER_WIN2];
-  double vfilterd[WIENER_WIN], hfilterd[WIENER_WIN];
-  const YV12_BUFFER_CONFIG *dgd = cm->frame_to_show;
   const int width = src->uv_crop_width;
   const int height = src->uv_crop_height;
-  const int src_stride = src->uv_stride;
-  const int dgd_stride = dgd->uv_stride;
-  double score;
   int tile_idx, tile_width, tile_height, nhtiles, nvtiles;
   int h_start, h_end, v_start, v_end;
   const int ntiles =
       av1_get_rest_ntiles(width, height, cm->rst_info[1].restoration_tilesize,
                           &tile_width, &tile_height, &nhtiles, &nvtiles);
-  assert(width == dgd->uv_crop_width);
-  assert(height == dgd->uv_crop_height);
+  assert(width == cm->frame_to_show->uv_crop_width);
+  assert(height == cm->frame_to_show->uv_crop_height);
 
   rsi[plane].frame_restoration_type = RESTORE_NONE;
   err = sse_restoration_frame(cm, src, cm->frame_to_show, (1 << plane));
@@ -777,6 +890,8 @@ static double search_wiener_uv(const YV12_BUFFER_CONFIG *src, AV1_COMP *cpi,
   }
 
   // Compute best Wiener filters for each tile
+  fit_restoration_tiles(src, cpi, RESTORE_WIENER, plane, &rsi[plane], type,
+                        ntiles);
   for (tile_idx = 0; tile_idx < ntiles; ++tile_idx) {
     av1_get_rest_tile_limits(tile_idx, 0, 0, nhtiles, nvtiles, tile_width,
                              tile_height, width, height, 0, 0, &h_start, &h_end,
@@ -789,50 +904,7 @@ static double search_wiener_uv(const YV12_BUFFER_CONFIG *src, AV1_COMP *cpi,
     cost_norestore = RDCOST_DBL(x->rdmult, x->rddiv, (bits >> 4), err);
     // best_tile_cost[tile_idx] = DBL_MAX;
 
-    av1_get_rest_tile_limits(tile_idx, 0, 0, nhtiles, nvtiles, tile_width,
-                             tile_height, width, height, WIENER_HALFWIN,
-                             WIENER_HALFWIN, &h_start, &h_end, &v_start,
-                             &v_end);
-    if (plane == AOM_PLANE_U) {
-#if CONFIG_AOM_HIGHBITDEPTH
-      if (cm->use_highbitdepth)
-        compute_stats_highbd(dgd->u_buffer, src->u_buffer, h_start, h_end,
-                             v_start, v_end, dgd_stride, src_stride, M, H);
-      else
-#endif  // CONFIG_AOM_HIGHBITDEPTH
-        compute_stats(dgd->u_buffer, src->u_buffer, h_start, h_end, v_start,
-                      v_end, dgd_stride, src_stride, M, H);
-    } else if (plane == AOM_PLANE_V) {
-#if CONFIG_AOM_HIGHBITDEPTH
-      if (cm->use_highbitdepth)
-        compute_stats_highbd(dgd->v_buffer, src->v_buffer, h_start, h_end,
-                             v_start, v_end, dgd_stride, src_stride, M, H);
-      else
-#endif  // CONFIG_AOM_HIGHBITDEPTH
-        compute_stats(dgd->v_buffer, src->v_buffer, h_start, h_end, v_start,
-                      v_end, dgd_stride, src_stride, M, H);
-    } else {
-      assert(0);
-    }
-
-    type[tile_idx] = RESTORE_WIENER;
-
-    if (!wiener_decompose_sep_sym(M, H, vfilterd, hfilterd)) {
-      type[tile_idx] = RESTORE_NONE;
-      continue;
-    }
-    quantize_sym_filter(vfilterd, rsi[plane].wiener_info[tile_idx].vfilter);
-    quantize_sym_filter(hfilterd, rsi[plane].wiener_info[tile_idx].hfilter);
-
-    // Filter score computes the value of the function x'*A*x - x'*b for the
-    // learned filter and compares it against identity filer. If there is no
-    // reduction in the function, the filter is reverted back to identity
-    score = compute_score(M, H, rsi[plane].wiener_info[tile_idx].vfilter,
-                          rsi[plane].wiener_info[tile_idx].hfilter);
-    if (score > 0.0) {
-      type[tile_idx] = RESTORE_NONE;
-      continue;
-    }
+    if (type[tile_idx] == RESTORE_NONE) continue;
 
     rsi[plane].restoration_type[tile_idx] = RESTORE_WIENER;
     err = try_restoration_tile(src, cpi, rsi, 1 << plane, partial_frame,
@@ -886,15 +958,10 @@ static double search_wiener(const YV12_BUFFER_CONFIG *src, AV1_COMP *cpi,
   int bits;
   double cost_wiener, cost_norestore;
   MACROBLOCK *x = &cpi->td.mb;
-  double M[WIENER_WIN2];
-  double H[WIENER_WIN2 * WIENER_WIN2];
-  double vfilterd[WIENER_WIN], hfilterd[WIENER_WIN];
   const YV12_BUFFER_CONFIG *dgd = cm->frame_to_show;
   const int width = cm->width;
   const int height = cm->height;
-  const int src_stride = src->y_stride;
   const int dgd_stride = dgd->y_stride;
-  double score;
   int tile_idx, tile_width, tile_height, nhtiles, nvtiles;
   int h_start, h_end, v_start, v_end;
   const int ntiles =
@@ -921,6 +988,8 @@ static double search_wiener(const YV12_BUFFER_CONFIG *src, AV1_COMP *cpi,
     extend_frame(dgd->y_buffer, width, height, dgd_stride);
 
   // Compute best Wiener filters for each tile
+  fit_restoration_tiles(src, cpi, RESTORE_WIENER, AOM_PLANE_Y, rsi, type,
+                        ntiles);
   for (tile_idx = 0; tile_idx < ntiles; ++tile_idx) {
     av1_get_rest_tile_limits(tile_idx, 0, 0, nhtiles, nvtiles, tile_width,
                              tile_height, width, height, 0, 0, &h_start, &h_end,
@@ -932,36 +1001,7 @@ static double search_wiener(const YV12_BUFFER_CONFIG *src, AV1_COMP *cpi,
     cost_norestore = RDCOST_DBL(x->rdmult, x->rddiv, (bits >> 4), err);
     best_tile_cost[tile_idx] = DBL_MAX;
 
-    av1_get_rest_tile_limits(tile_idx, 0, 0, nhtiles, nvtiles, tile_width,
-                             tile_height, width, height, 0, 0, &h_start, &h_end,
-                             &v_start, &v_end);
-#if CONFIG_AOM_HIGHBITDEPTH
-    if (cm->use_highbitdepth)
-      compute_stats_highbd(dgd->y_buffer, src->y_buffer, h_start, h_end,
-                           v_start, v_end, dgd_stride, src_stride, M, H);
-    else
-#endif  // CONFIG_AOM_HIGHBITDEPTH
-      compute_stats(dgd->y_buffer, src->y_buffer, h_start, h_end, v_start,
-                    v_end, dgd_stride, src_stride, M, H);
-
-    type[tile_idx] = RESTORE_WIENER;
-
-    if (!wiener_decompose_sep_sym(M, H, vfilterd, hfilterd)) {
-      type[tile_idx] = RESTORE_NONE;
-      continue;
-    }
-    quantize_sym_filter(vfilterd, rsi->wiener_info[tile_idx].vfilter);
-    quantize_sym_filter(hfilterd, rsi->wiener_info[tile_idx].hfilter);
-
-    // Filter score computes the value of the function x'*A*x - x'*b for the
-    // learned filter and compares it against identity filer. If there is no
-    // reduction in the function, the filter is reverted back to identity
-    score = compute_score(M, H, rsi->wiener_info[tile_idx].vfilter,
-                          rsi->wiener_info[tile_idx].hfilter);
-    if (score > 0.0) {
-      type[tile_idx] = RESTORE_NONE;
-      continue;
-    }
+    if (type[tile_idx] == RESTORE_NONE) continue;
 
     rsi->restoration_type[tile_idx] = RESTORE_WIENER;
     err = try_restoration_tile(src, cpi, rsi, 1, partial_frame, tile_idx, 0, 0,
@@ -20,6 +20,25 @@ extern "C" {
 struct yv12_buffer_config;
 struct AV1_COMP;
 
+// Filter fit of the restoration tiles of one plane. The tiles are fitted
+// independently of each other.
+typedef struct RestorationFitJob {
+  const YV12_BUFFER_CONFIG *src;
+  RestorationInfo *rsi;
+  // Set to RESTORE_NONE for the tiles whose fitted filter is rejected.
+  RestorationType *type;
+  // RESTORE_WIENER or RESTORE_SGRPROJ.
+  RestorationType rtype;
+  int plane;
+  int ntiles;
+} RestorationFitJob;
+
+// Fits the filter of one tile into job->rsi. tmpbuf must hold
+// RESTORATION_TMPBUF_SIZE bytes and not be shared with other threads.
+void av1_fit_restoration_tile(struct AV1_COMP *cpi,
+                              const RestorationFitJob *job, int tile_idx,
+                              int32_t *tmpbuf);
+
 void av1_pick_filter_restoration(const YV12_BUFFER_CONFIG *sd, AV1_COMP *cpi,
                                  LPF_PICK_METHOD method);
 
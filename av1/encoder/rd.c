@@ -165,12 +165,16 @@ static void fill_mode_costs(AV1_COMP *cpi) {
 }
 
 void av1_fill_token_costs(av1_coeff_cost *c,
+                          av1_coeff_probs_model (*cost_probs)[PLANE_TYPES],
                           av1_coeff_probs_model (*p)[PLANE_TYPES]) {
   int i, j, k, l;
   TX_SIZE t;
   for (t = 0; t < TX_SIZES; ++t)
     for (i = 0; i < PLANE_TYPES; ++i)
-      for (j = 0; j < REF_TYPES; ++j)
+      for (j = 0; j < REF_TYPES; ++j) {
+        if (!memcmp(cost_probs[t][i][j], p[t][i][j], sizeof(p[t][i][j])))
+          continue;
+        memcpy(cost_probs[t][i][j], p[t][i][j], sizeof(p[t][i][j]));
         for (k = 0; k < COEF_BANDS; ++k)
           for (l = 0; l < BAND_COEFF_CONTEXTS(k); ++l) {
             aom_prob probs[ENTROPY_NODES];
@@ -181,6 +185,7 @@ void av1_fill_token_costs(av1_coeff_cost *c,
             assert(c[t][i][j][k][0][l][EOB_TOKEN] ==
                    c[t][i][j][k][1][l][EOB_TOKEN]);
           }
+      }
 }
 
 // Values are now correlated to quantizer.
@@ -303,6 +308,16 @@ void av1_initialize_me_consts(const AV1_COMP *cpi, MACROBLOCK *x, int qindex) {
 #endif  // CONFIG_AOM_HIGHBITDEPTH
 }
 
+// Builds the MV cost tables from ctx, unless cost_ctx and cost_hp show they
+// were last built from the same probabilities and precision.
+static void fill_nmv_costs(int *mvjoint, int *mvcost[2], nmv_context *cost_ctx,
+                           int *cost_hp, const nmv_context *ctx, int usehp) {
+  if (*cost_hp == usehp && !memcmp(cost_ctx, ctx, sizeof(*ctx))) return;
+  av1_build_nmv_cost_table(mvjoint, mvcost, ctx, usehp);
+  memcpy(cost_ctx, ctx, sizeof(*ctx));
+  *cost_hp = usehp;
+}
+
 static void set_block_thresholds(const AV1_COMMON *cm, RD_OPT *rd) {
   int i, bsize, segment_id;
 
@@ -377,24 +392,26 @@ void av1_initialize_rd_consts(AV1_COMP *cpi) {
 
 #if CONFIG_REF_MV
   for (nmv_ctx = 0; nmv_ctx < NMV_CONTEXTS; ++nmv_ctx) {
-    av1_build_nmv_cost_table(
-        x->nmv_vec_cost[nmv_ctx],
-        cm->allow_high_precision_mv ? x->nmvcost_hp[nmv_ctx]
-                                    : x->nmvcost[nmv_ctx],
-        &cm->fc->nmvc[nmv_ctx], cm->allow_high_precision_mv);
+    fill_nmv_costs(x->nmv_vec_cost[nmv_ctx],
+                   cm->allow_high_precision_mv ? x->nmvcost_hp[nmv_ctx]
+                                               : x->nmvcost[nmv_ctx],
+                   &cpi->nmv_cost_ctx[nmv_ctx], &cpi->nmv_cost_hp[nmv_ctx],
+                   &cm->fc->nmvc[nmv_ctx], cm->allow_high_precision_mv);
   }
   x->mvcost = x->mv_cost_stack[0];
   x->nmvjointcost = x->nmv_vec_cost[0];
   x->mvsadcost = x->mvcost;
   x->nmvjointsadcost = x->nmvjointcost;
 #else
-  av1_build_nmv_cost_table(
+  fill_nmv_costs(
       x->nmvjointcost, cm->allow_high_precision_mv ? x->nmvcost_hp : x->nmvcost,
-      &cm->fc->nmvc, cm->allow_high_precision_mv);
+      &cpi->nmv_cost_ctx, &cpi->nmv_cost_hp, &cm->fc->nmvc,
+      cm->allow_high_precision_mv);
 #endif
 
   if (cpi->oxcf.pass != 1) {
-    av1_fill_token_costs(x->token_costs, cm->fc->coef_probs);
+    av1_fill_token_costs(cpi->token_costs, cpi->token_cost_probs,
+                         cm->fc->coef_probs);
 
     if (cpi->sf.partition_search_type != VAR_BASED_PARTITION ||
         cm->frame_type == KEY_FRAME) {
@@ -416,7 +416,10 @@ void av1_update_rd_thresh_fact(const AV1_COMMON *const cm,
                                int (*fact)[MAX_MODES], int rd_thresh, int bsize,
                                int best_mode_index);
 
+// Rebuilds the token costs in c for the groups of p that differ from
+// cost_probs, the probabilities c was last built from, and updates cost_probs.
 void av1_fill_token_costs(av1_coeff_cost *c,
+                          av1_coeff_probs_model (*cost_probs)[PLANE_TYPES],
                           av1_coeff_probs_model (*p)[PLANE_TYPES]);
 
 static INLINE int rd_less_than_thresh(int64_t best_rd, int thresh,
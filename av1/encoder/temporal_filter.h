@@ -12,11 +12,33 @@
 #ifndef AV1_ENCODER_TEMPORAL_FILTER_H_
 #define AV1_ENCODER_TEMPORAL_FILTER_H_
 
+#include "av1/common/scale.h"
+#include "av1/encoder/lookahead.h"
+#include "aom_scale/yv12config.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-void av1_temporal_filter(AV1_COMP *cpi, int distance);
+struct AV1_COMP;
+struct ThreadData;
+
+// Parameters of the ARNR filter of the current alt-ref frame, shared by the
+// threads filtering its macroblock rows.
+typedef struct {
+  YV12_BUFFER_CONFIG *frames[MAX_LAG_BUFFERS];
+  int frame_count;
+  int alt_ref_index;
+  int strength;
+  struct scale_factors sf;
+} ARNRFilterData;
+
+void av1_temporal_filter(struct AV1_COMP *cpi, int distance);
+
+// Filters one macroblock row of cpi->arnr_filter_data into
+// cpi->alt_ref_buffer.
+void av1_temporal_filter_iterate_row_c(struct AV1_COMP *cpi,
+                                       struct ThreadData *td, int mb_row);
 
 #ifdef __cplusplus
 }  // extern "C"
@@ -563,6 +563,7 @@ static void tokenize_b(int plane, int block, int blk_row, int blk_col,
   int16_t token;
   EXTRABIT extra;
   (void)plane_bsize;
+  ++td->counts->coef_blocks[txsize_sqr_map[tx_size]][type][ref];
   pt = get_entropy_context(tx_size, pd->above_context + blk_col,
                            pd->left_context + blk_row);
   scan = scan_order->scan;
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <smmintrin.h>
+#include <string.h>
+
+#include "./av1_rtcd.h"
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_ports/mem.h"
+
+#define TF_MAX_BLOCK 16
+// The squared differences are stored with a zero border of one pixel. The
+// first pixel of a row is at column 4 to keep the centre loads aligned.
+#define TF_SSE_STRIDE (TF_MAX_BLOCK + 8)
+#define TF_SSE_OFFSET 4
+
+// Returns floor(3 * sum / index) for index 4, 6 or 9, which is the number of
+// pixels in the 3x3 neighbourhood that lie inside the block.
+static INLINE __m128i scale_sse_sum(__m128i sum, __m128i index) {
+  const __m128i div3 = _mm_set1_epi32((int)0xAAAAAAAB);
+  // floor(sum / 3) using a 32x32->64 bit multiply by ceil(2^33 / 3).
+  const __m128i even = _mm_srli_epi64(_mm_mul_epu32(sum, div3), 33);
+  const __m128i odd =
+      _mm_srli_epi64(_mm_mul_epu32(_mm_srli_epi64(sum, 32), div3), 33);
+  const __m128i by9 = _mm_blend_epi16(even, _mm_slli_epi64(odd, 32), 0xcc);
+  const __m128i by6 = _mm_srli_epi32(sum, 1);
+  const __m128i by4 =
+      _mm_srli_epi32(_mm_add_epi32(sum, _mm_add_epi32(sum, sum)), 2);
+  const __m128i is9 = _mm_cmpeq_epi32(index, _mm_set1_epi32(9));
+  const __m128i is6 = _mm_cmpeq_epi32(index, _mm_set1_epi32(6));
+  return _mm_blendv_epi8(_mm_blendv_epi8(by4, by6, is6), by9, is9);
+}
+
+void av1_highbd_temporal_filter_apply_sse4_1(
+    uint8_t *frame1_8, unsigned int stride, uint8_t *frame2_8,
+    unsigned int block_width, unsigned int block_height, int strength,
+    int filter_weight, unsigned int *accumulator, uint16_t *count) {
+  const uint16_t *const frame1 = CONVERT_TO_SHORTPTR(frame1_8);
+  const uint16_t *const frame2 = CONVERT_TO_SHORTPTR(frame2_8);
+  DECLARE_ALIGNED(16, uint32_t, sse[(TF_MAX_BLOCK + 2) * TF_SSE_STRIDE]);
+  const __m128i rounding =
+      _mm_set1_epi32(strength > 0 ? 1 << (strength - 1) : 0);
+  const __m128i shift = _mm_cvtsi32_si128(strength);
+  const __m128i sixteen = _mm_set1_epi32(16);
+  const __m128i weight = _mm_set1_epi32(filter_weight);
+  unsigned int i, j;
+
+  if ((block_width & 3) || block_width > TF_MAX_BLOCK ||
+      block_height > TF_MAX_BLOCK || block_width < 2 || block_height < 2) {
+    av1_highbd_temporal_filter_apply_c(frame1_8, stride, frame2_8, block_width,
+                                       block_height, strength, filter_weight,
+                                       accumulator, count);
+    return;
+  }
+
+  memset(sse, 0, sizeof(sse));
+
+  for (i = 0; i < block_height; ++i) {
+    uint32_t *const sse_row = sse + (i + 1) * TF_SSE_STRIDE + TF_SSE_OFFSET;
+    for (j = 0; j < block_width; j += 4) {
+      const __m128i a = _mm_cvtepu16_epi32(
+          _mm_loadl_epi64((const __m128i *)(frame1 + i * stride + j)));
+      const __m128i b = _mm_cvtepu16_epi32(
+          _mm_loadl_epi64((const __m128i *)(frame2 + i * block_width + j)));
+      const __m128i diff = _mm_sub_epi32(a, b);
+      _mm_store_si128((__m128i *)(sse_row + j), _mm_mullo_epi32(diff, diff));
+    }
+  }
+
+  for (i = 0; i < block_height; ++i) {
+    const uint32_t *const above = sse + i * TF_SSE_STRIDE + TF_SSE_OFFSET;
+    const uint32_t *const cur = above + TF_SSE_STRIDE;
+    const uint32_t *const below = cur + TF_SSE_STRIDE;
+    const int rows = 1 + (i > 0) + (i < block_height - 1);
+
+    for (j = 0; j < block_width; j += 4) {
+      const unsigned int k = i * block_width + j;
+      const __m128i cols =
+          _mm_set_epi32(2 + (j + 3 < block_width - 1), 3, 3, 2 + (j > 0));
+      const __m128i index = _mm_mullo_epi32(cols, _mm_set1_epi32(rows));
+      __m128i sum = _mm_add_epi32(
+          _mm_add_epi32(_mm_loadu_si128((const __m128i *)(above + j - 1)),
+                        _mm_load_si128((const __m128i *)(above + j))),
+          _mm_loadu_si128((const __m128i *)(above + j + 1)));
+      __m128i modifier, pixel, cnt;
+
+      sum = _mm_add_epi32(
+          sum,
+          _mm_add_epi32(_mm_loadu_si128((const __m128i *)(cur + j - 1)),
+                        _mm_load_si128((const __m128i *)(cur + j))));
+      sum = _mm_add_epi32(
+          sum,
+          _mm_add_epi32(_mm_loadu_si128((const __m128i *)(cur + j + 1)),
+                        _mm_loadu_si128((const __m128i *)(below + j - 1))));
+      sum = _mm_add_epi32(
+          sum,
+          _mm_add_epi32(_mm_load_si128((const __m128i *)(below + j)),
+                        _mm_loadu_si128((const __m128i *)(below + j + 1))));
+
+      modifier = scale_sse_sum(sum, index);
+      modifier = _mm_srl_epi32(_mm_add_epi32(modifier, rounding), shift);
+      modifier = _mm_min_epu32(modifier, sixteen);
+      modifier = _mm_mullo_epi32(_mm_sub_epi32(sixteen, modifier), weight);
+
+      cnt = _mm_loadl_epi64((const __m128i *)(count + k));
+      cnt = _mm_add_epi16(cnt, _mm_packus_epi32(modifier, modifier));
+      _mm_storel_epi64((__m128i *)(count + k), cnt);
+
+      pixel = _mm_cvtepu16_epi32(
+          _mm_loadl_epi64((const __m128i *)(frame2 + k)));
+      _mm_storeu_si128(
+          (__m128i *)(accumulator + k),
+          _mm_add_epi32(_mm_loadu_si128((const __m128i *)(accumulator + k)),
+                        _mm_mullo_epi32(modifier, pixel)));
+    }
+  }
+}
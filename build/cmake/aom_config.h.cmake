@@ -109,6 +109,7 @@
 #define CONFIG_NEW_QUANT ${CONFIG_NEW_QUANT}
 #define CONFIG_SUPERTX ${CONFIG_SUPERTX}
 #define CONFIG_ANS ${CONFIG_ANS}
+#define ANS_NUM_STATES ${ANS_NUM_STATES}
 #define CONFIG_EC_MULTISYMBOL ${CONFIG_EC_MULTISYMBOL}
 #define CONFIG_NEW_TOKENSET ${CONFIG_NEW_TOKENSET}
 #define CONFIG_LOOP_RESTORATION ${CONFIG_LOOP_RESTORATION}
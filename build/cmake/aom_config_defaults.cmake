@@ -109,6 +109,7 @@ set(CONFIG_GLOBAL_MOTION 0 CACHE BOOL "Internal flag.")
 set(CONFIG_NEW_QUANT 0 CACHE BOOL "Internal flag.")
 set(CONFIG_SUPERTX 0 CACHE BOOL "Internal flag.")
 set(CONFIG_ANS 0 CACHE BOOL "Internal flag.")
+set(ANS_NUM_STATES 1 CACHE STRING "Number of interleaved ANS states.")
 set(CONFIG_EC_MULTISYMBOL 1 CACHE BOOL "Internal flag.")
 set(CONFIG_NEW_TOKENSET 0 CACHE BOOL "Internal flag.")
 set(CONFIG_LOOP_RESTORATION 0 CACHE BOOL "Internal flag.")
@@ -575,12 +575,17 @@ process_common_cmdline() {
       --size-limit=*)
         w="${optval%%x*}"
         h="${optval##*x}"
-        VAR_LIST="DECODE_WIDTH_LIMIT ${w} DECODE_HEIGHT_LIMIT ${h}"
+        VAR_LIST="${VAR_LIST} DECODE_WIDTH_LIMIT ${w} DECODE_HEIGHT_LIMIT ${h}"
         [ ${w} -gt 0 ] && [ ${h} -gt 0 ] || die "Invalid size-limit: too small."
         [ ${w} -lt 65536 ] && [ ${h} -lt 65536 ] \
             || die "Invalid size-limit: too big."
         enable_feature size_limit
         ;;
+      --ans-num-states=*)
+        [ "${optval}" -ge 1 ] 2>/dev/null && [ "${optval}" -le 8 ] \
+            || die "Invalid ans-num-states: must be 1 to 8."
+        VAR_LIST="${VAR_LIST} ANS_NUM_STATES ${optval}"
+        ;;
       --prefix=*)
         prefix="${optval}"
         ;;
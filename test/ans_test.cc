@@ -28,6 +28,8 @@ typedef std::vector<std::pair<uint8_t, bool> > PvVec;
 const int kPrintStats = 0;
 // Use a small buffer size to exercise ANS window spills or buffer growth
 const int kBufAnsSize = 1 << 8;
+// Each window ends with up to 4 bytes for every interleaved state.
+const int kMaxStateBytes = 4 * ANS_NUM_STATES;
 
 PvVec abs_encode_build_vals(int iters) {
   PvVec ret;
@@ -162,7 +164,10 @@ bool check_rans(const std::vector<int> &sym_vec, const rans_sym *const tab,
 class AbsTestFix : public ::testing::Test {
  protected:
   static void SetUpTestCase() { pv_vec_ = abs_encode_build_vals(kNumBools); }
-  virtual void SetUp() { buf_ = new uint8_t[kNumBools / 8]; }
+  virtual void SetUp() {
+    buf_ = new uint8_t[kNumBools / 8 +
+                       (kNumBools / kBufAnsSize + 1) * kMaxStateBytes];
+  }
   virtual void TearDown() { delete[] buf_; }
   static const int kNumBools = 100000000;
   static PvVec pv_vec_;
@@ -175,7 +180,10 @@ class AnsTestFix : public ::testing::Test {
   static void SetUpTestCase() {
     sym_vec_ = ans_encode_build_vals(rans_sym_tab_, kNumSyms);
   }
-  virtual void SetUp() { buf_ = new uint8_t[kNumSyms / 2]; }
+  virtual void SetUp() {
+    buf_ = new uint8_t[kNumSyms / 2 +
+                       (kNumSyms / kBufAnsSize + 1) * kMaxStateBytes];
+  }
   virtual void TearDown() { delete[] buf_; }
   static const int kNumSyms = 25000000;
   static std::vector<int> sym_vec_;
@@ -189,11 +197,30 @@ TEST_F(AbsTestFix, Rabs) { EXPECT_TRUE(check_rabs(pv_vec_, buf_)); }
 TEST_F(AnsTestFix, Rans) {
   EXPECT_TRUE(check_rans(sym_vec_, rans_sym_tab_, buf_));
 }
+// The interleaved states that code no symbol of the last window must not be
+// mistaken for an unfinished stream.
+TEST(AnsTest, FewerSymbolsThanStates) {
+  const PvVec pv_vec = abs_encode_build_vals(kBufAnsSize + ANS_NUM_STATES);
+  std::vector<uint8_t> buf(2 * kBufAnsSize + 2 * kMaxStateBytes);
+  for (int windows = 0; windows < 2; ++windows) {
+    for (int tail = 1; tail <= ANS_NUM_STATES; ++tail) {
+      const int num_bools = windows * kBufAnsSize + tail;
+      const PvVec head(pv_vec.begin(), pv_vec.begin() + num_bools);
+      EXPECT_TRUE(check_rabs(head, &buf[0])) << num_bools << " bools";
+    }
+  }
+}
 TEST(AnsTest, FinalStateSerialization) {
   for (unsigned i = L_BASE; i < L_BASE * IO_BASE; ++i) {
-    uint8_t buf[8];
+    uint8_t buf[kMaxStateBytes + 4];
     AnsCoder c;
     ans_write_init(&c, buf);
+#if ANS_NUM_STATES > 1
+    // The other interleaved states precede the first one in the output.
+    for (int s = 1; s < ANS_NUM_STATES; ++s) {
+      c.buf_offset += ans_write_state(c.buf + c.buf_offset, i);
+    }
+#endif
     c.state = i;
     const int written_size = ans_write_end(&c);
     ASSERT_LT(static_cast<size_t>(written_size), sizeof(buf));
@@ -206,6 +233,11 @@ TEST(AnsTest, FinalStateSerialization) {
     const int read_init_status = ans_read_init(&d, buf, written_size);
     EXPECT_EQ(read_init_status, 0);
     EXPECT_EQ(d.state, i);
+#if ANS_NUM_STATES > 1
+    for (int s = 0; s < ANS_NUM_STATES - 1; ++s) {
+      EXPECT_EQ(d.next_states[s], i);
+    }
+#endif
   }
 }
 }  // namespace
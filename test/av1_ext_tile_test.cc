@@ -10,9 +10,11 @@
  */
 
 #include <assert.h>
+#include <algorithm>
 #include <string>
 #include <vector>
 #include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "./aom_config.h"
 #include "test/codec_factory.h"
 #include "test/encode_test_driver.h"
 #include "test/i420_video_source.h"
@@ -194,4 +196,148 @@ AV1_INSTANTIATE_TEST_CASE(
     // Now only test 2-pass mode.
     AV1ExtTileTest, ::testing::Values(::libaom_test::kTwoPassGood),
     ::testing::Range(0, 4));
+
+#if !CONFIG_GLOBAL_MOTION && !CONFIG_WARPED_MOTION
+// Rectangle of tiles to decode, as tile column, row, columns and rows.
+const unsigned int kRectX = 2;
+const unsigned int kRectY = 1;
+const unsigned int kRectW = 3;
+const unsigned int kRectH = 2;
+
+// Frames whose samples outside the rectangle of tiles replicate its edges, as
+// the rectangle decoder does when motion vectors point outside of it.
+class RectVideoSource : public ::libaom_test::I420VideoSource {
+ public:
+  RectVideoSource(const std::string &file_name, unsigned int width,
+                  unsigned int height, int rate_numerator,
+                  int rate_denominator, unsigned int start, int limit)
+      : I420VideoSource(file_name, width, height, rate_numerator,
+                        rate_denominator, start, limit) {}
+
+  virtual void FillFrame() {
+    I420VideoSource::FillFrame();
+    for (int plane = 0; plane < 3; ++plane) {
+      const int shift = (plane == 0) ? 0 : 1;
+      const int x0 = (kRectX * kTIleSizeInPixels) >> shift;
+      const int y0 = (kRectY * kTIleSizeInPixels) >> shift;
+      const int x1 = x0 + ((kRectW * kTIleSizeInPixels) >> shift) - 1;
+      const int y1 = y0 + ((kRectH * kTIleSizeInPixels) >> shift) - 1;
+      const int w = static_cast<int>(img_->d_w) >> shift;
+      const int h = static_cast<int>(img_->d_h) >> shift;
+      const int stride = img_->stride[plane];
+      uint8_t *const buf = img_->planes[plane];
+      for (int r = 0; r < h; ++r) {
+        const int src_r = std::min(std::max(r, y0), y1);
+        for (int c = 0; c < w; ++c) {
+          const int src_c = std::min(std::max(c, x0), x1);
+          buf[r * stride + c] = buf[src_r * stride + src_c];
+        }
+      }
+    }
+  }
+};
+
+class AV1ExtTileRectTest : public ::libaom_test::EncoderTest,
+                           public ::libaom_test::CodecTestWithParam<int> {
+ protected:
+  AV1ExtTileRectTest()
+      : EncoderTest(GET_PARAM(0)), frames_match_(true), sizes_ok_(true),
+        n_frames_(0), n_threads_(GET_PARAM(1)) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.w = kImgWidth;
+    cfg.h = kImgHeight;
+    cfg.threads = n_threads_;
+    frame_dec_ = codec_->CreateDecoder(cfg, 0);
+    frame_dec_->Control(AV1_SET_DECODE_TILE_ROW, -1);
+    frame_dec_->Control(AV1_SET_DECODE_TILE_COL, -1);
+    rect_dec_ = codec_->CreateDecoder(cfg, 0);
+    aom_image_rect_t rect = { kRectX, kRectY, kRectW, kRectH };
+    rect_dec_->Control(AV1_SET_DECODE_TILE_RECT, &rect);
+  }
+
+  virtual ~AV1ExtTileRectTest() {
+    delete frame_dec_;
+    delete rect_dec_;
+  }
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kTwoPassGood);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_end_usage = AOM_VBR;
+    cfg_.g_error_resilient = 1;
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(AOME_SET_CPUUSED, 2);
+      // The reference frames outside the rectangle only replicate its edges
+      // if they are reconstructed exactly.
+      encoder->Control(AV1E_SET_LOSSLESS, 1);
+      encoder->Control(AV1E_SET_TILE_COLUMNS, kTileSize);
+      encoder->Control(AV1E_SET_TILE_ROWS, kTileSize);
+#if CONFIG_EXT_PARTITION
+      encoder->Control(AV1E_SET_SUPERBLOCK_SIZE, AOM_SUPERBLOCK_SIZE_64X64);
+#endif
+    }
+  }
+
+  const aom_image_t *DecodeFrame(::libaom_test::Decoder *dec,
+                                 const aom_codec_cx_pkt_t *pkt) {
+    const aom_codec_err_t res = dec->DecodeFrame(
+        reinterpret_cast<uint8_t *>(pkt->data.frame.buf), pkt->data.frame.sz);
+    EXPECT_EQ(AOM_CODEC_OK, res);
+    return dec->GetDxData().Next();
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    const aom_image_t *const frame = DecodeFrame(frame_dec_, pkt);
+    const aom_image_t *const rect = DecodeFrame(rect_dec_, pkt);
+    ASSERT_TRUE(frame != NULL && rect != NULL);
+    if (rect->d_w != kRectW * kTIleSizeInPixels ||
+        rect->d_h != kRectH * kTIleSizeInPixels)
+      sizes_ok_ = false;
+    ++n_frames_;
+
+    const int bytes = (rect->fmt & AOM_IMG_FMT_HIGHBITDEPTH) ? 2 : 1;
+    for (int plane = 0; plane < 3; ++plane) {
+      const int shift = (plane == 0) ? 0 : 1;
+      const int x = ((kRectX * kTIleSizeInPixels) >> shift) * bytes;
+      const int y = (kRectY * kTIleSizeInPixels) >> shift;
+      const int w = (rect->d_w >> shift) * bytes;
+      const int h = rect->d_h >> shift;
+      for (int r = 0; r < h; ++r) {
+        if (memcmp(frame->planes[plane] + frame->stride[plane] * (y + r) + x,
+                   rect->planes[plane] + rect->stride[plane] * r, w))
+          frames_match_ = false;
+      }
+    }
+  }
+
+  ::libaom_test::Decoder *frame_dec_, *rect_dec_;
+  bool frames_match_;
+  bool sizes_ok_;
+  int n_frames_;
+
+ private:
+  int n_threads_;
+};
+
+// Decoding a rectangle of tiles must output the rectangle, identical to the
+// frames decoded whole when the samples the inter frames predict from outside
+// of the rectangle replicate its edges.
+TEST_P(AV1ExtTileRectTest, FrameMatch) {
+  RectVideoSource video("hantro_collage_w352h288.yuv", kImgWidth, kImgHeight,
+                        30, 1, 0, kLimit);
+  cfg_.rc_target_bitrate = 500;
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+
+  EXPECT_GT(n_frames_, 1);
+  EXPECT_TRUE(sizes_ok_);
+  EXPECT_TRUE(frames_match_);
+}
+
+AV1_INSTANTIATE_TEST_CASE(AV1ExtTileRectTest, ::testing::Values(1, 4));
+#endif  // !CONFIG_GLOBAL_MOTION && !CONFIG_WARPED_MOTION
 }  // namespace
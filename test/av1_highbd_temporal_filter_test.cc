@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+#include "./aom_config.h"
+#include "./av1_rtcd.h"
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/register_state_check.h"
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_ports/mem.h"
+
+namespace {
+
+typedef void (*TemporalFilterFunc)(uint8_t *frame1, unsigned int stride,
+                                   uint8_t *frame2, unsigned int block_width,
+                                   unsigned int block_height, int strength,
+                                   int filter_weight,
+                                   unsigned int *accumulator, uint16_t *count);
+
+using libaom_test::ACMRandom;
+
+const int kNumTests = 10000;
+const int kStride = 48;
+
+class AV1HighbdTemporalFilterTest
+    : public ::testing::TestWithParam<TemporalFilterFunc> {
+ public:
+  virtual void SetUp() { func_ = GetParam(); }
+
+  virtual void TearDown() { libaom_test::ClearSystemState(); }
+
+  virtual ~AV1HighbdTemporalFilterTest() {}
+
+ protected:
+  void RunCheckOutput() {
+    ACMRandom rnd(ACMRandom::DeterministicSeed());
+    DECLARE_ALIGNED(16, uint16_t, frame1[16 * kStride]);
+    DECLARE_ALIGNED(16, uint16_t, frame2[16 * 16]);
+    DECLARE_ALIGNED(16, unsigned int, ref_accumulator[16 * 16]);
+    DECLARE_ALIGNED(16, unsigned int, accumulator[16 * 16]);
+    DECLARE_ALIGNED(16, uint16_t, ref_count[16 * 16]);
+    DECLARE_ALIGNED(16, uint16_t, count[16 * 16]);
+
+    for (int i = 0; i < kNumTests; ++i) {
+      const int bd = 8 + 2 * rnd(3);
+      const int mask = (1 << bd) - 1;
+      const unsigned int block_width = rnd(2) ? 16 : 8;
+      const unsigned int block_height = rnd(2) ? 16 : 8;
+      const int strength = rnd(7) + 2 * (bd - 8);
+      const int filter_weight = rnd(3);
+      // Mix close matches with unrelated blocks to cover the whole range of
+      // the filter modifier.
+      const int noise = rnd(2) ? 8 : mask + 1;
+
+      for (int j = 0; j < 16 * kStride; ++j) frame1[j] = rnd.Rand16() & mask;
+      for (unsigned int r = 0; r < block_height; ++r) {
+        for (unsigned int c = 0; c < block_width; ++c) {
+          frame2[r * block_width + c] =
+              (frame1[r * kStride + c] + rnd(noise)) & mask;
+        }
+      }
+      for (int j = 0; j < 16 * 16; ++j) {
+        ref_accumulator[j] = accumulator[j] = rnd.Rand16();
+        ref_count[j] = count[j] = rnd.Rand8();
+      }
+
+      av1_highbd_temporal_filter_apply_c(
+          CONVERT_TO_BYTEPTR(frame1), kStride, CONVERT_TO_BYTEPTR(frame2),
+          block_width, block_height, strength, filter_weight, ref_accumulator,
+          ref_count);
+      ASM_REGISTER_STATE_CHECK(func_(
+          CONVERT_TO_BYTEPTR(frame1), kStride, CONVERT_TO_BYTEPTR(frame2),
+          block_width, block_height, strength, filter_weight, accumulator,
+          count));
+
+      for (int j = 0; j < 16 * 16; ++j) {
+        ASSERT_EQ(ref_accumulator[j], accumulator[j])
+            << "accumulator mismatch: i = " << i << " j = " << j;
+        ASSERT_EQ(ref_count[j], count[j])
+            << "count mismatch: i = " << i << " j = " << j;
+      }
+    }
+  }
+
+  TemporalFilterFunc func_;
+};
+
+TEST_P(AV1HighbdTemporalFilterTest, CheckOutput) { RunCheckOutput(); }
+
+#if HAVE_SSE4_1
+INSTANTIATE_TEST_CASE_P(
+    SSE4_1, AV1HighbdTemporalFilterTest,
+    ::testing::Values(&av1_highbd_temporal_filter_apply_sse4_1));
+#endif  // HAVE_SSE4_1
+}  // namespace
@@ -13,12 +13,15 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <vector>
+
 #include "third_party/googletest/src/googletest/include/gtest/gtest.h"
 
 #include "test/acm_random.h"
 #include "aom/aom_integer.h"
 #include "aom_dsp/bitreader.h"
 #include "aom_dsp/bitwriter.h"
+#include "aom_ports/aom_timer.h"
 
 using libaom_test::ACMRandom;
 
@@ -141,3 +144,84 @@ TEST(AV1, TestTell) {
         << " frac_diff_total: " << frac_diff_total;
   }
 }
+
+#if CONFIG_EC_MULTISYMBOL
+namespace {
+// Fills cdf with a random Q15 CDF over nsyms symbols, each of which has a
+// non-zero probability.
+void GenerateCdf(ACMRandom *rnd, aom_cdf_prob *cdf, int nsyms) {
+  const int step = 32768 / nsyms;
+  for (int i = 0; i < nsyms - 1; ++i) {
+    cdf[i] = (i + 1) * step - rnd->Rand16() % (step / 2);
+  }
+  cdf[nsyms - 1] = 32768;
+}
+
+// Writes num_symbols random symbols coded with cdf to buffer and returns the
+// number of bytes written.
+int WriteSymbols(const aom_cdf_prob *cdf, int nsyms, int num_symbols,
+                 int seed, uint8_t *buffer) {
+  ACMRandom rnd(seed);
+  aom_writer bw;
+  aom_start_encode(&bw, buffer);
+  for (int i = 0; i < num_symbols; ++i) {
+    aom_write_cdf(&bw, rnd(nsyms), cdf, nsyms);
+  }
+  aom_stop_encode(&bw);
+  return bw.pos;
+}
+}  // namespace
+
+TEST(AV1, TestSymbolIO) {
+  const int kSymbolsToTest = 1000;
+  const int kBufferSize = 10000;
+  const int random_seed = 6432;
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  uint8_t bw_buffer[kBufferSize];
+  aom_cdf_prob cdf[16];
+  for (int n = 0; n < num_tests; ++n) {
+    for (int nsyms = 2; nsyms <= 16; ++nsyms) {
+      GenerateCdf(&rnd, cdf, nsyms);
+      const int size =
+          WriteSymbols(cdf, nsyms, kSymbolsToTest, random_seed, bw_buffer);
+      aom_reader br;
+      aom_reader_init(&br, bw_buffer, size, NULL, NULL);
+      ACMRandom symb_rnd(random_seed);
+      for (int i = 0; i < kSymbolsToTest; ++i) {
+        GTEST_ASSERT_EQ(aom_read_cdf(&br, cdf, nsyms, NULL), symb_rnd(nsyms))
+            << "pos: " << i << " / " << kSymbolsToTest << " nsyms: " << nsyms;
+      }
+    }
+  }
+}
+
+TEST(AV1, DISABLED_SymbolReadSpeed) {
+  const int kSymbols = 1 << 16;
+  const int kRuns = 100;
+  const int random_seed = 6432;
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  std::vector<uint8_t> bw_buffer(kSymbols * 2);
+  aom_cdf_prob cdf[16];
+  for (int nsyms = 2; nsyms <= 16; nsyms *= 2) {
+    GenerateCdf(&rnd, cdf, nsyms);
+    const int size =
+        WriteSymbols(cdf, nsyms, kSymbols, random_seed, &bw_buffer[0]);
+    int sum = 0;
+    aom_usec_timer timer;
+    aom_usec_timer_start(&timer);
+    for (int run = 0; run < kRuns; ++run) {
+      aom_reader br;
+      aom_reader_init(&br, &bw_buffer[0], size, NULL, NULL);
+      for (int i = 0; i < kSymbols; ++i) {
+        sum += aom_read_cdf(&br, cdf, nsyms, NULL);
+      }
+    }
+    aom_usec_timer_mark(&timer);
+    const int elapsed_time =
+        static_cast<int>(aom_usec_timer_elapsed(&timer) / 1000);
+    printf("nsyms %2d: %5d ms (%d Msymbols/s)\n", nsyms, elapsed_time,
+           elapsed_time ? kSymbols / 1000 * kRuns / elapsed_time : 0);
+    EXPECT_GT(sum, 0);
+  }
+}
+#endif  // CONFIG_EC_MULTISYMBOL
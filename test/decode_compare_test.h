@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2017, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#ifndef TEST_DECODE_COMPARE_TEST_H_
+#define TEST_DECODE_COMPARE_TEST_H_
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
+#include "test/md5_helper.h"
+
+namespace libaom_test {
+
+// Encodes a short clip and decodes every frame with two decoders, the second
+// one with a decoder control set, so that a test can check the control does
+// not change the output.
+class DecodeCompareTest : public EncoderTest {
+ protected:
+  DecodeCompareTest(const CodecFactory *codec, int threads, int ctrl_id,
+                    int ctrl_arg)
+      : EncoderTest(codec), md5_(), ctrl_md5_() {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.w = 352;
+    cfg.h = 288;
+    cfg.threads = threads;
+    dec_ = codec_->CreateDecoder(cfg, 0);
+    ctrl_dec_ = codec_->CreateDecoder(cfg, 0);
+    ctrl_dec_->Control(ctrl_id, ctrl_arg);
+#if CONFIG_AV1 && CONFIG_EXT_TILE
+    dec_->Control(AV1_SET_DECODE_TILE_ROW, -1);
+    dec_->Control(AV1_SET_DECODE_TILE_COL, -1);
+    ctrl_dec_->Control(AV1_SET_DECODE_TILE_ROW, -1);
+    ctrl_dec_->Control(AV1_SET_DECODE_TILE_COL, -1);
+#endif
+  }
+
+  virtual ~DecodeCompareTest() {
+    delete dec_;
+    delete ctrl_dec_;
+  }
+
+  virtual void PreEncodeFrameHook(VideoSource *video, Encoder *encoder) {
+    if (video->frame() == 1) encoder->Control(AOME_SET_CPUUSED, 3);
+  }
+
+  void DecodeFrame(Decoder *dec, MD5 *md5, const aom_codec_cx_pkt_t *pkt) {
+    const aom_codec_err_t res = dec->DecodeFrame(
+        reinterpret_cast<uint8_t *>(pkt->data.frame.buf), pkt->data.frame.sz);
+    ASSERT_EQ(AOM_CODEC_OK, res);
+    DxDataIterator frames = dec->GetDxData();
+    for (const aom_image_t *img = frames.Next(); img; img = frames.Next())
+      md5->Add(img);
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    ASSERT_NO_FATAL_FAILURE(DecodeFrame(dec_, &md5_, pkt));
+    ASSERT_NO_FATAL_FAILURE(DecodeFrame(ctrl_dec_, &ctrl_md5_, pkt));
+  }
+
+  // Encodes 10 frames and checks that both decoders output the same frames.
+  void RunAndCompare() {
+    InitializeConfig();
+    SetMode(kTwoPassGood);
+    const aom_rational timebase = { 33333333, 1000000000 };
+    cfg_.g_timebase = timebase;
+    cfg_.rc_target_bitrate = 500;
+    cfg_.g_lag_in_frames = 12;
+    cfg_.rc_end_usage = AOM_VBR;
+
+    I420VideoSource video("hantro_collage_w352h288.yuv", 352, 288,
+                          timebase.den, timebase.num, 0, 10);
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    ASSERT_STREQ(md5_.Get(), ctrl_md5_.Get());
+  }
+
+  MD5 md5_, ctrl_md5_;
+  Decoder *dec_, *ctrl_dec_;
+};
+
+}  // namespace libaom_test
+
+#endif  // TEST_DECODE_COMPARE_TEST_H_
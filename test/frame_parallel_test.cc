@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2017, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+*/
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+
+namespace {
+class FrameParallelTest : public ::libaom_test::EncoderTest,
+                          public ::libaom_test::CodecTestWithParam<int> {
+ protected:
+  FrameParallelTest()
+      : EncoderTest(GET_PARAM(0)), md5_serial_(), md5_parallel_(),
+        n_serial_frames_(0), n_parallel_frames_(0) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.w = 352;
+    cfg.h = 288;
+    serial_dec_ = codec_->CreateDecoder(cfg, 0);
+    cfg.threads = GET_PARAM(1);
+    parallel_dec_ =
+        codec_->CreateDecoder(cfg, AOM_CODEC_USE_FRAME_THREADING, 0);
+#if CONFIG_AV1 && CONFIG_EXT_TILE
+    serial_dec_->Control(AV1_SET_DECODE_TILE_ROW, -1);
+    serial_dec_->Control(AV1_SET_DECODE_TILE_COL, -1);
+    parallel_dec_->Control(AV1_SET_DECODE_TILE_ROW, -1);
+    parallel_dec_->Control(AV1_SET_DECODE_TILE_COL, -1);
+#endif
+  }
+
+  virtual ~FrameParallelTest() {
+    delete serial_dec_;
+    delete parallel_dec_;
+  }
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kTwoPassGood);
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0)
+      encoder->Control(AV1E_SET_FRAME_PARALLEL_DECODING, 1);
+    if (video->frame() == 1) encoder->Control(AOME_SET_CPUUSED, 3);
+  }
+
+  // Decodes a frame, or flushes the decoder if pkt is NULL, and hashes the
+  // frames output. Returns the number of frames output.
+  int DecodeFrame(::libaom_test::Decoder *dec, ::libaom_test::MD5 *md5,
+                  int *n_frames, const aom_codec_cx_pkt_t *pkt) {
+    const aom_codec_err_t res =
+        pkt ? dec->DecodeFrame(
+                  reinterpret_cast<uint8_t *>(pkt->data.frame.buf),
+                  pkt->data.frame.sz)
+            : dec->DecodeFrame(NULL, 0);
+    EXPECT_EQ(AOM_CODEC_OK, res);
+    const int n_frames_start = *n_frames;
+    ::libaom_test::DxDataIterator frames = dec->GetDxData();
+    for (const aom_image_t *img = frames.Next(); img; img = frames.Next()) {
+      md5->Add(img);
+      ++*n_frames;
+    }
+    return *n_frames - n_frames_start;
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    DecodeFrame(serial_dec_, &md5_serial_, &n_serial_frames_, pkt);
+    DecodeFrame(parallel_dec_, &md5_parallel_, &n_parallel_frames_, pkt);
+  }
+
+  ::libaom_test::MD5 md5_serial_, md5_parallel_;
+  int n_serial_frames_, n_parallel_frames_;
+  ::libaom_test::Decoder *serial_dec_, *parallel_dec_;
+};
+
+// Frame parallel decoding must output the same frames as serial decoding,
+// including when there are more frame threads than frames in flight, up to
+// the limit of MAX_DECODE_THREADS.
+TEST_P(FrameParallelTest, MD5Match) {
+  const aom_rational timebase = { 33333333, 1000000000 };
+  cfg_.g_timebase = timebase;
+  cfg_.rc_target_bitrate = 500;
+  cfg_.g_lag_in_frames = 12;
+  cfg_.rc_end_usage = AOM_VBR;
+
+  ::libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 352, 288,
+                                       timebase.den, timebase.num, 0, 40);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  // The frame threads hold back the frames until they are all busy, and a
+  // flush outputs one frame at a time.
+  while (DecodeFrame(parallel_dec_, &md5_parallel_, &n_parallel_frames_,
+                     NULL)) {
+  }
+
+  EXPECT_GT(n_serial_frames_, 0);
+  EXPECT_EQ(n_serial_frames_, n_parallel_frames_);
+  ASSERT_STREQ(md5_serial_.Get(), md5_parallel_.Get());
+}
+
+AV1_INSTANTIATE_TEST_CASE(FrameParallelTest, ::testing::Values(2, 16, 32));
+}  // namespace
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+*/
+
+#include <string>
+#include <vector>
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+
+namespace {
+
+const int kFrames = 12;
+const unsigned int kKfMaxDist = 4;
+
+// Encodes with AV1E_SET_KF_CHUNK_PARALLEL, with the key frame interval either
+// fixed (kf_min_dist == kf_max_dist) or only bounded by kf_max_dist, and
+// checks that the chunks decode and that the output does not depend on the
+// number of threads.
+class KfChunkTest
+    : public ::libaom_test::EncoderTest,
+      public ::libaom_test::CodecTestWithParam<unsigned int> {
+ protected:
+  KfChunkTest()
+      : EncoderTest(GET_PARAM(0)), kf_min_dist_(GET_PARAM(1)),
+        encoder_initialized_(false), num_key_frames_(0), num_psnr_pkts_(0) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.w = 352;
+    cfg.h = 288;
+    decoder_ = codec_->CreateDecoder(cfg, 0);
+#if CONFIG_AV1 && CONFIG_EXT_TILE
+    if (decoder_->IsAV1()) {
+      decoder_->Control(AV1_SET_DECODE_TILE_ROW, -1);
+      decoder_->Control(AV1_SET_DECODE_TILE_COL, -1);
+    }
+#endif
+  }
+  virtual ~KfChunkTest() { delete decoder_; }
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kTwoPassGood);
+    cfg_.g_lag_in_frames = 3;
+    cfg_.rc_end_usage = AOM_VBR;
+    cfg_.rc_target_bitrate = 500;
+    cfg_.kf_mode = AOM_KF_AUTO;
+    cfg_.kf_min_dist = kf_min_dist_;
+    cfg_.kf_max_dist = kKfMaxDist;
+  }
+
+  virtual void BeginPassHook(unsigned int /*pass*/) {
+    encoder_initialized_ = false;
+    num_psnr_pkts_ = 0;
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource * /*video*/,
+                                  ::libaom_test::Encoder *encoder) {
+    if (!encoder_initialized_) {
+      encoder->Control(AOME_SET_CPUUSED, 4);
+      encoder->Control(AV1E_SET_KF_CHUNK_PARALLEL, 1);
+      encoder_initialized_ = true;
+    }
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    if (pkt->data.frame.flags & AOM_FRAME_IS_KEY) ++num_key_frames_;
+
+    ::libaom_test::MD5 md5_enc;
+    md5_enc.Add(reinterpret_cast<uint8_t *>(pkt->data.frame.buf),
+                pkt->data.frame.sz);
+    md5_enc_.push_back(md5_enc.Get());
+
+    const aom_codec_err_t res = decoder_->DecodeFrame(
+        reinterpret_cast<uint8_t *>(pkt->data.frame.buf), pkt->data.frame.sz);
+    if (res != AOM_CODEC_OK) {
+      abort_ = true;
+      ASSERT_EQ(AOM_CODEC_OK, res);
+    }
+    const aom_image_t *img = decoder_->GetDxData().Next();
+    if (img) {
+      ::libaom_test::MD5 md5_res;
+      md5_res.Add(img);
+      md5_dec_.push_back(md5_res.Get());
+    }
+  }
+
+  virtual void PSNRPktHook(const aom_codec_cx_pkt_t *pkt) {
+    EXPECT_GT(pkt->data.psnr.psnr[0], 0.0);
+    ++num_psnr_pkts_;
+  }
+
+  void RunEncode(unsigned int threads) {
+    ::libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 352,
+                                         288, 30, 1, 0, kFrames);
+    cfg_.g_threads = threads;
+    num_key_frames_ = 0;
+    md5_enc_.clear();
+    md5_dec_.clear();
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  }
+
+  unsigned int kf_min_dist_;
+  bool encoder_initialized_;
+  int num_key_frames_;
+  int num_psnr_pkts_;
+  ::libaom_test::Decoder *decoder_;
+  std::vector<std::string> md5_enc_;
+  std::vector<std::string> md5_dec_;
+};
+
+TEST_P(KfChunkTest, ThreadsMatch) {
+  ASSERT_NO_FATAL_FAILURE(RunEncode(1));
+  const std::vector<std::string> single_thr_md5_enc = md5_enc_;
+  const std::vector<std::string> single_thr_md5_dec = md5_dec_;
+  // One chunk starts at least every kf_max_dist frames.
+  EXPECT_GE(num_key_frames_, kFrames / static_cast<int>(kKfMaxDist));
+  EXPECT_EQ(static_cast<size_t>(kFrames), md5_dec_.size());
+
+  ASSERT_NO_FATAL_FAILURE(RunEncode(4));
+  ASSERT_EQ(single_thr_md5_enc, md5_enc_);
+  ASSERT_EQ(single_thr_md5_dec, md5_dec_);
+}
+
+// The chunk compressors return a PSNR packet for every shown frame.
+TEST_P(KfChunkTest, Psnr) {
+  init_flags_ = AOM_CODEC_USE_PSNR;
+  ASSERT_NO_FATAL_FAILURE(RunEncode(4));
+  EXPECT_EQ(kFrames, num_psnr_pkts_);
+}
+
+AV1_INSTANTIATE_TEST_CASE(KfChunkTest, ::testing::Values(0u, kKfMaxDist));
+}  // namespace
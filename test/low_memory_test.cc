@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2017, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+*/
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/decode_compare_test.h"
+#include "test/util.h"
+
+namespace {
+class LowMemoryTest : public ::libaom_test::DecodeCompareTest,
+                      public ::libaom_test::CodecTestWithParam<int> {
+ protected:
+  LowMemoryTest()
+      : DecodeCompareTest(GET_PARAM(0), GET_PARAM(1), AV1D_SET_LOW_MEMORY, 1) {
+  }
+};
+
+// Freeing the buffers between frames must not change the output, and must
+// lower the memory held by the decoder.
+TEST_P(LowMemoryTest, MD5Match) {
+  ASSERT_NO_FATAL_FAILURE(RunAndCompare());
+
+  aom_dec_mem_usage_t usage, low_mem_usage;
+  dec_->Control(AV1D_GET_MEMORY_USAGE, &usage);
+  ctrl_dec_->Control(AV1D_GET_MEMORY_USAGE, &low_mem_usage);
+  EXPECT_GT(usage.current_bytes, 0u);
+  EXPECT_GE(usage.peak_bytes, usage.current_bytes);
+  EXPECT_GE(low_mem_usage.peak_bytes, low_mem_usage.current_bytes);
+  EXPECT_LT(low_mem_usage.current_bytes, usage.current_bytes);
+  EXPECT_LE(low_mem_usage.peak_bytes, usage.peak_bytes);
+  // The frame buffers are already allocated.
+  ctrl_dec_->Control(AV1D_SET_LOW_MEMORY, 0, AOM_CODEC_ERROR);
+}
+
+AV1_INSTANTIATE_TEST_CASE(LowMemoryTest, ::testing::Values(1, 4));
+}  // namespace
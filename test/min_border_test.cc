@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2017, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+*/
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/decode_compare_test.h"
+#include "test/util.h"
+
+namespace {
+class MinBorderTest : public ::libaom_test::DecodeCompareTest,
+                      public ::libaom_test::CodecTestWithParam<int> {
+ protected:
+  MinBorderTest()
+      : DecodeCompareTest(GET_PARAM(0), GET_PARAM(1), AV1D_SET_MIN_BORDER, 1) {
+  }
+};
+
+// Emulating the edges of the reference frames must not change the output.
+TEST_P(MinBorderTest, MD5Match) {
+  ASSERT_NO_FATAL_FAILURE(RunAndCompare());
+  // The frames already decoded keep their border.
+  ctrl_dec_->Control(AV1D_SET_MIN_BORDER, 0, AOM_CODEC_ERROR);
+}
+
+AV1_INSTANTIATE_TEST_CASE(MinBorderTest, ::testing::Values(1, 4));
+}  // namespace
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2017, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+*/
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+
+namespace {
+class PostFilterTest
+    : public ::libaom_test::EncoderTest,
+      public ::libaom_test::CodecTestWith2Params<int, int> {
+ protected:
+  PostFilterTest()
+      : EncoderTest(GET_PARAM(0)), md5_serial_(), md5_unfiltered_(),
+        md5_pipelined_() {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.w = 352;
+    cfg.h = 288;
+    cfg.threads = 1;
+    serial_dec_ = codec_->CreateDecoder(cfg, 0);
+    unfiltered_dec_ = codec_->CreateDecoder(cfg, 0);
+    unfiltered_dec_->Control(AV1_SET_SKIP_LOOP_FILTER, 1);
+    cfg.threads = GET_PARAM(1);
+    pipelined_dec_ = codec_->CreateDecoder(cfg, 0);
+    pipelined_dec_->Control(AV1D_SET_ROW_MT, GET_PARAM(2));
+#if CONFIG_AV1 && CONFIG_EXT_TILE
+    serial_dec_->Control(AV1_SET_DECODE_TILE_ROW, -1);
+    serial_dec_->Control(AV1_SET_DECODE_TILE_COL, -1);
+    unfiltered_dec_->Control(AV1_SET_DECODE_TILE_ROW, -1);
+    unfiltered_dec_->Control(AV1_SET_DECODE_TILE_COL, -1);
+    pipelined_dec_->Control(AV1_SET_DECODE_TILE_ROW, -1);
+    pipelined_dec_->Control(AV1_SET_DECODE_TILE_COL, -1);
+#endif
+  }
+
+  virtual ~PostFilterTest() {
+    delete serial_dec_;
+    delete unfiltered_dec_;
+    delete pipelined_dec_;
+  }
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kTwoPassGood);
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 1) encoder->Control(AOME_SET_CPUUSED, 3);
+  }
+
+  void DecodeFrame(::libaom_test::Decoder *dec, ::libaom_test::MD5 *md5,
+                   const aom_codec_cx_pkt_t *pkt) {
+    const aom_codec_err_t res = dec->DecodeFrame(
+        reinterpret_cast<uint8_t *>(pkt->data.frame.buf), pkt->data.frame.sz);
+    ASSERT_EQ(AOM_CODEC_OK, res);
+    ::libaom_test::DxDataIterator frames = dec->GetDxData();
+    for (const aom_image_t *img = frames.Next(); img; img = frames.Next())
+      md5->Add(img);
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    ASSERT_NO_FATAL_FAILURE(DecodeFrame(serial_dec_, &md5_serial_, pkt));
+    ASSERT_NO_FATAL_FAILURE(
+        DecodeFrame(unfiltered_dec_, &md5_unfiltered_, pkt));
+    ASSERT_NO_FATAL_FAILURE(DecodeFrame(pipelined_dec_, &md5_pipelined_, pkt));
+  }
+
+  ::libaom_test::MD5 md5_serial_, md5_unfiltered_, md5_pipelined_;
+  ::libaom_test::Decoder *serial_dec_, *unfiltered_dec_, *pipelined_dec_;
+};
+
+// The post filters pipelined over the superblock rows on several threads,
+// with the deblocking in the pipeline or not, must output the frames of the
+// serial filters. The output differs from the unfiltered one, so the filters
+// did run.
+TEST_P(PostFilterTest, MD5Match) {
+  const aom_rational timebase = { 33333333, 1000000000 };
+  cfg_.g_timebase = timebase;
+  cfg_.rc_target_bitrate = 200;
+  cfg_.rc_min_quantizer = 32;
+  cfg_.g_lag_in_frames = 12;
+  cfg_.rc_end_usage = AOM_VBR;
+
+  ::libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 352, 288,
+                                       timebase.den, timebase.num, 0, 10);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+
+  ASSERT_STRNE(md5_serial_.Get(), md5_unfiltered_.Get());
+  ASSERT_STREQ(md5_serial_.Get(), md5_pipelined_.Get());
+}
+
+AV1_INSTANTIATE_TEST_CASE(PostFilterTest, ::testing::Values(2, 3, 4, 8),
+                          ::testing::Values(0, 1));
+}  // namespace
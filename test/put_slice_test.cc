@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2017, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+*/
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
+#include "test/util.h"
+#include "test/md5_helper.h"
+
+namespace {
+class PutSliceTest : public ::libaom_test::EncoderTest,
+                     public ::libaom_test::CodecTestWith2Params<int, int> {
+ protected:
+  PutSliceTest()
+      : EncoderTest(GET_PARAM(0)), md5_frame_(), md5_slices_(), rows_(0),
+        n_frames_(0), n_slices_(0), n_partial_slices_(0), slices_ok_(true),
+        n_threads_(GET_PARAM(1)), row_mt_(GET_PARAM(2)) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.w = 352;
+    cfg.h = 288;
+    cfg.threads = n_threads_;
+    frame_dec_ = codec_->CreateDecoder(cfg, 0);
+    slice_dec_ = codec_->CreateDecoder(cfg, 0);
+    slice_dec_->Control(AV1D_SET_ROW_MT, row_mt_);
+#if CONFIG_AV1 && CONFIG_EXT_TILE
+    // Slices are only posted when the whole frame is decoded.
+    frame_dec_->Control(AV1_SET_DECODE_TILE_ROW, -1);
+    frame_dec_->Control(AV1_SET_DECODE_TILE_COL, -1);
+    slice_dec_->Control(AV1_SET_DECODE_TILE_ROW, -1);
+    slice_dec_->Control(AV1_SET_DECODE_TILE_COL, -1);
+#endif
+    put_slice_res_ = aom_codec_register_put_slice_cb(slice_dec_->GetDecoder(),
+                                                     PutSlice, this);
+  }
+
+  virtual ~PutSliceTest() {
+    delete frame_dec_;
+    delete slice_dec_;
+  }
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(libaom_test::kTwoPassGood);
+  }
+
+  virtual void PreEncodeFrameHook(libaom_test::VideoSource *video,
+                                  libaom_test::Encoder *encoder) {
+    if (video->frame() == 1) encoder->Control(AOME_SET_CPUUSED, 3);
+  }
+
+  // Checks that the slices of each frame follow each other, counts those
+  // posted before the last row of the frame is done, and hashes the frame
+  // once its last row has been posted.
+  static void PutSlice(void *user_priv, const aom_image_t *img,
+                       const aom_image_rect_t *valid,
+                       const aom_image_rect_t *update) {
+    PutSliceTest *const test = reinterpret_cast<PutSliceTest *>(user_priv);
+    if (update->y != test->rows_ || valid->y != 0 ||
+        valid->h != update->y + update->h || update->x != 0 ||
+        update->w != img->d_w || update->h == 0 || valid->h > img->d_h)
+      test->slices_ok_ = false;
+    test->rows_ = valid->h;
+    ++test->n_slices_;
+    if (valid->h < img->d_h) ++test->n_partial_slices_;
+    if (test->rows_ == img->d_h) {
+      test->md5_slices_.Add(img);
+      test->rows_ = 0;
+    }
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    uint8_t *const buf = reinterpret_cast<uint8_t *>(pkt->data.frame.buf);
+    aom_codec_err_t res = frame_dec_->DecodeFrame(buf, pkt->data.frame.sz);
+    ASSERT_EQ(AOM_CODEC_OK, res);
+    ::libaom_test::DxDataIterator frames = frame_dec_->GetDxData();
+    for (const aom_image_t *img = frames.Next(); img; img = frames.Next()) {
+      md5_frame_.Add(img);
+      ++n_frames_;
+    }
+
+    res = slice_dec_->DecodeFrame(buf, pkt->data.frame.sz);
+    ASSERT_EQ(AOM_CODEC_OK, res);
+    // All the rows of the shown frames are posted during the decode call.
+    ASSERT_EQ(0u, rows_);
+  }
+
+  ::libaom_test::MD5 md5_frame_, md5_slices_;
+  ::libaom_test::Decoder *frame_dec_, *slice_dec_;
+  aom_codec_err_t put_slice_res_;
+  unsigned int rows_;
+  int n_frames_;
+  int n_slices_;
+  int n_partial_slices_;
+  bool slices_ok_;
+  int n_threads_;
+
+ private:
+  int row_mt_;
+};
+
+// The frames posted by rows must be identical to the frames output by the
+// decoder. With threads, the superblock rows of the frames, 5 of them here,
+// are posted as they are done.
+TEST_P(PutSliceTest, MD5Match) {
+  const aom_rational timebase = { 33333333, 1000000000 };
+  cfg_.g_timebase = timebase;
+  cfg_.rc_target_bitrate = 500;
+  cfg_.g_lag_in_frames = 12;
+  cfg_.rc_end_usage = AOM_VBR;
+
+  ASSERT_EQ(AOM_CODEC_OK, put_slice_res_);
+  libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 352, 288,
+                                     timebase.den, timebase.num, 0, 10);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+
+  EXPECT_TRUE(slices_ok_);
+  EXPECT_GT(n_frames_, 0);
+  if (n_threads_ > 1) {
+    EXPECT_GT(n_slices_, n_frames_);
+    EXPECT_GT(n_partial_slices_, 0);
+  } else {
+    EXPECT_EQ(n_frames_, n_slices_);
+  }
+  ASSERT_STREQ(md5_frame_.Get(), md5_slices_.Get());
+}
+
+AV1_INSTANTIATE_TEST_CASE(PutSliceTest, ::testing::Values(1, 4),
+                          ::testing::Values(0, 1));
+}  // namespace
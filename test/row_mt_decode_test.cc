@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+*/
+
+#include <string>
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
+#include "test/util.h"
+#include "test/md5_helper.h"
+
+namespace {
+class RowMTDecodeTest
+    : public ::libaom_test::EncoderTest,
+      public ::libaom_test::CodecTestWith3Params<int, int, int> {
+ protected:
+  RowMTDecodeTest()
+      : EncoderTest(GET_PARAM(0)), md5_serial_(), md5_row_mt_(),
+        md5_tile_mt_(), n_threads_(GET_PARAM(1)),
+        n_tile_cols_(GET_PARAM(2)), n_tile_rows_(GET_PARAM(3)) {
+    init_flags_ = AOM_CODEC_USE_PSNR;
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.w = 352;
+    cfg.h = 288;
+    cfg.threads = 1;
+    serial_dec_ = codec_->CreateDecoder(cfg, 0);
+    cfg.threads = n_threads_;
+    row_mt_dec_ = codec_->CreateDecoder(cfg, 0);
+    row_mt_dec_->Control(AV1D_SET_ROW_MT, 1);
+    tile_mt_dec_ = codec_->CreateDecoder(cfg, 0);
+
+#if CONFIG_AV1 && CONFIG_EXT_TILE
+    if (serial_dec_->IsAV1() && row_mt_dec_->IsAV1()) {
+      serial_dec_->Control(AV1_SET_DECODE_TILE_ROW, -1);
+      serial_dec_->Control(AV1_SET_DECODE_TILE_COL, -1);
+      row_mt_dec_->Control(AV1_SET_DECODE_TILE_ROW, -1);
+      row_mt_dec_->Control(AV1_SET_DECODE_TILE_COL, -1);
+      tile_mt_dec_->Control(AV1_SET_DECODE_TILE_ROW, -1);
+      tile_mt_dec_->Control(AV1_SET_DECODE_TILE_COL, -1);
+    }
+#endif
+  }
+
+  virtual ~RowMTDecodeTest() {
+    delete serial_dec_;
+    delete row_mt_dec_;
+    delete tile_mt_dec_;
+  }
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(libaom_test::kTwoPassGood);
+  }
+
+  virtual void PreEncodeFrameHook(libaom_test::VideoSource *video,
+                                  libaom_test::Encoder *encoder) {
+    if (video->frame() == 1) {
+      encoder->Control(AV1E_SET_TILE_COLUMNS, n_tile_cols_);
+      encoder->Control(AV1E_SET_TILE_ROWS, n_tile_rows_);
+      encoder->Control(AOME_SET_CPUUSED, 3);
+    }
+  }
+
+  void UpdateMD5(::libaom_test::Decoder *dec, const aom_codec_cx_pkt_t *pkt,
+                 ::libaom_test::MD5 *md5) {
+    const aom_codec_err_t res = dec->DecodeFrame(
+        reinterpret_cast<uint8_t *>(pkt->data.frame.buf), pkt->data.frame.sz);
+    if (res != AOM_CODEC_OK) {
+      abort_ = true;
+      ASSERT_EQ(AOM_CODEC_OK, res);
+    }
+    const aom_image_t *img = dec->GetDxData().Next();
+    md5->Add(img);
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    UpdateMD5(serial_dec_, pkt, &md5_serial_);
+    UpdateMD5(row_mt_dec_, pkt, &md5_row_mt_);
+    UpdateMD5(tile_mt_dec_, pkt, &md5_tile_mt_);
+  }
+
+  ::libaom_test::MD5 md5_serial_, md5_row_mt_, md5_tile_mt_;
+  ::libaom_test::Decoder *serial_dec_, *row_mt_dec_, *tile_mt_dec_;
+
+ private:
+  int n_threads_;
+  int n_tile_cols_;
+  int n_tile_rows_;
+};
+
+// Encode with one or two tile columns and one or more tile rows, then decode
+// serially, with the superblock rows pipelined across threads and with the
+// tiles decoded in parallel. The output must be identical.
+TEST_P(RowMTDecodeTest, MD5Match) {
+  const aom_rational timebase = { 33333333, 1000000000 };
+  cfg_.g_timebase = timebase;
+  cfg_.rc_target_bitrate = 500;
+  cfg_.g_lag_in_frames = 12;
+  cfg_.rc_end_usage = AOM_VBR;
+
+  libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 352, 288,
+                                     timebase.den, timebase.num, 0, 10);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+
+  ASSERT_STREQ(md5_serial_.Get(), md5_row_mt_.Get());
+  ASSERT_STREQ(md5_serial_.Get(), md5_tile_mt_.Get());
+}
+
+#if CONFIG_EXT_TILE
+AV1_INSTANTIATE_TEST_CASE(RowMTDecodeTest, ::testing::Values(2, 4),
+                          ::testing::Values(1, 2), ::testing::Values(1, 2));
+#else
+AV1_INSTANTIATE_TEST_CASE(RowMTDecodeTest, ::testing::Values(2, 4),
+                          ::testing::Values(0, 1), ::testing::Values(0, 2));
+#endif  // CONFIG_EXT_TILE
+}  // namespace
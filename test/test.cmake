@@ -179,10 +179,18 @@ endif ()
 if (CONFIG_AV1_DECODER AND CONFIG_AV1_ENCODER)
   set(AOM_UNIT_TEST_COMMON_SOURCES
       ${AOM_UNIT_TEST_COMMON_SOURCES}
+      "${AOM_ROOT}/test/decode_compare_test.h"
       "${AOM_ROOT}/test/divu_small_test.cc"
       "${AOM_ROOT}/test/ethread_test.cc"
+      "${AOM_ROOT}/test/frame_parallel_test.cc"
       "${AOM_ROOT}/test/idct8x8_test.cc"
+      "${AOM_ROOT}/test/kf_chunk_test.cc"
+      "${AOM_ROOT}/test/low_memory_test.cc"
+      "${AOM_ROOT}/test/min_border_test.cc"
       "${AOM_ROOT}/test/partial_idct_test.cc"
+      "${AOM_ROOT}/test/post_filter_test.cc"
+      "${AOM_ROOT}/test/put_slice_test.cc"
+      "${AOM_ROOT}/test/row_mt_decode_test.cc"
       "${AOM_ROOT}/test/superframe_test.cc"
       "${AOM_ROOT}/test/tile_independence_test.cc")
 
@@ -209,6 +217,7 @@ if (CONFIG_AOM_HIGHBITDEPTH)
     set(AOM_UNIT_TEST_COMMON_INTRIN_SSE4_1
         ${AOM_UNIT_TEST_COMMON_INTRIN_SSE4_1}
         "${AOM_ROOT}/test/av1_highbd_iht_test.cc"
+        "${AOM_ROOT}/test/av1_highbd_temporal_filter_test.cc"
         "${AOM_ROOT}/test/av1_quantize_test.cc")
   endif ()
 
@@ -97,10 +97,18 @@ ifeq ($(CONFIG_AV1),yes)
 ifeq ($(CONFIG_AV1_ENCODER)$(CONFIG_AV1_DECODER),yesyes)
 # IDCT test currently depends on FDCT function
 LIBAOM_TEST_SRCS-yes                   += idct8x8_test.cc
+LIBAOM_TEST_SRCS-yes                   += frame_parallel_test.cc
+LIBAOM_TEST_SRCS-yes                   += decode_compare_test.h
+LIBAOM_TEST_SRCS-yes                   += low_memory_test.cc
+LIBAOM_TEST_SRCS-yes                   += min_border_test.cc
 LIBAOM_TEST_SRCS-yes                   += partial_idct_test.cc
+LIBAOM_TEST_SRCS-yes                   += post_filter_test.cc
+LIBAOM_TEST_SRCS-yes                   += put_slice_test.cc
 LIBAOM_TEST_SRCS-yes                   += superframe_test.cc
 LIBAOM_TEST_SRCS-yes                   += tile_independence_test.cc
+LIBAOM_TEST_SRCS-yes                   += row_mt_decode_test.cc
 LIBAOM_TEST_SRCS-yes                   += ethread_test.cc
+LIBAOM_TEST_SRCS-yes                   += kf_chunk_test.cc
 ifeq ($(CONFIG_EXT_TILE),yes)
 LIBAOM_TEST_SRCS-yes                   += av1_ext_tile_test.cc
 endif
@@ -186,6 +194,7 @@ endif
 ifeq ($(CONFIG_AOM_HIGHBITDEPTH),yes)
 LIBAOM_TEST_SRCS-$(HAVE_SSE4_1) += av1_quantize_test.cc
 LIBAOM_TEST_SRCS-$(HAVE_SSE4_1) += av1_highbd_iht_test.cc
+LIBAOM_TEST_SRCS-$(HAVE_SSE4_1) += av1_highbd_temporal_filter_test.cc
 endif # CONFIG_AOM_HIGHBITDEPTH
 endif # AV1
 